@@ -9,6 +9,7 @@ namespace OfflineRendererSample
     although it is possible to just resize camera render texture,  
     such image will be bound by gpu memory. To avoid this, here we render image in multiple frames
     tile-by-tile using frustrum camera projection. Resulting image size is (viewportSize * texturesPerRaw)
+    tiles are streamed to file by ImageTileWriter, so whole image is never kept in RAM either
     */
     class OfflineRendererApplication : public Application
     {
@@ -18,8 +19,27 @@ namespace OfflineRendererSample
         float imageSize = 0.2f;
         ///////////////////////////////////////////
 
-        using TextureArray = MxVector<Image>;
-        TextureArray textures;
+        // tiles are read back asynchronously and written to file as soon as they are ready, so only one row of tiles is kept in memory
+        MxVector<std::future<Image>> readbacks;
+        UniqueRef<ImageTileWriter> writer;
+        size_t writtenTiles = 0;
+
+        void WriteFinishedTiles()
+        {
+            while (!readbacks.empty() && readbacks.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                auto tile = readbacks.front().get();
+                readbacks.erase(readbacks.begin());
+
+                if (writer == nullptr) // tile size is known only when first tile is read
+                {
+                    writer = MakeUnique<ImageTileWriter>("Resources/scene.png", tile.GetWidth(), tile.GetHeight(),
+                        texturesPerRow, texturesPerRow, tile.GetChannelCount(), PngCompression::FAST);
+                }
+                writer->WriteTile(writtenTiles % texturesPerRow, writtenTiles / texturesPerRow, tile);
+                writtenTiles++;
+            }
+        }
 
     public:
         virtual void OnCreate() override
@@ -57,23 +77,27 @@ namespace OfflineRendererSample
 
         virtual void OnUpdate() override
         {
-            static int frameCount = 0;
+            static size_t frameCount = 0;
+            const size_t tileCount = texturesPerRow * texturesPerRow;
 
             // we determine current tile by frames passed. Total number of frames should be texturesPerRow^2
-            auto& cam = Rendering::GetViewport()->GetCamera<FrustrumCamera>();
-            cam.SetProjectionForTile(frameCount % texturesPerRow, frameCount / texturesPerRow, texturesPerRow, imageSize);
+            // tile rows are rendered from the top one to the bottom one, as image file is written in that order
+            if (frameCount < tileCount)
+            {
+                auto& cam = Rendering::GetViewport()->GetCamera<FrustrumCamera>();
+                cam.SetProjectionForTile(frameCount % texturesPerRow, texturesPerRow - 1 - frameCount / texturesPerRow, texturesPerRow, imageSize);
+            }
 
-            if (frameCount != 0) // avoid submitting empty texture, as on zero frame there is no image rendered
+            if (frameCount != 0 && frameCount <= tileCount) // avoid submitting empty texture, as on zero frame there is no image rendered
             {
                 auto texture = Rendering::GetViewport()->GetRenderTexture();
-                textures.push_back(texture->GetRawTextureData());
+                readbacks.push_back(TextureReadback::Read(texture));
             }
-            if (frameCount == texturesPerRow * texturesPerRow) // when we reach last frame, get image data and convert it to png format
+            this->WriteFinishedTiles();
+
+            // readbacks finish a frame or two after last tile is rendered, then application can be closed
+            if (writtenTiles == tileCount)
             {
-                auto result = ImageManager::CombineImages(textures, texturesPerRow);
-                auto png = ImageConverter::ConvertImagePNG(result);
-                File file("Resources/scene.png", File::WRITE | File::BINARY);
-                file.WriteBytes(png.data(), png.size());
                 this->CloseApplication();
             }
             frameCount++;
@@ -9,7 +9,7 @@ void InitGrid(MxObject& object)
 
 	auto material = object.GetOrAddComponent<MeshRenderer>()->GetMaterial();
 	material->AlbedoMap = AssetManager::LoadTexture("textures/brick_albedo.jpg"_id);
-	material->NormalMap = AssetManager::LoadTexture("textures/brick_normal.jpg"_id);
+	material->NormalMap = AssetManager::LoadTexture("textures/brick_normal.jpg"_id, TextureFormat::RGB, TextureUsage::NORMAL);
 	material->AmbientOcclusionMap = AssetManager::LoadTexture("textures/brick_ao.jpg"_id);
 	material->RoughnessMap = AssetManager::LoadTexture("textures/brick_roughness.jpg"_id);
 }
\ No newline at end of file
@@ -12,5 +12,5 @@ void InitPBRObject(MxObject& object)
     material->HeightMap = AssetManager::LoadTexture("textures/PBR/pirate-gold_height.png"_id);
     material->MetallicMap = AssetManager::LoadTexture("textures/PBR/pirate-gold_metallic.png"_id);
     material->RoughnessMap = AssetManager::LoadTexture("textures/PBR/pirate-gold_roughness.png"_id);
-    material->NormalMap = AssetManager::LoadTexture("textures/PBR/pirate-gold_normal-dx.png"_id);
+    material->NormalMap = AssetManager::LoadTexture("textures/PBR/pirate-gold_normal-dx.png"_id, TextureFormat::RGB, TextureUsage::NORMAL);
 }
\ No newline at end of file
@@ -11,5 +11,5 @@ void InitSphere(MxObject& sphere)
     auto material = sphere.GetOrAddComponent<MeshRenderer>()->GetMaterial();
     material->AlbedoMap = AssetManager::LoadTexture("textures/planet_texture.png"_id);
     material->HeightMap = AssetManager::LoadTexture("textures/planet_height.png"_id);
-    material->NormalMap = AssetManager::LoadTexture("textures/planet_normal.png"_id);
+    material->NormalMap = AssetManager::LoadTexture("textures/planet_normal.png"_id, TextureFormat::RGB, TextureUsage::NORMAL);
 }
\ No newline at end of file
@@ -49,6 +49,9 @@
 #include "Utilities/Json/Json.h"
 #include "Utilities/ImGui/Editors/ComponentEditor.h"
 #include "Utilities/Format/Format.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Core/Resources/TextureStreamer.h"
+#include "Core/Resources/TextureReadback.h"
 
 // components
 #include "Core/Components/Components.h"
@@ -105,10 +108,15 @@ namespace MxEngine
 		return this->counterFPS;
 	}
 
-	void Application::AddCollisionEntry(const MxObject::Handle& object1, const MxObject::Handle& object2)
+	size_t Application::GetCurrentFrame() const
+	{
+		return this->frameIndex;
+	}
+
+	void Application::AddCollisionEntry(MxObject::EngineHandle object1, MxObject::EngineHandle object2, uint32_t callbacks1, uint32_t callbacks2)
 	{
 		auto& [currentCollisions, previousCollisions] = this->collisions;
-		currentCollisions.emplace_back(object1, object2);
+		currentCollisions.Insert((uint32_t)object1, (uint32_t)object2, (uint16_t)callbacks1, (uint16_t)callbacks2);
 	}
 
 	EventDispatcherImpl<EventBase>& Application::GetEventDispatcher()
@@ -160,12 +168,36 @@ namespace MxEngine
 
 	void Application::InvokeUpdate()
 	{
+		// physics thread is stopped while frame is updated, so physics world can be accessed by any callback
+		PhysicsModule::BeginFrame();
+
+		// transforms changed from now on are reported as moved this frame
+		this->frameIndex++;
+
 		// update window and keyboard state
 		{
 			MAKE_SCOPE_PROFILER("MxEngine::OnUpdate");
 			this->GetWindow().OnUpdate();
 		}
 
+		// finish async jobs which require main thread (GPU resource creation, etc.)
+		{
+			MAKE_SCOPE_PROFILER("Application::ExecuteMainThreadTasks");
+			ThreadPool::ExecuteMainThreadTasks(0.001f * (float)this->config.MainThreadTaskBudget);
+		}
+
+		// upload streamed textures under per-frame budget
+		{
+			MAKE_SCOPE_PROFILER("Application::ProcessTextureUploads");
+			TextureStreamer::ProcessUploads();
+		}
+
+		// finish texture readbacks which were completed by GPU during previous frames
+		{
+			MAKE_SCOPE_PROFILER("Application::ProcessTextureReadbacks");
+			TextureReadback::ProcessReadbacks();
+		}
+
 		// do not invoke any events of perform physics if application is paused
 		if (!this->IsPaused)
 		{
@@ -204,6 +236,16 @@ namespace MxEngine
 				this->OnUpdate();
 			}
 		}
+
+		// let physics thread simulate while frame is rendered
+		PhysicsModule::EndFrame();
+	}
+
+	static MxObject* GetCollidingObject(uint32_t handle)
+	{
+		auto& pool = MxObject::Factory::Get<MxObject>();
+		if (handle >= pool.Capacity() || !pool.IsAllocated(handle)) return nullptr;
+		return &pool[handle].value;
 	}
 
 	void Application::InvokePhysics()
@@ -214,46 +256,42 @@ namespace MxEngine
 		MAKE_SCOPE_PROFILER("Physics::InvokeCollionsCallbacks()");
 
 		auto& [currentCollisions, previousCollisions] = this->collisions;
-		std::sort(currentCollisions.begin(), currentCollisions.end());
-		auto previousCollisionEntry = previousCollisions.begin();
 
-		constexpr auto CollisionCallback = [](MxObject::Handle& object1, MxObject::Handle& object2, auto callbackMethod)
+		constexpr auto CollisionCallback = [](const CollisionPair& pair, uint32_t mask, auto callbackMethod)
 		{
-			if (object1.IsValid() && object2.IsValid())
-				std::invoke(callbackMethod, object1->GetComponent<RigidBody>(), *object1, *object2);
-			if (object1.IsValid() && object2.IsValid())
-				std::invoke(callbackMethod, object2->GetComponent<RigidBody>(), *object2, *object1);
-		};
+			const uint32_t objects[] = { pair.GetFirst(), pair.GetSecond() };
+			const uint32_t callbacks[] = { pair.FirstCallbacks, pair.SecondCallbacks };
+			for (size_t i = 0; i < 2; i++)
+			{
+				if ((callbacks[i] & mask) == 0) continue;
 
-		for (auto it = currentCollisions.begin(); it != currentCollisions.end(); it++)
-		{
-			auto& [object1, object2] = *it;
+				// objects are looked up before each callback, as previous callbacks may destroy them
+				auto self = GetCollidingObject(objects[i]);
+				auto other = GetCollidingObject(objects[1 - i]);
+				if (self == nullptr || other == nullptr) continue;
 
-			while (previousCollisionEntry != previousCollisions.end() && *previousCollisionEntry < *it)
-			{
-				auto& [obj1, obj2] = *previousCollisionEntry;
-				CollisionCallback(obj1, obj2, &RigidBody::InvokeOnCollisionExitCallback);
-				previousCollisionEntry++;
+				auto rigidBody = self->GetComponent<RigidBody>();
+				if (rigidBody.IsValid())
+					std::invoke(callbackMethod, *rigidBody, *self, *other);
 			}
-			
-			if (previousCollisionEntry == previousCollisions.end() || *previousCollisionEntry != *it)
-				CollisionCallback(object1, object2, &RigidBody::InvokeOnCollisionEnterCallback);
+		};
 
-			if (previousCollisionEntry != previousCollisions.end() && *previousCollisionEntry == *it) 
-				previousCollisionEntry++;
+		for (const auto& pair : currentCollisions)
+		{
+			if (!previousCollisions.Contains(pair.Key))
+				CollisionCallback(pair, CollisionCallbackMask::COLLISION_ENTER, &RigidBody::InvokeOnCollisionEnterCallback);
 
-			CollisionCallback(object1, object2, &RigidBody::InvokeOnCollisionCallback);
+			CollisionCallback(pair, CollisionCallbackMask::COLLISION, &RigidBody::InvokeOnCollisionCallback);
 		}
 
-		while (previousCollisionEntry != previousCollisions.end())
+		for (const auto& pair : previousCollisions)
 		{
-			auto& [obj1, obj2] = *previousCollisionEntry;
-			CollisionCallback(obj1, obj2, &RigidBody::InvokeOnCollisionExitCallback);
-			previousCollisionEntry++;
+			if (!currentCollisions.Contains(pair.Key))
+				CollisionCallback(pair, CollisionCallbackMask::COLLISION_EXIT, &RigidBody::InvokeOnCollisionExitCallback);
 		}
 
 		std::swap(currentCollisions, previousCollisions);
-		currentCollisions.clear();
+		currentCollisions.Clear();
 	}
 
 	void Application::InvokeCreate()
@@ -299,6 +337,11 @@ namespace MxEngine
 
 		this->InitializeConfig(this->config);
 		FileManager::SetRoot(ToFilePath(config.ProjectRootDirectory));
+		if (this->config.WorkerThreadCount != 0)
+			ThreadPool::SetWorkerCount(this->config.WorkerThreadCount);
+		TextureStreamer::SetUploadBudget(this->config.TextureUploadBudget * 1024 * 1024);
+		PhysicsModule::SetMultithreading(this->config.MultithreadedPhysics, this->config.PhysicsThreadCount);
+		PhysicsModule::SetThreadedSimulation(this->config.PhysicsOnDedicatedThread, 1.0f / (float)Max(this->config.PhysicsTickRate, (size_t)1));
 
 		this->GetWindow()
 			.UseEventDispatcher(this->dispatcher)
@@ -364,6 +407,7 @@ namespace MxEngine
 			{
 				MAKE_SCOPE_PROFILER("Application::CloseApplication");
 				MAKE_SCOPE_TIMER("MxEngine::Application", "Application::CloseApplication()");
+				PhysicsModule::SetThreadedSimulation(false); // objects may be destroyed outside of frame update from now
 				AppDestroyEvent appDestroyEvent;
 				Event::Invoke(appDestroyEvent);
 				this->OnDestroy();
@@ -409,6 +453,11 @@ namespace MxEngine
 
 	Application::ModuleManager::~ModuleManager()
 	{
+		TextureReadback::Flush(); // pending screenshots must be saved before workers are stopped
+		ThreadPool::Destroy(); // workers must be joined before other modules are destroyed
+		TextureStreamer::Destroy(); // pixel buffers must be deleted while graphic context exists
+		TextureReadback::Destroy();
+		AssetManager::Destroy();
 		PhysicsModule::Destroy();
 		GraphicModule::Destroy();
 		AudioFactory::DeInit(); // OpenAL is angry when buffers are not deleted
@@ -584,7 +633,6 @@ namespace MxEngine
 		this->RegisterComponentUpdate<VRCameraController>();
 		this->RegisterComponentUpdate<AudioListener>();
 		this->RegisterComponentUpdate<AudioSource>();
-		this->RegisterComponentUpdate<RigidBody>();
 		this->RegisterComponentUpdate<CharacterController>();
 	}
 }
\ No newline at end of file
@@ -32,6 +32,7 @@
 #include "Core/Events/EventBase.h"
 #include "Core/Rendering/RenderAdaptor.h"
 #include "Core/MxObject/MxObject.h"
+#include "Core/Application/CollisionPairSet.h"
 #include "Utilities/FileSystem/File.h"
 #include "Core/Config/Config.h"
 #include "Utilities/Profiler/Profiler.h"
@@ -52,8 +53,7 @@ namespace MxEngine
 		} manager;
 
 		using CallbackList = MxVector<std::function<void(TimeStep)>>;
-		using CollisionList = MxVector<std::pair<MxObject::Handle, MxObject::Handle>>;
-		using CollisionSwapPair = std::pair<CollisionList, CollisionList>;
+		using CollisionSwapPair = std::pair<CollisionPairSet, CollisionPairSet>;
 	private:
 		static inline Application* Current = nullptr;
 		UniqueRef<Window> window;
@@ -65,6 +65,7 @@ namespace MxEngine
 		Config config;
 		TimeStep timeDelta = 0.0f;
 		size_t counterFPS = 0;
+		size_t frameIndex = 0;
 		bool shouldClose = false;
 		bool isRunning = false;
 
@@ -96,7 +97,7 @@ namespace MxEngine
 		void ToggleWindowUpdates(bool isPolled);
 		void CloseOnKeyPress(KeyCode key);
 
-		void AddCollisionEntry(const MxObject::Handle& object1, const MxObject::Handle& object2);
+		void AddCollisionEntry(MxObject::EngineHandle object1, MxObject::EngineHandle object2, uint32_t callbacks1, uint32_t callbacks2);
 		EventDispatcherImpl<EventBase>& GetEventDispatcher();
 		RenderAdaptor& GetRenderAdaptor();
 		RuntimeEditor& GetRuntimeEditor();
@@ -105,6 +106,11 @@ namespace MxEngine
 		float GetTimeDelta() const;
 		float GetUnscaledTimeDelta() const;
 		size_t GetCurrentFPS() const;
+		/*!
+		gets index of current frame. Application is shared with runtime-compiled modules, so all modules observe same counter
+		\returns number of frames started since application launch
+		*/
+		size_t GetCurrentFrame() const;
 		void Run();
 		bool IsRunning() const;
 		void CloseApplication();
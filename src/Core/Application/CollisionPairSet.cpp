@@ -0,0 +1,231 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "CollisionPairSet.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace MxEngine
+{
+    uint64_t CollisionPair::MakeKey(uint32_t object1, uint32_t object2)
+    {
+        if (object1 > object2) std::swap(object1, object2);
+        return (uint64_t(object1) << 32) | uint64_t(object2);
+    }
+
+    uint32_t CollisionPair::GetFirst() const
+    {
+        return uint32_t(this->Key >> 32);
+    }
+
+    uint32_t CollisionPair::GetSecond() const
+    {
+        return uint32_t(this->Key);
+    }
+
+    static size_t HashCollisionKey(uint64_t key, uint32_t shift)
+    {
+        // fold handles together, then take top bits of fibonacci hash
+        key ^= key >> 32;
+        return size_t((key * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    size_t CollisionPairSet::FindSlot(uint64_t key) const
+    {
+        // table is kept at most half full, so linear probing always reaches key or empty slot
+        size_t mask = this->slots.size() - 1;
+        size_t slot = HashCollisionKey(key, this->hashShift);
+        while (this->slots[slot] != 0 && this->pairs[this->slots[slot] - 1].Key != key)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void CollisionPairSet::Rehash(size_t slotCount)
+    {
+        uint32_t bitCount = 0;
+        while ((size_t(1) << bitCount) < slotCount) bitCount++;
+
+        this->slots.assign(size_t(1) << bitCount, 0);
+        this->hashShift = 64 - bitCount;
+        for (size_t i = 0; i < this->pairs.size(); i++)
+        {
+            size_t slot = this->FindSlot(this->pairs[i].Key);
+            this->slots[slot] = uint32_t(i + 1);
+            this->pairs[i].Slot = uint32_t(slot);
+        }
+    }
+
+    void CollisionPairSet::Insert(uint32_t object1, uint32_t object2, uint16_t callbacks1, uint16_t callbacks2)
+    {
+        if (object1 > object2)
+        {
+            std::swap(object1, object2);
+            std::swap(callbacks1, callbacks2);
+        }
+
+        if ((this->pairs.size() + 1) * 2 > this->slots.size())
+            this->Rehash(Max(this->slots.size() * 2, (size_t)64));
+
+        uint64_t key = CollisionPair::MakeKey(object1, object2);
+        size_t slot = this->FindSlot(key);
+        if (this->slots[slot] != 0)
+        {
+            // objects may have several manifolds, for example if one of them has compound collider
+            auto& pair = this->pairs[this->slots[slot] - 1];
+            pair.FirstCallbacks |= callbacks1;
+            pair.SecondCallbacks |= callbacks2;
+            return;
+        }
+
+        this->pairs.push_back(CollisionPair{ key, callbacks1, callbacks2, uint32_t(slot) });
+        this->slots[slot] = uint32_t(this->pairs.size());
+    }
+
+    bool CollisionPairSet::Contains(uint64_t key) const
+    {
+        if (this->pairs.empty()) return false;
+        return this->slots[this->FindSlot(key)] != 0;
+    }
+
+    void CollisionPairSet::Clear()
+    {
+        for (const auto& pair : this->pairs)
+            this->slots[pair.Slot] = 0;
+        this->pairs.clear();
+    }
+
+    size_t CollisionPairSet::Size() const
+    {
+        return this->pairs.size();
+    }
+
+    bool CollisionPairSet::IsEmpty() const
+    {
+        return this->pairs.empty();
+    }
+
+    MxVector<CollisionPair>::const_iterator CollisionPairSet::begin() const
+    {
+        return this->pairs.begin();
+    }
+
+    MxVector<CollisionPair>::const_iterator CollisionPairSet::end() const
+    {
+        return this->pairs.end();
+    }
+
+    CollisionPairSetBenchmark CollisionPairSet::RunBenchmark(size_t pairCount, size_t frameCount)
+    {
+        constexpr size_t changePeriod = 20; // each pair changes its partner once in 20 frames
+        constexpr uint32_t partnerRange = 1024;
+
+        CollisionPairSetBenchmark result;
+        result.PairCount = pairCount;
+        result.FrameCount = Max(frameCount, (size_t)1);
+
+        // bullet keeps manifolds in its pool, so they are visited in the same unordered sequence every frame
+        MxVector<uint32_t> order(pairCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+        auto getPartner = [](uint32_t object, size_t frame)
+        {
+            uint64_t generation = (frame + object) / changePeriod;
+            uint64_t hash = (uint64_t(object) * 0x9E3779B97F4A7C15ull) ^ (generation * 0xC2B2AE3D27D4EB4Full);
+            return object + 1 + uint32_t((hash >> 40) % partnerRange);
+        };
+
+        // previous implementation: sort pairs of object identifiers and merge-walk them against previous frame
+        using SortedPair = std::pair<uint64_t, uint64_t>;
+        MxVector<SortedPair> currentSorted, previousSorted;
+        size_t sortedEnterCount = 0, sortedExitCount = 0;
+
+        TimeStep start = Time::Current();
+        for (size_t frame = 0; frame < result.FrameCount; frame++)
+        {
+            for (uint32_t object : order)
+                currentSorted.emplace_back(object, getPartner(object, frame));
+            std::sort(currentSorted.begin(), currentSorted.end());
+
+            auto previous = previousSorted.begin();
+            for (const auto& pair : currentSorted)
+            {
+                while (previous != previousSorted.end() && *previous < pair)
+                {
+                    sortedExitCount++;
+                    previous++;
+                }
+                if (previous != previousSorted.end() && *previous == pair)
+                    previous++;
+                else
+                    sortedEnterCount++;
+            }
+            sortedExitCount += size_t(previousSorted.end() - previous);
+
+            std::swap(currentSorted, previousSorted);
+            currentSorted.clear();
+        }
+        result.SortedVector = (Time::Current() - start) / (float)result.FrameCount;
+
+        CollisionPairSet currentSet, previousSet;
+        start = Time::Current();
+        for (size_t frame = 0; frame < result.FrameCount; frame++)
+        {
+            for (uint32_t object : order)
+                currentSet.Insert(object, getPartner(object, frame), 1, 0);
+
+            for (const auto& pair : currentSet)
+            {
+                if (!previousSet.Contains(pair.Key)) result.EnterCount++;
+            }
+            for (const auto& pair : previousSet)
+            {
+                if (!currentSet.Contains(pair.Key)) result.ExitCount++;
+            }
+
+            std::swap(currentSet, previousSet);
+            currentSet.Clear();
+        }
+        result.HashSet = (Time::Current() - start) / (float)result.FrameCount;
+
+        if (sortedEnterCount != result.EnterCount || sortedExitCount != result.ExitCount)
+        {
+            MXLOG_ERROR("MxEngine::CollisionPairSet", MxFormat("benchmark results differ: enter {0} / {1}, exit {2} / {3}",
+                sortedEnterCount, result.EnterCount, sortedExitCount, result.ExitCount));
+        }
+        MXLOG_INFO("MxEngine::CollisionPairSet", MxFormat("benchmark on {0} pairs, {1} frames: sorted vector {2}ms -> hash set {3}ms per frame ({4} enter, {5} exit events)",
+            result.PairCount, result.FrameCount, result.SortedVector * 1000.0f, result.HashSet * 1000.0f, result.EnterCount, result.ExitCount));
+        return result;
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+namespace MxEngine
+{
+    /*!
+    pair of colliding objects, identified by their native handles. Handles are packed into 64-bit key
+    with smaller handle in high bits, so pairs (a, b) and (b, a) share the same key
+    */
+    struct CollisionPair
+    {
+        uint64_t Key;
+        uint16_t FirstCallbacks;  // collision callbacks registered by object with smaller handle
+        uint16_t SecondCallbacks; // collision callbacks registered by object with greater handle
+        uint32_t Slot;
+
+        static uint64_t MakeKey(uint32_t object1, uint32_t object2);
+        uint32_t GetFirst() const;
+        uint32_t GetSecond() const;
+    };
+
+    /*!
+    timings of collision pair diffing benchmark for one simulated frame, measured in seconds
+    */
+    struct CollisionPairSetBenchmark
+    {
+        size_t PairCount = 0;
+        size_t FrameCount = 0;
+        size_t EnterCount = 0;
+        size_t ExitCount = 0;
+        TimeStep SortedVector = 0.0f;
+        TimeStep HashSet = 0.0f;
+    };
+
+    /*!
+    open-addressing hash set of collision pairs. Pairs are stored densely in insertion order, hash table only keeps their indices,
+    so iteration and clearing cost is proportional to number of pairs, not to table size
+    */
+    class CollisionPairSet
+    {
+        MxVector<CollisionPair> pairs;
+        MxVector<uint32_t> slots; // index of pair plus one, zero for empty slot
+        uint32_t hashShift = 64;
+
+        size_t FindSlot(uint64_t key) const;
+        void Rehash(size_t slotCount);
+    public:
+        /*!
+        inserts pair of objects into set. If pair is already present, callback flags are merged
+        \param object1 native handle of first object
+        \param object2 native handle of second object
+        \param callbacks1 collision callbacks registered by first object
+        \param callbacks2 collision callbacks registered by second object
+        */
+        void Insert(uint32_t object1, uint32_t object2, uint16_t callbacks1, uint16_t callbacks2);
+        bool Contains(uint64_t key) const;
+        void Clear();
+        size_t Size() const;
+        bool IsEmpty() const;
+
+        MxVector<CollisionPair>::const_iterator begin() const;
+        MxVector<CollisionPair>::const_iterator end() const;
+
+        /*!
+        diffs synthetic collision pairs between frames using sorted vectors with merge walk (as done before) and hash sets, logging timings.
+        Sorted vector variant does not include handle refcounting, so its timings are lower bound of previous implementation
+        \param pairCount number of colliding pairs (contact manifolds) in each frame
+        \param frameCount number of simulated frames. Every frame 5% of pairs change
+        \returns benchmark timings
+        */
+        static CollisionPairSetBenchmark RunBenchmark(size_t pairCount = 100000, size_t frameCount = 60);
+    };
+}
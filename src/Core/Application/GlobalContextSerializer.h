@@ -34,6 +34,9 @@
 #include "Core/Resources/AssetManager.h"
 #include "Core/Runtime/RuntimeCompiler.h"
 #include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Core/Resources/TextureStreamer.h"
+#include "Core/Resources/TextureReadback.h"
 #include "Platform/Modules/PhysicsModule.h"
 #include "Platform/Modules/GraphicModule.h"
 #include "Platform/Modules/AudioModule.h"
@@ -44,6 +47,10 @@ namespace MxEngine
 	using GlobalContextSerializer = StaticSerializer<
 		Application,
 		Logger,
+		ThreadPool,
+		TextureStreamer,
+		TextureReadback,
+		AssetManager,
 		FileManager,
 		AudioModule,
 		GraphicModule,
@@ -33,6 +33,14 @@
 #include "Platform/Bullet3/Bullet3Utils.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Core/Application/Application.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/Format/Format.h"
+
+#include <atomic>
+#include <random>
+#include <cmath>
 
 namespace MxEngine
 {
@@ -42,6 +50,7 @@ namespace MxEngine
     {
         MAKE_SCOPE_PROFILER("Physics::SubmitCollisions()");
         auto dispatcher = WORLD->getDispatcher();
+        auto application = Application::GetImpl();
         int numManiforlds = dispatcher->getNumManifolds();
         for (int i = 0; i < numManiforlds; i++)
         {
@@ -49,16 +58,73 @@ namespace MxEngine
             const btCollisionObject* collider1 = contactManifold->getBody0();
             const btCollisionObject* collider2 = contactManifold->getBody1();
 
+            // user index contains collision callbacks registered by RigidBody, see NativeRigidBody
+            auto callbacks1 = (uint32_t)collider1->getUserIndex();
+            auto callbacks2 = (uint32_t)collider2->getUserIndex();
+            if ((callbacks1 | callbacks2) == CollisionCallbackMask::NONE) continue;
+
             if (!collider1->getCollisionShape()->isNonMoving() && !collider2->getCollisionShape()->isNonMoving())
             {
-                auto object1 = Physics::GetRigidBodyParent(collider1);
-                auto object2 = Physics::GetRigidBodyParent(collider2);
+                auto object1 = reinterpret_cast<MxObject::EngineHandle>(collider1->getUserPointer());
+                auto object2 = reinterpret_cast<MxObject::EngineHandle>(collider2->getUserPointer());
 
-                Application::GetImpl()->AddCollisionEntry(object1, object2);
+                application->AddCollisionEntry(object1, object2, callbacks1, callbacks2);
             }
         }
     }
 
+    static RigidBody::Handle GetRigidBodyComponent(const btRigidBody* body)
+    {
+        auto object = Physics::GetRigidBodyParent(body);
+        return object.IsValid() ? object->GetComponent<RigidBody>() : RigidBody::Handle{ };
+    }
+
+    void SubmitRigidBodyUpdates()
+    {
+        MAKE_SCOPE_PROFILER("Physics::SubmitRigidBodyUpdates()");
+        auto& data = *PhysicsModule::GetImpl();
+
+        // indices are used as applying collider may add more bodies to the list
+        for (size_t i = 0; i < data.ColliderUpdates.size(); i++)
+        {
+            auto rigidBody = GetRigidBodyComponent(data.ColliderUpdates[i]);
+            if (rigidBody.IsValid()) rigidBody->UpdateCollider();
+        }
+        data.ColliderUpdates.clear();
+
+        for (auto body : data.KinematicBodies)
+        {
+            auto rigidBody = GetRigidBodyComponent(body);
+            if (rigidBody.IsValid()) rigidBody->UpdateTransform();
+        }
+    }
+
+    void FetchRigidBodyTransforms()
+    {
+        MAKE_SCOPE_PROFILER("Physics::FetchRigidBodyTransforms()");
+        auto& data = *PhysicsModule::GetImpl();
+
+        for (auto body : data.MovedBodies)
+        {
+            auto rigidBody = GetRigidBodyComponent(body);
+            if (rigidBody.IsValid()) rigidBody->UpdateTransform();
+        }
+        data.MovedBodies.clear();
+    }
+
+    void ApplyInterpolatedRigidBodyTransforms(const MxVector<PhysicsBodyState>& states, float alpha)
+    {
+        MAKE_SCOPE_PROFILER("Physics::ApplyInterpolatedRigidBodyTransforms()");
+        for (const auto& state : states)
+        {
+            auto rigidBody = GetRigidBodyComponent(state.Body);
+            if (!rigidBody.IsValid() || rigidBody->IsKinematic()) continue;
+
+            auto position = state.PreviousPosition + (state.CurrentPosition - state.PreviousPosition) * alpha;
+            auto rotation = Slerp(state.PreviousRotation, state.CurrentRotation, alpha);
+            rigidBody->ApplyInterpolatedTransform(position, rotation);
+        }
+    }
 
     struct CustomRayCastCallback : public btCollisionWorld::ClosestRayResultCallback
     {
@@ -81,6 +147,226 @@ namespace MxEngine
         }
     };
 
+    // number of queries processed by one thread pool task
+    constexpr size_t PhysicsQueryGranularity = 64;
+
+    static void SetQueryHit(PhysicsQueryHit& hit, const btCollisionObject* object, const btVector3& point, const btVector3& normal, float fraction)
+    {
+        hit.Object = reinterpret_cast<MxObject::EngineHandle>(object->getUserPointer());
+        hit.Point = FromBulletVector3(point);
+        hit.Normal = FromBulletVector3(normal);
+        hit.Fraction = fraction;
+    }
+
+    static bool RayCastSingle(btCollisionWorld& world, const RayCastQuery& query, PhysicsQueryHit& result)
+    {
+        auto btFrom = ToBulletVector3(query.From);
+        auto btTo = ToBulletVector3(query.To);
+        CustomRayCastCallback callback(btFrom, btTo, query.Mask);
+
+        world.rayTest(btFrom, btTo, callback);
+        result = PhysicsQueryHit{ };
+        if (!callback.hasHit()) return false;
+
+        SetQueryHit(result, callback.m_collisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction);
+        return true;
+    }
+
+    static bool ConvexSweepSingle(btCollisionWorld& world, const btConvexShape& shape, const btTransform& from, const btTransform& to, CollisionMask::Mask mask, PhysicsQueryHit& result)
+    {
+        btCollisionWorld::ClosestConvexResultCallback callback(from.getOrigin(), to.getOrigin());
+        callback.m_collisionFilterGroup = CollisionGroup::ALL;
+        callback.m_collisionFilterMask = mask;
+
+        world.convexSweepTest(&shape, from, to, callback);
+        result = PhysicsQueryHit{ };
+        if (!callback.hasHit()) return false;
+
+        SetQueryHit(result, callback.m_hitCollisionObject, callback.m_hitPointWorld, callback.m_hitNormalWorld, callback.m_closestHitFraction);
+        return true;
+    }
+
+    static bool SphereSweepSingle(btCollisionWorld& world, const SphereSweepQuery& query, PhysicsQueryHit& result)
+    {
+        btSphereShape shape(query.Radius);
+        btTransform from(btQuaternion::getIdentity(), ToBulletVector3(query.From));
+        btTransform to(btQuaternion::getIdentity(), ToBulletVector3(query.To));
+        return ConvexSweepSingle(world, shape, from, to, query.Mask, result);
+    }
+
+    static bool BoxSweepSingle(btCollisionWorld& world, const BoxSweepQuery& query, PhysicsQueryHit& result)
+    {
+        btBoxShape shape(ToBulletVector3(query.HalfExtents));
+        auto rotation = ToBulletQuaternion(query.Rotation);
+        btTransform from(rotation, ToBulletVector3(query.From));
+        btTransform to(rotation, ToBulletVector3(query.To));
+        return ConvexSweepSingle(world, shape, from, to, query.Mask, result);
+    }
+
+    /*!
+    collision algorithms used for overlap narrow phase allocate their manifolds from dispatcher, which is not thread safe.
+    So instead of world dispatcher each thread uses its own one, created once on first overlap query
+    */
+    struct OverlapQueryDispatcher
+    {
+        btDefaultCollisionConfiguration Configuration;
+        btCollisionDispatcher Dispatcher{ &Configuration };
+
+        static btCollisionDispatcher& GetThreadLocal()
+        {
+            thread_local OverlapQueryDispatcher instance;
+            return instance.Dispatcher;
+        }
+    };
+
+    /*!
+    collects deepest contact point between query shape (body 0) and other object (body 1)
+    */
+    struct OverlapManifoldResult : public btManifoldResult
+    {
+        PhysicsQueryHit Hit;
+        btScalar Depth = 0.0f;
+
+        OverlapManifoldResult(const btCollisionObjectWrapper* query, const btCollisionObjectWrapper* other)
+            : btManifoldResult(query, other) { }
+
+        virtual void addContactPoint(const btVector3& normalOnBInWorld, const btVector3& pointInWorld, btScalar depth) override
+        {
+            if (depth > 0.0f || (this->Hit.HasHit() && depth >= this->Depth)) return;
+
+            // algorithms may process pair in reversed order, same check is done by btManifoldResult
+            bool isSwapped = this->m_manifoldPtr != nullptr && this->m_manifoldPtr->getBody0() != this->m_body0Wrap->getCollisionObject();
+            auto other = this->m_body1Wrap->getCollisionObject();
+            if (isSwapped)
+                SetQueryHit(this->Hit, other, pointInWorld + normalOnBInWorld * depth, -normalOnBInWorld, 0.0f);
+            else
+                SetQueryHit(this->Hit, other, pointInWorld, normalOnBInWorld, 0.0f);
+            this->Depth = depth;
+        }
+    };
+
+    struct OverlapBroadphaseCallback : public btBroadphaseAabbCallback
+    {
+        const btDispatcherInfo& DispatchInfo;
+        btCollisionDispatcher& Dispatcher;
+        const btCollisionObjectWrapper& Query;
+        CollisionMask::Mask Mask;
+        PhysicsQueryHit* Hits;
+        size_t MaxHits;
+        size_t HitCount = 0;
+
+        OverlapBroadphaseCallback(const btDispatcherInfo& info, btCollisionDispatcher& dispatcher, const btCollisionObjectWrapper& query,
+            CollisionMask::Mask mask, PhysicsQueryHit* hits, size_t maxHits)
+            : DispatchInfo(info), Dispatcher(dispatcher), Query(query), Mask(mask), Hits(hits), MaxHits(maxHits) { }
+
+        virtual bool process(const btBroadphaseProxy* proxy) override
+        {
+            // return value is ignored by dbvt broadphase, so the rest of candidates are just skipped
+            if (this->HitCount == this->MaxHits) return false;
+            if ((proxy->m_collisionFilterGroup & this->Mask) == 0 || (proxy->m_collisionFilterMask & CollisionGroup::ALL) == 0) return true;
+
+            auto object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            btCollisionObjectWrapper other(nullptr, object->getCollisionShape(), object, object->getWorldTransform(), -1, -1);
+            auto algorithm = this->Dispatcher.findAlgorithm(&this->Query, &other, nullptr, BT_CLOSEST_POINT_ALGORITHMS);
+            if (algorithm == nullptr) return true;
+
+            OverlapManifoldResult result(&this->Query, &other);
+            algorithm->processCollision(&this->Query, &other, this->DispatchInfo, &result);
+            algorithm->~btCollisionAlgorithm();
+            this->Dispatcher.freeCollisionAlgorithm(algorithm);
+
+            if (result.Hit.HasHit()) this->Hits[this->HitCount++] = result.Hit;
+            return true;
+        }
+    };
+
+    static size_t ShapeOverlapSingle(btCollisionWorld& world, btCollisionShape& shape, const btTransform& transform, CollisionMask::Mask mask, PhysicsQueryHit* hits, size_t maxHits)
+    {
+        btCollisionObject queryObject;
+        queryObject.setCollisionShape(&shape);
+        queryObject.setWorldTransform(transform);
+        btCollisionObjectWrapper query(nullptr, &shape, &queryObject, transform, -1, -1);
+
+        btVector3 aabbMin, aabbMax;
+        shape.getAabb(transform, aabbMin, aabbMax);
+        OverlapBroadphaseCallback callback(world.getDispatchInfo(), OverlapQueryDispatcher::GetThreadLocal(), query, mask, hits, maxHits);
+        world.getBroadphase()->aabbTest(aabbMin, aabbMax, callback);
+
+        for (size_t i = callback.HitCount; i < maxHits; i++)
+            hits[i] = PhysicsQueryHit{ };
+        return callback.HitCount;
+    }
+
+    static size_t SphereOverlapSingle(btCollisionWorld& world, const SphereOverlapQuery& query, PhysicsQueryHit* hits, size_t maxHits)
+    {
+        btSphereShape shape(query.Radius);
+        btTransform transform(btQuaternion::getIdentity(), ToBulletVector3(query.Center));
+        return ShapeOverlapSingle(world, shape, transform, query.Mask, hits, maxHits);
+    }
+
+    static size_t BoxOverlapSingle(btCollisionWorld& world, const BoxOverlapQuery& query, PhysicsQueryHit* hits, size_t maxHits)
+    {
+        btBoxShape shape(ToBulletVector3(query.HalfExtents));
+        btTransform transform(ToBulletQuaternion(query.Rotation), ToBulletVector3(query.Center));
+        return ShapeOverlapSingle(world, shape, transform, query.Mask, hits, maxHits);
+    }
+
+    /*!
+    processes queries in parallel. World is only read by queries, so they can be run concurrently while simulation is not stepping
+    \param count number of queries
+    \param query callable object with (size_t index) signature which returns number of hits of query
+    \returns total number of hits
+    */
+    template<typename F>
+    static size_t RunQueryBatch(size_t count, F&& query)
+    {
+        std::atomic<size_t> hitCount{ 0 };
+        ThreadPool::ParallelFor(count, PhysicsQueryGranularity, [&query, &hitCount](size_t begin, size_t end)
+        {
+            size_t chunkHitCount = 0;
+            for (size_t i = begin; i < end; i++)
+                chunkHitCount += (size_t)query(i);
+            hitCount += chunkHitCount;
+        });
+        return hitCount.load();
+    }
+
+    static size_t RayCastBatchImpl(btCollisionWorld& world, ArrayView<RayCastQuery> queries, ArrayView<PhysicsQueryHit> results)
+    {
+        MX_ASSERT(results.size() == queries.size());
+        return RunQueryBatch(queries.size(), [&](size_t i) { return RayCastSingle(world, queries[i], results[i]); });
+    }
+
+    static size_t SphereSweepBatchImpl(btCollisionWorld& world, ArrayView<SphereSweepQuery> queries, ArrayView<PhysicsQueryHit> results)
+    {
+        MX_ASSERT(results.size() == queries.size());
+        return RunQueryBatch(queries.size(), [&](size_t i) { return SphereSweepSingle(world, queries[i], results[i]); });
+    }
+
+    static size_t BoxSweepBatchImpl(btCollisionWorld& world, ArrayView<BoxSweepQuery> queries, ArrayView<PhysicsQueryHit> results)
+    {
+        MX_ASSERT(results.size() == queries.size());
+        return RunQueryBatch(queries.size(), [&](size_t i) { return BoxSweepSingle(world, queries[i], results[i]); });
+    }
+
+    static size_t SphereOverlapBatchImpl(btCollisionWorld& world, ArrayView<SphereOverlapQuery> queries, ArrayView<PhysicsQueryHit> results, size_t maxHitsPerQuery)
+    {
+        MX_ASSERT(results.size() == queries.size() * maxHitsPerQuery);
+        return RunQueryBatch(queries.size(), [&](size_t i)
+        {
+            return SphereOverlapSingle(world, queries[i], results.data() + i * maxHitsPerQuery, maxHitsPerQuery);
+        });
+    }
+
+    static size_t BoxOverlapBatchImpl(btCollisionWorld& world, ArrayView<BoxOverlapQuery> queries, ArrayView<PhysicsQueryHit> results, size_t maxHitsPerQuery)
+    {
+        MX_ASSERT(results.size() == queries.size() * maxHitsPerQuery);
+        return RunQueryBatch(queries.size(), [&](size_t i)
+        {
+            return BoxOverlapSingle(world, queries[i], results.data() + i * maxHitsPerQuery, maxHitsPerQuery);
+        });
+    }
+
     void Physics::AddRigidBody(void* body) //-V813
     {
         WORLD->addRigidBody((btRigidBody*)body);
@@ -143,6 +429,139 @@ namespace MxEngine
         return callback.GetResult();
     }
 
+    size_t Physics::RayCastBatch(ArrayView<RayCastQuery> queries, ArrayView<PhysicsQueryHit> results)
+    {
+        MAKE_SCOPE_PROFILER("Physics::RayCastBatch()");
+        return RayCastBatchImpl(*WORLD, queries, results);
+    }
+
+    size_t Physics::SphereSweepBatch(ArrayView<SphereSweepQuery> queries, ArrayView<PhysicsQueryHit> results)
+    {
+        MAKE_SCOPE_PROFILER("Physics::SphereSweepBatch()");
+        return SphereSweepBatchImpl(*WORLD, queries, results);
+    }
+
+    size_t Physics::BoxSweepBatch(ArrayView<BoxSweepQuery> queries, ArrayView<PhysicsQueryHit> results)
+    {
+        MAKE_SCOPE_PROFILER("Physics::BoxSweepBatch()");
+        return BoxSweepBatchImpl(*WORLD, queries, results);
+    }
+
+    size_t Physics::SphereOverlapBatch(ArrayView<SphereOverlapQuery> queries, ArrayView<PhysicsQueryHit> results, size_t maxHitsPerQuery)
+    {
+        MAKE_SCOPE_PROFILER("Physics::SphereOverlapBatch()");
+        return SphereOverlapBatchImpl(*WORLD, queries, results, maxHitsPerQuery);
+    }
+
+    size_t Physics::BoxOverlapBatch(ArrayView<BoxOverlapQuery> queries, ArrayView<PhysicsQueryHit> results, size_t maxHitsPerQuery)
+    {
+        MAKE_SCOPE_PROFILER("Physics::BoxOverlapBatch()");
+        return BoxOverlapBatchImpl(*WORLD, queries, results, maxHitsPerQuery);
+    }
+
+    PhysicsQueryBenchmark Physics::RunQueryBenchmark(size_t bodyCount, size_t queryCount)
+    {
+        MAKE_SCOPE_PROFILER("Physics::RunQueryBenchmark()");
+        constexpr size_t maxOverlapHits = 4;
+        PhysicsQueryBenchmark result;
+        result.BodyCount = bodyCount;
+        result.QueryCount = queryCount;
+
+        btDefaultCollisionConfiguration configuration;
+        btCollisionDispatcher dispatcher(&configuration);
+        btDbvtBroadphase broadphase;
+        btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+
+        // static boxes are placed on a grid with random heights, so queries both hit and miss them
+        btBoxShape boxShape(btVector3(0.5f, 0.5f, 0.5f));
+        size_t rowSize = (size_t)std::ceil(std::sqrt((float)bodyCount));
+        float halfSize = float(rowSize);
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> height(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> coord(-halfSize, halfSize);
+        std::uniform_real_distribution<float> angle(0.0f, TwoPi<float>());
+
+        MxVector<btCollisionObject*> objects;
+        objects.reserve(bodyCount);
+        for (size_t i = 0; i < bodyCount; i++)
+        {
+            auto object = Alloc<btCollisionObject>();
+            object->setCollisionShape(&boxShape);
+            object->setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(
+                2.0f * float(i % rowSize) - halfSize, height(generator), 2.0f * float(i / rowSize) - halfSize)));
+            object->setUserPointer(reinterpret_cast<void*>(i));
+            world.addCollisionObject(object, CollisionGroup::ALL, CollisionGroup::ALL);
+            objects.push_back(object);
+        }
+
+        MxVector<RayCastQuery> rays(queryCount);
+        MxVector<SphereSweepQuery> sphereSweeps(queryCount);
+        MxVector<BoxSweepQuery> boxSweeps(queryCount);
+        MxVector<SphereOverlapQuery> sphereOverlaps(queryCount);
+        MxVector<BoxOverlapQuery> boxOverlaps(queryCount);
+        for (size_t i = 0; i < queryCount; i++)
+        {
+            Vector3 from = MakeVector3(coord(generator), 5.0f, coord(generator));
+            Vector3 to = MakeVector3(coord(generator), -5.0f, coord(generator));
+            Vector3 center = MakeVector3(coord(generator), height(generator), coord(generator));
+            Quaternion rotation = MakeQuaternion(angle(generator), Normalize(MakeVector3(1.0f, 1.0f, 1.0f)));
+
+            rays[i].From = from;
+            rays[i].To = to;
+            sphereSweeps[i].From = from;
+            sphereSweeps[i].To = to;
+            sphereSweeps[i].Radius = 0.3f;
+            boxSweeps[i].From = from;
+            boxSweeps[i].To = to;
+            boxSweeps[i].HalfExtents = MakeVector3(0.3f);
+            boxSweeps[i].Rotation = rotation;
+            sphereOverlaps[i].Center = center;
+            sphereOverlaps[i].Radius = 1.0f;
+            boxOverlaps[i].Center = center;
+            boxOverlaps[i].HalfExtents = MakeVector3(1.0f);
+            boxOverlaps[i].Rotation = rotation;
+        }
+        MxVector<PhysicsQueryHit> hits(queryCount * maxOverlapHits);
+        ArrayView<PhysicsQueryHit> singleHits(hits.data(), queryCount);
+
+        auto measure = [&result, queryCount](const char* name, auto&& runQueries)
+        {
+            PhysicsQueryTiming timing;
+            timing.Name = name;
+            timing.QueryCount = queryCount;
+
+            TimeStep start = Time::Current();
+            timing.HitCount = runQueries();
+            timing.TotalTime = Time::Current() - start;
+            timing.QueriesPerSecond = float(queryCount) / Max(timing.TotalTime, 0.000001f);
+
+            MXLOG_INFO("MxEngine::Physics", MxFormat("query benchmark {0} bodies, {1}: {2} queries, {3} hits, {4} ms, {5} queries/s",
+                result.BodyCount, name, queryCount, timing.HitCount, timing.TotalTime * 1000.0f, timing.QueriesPerSecond));
+            result.Timings.push_back(timing);
+        };
+
+        // one ray per call on calling thread, as Physics::RayCast does
+        measure("single ray casts", [&]()
+        {
+            size_t hitCount = 0;
+            for (size_t i = 0; i < queryCount; i++)
+                hitCount += (size_t)RayCastSingle(world, rays[i], hits[i]);
+            return hitCount;
+        });
+        measure("ray cast batch", [&]() { return RayCastBatchImpl(world, rays, singleHits); });
+        measure("sphere sweep batch", [&]() { return SphereSweepBatchImpl(world, sphereSweeps, singleHits); });
+        measure("box sweep batch", [&]() { return BoxSweepBatchImpl(world, boxSweeps, singleHits); });
+        measure("sphere overlap batch", [&]() { return SphereOverlapBatchImpl(world, sphereOverlaps, hits, maxOverlapHits); });
+        measure("box overlap batch", [&]() { return BoxOverlapBatchImpl(world, boxOverlaps, hits, maxOverlapHits); });
+
+        for (auto object : objects)
+        {
+            world.removeCollisionObject(object);
+            Free(object);
+        }
+        return result;
+    }
+
     Vector3 Physics::GetGravity()
     {
         return FromBulletVector3(WORLD->getGravity());
@@ -155,8 +574,9 @@ namespace MxEngine
 
     void Physics::PerformExtraSimulationStep(float timeDelta)
     {
-        MAKE_SCOPE_PROFILER("Physics::SimulationStep()");
+        SubmitRigidBodyUpdates();
         PhysicsModule::PerformSimulationStep(timeDelta);
+        FetchRigidBodyTransforms();
     }
 
     void Physics::SetSimulationStep(float timeDelta)
@@ -168,4 +588,29 @@ namespace MxEngine
     {
         return PhysicsModule::GetSimulationStep();
     }
+
+    void Physics::SetMultithreading(bool isEnabled, size_t threadCount)
+    {
+        PhysicsModule::SetMultithreading(isEnabled, threadCount);
+    }
+
+    void Physics::SetThreadedSimulation(bool isEnabled, float fixedStep)
+    {
+        PhysicsModule::SetThreadedSimulation(isEnabled, fixedStep);
+    }
+
+    bool Physics::IsThreadedSimulation()
+    {
+        return PhysicsModule::IsThreadedSimulation();
+    }
+
+    bool Physics::IsMultithreaded()
+    {
+        return PhysicsModule::IsMultithreaded();
+    }
+
+    size_t Physics::GetThreadCount()
+    {
+        return PhysicsModule::GetThreadCount();
+    }
 }
\ No newline at end of file
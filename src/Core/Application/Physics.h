@@ -30,9 +30,80 @@
 
 #include "Core/MxObject/MxObject.h"
 #include "Platform/PhysicsAPI.h"
+#include "Utilities/Array/ArrayView.h"
+#include "Utilities/Time/Time.h"
 
 namespace MxEngine
 {
+    struct RayCastQuery
+    {
+        Vector3 From{ 0.0f };
+        Vector3 To{ 0.0f };
+        CollisionMask::Mask Mask = CollisionMask::RAYCAST_ONLY;
+    };
+
+    struct SphereSweepQuery
+    {
+        Vector3 From{ 0.0f };
+        Vector3 To{ 0.0f };
+        float Radius = 0.5f;
+        CollisionMask::Mask Mask = CollisionMask::RAYCAST_ONLY;
+    };
+
+    struct BoxSweepQuery
+    {
+        Vector3 From{ 0.0f };
+        Vector3 To{ 0.0f };
+        Vector3 HalfExtents{ 0.5f };
+        Quaternion Rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+        CollisionMask::Mask Mask = CollisionMask::RAYCAST_ONLY;
+    };
+
+    struct SphereOverlapQuery
+    {
+        Vector3 Center{ 0.0f };
+        float Radius = 0.5f;
+        CollisionMask::Mask Mask = CollisionMask::RAYCAST_ONLY;
+    };
+
+    struct BoxOverlapQuery
+    {
+        Vector3 Center{ 0.0f };
+        Vector3 HalfExtents{ 0.5f };
+        Quaternion Rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+        CollisionMask::Mask Mask = CollisionMask::RAYCAST_ONLY;
+    };
+
+    /*!
+    result of one physics query. Object is native handle of hit object (see MxObject::GetByHandle), or InvalidHandle if nothing was hit.
+    For ray casts and sweeps fraction is hit position along [From, To] segment. For overlaps fraction is always zero, point lies on hit object and normal points from it to query shape
+    */
+    struct PhysicsQueryHit
+    {
+        MxObject::EngineHandle Object = MxObject::InvalidHandle;
+        Vector3 Point{ 0.0f };
+        Vector3 Normal{ 0.0f };
+        float Fraction = 1.0f;
+
+        bool HasHit() const { return this->Object != MxObject::InvalidHandle; }
+    };
+
+    struct PhysicsQueryTiming
+    {
+        const char* Name = "";
+        size_t QueryCount = 0;
+        size_t HitCount = 0;
+        TimeStep TotalTime = 0.0f;
+        float QueriesPerSecond = 0.0f;
+    };
+
+    struct PhysicsQueryBenchmark
+    {
+        size_t BodyCount = 0;
+        size_t QueryCount = 0;
+        MxVector<PhysicsQueryTiming> Timings;
+    };
+
     class Physics
     {
     public:
@@ -46,11 +117,68 @@ namespace MxEngine
         static MxObject::Handle RayCast(const Vector3& from, const Vector3& to);
         static MxObject::Handle RayCast(const Vector3& from, const Vector3& to, float& rayFraction);
         static MxObject::Handle RayCast(const Vector3& from, const Vector3& to, float& rayFraction, CollisionMask::Mask rayCastMask);
+
+        /*!
+        casts all rays in parallel using thread pool and writes closest hit of each ray to results. Must be called between simulation steps
+        \param queries rays with their collision masks
+        \param results output hits, must have the same size as queries
+        \returns number of rays which hit something
+        */
+        static size_t RayCastBatch(ArrayView<RayCastQuery> queries, ArrayView<PhysicsQueryHit> results);
+        /*!
+        sweeps spheres from start to end positions in parallel and writes closest hit of each sweep to results. Must be called between simulation steps
+        \param queries sweeps with their collision masks
+        \param results output hits, must have the same size as queries
+        \returns number of sweeps which hit something
+        */
+        static size_t SphereSweepBatch(ArrayView<SphereSweepQuery> queries, ArrayView<PhysicsQueryHit> results);
+        /*!
+        sweeps oriented boxes from start to end positions in parallel and writes closest hit of each sweep to results. Must be called between simulation steps
+        \param queries sweeps with their collision masks
+        \param results output hits, must have the same size as queries
+        \returns number of sweeps which hit something
+        */
+        static size_t BoxSweepBatch(ArrayView<BoxSweepQuery> queries, ArrayView<PhysicsQueryHit> results);
+        /*!
+        finds objects intersecting spheres in parallel. Each query owns range [i * maxHitsPerQuery, (i + 1) * maxHitsPerQuery) of results,
+        unused entries of the range are reset to empty hits. Must be called between simulation steps
+        \param queries spheres with their collision masks
+        \param results output hits, must have size of queries.size() * maxHitsPerQuery
+        \param maxHitsPerQuery maximal number of distinct objects reported for one query
+        \returns total number of hits written
+        */
+        static size_t SphereOverlapBatch(ArrayView<SphereOverlapQuery> queries, ArrayView<PhysicsQueryHit> results, size_t maxHitsPerQuery = 1);
+        /*!
+        finds objects intersecting oriented boxes in parallel. Results are laid out in the same way as in SphereOverlapBatch
+        \param queries boxes with their collision masks
+        \param results output hits, must have size of queries.size() * maxHitsPerQuery
+        \param maxHitsPerQuery maximal number of distinct objects reported for one query
+        \returns total number of hits written
+        */
+        static size_t BoxOverlapBatch(ArrayView<BoxOverlapQuery> queries, ArrayView<PhysicsQueryHit> results, size_t maxHitsPerQuery = 1);
+        /*!
+        runs single ray casts and all batched queries against headless world of static boxes and measures their throughput
+        \param bodyCount number of static boxes in benchmark world
+        \param queryCount number of queries of each type
+        \returns timings of each query type
+        */
+        static PhysicsQueryBenchmark RunQueryBenchmark(size_t bodyCount = 10000, size_t queryCount = 100000);
         static Vector3 GetGravity();
 
         static void SetGravity(const Vector3& gravity);
         static void PerformExtraSimulationStep(float timeDelta);
         static void SetSimulationStep(float timeDelta);
         static float GetSimulationStep();
+        static void SetMultithreading(bool isEnabled, size_t threadCount = 0);
+        /*!
+        enables simulation on dedicated physics thread with fixed timestep. Transforms of moving bodies are interpolated between two last steps.
+        In this mode physics objects must be modified only during frame update, not in render callbacks
+        \param isEnabled if physics should be simulated on dedicated thread
+        \param fixedStep time of one simulation step in seconds
+        */
+        static void SetThreadedSimulation(bool isEnabled, float fixedStep = 1.0f / 60.0f);
+        static bool IsThreadedSimulation();
+        static bool IsMultithreaded();
+        static size_t GetThreadCount();
     };
 }
\ No newline at end of file
@@ -123,6 +123,21 @@ namespace MxEngine
         return FWD(GetLightSamples);
     }
 
+    void Rendering::SetClusterCulling(bool value)
+    {
+        FWD(SetClusterCulling, value);
+    }
+
+    bool Rendering::IsClusterCullingEnabled()
+    {
+        return FWD(IsClusterCullingEnabled);
+    }
+
+    const ClusterCullingStatistics& Rendering::GetClusterStatistics()
+    {
+        return Rendering::GetController().GetClusterStatistics();
+    }
+
     #define DRW Application::GetImpl()->GetRenderAdaptor().DebugDrawer
 
     void Rendering::Draw(const Line& line, const Vector4& color)
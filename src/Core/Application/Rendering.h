@@ -57,6 +57,9 @@ namespace MxEngine
         static size_t GetShadowBlurIterations();
         static void SetLightSamples(size_t samples);
         static size_t GetLightSamples();
+        static void SetClusterCulling(bool value = true);
+        static bool IsClusterCullingEnabled();
+        static const ClusterCullingStatistics& GetClusterStatistics();
         static void Draw(const Line& line, const Vector4& color);
         static void Draw(const AABB& box, const Vector4& color);
         static void Draw(const BoundingBox& box, const Vector4& color);
@@ -33,16 +33,43 @@ namespace MxEngine
 {
     void AudioSource::OnUpdate(float timeDelta)
     {
-        auto position = MxObject::GetByComponent(*this).Transform.GetPosition();
+        if (this->stream.IsValid())
+        {
+            this->stream->Update(*this->player, this->isPlaying);
+            if (this->isPlaying && this->stream->IsFinished())
+                this->isPlaying = false;
+        }
+        else if (!this->isBufferAttached && this->buffer.IsValid() && this->buffer->IsReady())
+        {
+            // buffer was loaded asynchronously, so playback requested before its upload starts now
+            this->AttachBuffer();
+            if (this->isPlaying) this->player->Play();
+        }
+
+        // transform may be changed later in the frame in which it was synced, so that frame is checked again
+        auto& transform = MxObject::GetByComponent(*this).Transform;
+        if (transform.GetLastChangeFrame() < this->positionSyncFrame) return;
+
+        auto& position = transform.GetPosition();
         this->player->SetPosition(position.x, position.y, position.z);
+        this->positionSyncFrame = TransformComponent::GetCurrentFrame();
     }
 
     void AudioSource::Init()
     {
         this->player = AudioFactory::Create<AudioPlayer>();
         this->SetDirection(this->GetDirection());
-        if (this->buffer.IsValid())
-            this->player->AttachBuffer(*this->buffer);
+        this->AttachBuffer();
+    }
+
+    void AudioSource::AttachBuffer()
+    {
+        // OpenAL cannot upload samples to attached buffer, so pending buffer is attached only after it is ready
+        this->isBufferAttached = this->buffer.IsValid() && this->buffer->IsReady();
+        if (!this->isBufferAttached) return;
+
+        this->player->Stop();
+        this->player->AttachBuffer(*this->buffer);
     }
 
     AudioSource::AudioSource(const AudioBufferHandle& buffer)
@@ -50,18 +77,59 @@ namespace MxEngine
 
     void AudioSource::Load(const AudioBufferHandle& buffer)
     {
+        if (this->stream.IsValid())
+        {
+            // attaching stream again stops player and releases its queued buffers. Looping is handled by player for static buffer
+            this->stream->Attach(*this->player);
+            this->stream = { };
+            this->player->SetLooping(this->isLooping);
+        }
+
         this->buffer = buffer;
-        if(this->buffer.IsValid())
-            player->AttachBuffer(*buffer);
+        this->AttachBuffer();
     }
 
     AudioBufferHandle AudioSource::GetLoadedSource() const
     {
         return this->buffer;
     }
+
+    void AudioSource::LoadStream(const MxString& path)
+    {
+        this->buffer = { };
+        this->isBufferAttached = false;
+        if (!this->stream.IsValid())
+            this->stream = AudioFactory::Create<AudioStream>();
+
+        this->stream->SetLooping(this->isLooping);
+        this->stream->Attach(*this->player);
+        this->stream->Load(path);
+    }
+
+    AudioStreamHandle AudioSource::GetLoadedStream() const
+    {
+        return this->stream;
+    }
+
+    bool AudioSource::IsStreaming() const
+    {
+        return this->stream.IsValid();
+    }
+
+    void AudioSource::Seek(float seconds)
+    {
+        if (this->stream.IsValid())
+            this->stream->Seek(*this->player, seconds);
+        else
+            this->player->SetPlaybackPosition(seconds);
+    }
     
     void AudioSource::Play()
     {
+        // finished stream is replayed from the beginning, in the same way as stopped static buffer
+        if (this->stream.IsValid() && this->stream->IsFinished())
+            this->stream->Seek(*this->player, 0.0f);
+
         this->isPlaying = true;
     	this->player->Play();
     }
@@ -70,6 +138,8 @@ namespace MxEngine
     {
         this->isPlaying = false;
     	this->player->Stop();
+        if (this->stream.IsValid())
+            this->stream->Seek(*this->player, 0.0f);
     }
 
     void AudioSource::Pause()
@@ -80,7 +150,10 @@ namespace MxEngine
 
     void AudioSource::Reset()
     {
-        this->player->Reset();
+        if (this->stream.IsValid())
+            this->stream->Seek(*this->player, 0.0f);
+        else
+            this->player->Reset();
     }
 
     void AudioSource::Replay()
@@ -98,7 +171,10 @@ namespace MxEngine
     void AudioSource::SetLooping(bool value)
     {
         this->isLooping = value;
-        this->player->SetLooping(this->isLooping);
+        if (this->stream.IsValid())
+            this->stream->SetLooping(this->isLooping);
+        else
+            this->player->SetLooping(this->isLooping);
     }
 
     void AudioSource::SetRelative(bool value)
@@ -39,6 +39,8 @@ namespace MxEngine
 		MAKE_COMPONENT(AudioSource);
 
 		AudioBufferHandle buffer;
+		// declared before player, so player releases stream buffers before they are deleted
+		AudioStreamHandle stream;
 		AudioPlayerHandle player;
 		float currentVolume = 1.0f;
 		float currentSpeed = 1.0f;
@@ -52,6 +54,10 @@ namespace MxEngine
 		bool isLooping = false;
 		bool isPlaying = false;
 		bool isRelative = false;
+		size_t positionSyncFrame = 0;
+		bool isBufferAttached = false;
+
+		void AttachBuffer();
 	public:
 		void OnUpdate(float timeDelta);
 		void Init();
@@ -60,6 +66,19 @@ namespace MxEngine
 
 		void Load(const AudioBufferHandle& buffer);
 		AudioBufferHandle GetLoadedSource() const;
+		/*!
+		switches source to streaming mode. File is decoded in small blocks while playing instead of being loaded into memory.
+		Use it for long tracks such as music, as memory per stream is bounded to a few hundred KB
+		\param path path to wav, mp3, flac or ogg file
+		*/
+		void LoadStream(const MxString& path);
+		AudioStreamHandle GetLoadedStream() const;
+		bool IsStreaming() const;
+		/*!
+		moves playback to the specified position. Streaming source drops already decoded audio and continues after it is decoded again
+		\param seconds position in seconds from the beginning of audio
+		*/
+		void Seek(float seconds);
 
 		void Play();
 		void Stop();
@@ -38,6 +38,7 @@ namespace MxEngine
 
 		Vector3 color{ 1.0f };
 		MxObject::Handle parent;
+		size_t colorChangeFrame = TransformComponent::GetCurrentFrame();
 	public:
 		Instance(const MxObject::Handle& parent) : parent(parent) { }
 
@@ -46,11 +47,17 @@ namespace MxEngine
 		void SetColor(const Vector3& color)
 		{
 			this->color = Clamp(color, MakeVector3(0.0f), MakeVector3(1.0f));
+			this->colorChangeFrame = TransformComponent::GetCurrentFrame();
 		}
 
 		const Vector3& GetColor() const
 		{
 			return this->color;
 		}
+
+		size_t GetLastColorChangeFrame() const
+		{
+			return this->colorChangeFrame;
+		}
 	};
 }
\ No newline at end of file
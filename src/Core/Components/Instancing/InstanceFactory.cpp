@@ -57,7 +57,29 @@ namespace MxEngine
     void InstanceFactory::OnUpdate(float timeDelta)
     {
         this->RemoveDanglingHandles();
-        if (!this->IsStatic) this->SendInstancesToGPU();
+        if (!this->IsStatic && this->HasInstanceChanges()) this->SendInstancesToGPU();
+    }
+
+    bool InstanceFactory::HasInstanceChanges() const
+    {
+        MAKE_SCOPE_PROFILER("Instancing::CheckChanges");
+
+        // mesh source could be replaced, in which case instanced buffers must be re-created
+        auto& object = MxObject::GetByComponent(*this);
+        auto meshSource = object.GetComponent<MeshSource>();
+        if (meshSource.IsValid() && (uint16_t)meshSource->Mesh->GetBufferCount() < this->bufferIndex + 2)
+            return true;
+
+        // new instances are timestamped on creation, so only removal can be missed by checking frames
+        if (this->GetCount() != this->uploadedCount) return true;
+
+        for (const auto& instance : this->pool)
+        {
+            auto& value = *instance.GetUnchecked();
+            if (value.Transform.GetLastChangeFrame() >= this->uploadFrame) return true;
+            if (value.GetComponent<Instance>()->GetLastColorChangeFrame() >= this->uploadFrame) return true;
+        }
+        return false;
     }
 
     void InstanceFactory::SubmitInstances()
@@ -160,6 +182,8 @@ namespace MxEngine
                 this->BufferDataByIndex(mesh, (size_t)this->bufferIndex + 1, this->GetNormalData());
                 this->BufferDataByIndex(mesh, (size_t)this->bufferIndex + 2, this->GetColorData());
             }
+            this->uploadFrame = TransformComponent::GetCurrentFrame();
+            this->uploadedCount = this->GetCount();
         }
     }
 }
\ No newline at end of file
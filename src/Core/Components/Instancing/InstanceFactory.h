@@ -144,6 +144,8 @@ namespace MxEngine
 		NormalData normals;
 		ColorData colors;
 		BufferIndex bufferIndex = std::numeric_limits<BufferIndex>::max();
+		size_t uploadFrame = 0;
+		size_t uploadedCount = 0;
 
 		template<typename T>
 		BufferIndex AddInstancedBuffer(Mesh& mesh, const MxVector<T>& data)
@@ -165,6 +167,7 @@ namespace MxEngine
         void InitMesh();
 		void RemoveInstancedBuffer(Mesh& mesh, size_t index);
 		void RemoveDanglingHandles();
+        bool HasInstanceChanges() const;
         void SendInstancesToGPU();
 		void Destroy();
 
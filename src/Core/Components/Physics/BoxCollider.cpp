@@ -35,7 +35,7 @@ namespace MxEngine
 {
     void BoxCollider::CreateNewShape(const BoundingBox& box)
     {
-        this->SetColliderChangedFlag(true);
+        this->OnColliderChanged(MxObject::GetByComponent(*this));
         this->boxShape = PhysicsFactory::Create<BoxShape>(box);
     }
 
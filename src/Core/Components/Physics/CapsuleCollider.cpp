@@ -35,7 +35,7 @@ namespace MxEngine
 {
     void CapsuleCollider::CreateNewShape(const Capsule& capsule)
     {
-        this->SetColliderChangedFlag(true);
+        this->OnColliderChanged(MxObject::GetByComponent(*this));
         this->capsuleShape = PhysicsFactory::Create<CapsuleShape>(capsule);
     }
 
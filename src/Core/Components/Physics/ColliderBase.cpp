@@ -30,6 +30,7 @@
 #include "Core/MxObject/MxObject.h"
 #include "Core/Components/Instancing/Instance.h"
 #include "Core/Components/Rendering/MeshSource.h"
+#include "Core/Components/Physics/RigidBody.h"
 
 namespace MxEngine
 {
@@ -62,6 +63,25 @@ namespace MxEngine
         return false;
     }
 
+    void ColliderBase::OnColliderChanged(MxObject& self)
+    {
+        this->colliderChangedFlag = true;
+        auto rigidBody = self.GetComponent<RigidBody>();
+        if (rigidBody.IsValid())
+            rigidBody->QueueColliderUpdate();
+    }
+
+    void ColliderBase::OnRemove(MxObject& self)
+    {
+        // shape is destroyed together with collider, so rigid body must stop using it immediately
+        auto rigidBody = self.GetComponent<RigidBody>();
+        if (rigidBody.IsValid())
+        {
+            rigidBody->GetNativeHandle()->SetCollisionShape(nullptr);
+            rigidBody->QueueColliderUpdate();
+        }
+    }
+
     const AABB& ColliderBase::GetAABB(MxObject& self)
     {
         auto meshSource = GetCurrentlyUsedMesh(self); 
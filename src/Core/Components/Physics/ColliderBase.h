@@ -42,9 +42,11 @@ namespace MxEngine
         bool colliderChangedFlag = true;
     protected:
         bool ShouldUpdateCollider(MxObject& self);
+        void OnColliderChanged(MxObject& self);
         static const AABB& GetAABB(MxObject& self);
         static const BoundingSphere& GetBoundingSphere(MxObject& self);
     public:
+        void OnRemove(MxObject& self);
         void SetColliderChangedFlag(bool value);
         bool HasColliderChanged() const;
     };
@@ -33,7 +33,7 @@ namespace MxEngine
 {
     void CompoundCollider::CreateNewShape()
     {
-        this->SetColliderChangedFlag(true);
+        this->OnColliderChanged(MxObject::GetByComponent(*this));
         this->compoundShape = PhysicsFactory::Create<CompoundShape>();
     }
 
@@ -35,7 +35,7 @@ namespace MxEngine
 {
     void CylinderCollider::CreateNewShape(const Cylinder& cylinder)
     {
-        this->SetColliderChangedFlag(true);
+        this->OnColliderChanged(MxObject::GetByComponent(*this));
         this->cylinderShape = PhysicsFactory::Create<CylinderShape>(cylinder);
     }
 
@@ -39,29 +39,60 @@
 
 namespace MxEngine
 {
+    void OnObjectScaleChanged(TransformComponent& transform)
+    {
+        // scale of static and sleeping bodies is not applied by simulation, so it is submitted together with collider
+        auto rigidBody = MxObject::GetByComponent(transform).GetComponent<RigidBody>();
+        if (rigidBody.IsValid()) rigidBody->QueueColliderUpdate();
+    }
+
     void RigidBody::UpdateTransform()
     {
         auto& self = MxObject::GetByComponent(*this);
-        auto& selfScale = self.Transform.GetScale();
 
         if (this->IsKinematic())
         {
             // if body is kinematic, MxObject's Transform component controls its position
-            btTransform tr;
-            ToBulletTransform(tr, self.Transform);
-            this->rigidBody->GetNativeHandle()->getMotionState()->setWorldTransform(tr);
+            this->rigidBody->SetKinematicTransform(self.Transform);
         }
         else if (this->rigidBody->HasTransformUpdate())
         {
             // if body is not kinematic, transform is controlled by physics engine
             FromBulletTransform(self.Transform, this->rigidBody->GetNativeHandle()->getWorldTransform());
-            this->rigidBody->SetTransformUpdateFlag(false);
         }
+        this->rigidBody->SetTransformUpdateFlag(false);
 
-        if (selfScale != this->rigidBody->GetScale())
+        this->UpdateScale();
+    }
+
+    void RigidBody::SubmitTransform()
+    {
+        auto& self = MxObject::GetByComponent(*this);
+        this->rigidBody->SetWorldTransform(self.Transform);
+
+        // submitted transform is not reported as changed by user on next interpolation
+        this->interpolatedPosition = self.Transform.GetPosition();
+        this->interpolatedRotation = self.Transform.GetRotation();
+    }
+
+    void RigidBody::ApplyInterpolatedTransform(const Vector3& position, const Quaternion& rotation)
+    {
+        auto& transform = MxObject::GetByComponent(*this).Transform;
+        bool isChangedByUser = transform.GetPosition() != this->interpolatedPosition || transform.GetRotation() != this->interpolatedRotation;
+        if (this->hasInterpolatedTransform && isChangedByUser)
+            this->SubmitTransform();
+
+        // states published before body was teleported are stale until physics thread steps it from the new transform
+        if (!this->rigidBody->HasPendingTransform())
         {
-            this->rigidBody->SetScale(selfScale);
+            // bodies which came to rest keep their states until next fetch, but must not be reported as moved each frame
+            if (position != transform.GetPosition()) transform.SetPosition(position);
+            if (rotation != transform.GetRotation()) transform.SetRotation(rotation);
+            this->interpolatedPosition = position;
+            this->interpolatedRotation = rotation;
+            this->hasInterpolatedTransform = true;
         }
+        this->UpdateScale();
     }
 
     NativeRigidBodyHandle RigidBody::GetNativeHandle() const
@@ -69,27 +100,31 @@ namespace MxEngine
         return this->rigidBody;
     }
 
-    void RigidBody::OnUpdate(float dt)
-    {
-        this->UpdateCollider();
-        this->UpdateTransform();
-    }
-
     template<typename T>
-    bool TestCollider(NativeRigidBodyHandle& rigidBody, T collider)
+    bool TestCollider(NativeRigidBodyHandle& rigidBody, T collider, const Vector3& scale)
     {
         if (!collider.IsValid()) return false;
 
         collider->UpdateCollider();
         if (collider->HasColliderChanged())
         {
-            auto shape = collider->GetNativeHandle();
-            rigidBody->SetCollisionShape(shape->GetNativeHandle());
+            // scale is applied before shape is set, so inertia is computed for scaled shape
+            collider->GetNativeHandle()->SetScale(scale, [&rigidBody](btCollisionShape* shape) { rigidBody->SetCollisionShape(shape); });
             collider->SetColliderChangedFlag(false);
         }
         return true;
     }
 
+    template<typename T>
+    bool ApplyColliderScale(NativeRigidBodyHandle& rigidBody, T collider, const Vector3& scale)
+    {
+        if (!collider.IsValid() || collider->HasColliderChanged()) return false;
+
+        // shared shapes are replaced by scaled ones from cache, so native body must receive new shape before old one is released
+        collider->GetNativeHandle()->SetScale(scale, [&rigidBody](btCollisionShape* shape) { rigidBody->SetCollisionShape(shape); });
+        return true;
+    }
+
     template<typename T>
     void InvalidateCollider(MxObject& self)
     {
@@ -112,19 +147,56 @@ namespace MxEngine
         InvalidateCollider<CylinderCollider>(self);
         InvalidateCollider<CapsuleCollider>(self);
         InvalidateCollider<CompoundCollider>(self);
+        this->UpdateCollider();
     }
 
     void RigidBody::UpdateCollider()
     {
         auto& self = MxObject::GetByComponent(*this);
+        auto& scale = self.Transform.GetScale();
+
+        // flag is reset only after collider is applied, as testing collider may mark it as changed again
+        if (!TestCollider(this->rigidBody, self.GetComponent<BoxCollider>(), scale)      &&
+            !TestCollider(this->rigidBody, self.GetComponent<SphereCollider>(), scale)   &&
+            !TestCollider(this->rigidBody, self.GetComponent<CylinderCollider>(), scale) &&
+            !TestCollider(this->rigidBody, self.GetComponent<CapsuleCollider>(), scale)  &&
+            !TestCollider(this->rigidBody, self.GetComponent<CompoundCollider>(), scale))
+        {
+            this->rigidBody->SetCollisionShape(nullptr); // no collider
+        }
+        this->UpdateScale(); // colliders which were not changed still may need new scale
+        this->rigidBody->SetColliderUpdateFlag(false);
+    }
 
-        if(TestCollider(this->rigidBody, self.GetComponent<BoxCollider>()))      return;
-        if(TestCollider(this->rigidBody, self.GetComponent<SphereCollider>()))   return;
-        if(TestCollider(this->rigidBody, self.GetComponent<CylinderCollider>())) return;
-        if(TestCollider(this->rigidBody, self.GetComponent<CapsuleCollider>()))  return;
-        if(TestCollider(this->rigidBody, self.GetComponent<CompoundCollider>()))  return;
+    void RigidBody::UpdateScale()
+    {
+        auto& self = MxObject::GetByComponent(*this);
+        auto& scale = self.Transform.GetScale();
+        if (scale == this->rigidBody->GetScale()) return;
+
+        // if collider is not yet applied, scale will be set together with it in UpdateCollider()
+        if (!ApplyColliderScale(this->rigidBody, self.GetComponent<BoxCollider>(), scale)      &&
+            !ApplyColliderScale(this->rigidBody, self.GetComponent<SphereCollider>(), scale)   &&
+            !ApplyColliderScale(this->rigidBody, self.GetComponent<CylinderCollider>(), scale) &&
+            !ApplyColliderScale(this->rigidBody, self.GetComponent<CapsuleCollider>(), scale))
+        {
+            ApplyColliderScale(this->rigidBody, self.GetComponent<CompoundCollider>(), scale);
+        }
+    }
 
-        this->rigidBody->SetCollisionShape(nullptr); // no collider
+    void RigidBody::QueueColliderUpdate()
+    {
+        this->rigidBody->SetColliderUpdateFlag(true);
+    }
+
+    void RigidBody::UpdateCollisionCallbackMask()
+    {
+        // stored in native body, so pairs of objects without callbacks are skipped before reaching Application
+        uint32_t mask = CollisionCallbackMask::NONE;
+        if (this->onCollision)      mask |= CollisionCallbackMask::COLLISION;
+        if (this->onCollisionEnter) mask |= CollisionCallbackMask::COLLISION_ENTER;
+        if (this->onCollisionExit)  mask |= CollisionCallbackMask::COLLISION_EXIT;
+        this->rigidBody->SetCollisionCallbackMask(mask);
     }
 
     void RigidBody::InvokeOnCollisionEnterCallback(MxObject& self, MxObject& object)
@@ -214,6 +286,17 @@ namespace MxEngine
         return this->rigidBody->IsMoving();
     }
 
+    bool RigidBody::IsSleeping() const
+    {
+        return this->rigidBody->GetActivationState() == ActivationState::ISLAND_SLEEPING;
+    }
+
+    size_t RigidBody::GetFramesSinceMoved() const
+    {
+        auto& self = MxObject::GetByComponent(*this);
+        return TransformComponent::GetCurrentFrame() - self.Transform.GetLastChangeFrame();
+    }
+
     void RigidBody::SetCollisionFilter(uint32_t mask, uint32_t group)
     {
         this->rigidBody->SetCollisionFilter(group, mask);
@@ -441,7 +524,7 @@ namespace MxEngine
     void RigidBody::ApplyForce(const Vector3& force, const Vector3& relativePosition)
     {
         this->rigidBody->Activate();
-        this->rigidBody->GetNativeHandle()->applyForce(ToBulletVector3(force), ToBulletVector3(relativePosition));
+        this->rigidBody->ApplyForce(force, relativePosition);
     }
 
     void RigidBody::ApplyImpulse(const Vector3& impulse, const Vector3& relativePosition)
@@ -459,7 +542,7 @@ namespace MxEngine
     void RigidBody::ApplyTorque(const Vector3& force)
     {
         this->rigidBody->Activate();
-        this->rigidBody->GetNativeHandle()->applyTorque(ToBulletVector3(force));
+        this->rigidBody->ApplyTorque(force);
     }
 
     void RigidBody::ApplyTorqueImpulse(const Vector3& impulse)
@@ -477,7 +560,7 @@ namespace MxEngine
     void RigidBody::ApplyCentralForce(const Vector3& force)
     {
         this->rigidBody->Activate();
-        this->rigidBody->GetNativeHandle()->applyCentralForce(ToBulletVector3(force));
+        this->rigidBody->ApplyForce(force, MakeVector3(0.0f));
     }
 
     void RigidBody::SetPushVelocity(const Vector3& velocity)
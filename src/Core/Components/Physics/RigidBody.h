@@ -53,16 +53,47 @@ namespace MxEngine
         CollisionCallback onCollision;
         CollisionCallback onCollisionEnter;
         CollisionCallback onCollisionExit;
+        Vector3 interpolatedPosition{ 0.0f };
+        Quaternion interpolatedRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+        bool hasInterpolatedTransform = false;
 
-        void UpdateTransform();
+        void UpdateCollisionCallbackMask();
     public:
         MXENGINE_MAKE_MOVEONLY(RigidBody);
 
         NativeRigidBodyHandle GetNativeHandle() const;
 
         void Init();
-        void OnUpdate(float dt);
+        /*!
+        applies collider and scale of parent object to rigid body. Called before simulation step for bodies which colliders were changed
+        */
         void UpdateCollider();
+        /*!
+        marks collider as changed, so it will be applied to rigid body before next simulation step
+        */
+        void QueueColliderUpdate();
+        /*!
+        submits Transform of kinematic body to physics world or fetches transform of body moved by simulation.
+        Called automatically only for kinematic bodies and bodies moved during last simulation step
+        */
+        void UpdateTransform();
+        /*!
+        moves body to parent object Transform, bypassing simulation. Until body is stepped from the new transform,
+        states published by physics thread are not applied to it
+        */
+        void SubmitTransform();
+        /*!
+        applies transform interpolated between two last steps of threaded simulation to parent object.
+        If parent Transform was changed since last call, it is treated as teleport and submitted to physics world instead
+        \param position interpolated position of body
+        \param rotation interpolated rotation of body
+        */
+        void ApplyInterpolatedTransform(const Vector3& position, const Quaternion& rotation);
+        /*!
+        applies scale of parent object Transform to collision shape of rigid body. Collision shapes are shared between colliders,
+        so instead of rescaling shape in place, shape with new scale is acquired and set to rigid body (inertia is recomputed)
+        */
+        void UpdateScale();
         void InvokeOnCollisionCallback(MxObject& self, MxObject& object);
         void InvokeOnCollisionEnterCallback(MxObject& self, MxObject& object);
         void InvokeOnCollisionExitCallback(MxObject& self, MxObject& object);
@@ -78,6 +109,16 @@ namespace MxEngine
         bool IsRayCastable() const;
         void ToggleRayCasting(bool value);
         bool IsMoving() const;
+        /*!
+        checks if body was put to sleep by physics engine. Sleeping bodies are not simulated until activated by collision or by user
+        \returns true if activation state of body is ISLAND_SLEEPING
+        */
+        bool IsSleeping() const;
+        /*!
+        gets number of frames since parent object Transform was last changed, either by simulation or by user
+        \returns 0 if object moved this frame, number of frames passed since last movement otherwise
+        */
+        size_t GetFramesSinceMoved() const;
 
         template<typename F>
         void SetOnCollisionCallback(F&& func)
@@ -85,6 +126,7 @@ namespace MxEngine
             static_assert(std::is_convertible_v<F, CollisionCallback>,
                 "callback must be in form `void callback(MxObject& self, MxObject& object)`");
             this->onCollision = std::forward<F>(func);
+            this->UpdateCollisionCallbackMask();
         }
 
         template<typename F>
@@ -93,6 +135,7 @@ namespace MxEngine
             static_assert(std::is_convertible_v<F, CollisionCallback>,
                 "callback must be in form `void callback(MxObject& self, MxObject& object)`");
             this->onCollisionEnter = std::forward<F>(func);
+            this->UpdateCollisionCallbackMask();
         }
 
         template<typename F>
@@ -101,6 +144,7 @@ namespace MxEngine
             static_assert(std::is_convertible_v<F, CollisionCallback>,
                 "callback must be in form `void callback(MxObject& self, MxObject& object)`");
             this->onCollisionExit = std::forward<F>(func);
+            this->UpdateCollisionCallbackMask();
         }
 
         void SetCollisionFilter(uint32_t mask, uint32_t group = CollisionGroup::ALL);
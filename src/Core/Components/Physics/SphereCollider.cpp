@@ -35,7 +35,7 @@ namespace MxEngine
 {
     void SphereCollider::CreateNewShape(const BoundingSphere& sphere)
     {
-        this->SetColliderChangedFlag(true);
+        this->OnColliderChanged(MxObject::GetByComponent(*this));
         this->sphereShape = PhysicsFactory::Create<SphereShape>(sphere.Radius);
     }
 
@@ -31,40 +31,198 @@
 #include "Core/MxObject/MxObject.h"
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/Format/Format.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+
+#include <atomic>
 
 namespace MxEngine
 {
-    void MeshLOD::Generate(const LODConfig& config)
+    /*!
+    shared state of asynchronous LOD generation. Holds only CPU-side data, as it is accessed from worker threads
+    engine resources (component handle, meshes) are recreated from plain ids on main thread when generation is finished
+    */
+    struct LODGenerationState
+    {
+        struct SourceData
+        {
+            MxVector<Vertex> Vertecies;
+            MxVector<uint32_t> Indicies;
+            AABB BoundingBox;
+        };
+
+        UUID ComponentUUID;
+        size_t ComponentHandle;
+        LODConfig Config;
+        MxVector<SourceData> Sources;
+        MxVector<MxVector<LODGenerator::LODData>> Results; // [factor][submesh]
+        std::atomic<size_t> RemainingTasks{ 0 };
+        std::atomic<bool> IsCancelled{ false };
+        std::promise<void> Completion;
+
+        void GenerateSubmeshLOD(size_t factorIndex, size_t submeshIndex)
+        {
+            if (!this->IsCancelled)
+            {
+                const auto& source = this->Sources[submeshIndex];
+                LODGenerator lod(source.Vertecies, source.Indicies, source.BoundingBox);
+                this->Results[factorIndex][submeshIndex] = lod.CreateObjectData(this->Config.Factors[factorIndex]);
+            }
+        }
+
+        void UploadResults(const Ref<LODGenerationState>& self)
+        {
+            MAKE_SCOPE_PROFILER("MeshLOD::UploadResults()");
+            MeshLOD::Handle meshLOD(this->ComponentUUID, this->ComponentHandle);
+            if (!meshLOD.IsValid() || meshLOD->generationState != self)
+            {
+                // component was destroyed or LODs were regenerated, so results are outdated
+                this->Completion.set_value();
+                return;
+            }
+
+            auto& object = MxObject::GetByComponent(*meshLOD);
+            auto meshSource = object.GetComponent<MeshSource>();
+            if (!meshSource.IsValid() || !meshSource->Mesh.IsValid() || meshSource->Mesh->Submeshes.size() != this->Sources.size())
+            {
+                MXLOG_WARNING("MxEngine::MeshLOD", "LODs are discarded as object mesh was changed during generation: " + object.Name);
+                meshLOD->status = LODStatus::NOT_GENERATED;
+                meshLOD->generationState.reset();
+                this->Completion.set_value();
+                return;
+            }
+
+            auto& submeshes = meshSource->Mesh->Submeshes;
+            meshLOD->LODs.clear();
+            meshLOD->LODs.reserve(this->Results.size());
+            for (auto& factorResults : this->Results)
+            {
+                auto meshLODhandle = meshLOD->LODs.emplace_back(ResourceFactory::Create<Mesh>());
+                auto& meshLODsubmeshes = meshLODhandle->Submeshes;
+                meshLODsubmeshes.reserve(submeshes.size());
+
+                size_t totalIndicies = 0;
+                float acmrBefore = 0.0f, acmrAfter = 0.0f;
+                for (size_t i = 0; i < submeshes.size(); i++)
+                {
+                    acmrBefore += factorResults[i].Optimization.Before.ACMR;
+                    acmrAfter += factorResults[i].Optimization.After.ACMR;
+                    auto& submeshLOD = meshLODsubmeshes.emplace_back(submeshes[i].GetMaterialId(), submeshes[i].GetTransform());
+                    submeshLOD.Name = submeshes[i].Name;
+                    // format is set while LOD has no vertecies yet, so they are buffered only once
+                    submeshLOD.Data.SetVertexFormat(submeshes[i].Data.GetVertexFormat());
+                    submeshLOD.Data.GetVertecies() = std::move(factorResults[i].Vertecies);
+                    submeshLOD.Data.GetIndicies() = std::move(factorResults[i].Indicies);
+                    submeshLOD.Data.BufferVertecies();
+                    submeshLOD.Data.BufferIndicies();
+                    totalIndicies += submeshLOD.Data.GetIndicies().size();
+                }
+                MXLOG_DEBUG("MxEngine::MeshLOD", MxFormat("generated LOD with {0} indicies for object: {1}", totalIndicies, object.Name.c_str()));
+                if (!submeshes.empty())
+                {
+                    MXLOG_DEBUG("MxEngine::MeshLOD", MxFormat("LOD average ACMR optimized from {0} to {1}",
+                        acmrBefore / submeshes.size(), acmrAfter / submeshes.size()));
+                }
+            }
+
+            meshLOD->status = LODStatus::READY;
+            meshLOD->generationState.reset();
+            this->Completion.set_value();
+        }
+    };
+
+    const char* EnumToString(LODStatus status)
+    {
+        switch (status)
+        {
+        case LODStatus::NOT_GENERATED:
+            return "NOT_GENERATED";
+        case LODStatus::PENDING:
+            return "PENDING";
+        case LODStatus::READY:
+            return "READY";
+        default:
+            return "NOT_GENERATED";
+        }
+    }
+
+    std::shared_future<void> MeshLOD::Generate(const LODConfig& config)
     {
         auto& object = MxObject::GetByComponent(*this);
         auto meshSource = object.GetComponent<MeshSource>();
         if (!meshSource.IsValid() || !meshSource->Mesh.IsValid())
         {
             MXLOG_WARNING("MxEngine::MeshLOD", "LODs are not generated as object has no mesh: " + object.Name);
-            return;
+            return this->generationFuture;
         }
 
+        // cancel previous generation if it is still running
+        if (this->generationState != nullptr)
+            this->generationState->IsCancelled = true;
+
         auto mesh = meshSource.GetUnchecked()->Mesh;
+        auto handle = MxObject::GetComponentHandle(*this);
+
+        auto state = MakeRef<LODGenerationState>();
+        state->ComponentUUID = handle.GetUUID();
+        state->ComponentHandle = handle.GetHandle();
+        state->Config = config;
+
+        // copy source data, so main thread can freely modify or destroy mesh while LODs are generated
+        state->Sources.reserve(mesh->Submeshes.size());
+        for (const auto& submesh : mesh->Submeshes)
+        {
+            auto& source = state->Sources.emplace_back();
+            source.Vertecies = submesh.Data.GetVertecies();
+            source.Indicies = submesh.Data.GetIndicies();
+            source.BoundingBox = submesh.Data.GetBoundingBox();
+        }
+
+        state->Results.resize(config.Factors.size());
+        for (auto& factorResults : state->Results)
+            factorResults.resize(state->Sources.size());
+
         this->LODs.clear();
-        this->LODs.reserve(config.Factors.size());
+        this->status = LODStatus::PENDING;
+        this->generationState = state;
+        this->generationFuture = state->Completion.get_future().share();
 
-        for (auto factor : config.Factors)
+        size_t taskCount = config.Factors.size() * state->Sources.size();
+        state->RemainingTasks = taskCount;
+        if (taskCount == 0)
         {
-            auto meshLODhandle = this->LODs.emplace_back(ResourceFactory::Create<Mesh>());
-            auto& meshLODsubmeshes = meshLODhandle->Submeshes;
-            meshLODsubmeshes.reserve(mesh->Submeshes.size());
+            ThreadPool::SubmitToMainThread([state]() { state->UploadResults(state); });
+            return this->generationFuture;
+        }
 
-            size_t totalIndicies = 0;
-            for (const auto& submesh : mesh->Submeshes)
+        for (size_t factor = 0; factor < config.Factors.size(); factor++)
+        {
+            for (size_t submesh = 0; submesh < state->Sources.size(); submesh++)
             {
-                LODGenerator lod(submesh.Data);
-                auto& submeshLOD = meshLODsubmeshes.emplace_back(submesh.GetMaterialId(), submesh.GetTransform());
-                submeshLOD.Name = submesh.Name;
-                submeshLOD.Data = lod.CreateObject(factor);
-                totalIndicies += submeshLOD.Data.GetIndicies().size();
+                ThreadPool::Submit([state, factor, submesh]()
+                {
+                    state->GenerateSubmeshLOD(factor, submesh);
+                    if (--state->RemainingTasks == 0) // last task marshals GPU upload back to main thread
+                        ThreadPool::SubmitToMainThread([state]() { state->UploadResults(state); });
+                });
             }
-            MXLOG_DEBUG("MxEngine::MeshLOD", MxFormat("generated LOD with {0} indicies for object: {1}", totalIndicies, object.Name.c_str()));
         }
+        return this->generationFuture;
+    }
+
+    std::shared_future<void> MeshLOD::GetFuture() const
+    {
+        return this->generationFuture;
+    }
+
+    LODStatus MeshLOD::GetStatus() const
+    {
+        return this->status;
+    }
+
+    bool MeshLOD::IsReady() const
+    {
+        return this->status == LODStatus::READY;
     }
 
     void MeshLOD::FixBestLOD(const Vector3& viewportPosition, float viewportZoom)
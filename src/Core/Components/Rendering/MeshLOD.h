@@ -32,6 +32,8 @@
 #include "Core/Resources/AssetManager.h"
 #include "MeshSource.h"
 
+#include <future>
+
 namespace MxEngine
 {
     struct LODConfig
@@ -39,9 +41,26 @@ namespace MxEngine
         std::array<float, 5> Factors{ 0.001f, 0.01f, 0.05f, 0.15f, 0.3f };
     };
 
+    enum class LODStatus : uint8_t
+    {
+        NOT_GENERATED,
+        PENDING,
+        READY,
+    };
+
+    const char* EnumToString(LODStatus status);
+
+    struct LODGenerationState;
+
     class MeshLOD
     {
         MAKE_COMPONENT(MeshLOD);
+
+        Ref<LODGenerationState> generationState;
+        std::shared_future<void> generationFuture;
+        LODStatus status = LODStatus::NOT_GENERATED;
+
+        friend struct LODGenerationState;
     public:
         using LODInstance = MeshHandle;
         using LODIndex = uint8_t;
@@ -50,7 +69,15 @@ namespace MxEngine
         LODIndex CurrentLOD = 0;
 
         MxVector<LODInstance> LODs;
-        void Generate(const LODConfig& config = LODConfig{ });
+        /*!
+        starts LOD generation on worker threads. Until results are uploaded to GPU, base mesh (LOD0) is used for rendering
+        \param config LOD factors which are used to generate each LOD level
+        \returns future which becomes ready when LODs are uploaded. Do not wait for it on main thread, as uploads are done there
+        */
+        std::shared_future<void> Generate(const LODConfig& config = LODConfig{ });
+        std::shared_future<void> GetFuture() const;
+        LODStatus GetStatus() const;
+        bool IsReady() const;
         void FixBestLOD(const Vector3& viewportPosition, float viewportZoom = 1.0f);
         LODInstance GetMeshLOD() const;
     };
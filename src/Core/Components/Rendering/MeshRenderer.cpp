@@ -29,17 +29,23 @@
 #include "MeshRenderer.h"
 #include "Utilities/ObjectLoader/ObjectLoader.h"
 #include "Core/Resources/AssetManager.h"
+#include "Core/Application/Application.h"
+#include "Library/Primitives/Colors.h"
 
 namespace MxEngine
 {
-	void MakeTexture(TextureHandle& currentTexture, MxHashMap<StringId, TextureHandle>& textures, const MxString& path, TextureFormat format)
+	void MakeTexture(TextureHandle& currentTexture, MxHashMap<StringId, TextureHandle>& textures, const MxString& path, TextureFormat format, TextureUsage usage, Colors::Palette placeholder)
 	{
 		if (!path.empty()) 
 		{
 			auto id = MakeStringId(path);
 			if (textures.find(id) == textures.end())
 			{
-				textures[id] = GraphicFactory::Create<Texture>(path, format);
+				// textures are shared between all materials which are loaded through asset manager
+				if (Application::GetImpl()->GetConfig().StreamMaterialTextures)
+					textures[id] = AssetManager::LoadTextureAsync(path, format, Colors::Create(placeholder), usage);
+				else
+					textures[id] = AssetManager::LoadTexture(path, format, usage);
 			}
 			currentTexture = textures[id];
 		}
@@ -50,13 +56,13 @@ namespace MxEngine
 		auto materialResource = ResourceFactory::Create<Material>();
 		auto& material = *materialResource;
 
-		MakeTexture(material.AlbedoMap, textures, mat.AlbedoMap, TextureFormat::RGBA);
-		MakeTexture(material.EmmisiveMap, textures, mat.EmmisiveMap, TextureFormat::R);
-		MakeTexture(material.HeightMap, textures, mat.HeightMap, TextureFormat::RGB);
-		MakeTexture(material.NormalMap, textures, mat.NormalMap, TextureFormat::RGB);
-		MakeTexture(material.MetallicMap, textures, mat.MetallicMap, TextureFormat::R);
-		MakeTexture(material.RoughnessMap, textures, mat.RoughnessMap, TextureFormat::R);
-		MakeTexture(material.AmbientOcclusionMap, textures, mat.AmbientOcclusionMap, TextureFormat::R);
+		MakeTexture(material.AlbedoMap, textures, mat.AlbedoMap, TextureFormat::RGBA, TextureUsage::COLOR, Colors::WHITE);
+		MakeTexture(material.EmmisiveMap, textures, mat.EmmisiveMap, TextureFormat::R, TextureUsage::COLOR, Colors::BLACK);
+		MakeTexture(material.HeightMap, textures, mat.HeightMap, TextureFormat::RGB, TextureUsage::DATA, Colors::BLACK);
+		MakeTexture(material.NormalMap, textures, mat.NormalMap, TextureFormat::RGB, TextureUsage::NORMAL, Colors::FLAT_NORMAL);
+		MakeTexture(material.MetallicMap, textures, mat.MetallicMap, TextureFormat::R, TextureUsage::DATA, Colors::BLACK);
+		MakeTexture(material.RoughnessMap, textures, mat.RoughnessMap, TextureFormat::R, TextureUsage::DATA, Colors::WHITE);
+		MakeTexture(material.AmbientOcclusionMap, textures, mat.AmbientOcclusionMap, TextureFormat::R, TextureUsage::DATA, Colors::WHITE);
 
 		material.Emmision = mat.Emmision;
 		material.Transparency = mat.Transparency;
@@ -70,25 +76,33 @@ namespace MxEngine
 	}
 
 	MeshRenderer::MaterialArray MeshRenderer::LoadMaterials(const MxString& path)
+	{
+		auto materialLibrary = ObjectLoader::LoadMaterials(MeshRenderer::GetMaterialLibraryPath(path));
+		return MeshRenderer::CreateMaterials(materialLibrary);
+	}
+
+	MeshRenderer::MaterialArray MeshRenderer::CreateMaterials(const MaterialLibrary& library)
 	{
 		MaterialArray materials;
 		MxHashMap<StringId, TextureHandle> textures;
-		auto matlibExtenstion = MeshRenderer::GetMaterialFileSuffix();
-		MxString actualPath = path;
-		if (ToFilePath(path).extension() != ToFilePath(matlibExtenstion))
-			actualPath = path + matlibExtenstion;
-
-		auto materialLibrary = ObjectLoader::LoadMaterials(actualPath);
 
-		materials.resize(materialLibrary.size());
-		for (size_t i = 0; i < materialLibrary.size(); i++)
+		materials.resize(library.size());
+		for (size_t i = 0; i < library.size(); i++)
 		{
-			materials[i] = ConvertMaterial(materialLibrary[i], textures);
+			materials[i] = ConvertMaterial(library[i], textures);
 		}
 
 		return materials;
 	}
 
+	MxString MeshRenderer::GetMaterialLibraryPath(const MxString& path)
+	{
+		auto matlibExtenstion = MeshRenderer::GetMaterialFileSuffix();
+		if (ToFilePath(path).extension() != ToFilePath(matlibExtenstion))
+			return path + matlibExtenstion;
+		return path;
+	}
+
 	MxString MeshRenderer::GetMaterialFileSuffix()
 	{
 		return ".mx_matlib";
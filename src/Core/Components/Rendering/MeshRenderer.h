@@ -49,6 +49,8 @@ namespace MxEngine
         MaterialRef GetMaterial() const { MX_ASSERT(!Materials.empty()); return this->Materials[0]; }
 
         static MaterialArray LoadMaterials(const MxString& objectFilepath);
+        static MaterialArray CreateMaterials(const MaterialLibrary& library);
+        static MxString GetMaterialLibraryPath(const MxString& objectFilepath);
         static MxString GetMaterialFileSuffix();
     };
 }
\ No newline at end of file
@@ -27,6 +27,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Transform.h"
+#include "Core/Application/Application.h"
 
 namespace MxEngine
 {
@@ -34,8 +35,19 @@ namespace MxEngine
     static Vector3 RightVec   = MakeVector3(-1.0f, 0.0f, 0.0f);
     static Vector3 UpVec      = MakeVector3( 0.0f, 1.0f, 0.0f);
 
+    // defined in Core/Components/Physics/RigidBody.cpp
+    void OnObjectScaleChanged(TransformComponent& transform);
+
+    void TransformComponent::OnScaleChanged()
+    {
+        // only transform of MxObject has its handle as user data, standalone transforms are not tracked
+        if (this->UserData != (void*)std::numeric_limits<uintptr_t>::max())
+            OnObjectScaleChanged(*this);
+    }
+
     void TransformComponent::Copy(const TransformComponent& other) noexcept
     {
+        bool isScaleChanged = this->scale != other.GetScale();
         this->translation = other.GetTranslation();
         this->scale = other.GetScale();
         this->rotation = other.GetRotation();
@@ -44,6 +56,8 @@ namespace MxEngine
         other.GetNormalMatrix(this->transform, this->normalMatrix);
         this->needTransformUpdate = false;
         this->needRotationUpdate = false;
+        this->lastChangeFrame = GetCurrentFrame();
+        if (isScaleChanged) this->OnScaleChanged();
     }
 
     TransformComponent::TransformComponent(const TransformComponent& other)
@@ -156,10 +170,28 @@ namespace MxEngine
         return this->translation;
     }
 
+    bool TransformComponent::IsMovedThisFrame() const
+    {
+        return this->lastChangeFrame == GetCurrentFrame();
+    }
+
+    size_t TransformComponent::GetLastChangeFrame() const
+    {
+        return this->lastChangeFrame;
+    }
+
+    size_t TransformComponent::GetCurrentFrame()
+    {
+        // frame counter is stored in application, as static members are not shared between runtime-compiled modules
+        auto application = Application::GetImpl();
+        return application != nullptr ? application->GetCurrentFrame() : 0;
+    }
+
     TransformComponent& TransformComponent::SetTranslation(const Vector3& dist)
     {
         this->translation = dist;
         this->needTransformUpdate = true;
+        this->lastChangeFrame = GetCurrentFrame();
         return *this;
     }
 
@@ -173,6 +205,7 @@ namespace MxEngine
         this->rotation = q;
         this->needRotationUpdate = true;
         this->needTransformUpdate = true;
+        this->lastChangeFrame = GetCurrentFrame();
         return *this;
     }
 
@@ -180,6 +213,8 @@ namespace MxEngine
     {
         this->scale = scale;
         this->needTransformUpdate = true;
+        this->lastChangeFrame = GetCurrentFrame();
+        this->OnScaleChanged();
         return *this;
     }
 
@@ -202,6 +237,8 @@ namespace MxEngine
     {
         this->scale *= scale;
         this->needTransformUpdate = true;
+        this->lastChangeFrame = GetCurrentFrame();
+        this->OnScaleChanged();
         return *this;
     }
 
@@ -230,6 +267,7 @@ namespace MxEngine
         this->rotation *= q;
         this->needRotationUpdate = true;
         this->needTransformUpdate = true;
+        this->lastChangeFrame = GetCurrentFrame();
         return *this;
     }
 
@@ -252,6 +290,7 @@ namespace MxEngine
     {
         this->translation += dist;
         this->needTransformUpdate = true;
+        this->lastChangeFrame = GetCurrentFrame();
         return *this;
     }
 
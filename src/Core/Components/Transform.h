@@ -45,8 +45,10 @@ namespace MxEngine
 		mutable bool needTransformUpdate = true;
 		mutable bool needRotationUpdate = true;
 		mutable Matrix3x3 normalMatrix{ 0.0f };
+		size_t lastChangeFrame = GetCurrentFrame();
 
 		void Copy(const TransformComponent& other) noexcept;
+		void OnScaleChanged();
 	public:
 		TransformComponent() = default;
 		~TransformComponent() = default;
@@ -69,6 +71,23 @@ namespace MxEngine
 		const Vector3& GetScale() const;
 		const Vector3& GetEulerRotation() const;
 		const Vector3& GetPosition() const;
+		/*!
+		checks if translation, rotation or scale was changed during current frame. Systems can use it to skip objects which did not move
+		\returns true if transform was changed during current frame
+		*/
+		bool IsMovedThisFrame() const;
+		/*!
+		gets index of frame in which transform was last changed. Systems which run in the middle of frame should compare it with
+		frame of their last update, as transform still may be changed after them
+		\returns frame index of last translation, rotation or scale change
+		*/
+		size_t GetLastChangeFrame() const;
+
+		/*!
+		gets index of current frame, used to timestamp transform changes (see Application::GetCurrentFrame())
+		\returns number of frames started since application launch
+		*/
+		static size_t GetCurrentFrame();
 
 		TransformComponent& SetTranslation(const Vector3& dist);
 		TransformComponent& SetRotation(float angle, const Vector3& axis);
@@ -102,6 +102,11 @@ namespace MxEngine
 
     void Deserialize(Config& config, const JsonFile& json)
     {
+        // threading section may be missing in configs generated by older engine versions
+        auto threading = json.value("threading", JsonFile::object());
+        auto physics = json.value("physics", JsonFile::object());
+        auto audio = json.value("audio", JsonFile::object());
+
         FromJson(config.WindowPosition,         json["window"],      "position"                );
         FromJson(config.WindowSize,             json["window"],      "size"                    );
         FromJson(config.WindowTitle,            json["window"],      "title"                   );
@@ -115,8 +120,23 @@ namespace MxEngine
         FromJson(config.PointLightTextureSize,  json["renderer"],    "point-light-texture-size");
         FromJson(config.SpotLightTextureSize,   json["renderer"],    "spot-light-texture-size" );
         FromJson(config.EngineTextureSize,      json["renderer"],    "engine-texture-size"     );
+        FromJson(config.OptimizeImportedMeshes, json["renderer"],    "optimize-imported-meshes");
+        FromJson(config.BuildMeshClusters,      json["renderer"],    "build-mesh-clusters"     );
+        FromJson(config.StreamMaterialTextures, json["renderer"],    "stream-material-textures");
+        FromJson(config.CompressTextures,       json["renderer"],    "compress-textures"       );
+        FromJson(config.TextureUploadBudget,    json["renderer"],    "texture-upload-budget-mb");
         FromJson(config.ProjectRootDirectory,   json["filesystem"],  "root"                    );
         FromJson(config.ShaderSourceDirectory,  json["filesystem"],  "shader-source-directory" );
+        FromJson(config.UseMeshCache,           json["filesystem"],  "use-mesh-cache"          );
+        FromJson(config.UseAudioCache,          json["filesystem"],  "use-audio-cache"         );
+        FromJson(config.ExportEmbeddedTextures, json["filesystem"],  "export-embedded-textures");
+        FromJson(config.AudioSampleRate,        audio,               "sample-rate"             );
+        FromJson(config.WorkerThreadCount,      threading,           "worker-count"            );
+        FromJson(config.MainThreadTaskBudget,   threading,           "main-thread-budget-ms"   );
+        FromJson(config.MultithreadedPhysics,   physics,             "multithreaded"           );
+        FromJson(config.PhysicsThreadCount,     physics,             "thread-count"            );
+        FromJson(config.PhysicsOnDedicatedThread, physics,           "dedicated-thread"        );
+        FromJson(config.PhysicsTickRate,        physics,             "tick-rate"               );
         FromJson(config.ApplicationCloseKey,    json["debug-build"], "app-close-key"           );
         FromJson(config.Style,                  json["debug-build"], "editor-style"            );
         FromJson(config.EditorOpenKey,          json["debug-build"], "editor-key"              );
@@ -140,8 +160,23 @@ namespace MxEngine
         json["renderer"   ]["point-light-texture-size"] = config.PointLightTextureSize;
         json["renderer"   ]["spot-light-texture-size" ] = config.SpotLightTextureSize;
         json["renderer"   ]["engine-texture-size"     ] = config.EngineTextureSize;
+        json["renderer"   ]["optimize-imported-meshes"] = config.OptimizeImportedMeshes;
+        json["renderer"   ]["build-mesh-clusters"     ] = config.BuildMeshClusters;
+        json["renderer"   ]["stream-material-textures"] = config.StreamMaterialTextures;
+        json["renderer"   ]["compress-textures"       ] = config.CompressTextures;
+        json["renderer"   ]["texture-upload-budget-mb"] = config.TextureUploadBudget;
         json["filesystem" ]["root"                    ] = config.ProjectRootDirectory;
         json["filesystem" ]["shader-source-directory" ] = config.ShaderSourceDirectory;
+        json["filesystem" ]["use-mesh-cache"          ] = config.UseMeshCache;
+        json["filesystem" ]["use-audio-cache"         ] = config.UseAudioCache;
+        json["filesystem" ]["export-embedded-textures"] = config.ExportEmbeddedTextures;
+        json["audio"      ]["sample-rate"             ] = config.AudioSampleRate;
+        json["threading"  ]["worker-count"            ] = config.WorkerThreadCount;
+        json["threading"  ]["main-thread-budget-ms"   ] = config.MainThreadTaskBudget;
+        json["physics"    ]["multithreaded"           ] = config.MultithreadedPhysics;
+        json["physics"    ]["thread-count"            ] = config.PhysicsThreadCount;
+        json["physics"    ]["dedicated-thread"        ] = config.PhysicsOnDedicatedThread;
+        json["physics"    ]["tick-rate"               ] = config.PhysicsTickRate;
         json["debug-build"]["app-close-key"           ] = config.ApplicationCloseKey;
         json["debug-build"]["editor-style"            ] = config.Style;
         json["debug-build"]["editor-key"              ] = config.EditorOpenKey;
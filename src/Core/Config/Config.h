@@ -88,10 +88,31 @@ namespace MxEngine
         size_t PointLightTextureSize = 512;
         size_t SpotLightTextureSize = 512;
         size_t EngineTextureSize = 512;
+        bool OptimizeImportedMeshes = false;
+        bool BuildMeshClusters = false;
+        bool StreamMaterialTextures = false;
+        bool CompressTextures = false;
+        size_t TextureUploadBudget = 16; // in megabytes per frame
 
         // Filesystem settings
         MxString ProjectRootDirectory = "Resources";
         MxString ShaderSourceDirectory = "../../src/Platform/OpenGL/Shaders";
+        bool UseMeshCache = true;
+        bool UseAudioCache = false;
+        bool ExportEmbeddedTextures = false;
+
+        // Audio settings
+        size_t AudioSampleRate = 0; // sampling rate of loaded audio buffers, 0 means sampling rate of source file
+
+        // Threading settings
+        size_t WorkerThreadCount = 0; // 0 means hardware concurrency - 1
+        size_t MainThreadTaskBudget = 2; // in milliseconds
+
+        // Physics settings
+        bool MultithreadedPhysics = false;
+        size_t PhysicsThreadCount = 0; // 0 means all worker threads and main thread
+        bool PhysicsOnDedicatedThread = false;
+        size_t PhysicsTickRate = 60; // fixed simulation steps per second on dedicated physics thread
 
         // Debug settings
         bool GraphicAPIDebug = true;
@@ -40,6 +40,7 @@ namespace MxEngine
     {
 		auto object = Factory::Create<MxObject>();
 		object->handle = object.GetHandle();
+		object->Transform.UserData = reinterpret_cast<void*>(object->handle); // lets transform notify components about its changes
 		object.MakeStatic();
 		return object;
     }
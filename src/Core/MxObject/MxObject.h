@@ -30,7 +30,10 @@
 
 #include "Core/Components/Transform.h"
 
+namespace MxEngine { class MxObject; }
+
 GENERATE_METHOD_CHECK(Init, Init())
+GENERATE_METHOD_CHECK(OnRemove, OnRemove(std::declval<MxEngine::MxObject&>()))
 
 #if !defined(MXENGINE_SHIPPING)
 #define MXENGINE_MXOBJECT_EDITOR
@@ -100,6 +103,8 @@ namespace MxEngine
 		{
 			static_assert(!std::is_same_v<T, TransformComponent>, "Transform component is already present in MxObject");
 
+			if constexpr (has_method_OnRemove<T>::value)
+				this->RemoveComponent<T>(); // notify old component before it is replaced
 			auto component = this->components.AddComponent<T>(std::forward<Args>(args)...);
 			component->UserData = reinterpret_cast<void*>(this->handle);
 			if constexpr (has_method_Init<T>::value) 
@@ -126,6 +131,11 @@ namespace MxEngine
 		void RemoveComponent()
 		{
 			static_assert(!std::is_same_v<T, MxEngine::TransformComponent>, "Transform component cannot be deleted");
+			if constexpr (has_method_OnRemove<T>::value)
+			{
+				auto component = this->components.GetComponent<T>();
+				if (component.IsValid()) component->OnRemove(*this);
+			}
 			this->components.RemoveComponent<T>();
 		}
 
@@ -57,6 +57,7 @@ namespace MxEngine
         this->SetRenderToDefaultFrameBuffer();
         this->SetShadowBlurIterations(1);
         this->SetLightSamples(4);
+        this->SetClusterCulling(true);
 
         // helper objects
         environment.RectangularObject.Init(1.0f);
@@ -430,4 +431,14 @@ namespace MxEngine
     {
         return (size_t)this->Renderer.GetEnvironment().LightSamples;
     }
+
+    void RenderAdaptor::SetClusterCulling(bool value)
+    {
+        this->Renderer.GetEnvironment().ClusterCulling = value;
+    }
+
+    bool RenderAdaptor::IsClusterCullingEnabled() const
+    {
+        return this->Renderer.GetEnvironment().ClusterCulling;
+    }
 }
\ No newline at end of file
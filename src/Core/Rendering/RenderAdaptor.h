@@ -51,5 +51,7 @@ namespace MxEngine
         size_t GetShadowBlurIterations() const;
         void SetLightSamples(size_t samples);
         size_t GetLightSamples() const;
+        void SetClusterCulling(bool value);
+        bool IsClusterCullingEnabled() const;
     };
 }
\ No newline at end of file
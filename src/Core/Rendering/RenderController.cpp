@@ -74,15 +74,30 @@ namespace MxEngine
 		shader.SetUniformMat4("ViewProjMatrix", camera.ViewProjectionMatrix);
 		shader.SetUniformFloat("gamma", camera.Gamma);
 
+		bool useClusterCulling = this->Pipeline.Environment.ClusterCulling;
 		for (const auto& unit : objects)
 		{
 			bool isUnitVisible = unit.InstanceCount > 0 || camera.Culler.IsAABBVisible(unit.MinAABB, unit.MaxAABB);
+			if (!isUnitVisible) continue;
 
-			if (isUnitVisible) this->DrawObject(unit, shader);
+			// instanced units are not culled as their clusters are placed differently for each instance
+			if (useClusterCulling && unit.InstanceCount == 0 && unit.Clusters != nullptr && !unit.Clusters->empty())
+			{
+				this->visibleClusterRanges.clear();
+				ClusterBuilder::Cull(*unit.Clusters, camera.Culler, unit.ModelMatrix, camera.ViewportPosition,
+					this->isBackfaceCullingEnabled, this->visibleClusterRanges, this->clusterStatistics);
+
+				if (!this->visibleClusterRanges.empty())
+					this->DrawObject(unit, shader, &this->visibleClusterRanges);
+			}
+			else
+			{
+				this->DrawObject(unit, shader);
+			}
 		}
 	}
 
-	void RenderController::DrawObject(const RenderUnit& unit, const Shader& shader)
+	void RenderController::DrawObject(const RenderUnit& unit, const Shader& shader, const MxVector<IndexRange>* ranges)
 	{
 		Texture::TextureBindId textureBindIndex = 0;
 		const auto& material = this->Pipeline.MaterialUnits[unit.materialIndex];
@@ -115,8 +130,13 @@ namespace MxEngine
 		this->GetRenderEngine().SetDefaultVertexAttribute(5, unit.ModelMatrix); //-V807
 		this->GetRenderEngine().SetDefaultVertexAttribute(9, unit.NormalMatrix);
 		this->GetRenderEngine().SetDefaultVertexAttribute(12, material.BaseColor);
+		this->GetRenderEngine().SetDefaultVertexAttribute(13, unit.PositionDecodeOffset);
+		this->GetRenderEngine().SetDefaultVertexAttribute(14, unit.PositionDecodeScale);
 		
-		this->GetRenderEngine().DrawTrianglesInstanced(*unit.VAO, *unit.IBO, shader, unit.InstanceCount);
+		if (ranges != nullptr)
+			this->GetRenderEngine().DrawTriangles(*unit.VAO, *unit.IBO, ranges->data(), ranges->size(), shader);
+		else
+			this->GetRenderEngine().DrawTrianglesInstanced(*unit.VAO, *unit.IBO, shader, unit.InstanceCount);
 	}
 
 	void RenderController::ComputeBloomEffect(CameraUnit& camera)
@@ -765,6 +785,8 @@ namespace MxEngine
 	void RenderController::ToggleFaceCulling(bool value, bool counterClockWise, bool cullBack)
 	{
 		this->GetRenderEngine().UseCulling(value, counterClockWise, cullBack);
+		// clusters can be rejected by normal cones only if back faces are discarded by rasterizer anyway
+		this->isBackfaceCullingEnabled = value && counterClockWise && cullBack;
 	}
 
 	void RenderController::SetAnisotropicFiltering(float value)
@@ -837,6 +859,11 @@ namespace MxEngine
 		return this->Pipeline.Lighting;
 	}
 
+	const ClusterCullingStatistics& RenderController::GetClusterStatistics() const
+	{
+		return this->lastFrameClusterStatistics;
+	}
+
 	void RenderController::ResetPipeline()
 	{
 		this->Pipeline.Lighting.DirectionalLights.clear();
@@ -849,6 +876,9 @@ namespace MxEngine
 		this->Pipeline.ShadowCasterUnits.clear();
 		this->Pipeline.MaterialUnits.clear();
 		this->Pipeline.Cameras.clear();
+
+		this->lastFrameClusterStatistics = this->clusterStatistics;
+		this->clusterStatistics = ClusterCullingStatistics{ };
 	}
 
 	void RenderController::SubmitLightSource(const DirectionalLight& light, const TransformComponent& parentTransform)
@@ -967,7 +997,10 @@ namespace MxEngine
 		primitive.materialIndex = this->Pipeline.MaterialUnits.size();
 		primitive.ModelMatrix  = parentTransform.GetMatrix() * object.GetTransform()->GetMatrix(); //-V807
 		primitive.NormalMatrix = parentTransform.GetNormalMatrix() * object.GetTransform()->GetNormalMatrix();
+		primitive.PositionDecodeOffset = object.Data.GetPositionDecodeOffset();
+		primitive.PositionDecodeScale = object.Data.GetPositionDecodeScale();
 		primitive.InstanceCount = instanceCount;
+		primitive.Clusters = &object.Data.GetClusters();
 
 		// compute aabb of primitive object for later frustrum culling
 		auto aabb = object.Data.GetBoundingBox() * primitive.ModelMatrix;
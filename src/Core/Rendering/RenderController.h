@@ -50,12 +50,16 @@ namespace MxEngine
 	{
 		Renderer renderer;
 		RenderPipeline Pipeline;
+		ClusterCullingStatistics clusterStatistics;
+		ClusterCullingStatistics lastFrameClusterStatistics;
+		MxVector<IndexRange> visibleClusterRanges;
+		bool isBackfaceCullingEnabled = true;
 
 		void PrepareShadowMaps();
 		void DrawSkybox(const CameraUnit& camera);
 		void DrawObjects(const CameraUnit& camera, const Shader& shader, const MxVector<RenderUnit>& objects);
 		void DrawDebugBuffer(const CameraUnit& camera);
-		void DrawObject(const RenderUnit& unit, const Shader& shader);
+		void DrawObject(const RenderUnit& unit, const Shader& shader, const MxVector<IndexRange>* ranges = nullptr);
 		void ComputeBloomEffect(CameraUnit& camera);
 		TextureHandle ComputeAverageWhite(CameraUnit& camera);
 		void PerformPostProcessing(CameraUnit& camera);
@@ -101,6 +105,7 @@ namespace MxEngine
 		const EnvironmentUnit& GetEnvironment() const;
 		LightingSystem& GetLightInformation();
 		const LightingSystem& GetLightInformation() const;
+		const ClusterCullingStatistics& GetClusterStatistics() const;
 		void ResetPipeline();
 		void SubmitLightSource(const DirectionalLight& light, const TransformComponent& parentTransform);
 		void SubmitLightSource(const PointLight& light, const TransformComponent& parentTransform);
@@ -36,6 +36,7 @@
 #include "RenderObjects/SpotLightInstancedObject.h"
 #include "Core/Resources/ACESCurve.h"
 #include "Core/Resources/Material.h"
+#include "Utilities/ClusterBuilder/ClusterBuilder.h"
 
 #include "Utilities/STL/MxHashMap.h"
 #include "Utilities/String/String.h"
@@ -116,6 +117,7 @@ namespace MxEngine
         uint8_t ShadowBlurIterations;
         uint8_t MainCameraIndex;
         bool OverlayDebugDraws;
+        bool ClusterCulling;
         bool RenderToDefaultFrameBuffer;
     };
 
@@ -163,9 +165,14 @@ namespace MxEngine
         
         Matrix4x4 ModelMatrix;
         Matrix3x3 NormalMatrix;
+        Vector4 PositionDecodeOffset;
+        Vector4 PositionDecodeScale;
 
         Vector3 MinAABB, MaxAABB;
         size_t InstanceCount;
+
+        // points to mesh data which outlives frame rendering. Empty if mesh has no clusters
+        const MxVector<MeshCluster>* Clusters;
     };
 
     struct RenderPipeline
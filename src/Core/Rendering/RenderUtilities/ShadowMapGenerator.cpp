@@ -56,6 +56,8 @@ namespace MxEngine
 
             Rendering::GetController().GetRenderEngine().SetDefaultVertexAttribute(5, unit.ModelMatrix); //-V807
             Rendering::GetController().GetRenderEngine().SetDefaultVertexAttribute(9, unit.NormalMatrix);
+            Rendering::GetController().GetRenderEngine().SetDefaultVertexAttribute(13, unit.PositionDecodeOffset);
+            Rendering::GetController().GetRenderEngine().SetDefaultVertexAttribute(14, unit.PositionDecodeScale);
             Rendering::GetController().GetRenderEngine().DrawTrianglesInstanced(*unit.VAO, *unit.IBO, shader, unit.InstanceCount);
         }
     }
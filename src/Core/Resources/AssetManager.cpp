@@ -29,9 +29,581 @@
 #include "AssetManager.h"
 #include "Utilities/FileSystem/FileManager.h"
 #include "Core/Components/Rendering/MeshRenderer.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Core/Resources/TextureStreamer.h"
+#include "Core/Application/Application.h"
+#include "Utilities/TextureCache/TextureCache.h"
+#include "Utilities/AudioCache/AudioCache.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
 
 namespace MxEngine
 {
+    /*!
+    shared state of asynchronous mesh loading. Object is imported on worker thread, then submeshes are created
+    one per main thread task, so GPU uploads are spread across frames by ThreadPool time budget.
+    Engine resources are accessed only on main thread, mesh is recreated from its plain id in each task
+    */
+    struct MeshLoadingState
+    {
+        UUID MeshUUID;
+        size_t ResourceHandle = 0;
+        MxString Path;
+        MeshImportSettings Settings;
+        ObjectInfo Object;
+        MxVector<SubMesh> Submeshes;
+        std::promise<void> ImportCompletion;
+        std::shared_future<void> ImportFuture;
+        TaskGroup ImportGroup = ThreadPool::DefaultGroup;
+        std::promise<void> Completion;
+
+        void Start(MeshHandle& mesh)
+        {
+            this->MeshUUID = mesh.GetUUID();
+            this->ResourceHandle = mesh.GetHandle();
+            this->ImportFuture = this->ImportCompletion.get_future().share();
+            mesh->status = MeshStatus::PENDING;
+            mesh->loadFuture = this->Completion.get_future().share();
+        }
+
+        void Import()
+        {
+            // import completion must be set on every exit path, as material loading waits for it
+            try
+            {
+                this->Object = Mesh::ImportObject(this->Path, this->Settings);
+            }
+            catch (...)
+            {
+                this->Object = ObjectInfo();
+                this->ImportCompletion.set_exception(std::current_exception());
+                return;
+            }
+
+            if (this->Object.meshes.empty())
+                this->ImportCompletion.set_exception(std::make_exception_ptr(std::runtime_error(("failed to import object: " + this->Path).c_str())));
+            else
+                this->ImportCompletion.set_value();
+        }
+
+        void Finish()
+        {
+            // submeshes hold engine handles, so they must be released on main thread
+            this->Submeshes.clear();
+            this->Object = ObjectInfo();
+            this->Completion.set_value();
+        }
+
+        void UploadSubmesh(Ref<MeshLoadingState> self);
+    };
+
+    /*!
+    decoded audio which is uploaded to audio buffer. Decoding can be done on any thread, samples are either owned
+    by state or point to mapped .mxpcm cache, so uncompressed sources are never copied before upload unless they are resampled
+    */
+    struct AudioLoadingState
+    {
+        UUID BufferUUID;
+        size_t ResourceHandle = 0;
+        MxString Path;
+        size_t Frequency = 0;
+        bool UseCache = false;
+        bool IsCached = false;
+        MappedFile Cache;
+        AudioData Audio;
+
+        void Decode()
+        {
+            // cache built for other engine sampling rate is rejected, so it is decoded again and overwritten
+            if (this->UseCache && AudioCache::Map(this->Path, this->Frequency, this->Cache, this->Audio))
+            {
+                this->IsCached = true;
+                return;
+            }
+
+            this->Audio = AudioLoader::LoadMono(this->Path);
+            bool isResampled = AudioLoader::Resample(this->Audio, this->Frequency);
+            // wav files are already stored as PCM, so caching them would only duplicate source unless they were resampled
+            if (this->UseCache && this->Audio.data != nullptr && (this->Audio.type != AudioType::WAV || isResampled))
+                AudioCache::Save(this->Audio, this->Path, this->Frequency);
+        }
+
+        void Upload(AudioBuffer& buffer)
+        {
+            if (this->Audio.data != nullptr)
+                buffer.Load(this->Audio, this->Path);
+            else
+                buffer.SetFailed();
+        }
+
+        void Release()
+        {
+            if (this->IsCached)
+                this->Cache.Close();
+            else if (this->Audio.data != nullptr)
+                AudioLoader::Free(this->Audio);
+            this->Audio = AudioData();
+        }
+    };
+
+    const char* EnumToString(AssetType type)
+    {
+        switch (type)
+        {
+        case AssetType::TEXTURE:
+            return "TEXTURE";
+        case AssetType::CUBEMAP:
+            return "CUBEMAP";
+        case AssetType::MESH:
+            return "MESH";
+        case AssetType::AUDIO:
+            return "AUDIO";
+        default:
+            return "TEXTURE";
+        }
+    }
+
+    const char* EnumToString(TextureUsage usage)
+    {
+        switch (usage)
+        {
+        case TextureUsage::COLOR:
+            return "COLOR";
+        case TextureUsage::NORMAL:
+            return "NORMAL";
+        case TextureUsage::DATA:
+            return "DATA";
+        default:
+            return "COLOR";
+        }
+    }
+
+    static MxString NormalizeAssetPath(const MxString& path)
+    {
+        return ToMxString(ToFilePath(path).lexically_normal());
+    }
+
+    static size_t MakeCacheKey(AssetType type, const MxString& normalizedPath, size_t variant)
+    {
+        size_t key = MakeStringId(normalizedPath);
+        key ^= (variant + ((size_t)type << 32)) * 0x9E3779B97F4A7C15ull;
+        return key;
+    }
+
+    static size_t GetMeshImportVariant(const MeshImportSettings& settings)
+    {
+        return size_t(settings.Optimize) | (size_t(settings.BuildClusters) << 1) | (size_t(settings.ExportEmbeddedTextures) << 2);
+    }
+
+    static Ref<Image> FindEmbeddedTexture(AssetManagerImpl& data, const MxString& path)
+    {
+        std::lock_guard<std::mutex> lock(data.EmbeddedTexturesMutex);
+        if (data.EmbeddedTextures.empty()) return nullptr;
+
+        auto embedded = data.EmbeddedTextures.find(NormalizeAssetPath(path));
+        if (embedded == data.EmbeddedTextures.end()) return nullptr;
+        return embedded->second.Data;
+    }
+
+    static Image CopyImage(const Image& image)
+    {
+        auto data = (uint8_t*)std::malloc(image.GetTotalByteSize());
+        std::memcpy(data, image.GetRawData(), image.GetTotalByteSize());
+        return Image(data, image.GetWidth(), image.GetHeight(), image.GetChannelCount(), image.IsFloatingPoint());
+    }
+
+    static BlockCompression SelectTextureCompression(TextureFormat format, TextureUsage usage)
+    {
+        switch (format)
+        {
+        case TextureFormat::R:
+            return BlockCompression::BC4;
+        case TextureFormat::RG:
+            return BlockCompression::BC5;
+        case TextureFormat::RGB:
+        case TextureFormat::RGBA:
+            // normal maps keep only X and Y with independent endpoints, BC1 / BC3 would quantize channels of data textures together
+            if (usage == TextureUsage::NORMAL) return BlockCompression::BC5;
+            if (usage == TextureUsage::DATA) return BlockCompression::NONE;
+            return format == TextureFormat::RGB ? BlockCompression::BC1 : BlockCompression::BC3;
+        default:
+            return BlockCompression::NONE; // high precision and depth textures are never compressed
+        }
+    }
+
+    static size_t GetTextureVariant(TextureFormat format, TextureUsage usage)
+    {
+        return (size_t)format | ((size_t)usage << 8);
+    }
+
+    /*!
+    recreates resource handle from cache entry
+    \returns valid handle if resource is still alive, null handle either
+    */
+    template<typename T, typename Factory>
+    static Resource<T, Factory> LockCacheEntry(const AssetCacheEntry& entry)
+    {
+        auto& pool = Factory::template Get<T>();
+        if (pool.IsAllocated(entry.ResourceHandle) && pool[entry.ResourceHandle].uuid == entry.ResourceUUID)
+            return Resource<T, Factory>(entry.ResourceUUID, entry.ResourceHandle);
+        return Resource<T, Factory>();
+    }
+
+    template<typename T, typename Factory>
+    static size_t GetReferenceCount(const Resource<T, Factory>& resource)
+    {
+        // handle which is used to get reference count is not counted
+        return Factory::template Get<T>()[resource.GetHandle()].refCount - 1;
+    }
+
+    /*!
+    finds alive cached asset. Cache hit is counted only if asset is accepted by isReusable predicate, as rejected asset is loaded again
+    */
+    template<typename T, typename Factory, typename Predicate>
+    static Resource<T, Factory> FindCachedAsset(AssetManagerImpl& data, AssetType type, const MxString& path, size_t variant, Predicate&& isReusable)
+    {
+        auto normalizedPath = NormalizeAssetPath(path);
+        auto entry = data.Cache.find(MakeCacheKey(type, normalizedPath, variant));
+        if (entry != data.Cache.end() && entry->second.Type == type && entry->second.Variant == variant && entry->second.Path == normalizedPath)
+        {
+            auto resource = LockCacheEntry<T, Factory>(entry->second);
+            if (resource.IsValid() && isReusable(*resource))
+            {
+                data.CacheHits++;
+                return resource;
+            }
+        }
+        data.CacheMisses++;
+        return Resource<T, Factory>();
+    }
+
+    template<typename T, typename Factory>
+    static Resource<T, Factory> FindCachedAsset(AssetManagerImpl& data, AssetType type, const MxString& path, size_t variant)
+    {
+        return FindCachedAsset<T, Factory>(data, type, path, variant, [](const T&) { return true; });
+    }
+
+    static size_t GetAudioVariant()
+    {
+        return Application::GetImpl()->GetConfig().AudioSampleRate;
+    }
+
+    template<typename T, typename Factory>
+    static void CacheAsset(AssetManagerImpl& data, AssetType type, const MxString& path, size_t variant, const Resource<T, Factory>& resource)
+    {
+        AssetCacheEntry entry;
+        entry.Path = NormalizeAssetPath(path);
+        entry.Type = type;
+        entry.Variant = variant;
+        entry.ResourceUUID = resource.GetUUID();
+        entry.ResourceHandle = resource.GetHandle();
+        data.Cache[MakeCacheKey(type, entry.Path, variant)] = std::move(entry);
+    }
+
+    static size_t EstimateByteSize(const Texture& texture)
+    {
+        if (texture.GetCompression() != BlockCompression::NONE)
+        {
+            size_t blockCount = ((texture.GetWidth() + 3) / 4) * ((texture.GetHeight() + 3) / 4);
+            return blockCount * TextureCompressor::GetBlockByteSize(texture.GetCompression()) * 4 / 3;
+        }
+        size_t pixelSize = texture.GetChannelCount() * (texture.IsFloatingPoint() ? sizeof(float) : sizeof(uint8_t));
+        size_t baseLevelSize = texture.GetWidth() * texture.GetHeight() * pixelSize;
+        return baseLevelSize * 4 / 3; // full mipmap chain is assumed
+    }
+
+    static size_t EstimateByteSize(const CubeMap& cubemap)
+    {
+        return cubemap.GetWidth() * cubemap.GetHeight() * cubemap.GetChannelCount() * 6 * 4 / 3;
+    }
+
+    static size_t EstimateByteSize(const Mesh& mesh)
+    {
+        size_t byteSize = 0;
+        for (const auto& submesh : mesh.Submeshes)
+        {
+            byteSize += submesh.Data.GetVBO()->GetSize() * sizeof(float);
+            byteSize += submesh.Data.GetIBO()->GetCount() * sizeof(IndexBuffer::IndexType);
+        }
+        return byteSize;
+    }
+
+    static size_t EstimateByteSize(const AudioBuffer& buffer)
+    {
+        return buffer.GetSampleCount() * sizeof(int16_t);
+    }
+
+    void MeshLoadingState::UploadSubmesh(Ref<MeshLoadingState> self)
+    {
+        MAKE_SCOPE_PROFILER("AssetManager::UploadSubmesh()");
+        auto& imports = AssetManager::GetImpl()->PendingMeshImports;
+        auto import = imports.find(MeshRenderer::GetMaterialLibraryPath(this->Path));
+        if (import != imports.end() && import->second == self) imports.erase(import);
+
+        MeshHandle mesh(this->MeshUUID, this->ResourceHandle);
+        if (!mesh.IsValid())
+        {
+            // mesh was destroyed while loading, so there is no need to upload it
+            this->Finish();
+            return;
+        }
+        if (this->Object.meshes.empty())
+        {
+            MXLOG_WARNING("MxEngine::AssetManager", "failed to load mesh asynchronously: " + this->Path);
+            mesh->status = MeshStatus::FAILED;
+            this->Finish();
+            return;
+        }
+
+        size_t index = this->Submeshes.size();
+        this->Submeshes.push_back(Mesh::CreateSubmesh(this->Object, index));
+        if (this->Submeshes.size() < this->Object.meshes.size())
+        {
+            ThreadPool::SubmitToMainThread([self = std::move(self)]() mutable { self->UploadSubmesh(std::move(self)); });
+            return;
+        }
+
+        // all submeshes are uploaded, publish them at once so mesh is never rendered partially
+        for (auto& submesh : this->Submeshes)
+        {
+            for (size_t i = 0; i < mesh->GetBufferCount(); i++)
+                submesh.Data.GetVAO()->AddInstancedBuffer(*mesh->GetBufferByIndex(i), *mesh->GetBufferLayoutByIndex(i));
+        }
+        mesh->Submeshes = std::move(this->Submeshes);
+        mesh->UpdateBoundingGeometry();
+        mesh->status = MeshStatus::READY;
+        MXLOG_DEBUG("MxEngine::AssetManager", "mesh loaded asynchronously: " + this->Path);
+        this->Finish();
+    }
+
+    /*!
+    shared state of asynchronous material loading. Material library is parsed on worker thread, materials and textures are created on main thread
+    */
+    struct MaterialLoadingState
+    {
+        MxString Path;
+        std::shared_future<void> Dependency;
+        TaskGroup DependencyGroup = ThreadPool::DefaultGroup;
+        MaterialLibrary Library;
+        std::exception_ptr Failure;
+        std::promise<MxVector<MaterialHandle>> Completion;
+
+        void Load()
+        {
+            try
+            {
+                // material library is written by mesh import, so it must be finished first. If import is still queued, it is executed by this thread
+                if (this->Dependency.valid())
+                {
+                    ThreadPool::Wait(this->Dependency, this->DependencyGroup);
+                    this->Dependency.get(); // rethrows import failure
+                }
+                this->Library = ObjectLoader::LoadMaterials(this->Path);
+            }
+            catch (...)
+            {
+                this->Failure = std::current_exception();
+            }
+        }
+
+        void CreateMaterials()
+        {
+            MAKE_SCOPE_PROFILER("AssetManager::CreateMaterials()");
+            if (this->Failure != nullptr)
+            {
+                this->Completion.set_exception(this->Failure);
+                return;
+            }
+
+            try
+            {
+                this->Completion.set_value(MeshRenderer::CreateMaterials(this->Library));
+            }
+            catch (...)
+            {
+                this->Completion.set_exception(std::current_exception());
+            }
+        }
+    };
+
+    void AssetManager::Init()
+    {
+        impl = Alloc<AssetManagerImpl>();
+    }
+
+    void AssetManager::Destroy()
+    {
+        // loading states hold engine resources, so they must be released before factories are destroyed
+        Free(impl);
+        impl = nullptr;
+    }
+
+    AssetManagerImpl* AssetManager::GetImpl()
+    {
+        return impl;
+    }
+
+    void AssetManager::Clone(AssetManagerImpl* other)
+    {
+        impl = other;
+    }
+
+    void AssetManager::EvictCache(const MxString& path)
+    {
+        auto normalizedPath = NormalizeAssetPath(path);
+        for (auto it = impl->Cache.begin(); it != impl->Cache.end();)
+        {
+            if (it->second.Path == normalizedPath)
+                it = impl->Cache.erase(it);
+            else
+                it++;
+        }
+    }
+
+    size_t AssetManager::EvictExpiredCache()
+    {
+        size_t evicted = 0;
+        for (auto it = impl->Cache.begin(); it != impl->Cache.end();)
+        {
+            bool isAlive = false;
+            switch (it->second.Type)
+            {
+            case AssetType::TEXTURE:
+                isAlive = LockCacheEntry<Texture, GraphicFactory>(it->second).IsValid();
+                break;
+            case AssetType::CUBEMAP:
+                isAlive = LockCacheEntry<CubeMap, GraphicFactory>(it->second).IsValid();
+                break;
+            case AssetType::MESH:
+                isAlive = LockCacheEntry<Mesh, ResourceFactory>(it->second).IsValid();
+                break;
+            case AssetType::AUDIO:
+                isAlive = LockCacheEntry<AudioBuffer, AudioFactory>(it->second).IsValid();
+                break;
+            }
+
+            if (isAlive)
+            {
+                it++;
+            }
+            else
+            {
+                it = impl->Cache.erase(it);
+                evicted++;
+            }
+        }
+
+        // embedded textures are released only when mesh of their object is not cached anymore, as its materials may be created again
+        MxVector<MxString> cachedObjects;
+        for (const auto& [key, entry] : impl->Cache)
+        {
+            if (entry.Type == AssetType::MESH)
+                cachedObjects.push_back(entry.Path);
+        }
+        std::lock_guard<std::mutex> lock(impl->EmbeddedTexturesMutex);
+        for (auto it = impl->EmbeddedTextures.begin(); it != impl->EmbeddedTextures.end();)
+        {
+            if (std::find(cachedObjects.begin(), cachedObjects.end(), it->second.ObjectPath) == cachedObjects.end())
+                it = impl->EmbeddedTextures.erase(it);
+            else
+                it++;
+        }
+        return evicted;
+    }
+
+    void AssetManager::ClearCache()
+    {
+        impl->Cache.clear();
+        // embedded textures are owned by cached meshes, so they are released together with them
+        std::lock_guard<std::mutex> lock(impl->EmbeddedTexturesMutex);
+        impl->EmbeddedTextures.clear();
+    }
+
+    void AssetManager::AddEmbeddedTextures(MxVector<EmbeddedTexture>& textures, const MxString& objectPath)
+    {
+        auto normalizedObjectPath = NormalizeAssetPath(objectPath);
+        std::lock_guard<std::mutex> lock(impl->EmbeddedTexturesMutex);
+        for (auto& texture : textures)
+        {
+            if (texture.Data.GetRawData() == nullptr) continue;
+
+            auto& entry = impl->EmbeddedTextures[NormalizeAssetPath(texture.Path)];
+            entry.Data = MakeRef<Image>(std::move(texture.Data));
+            entry.ObjectPath = normalizedObjectPath;
+        }
+        textures.clear();
+    }
+
+    AssetCacheReport AssetManager::GetCacheReport()
+    {
+        AssetCacheReport report;
+        report.CacheHits = impl->CacheHits;
+        report.CacheMisses = impl->CacheMisses;
+
+        for (const auto& [key, entry] : impl->Cache)
+        {
+            AssetCacheRecord record;
+            record.Path = entry.Path;
+            record.Type = entry.Type;
+
+            bool isAlive = false;
+            switch (entry.Type)
+            {
+            case AssetType::TEXTURE:
+                if (auto texture = LockCacheEntry<Texture, GraphicFactory>(entry); texture.IsValid())
+                {
+                    record.ByteSize = EstimateByteSize(*texture);
+                    record.ReferenceCount = GetReferenceCount(texture);
+                    report.TextureBytes += record.ByteSize;
+                    isAlive = true;
+                }
+                break;
+            case AssetType::CUBEMAP:
+                if (auto cubemap = LockCacheEntry<CubeMap, GraphicFactory>(entry); cubemap.IsValid())
+                {
+                    record.ByteSize = EstimateByteSize(*cubemap);
+                    record.ReferenceCount = GetReferenceCount(cubemap);
+                    report.CubeMapBytes += record.ByteSize;
+                    isAlive = true;
+                }
+                break;
+            case AssetType::MESH:
+                if (auto mesh = LockCacheEntry<Mesh, ResourceFactory>(entry); mesh.IsValid())
+                {
+                    record.ByteSize = EstimateByteSize(*mesh);
+                    record.ReferenceCount = GetReferenceCount(mesh);
+                    report.MeshBytes += record.ByteSize;
+                    isAlive = true;
+                }
+                break;
+            case AssetType::AUDIO:
+                if (auto buffer = LockCacheEntry<AudioBuffer, AudioFactory>(entry); buffer.IsValid())
+                {
+                    record.ByteSize = EstimateByteSize(*buffer);
+                    record.ReferenceCount = GetReferenceCount(buffer);
+                    report.AudioBytes += record.ByteSize;
+                    isAlive = true;
+                }
+                break;
+            }
+
+            if (isAlive)
+                report.Records.push_back(std::move(record));
+            else
+                report.ExpiredEntries++;
+        }
+        report.TotalBytes = report.TextureBytes + report.CubeMapBytes + report.MeshBytes + report.AudioBytes;
+
+        std::sort(report.Records.begin(), report.Records.end(), [](const auto& r1, const auto& r2) { return r1.ByteSize > r2.ByteSize; });
+        return report;
+    }
+
     CubeMapHandle AssetManager::LoadCubeMap(StringId hash)
     {
         return AssetManager::LoadCubeMap(FileManager::GetFilePath(hash));
@@ -44,7 +616,12 @@ namespace MxEngine
 
     CubeMapHandle AssetManager::LoadCubeMap(const MxString& path)
     {
-        return GraphicFactory::Create<CubeMap>(path);
+        auto cubemap = FindCachedAsset<CubeMap, GraphicFactory>(*impl, AssetType::CUBEMAP, path, 0);
+        if (cubemap.IsValid()) return cubemap;
+
+        cubemap = GraphicFactory::Create<CubeMap>(path);
+        CacheAsset(*impl, AssetType::CUBEMAP, path, 0, cubemap);
+        return cubemap;
     }
 
     CubeMapHandle AssetManager::LoadCubeMap(const char* path)
@@ -71,8 +648,14 @@ namespace MxEngine
 
     CubeMapHandle AssetManager::LoadCubeMap(const MxString& right, const MxString& left, const MxString& top, const MxString& bottom, const MxString& front, const MxString& back)
     {
-        auto cubemap = GraphicFactory::Create<CubeMap>();
+        // cubemap loaded from six faces is cached by all its face paths
+        auto facePaths = right + '|' + left + '|' + top + '|' + bottom + '|' + front + '|' + back;
+        auto cubemap = FindCachedAsset<CubeMap, GraphicFactory>(*impl, AssetType::CUBEMAP, facePaths, 0);
+        if (cubemap.IsValid()) return cubemap;
+
+        cubemap = GraphicFactory::Create<CubeMap>();
         cubemap->Load(right, left, top, bottom, front, back);
+        CacheAsset(*impl, AssetType::CUBEMAP, facePaths, 0, cubemap);
         return cubemap;
     }
 
@@ -84,24 +667,85 @@ namespace MxEngine
         );
     }
 
-    TextureHandle AssetManager::LoadTexture(StringId hash, TextureFormat format)
+    TextureHandle AssetManager::LoadTexture(StringId hash, TextureFormat format, TextureUsage usage)
+    {
+        return AssetManager::LoadTexture(FileManager::GetFilePath(hash), format, usage);
+    }
+
+    TextureHandle AssetManager::LoadTexture(const FilePath& path, TextureFormat format, TextureUsage usage)
+    {
+        return AssetManager::LoadTexture(ToMxString(path), format, usage);
+    }
+
+    TextureHandle AssetManager::LoadTexture(const MxString& path, TextureFormat format, TextureUsage usage)
     {
-        return AssetManager::LoadTexture(FileManager::GetFilePath(hash), format);
+        auto texture = FindCachedAsset<Texture, GraphicFactory>(*impl, AssetType::TEXTURE, path, GetTextureVariant(format, usage));
+        if (texture.IsValid()) return texture;
+
+        auto compression = SelectTextureCompression(format, usage);
+        bool useCompression = Application::GetImpl()->GetConfig().CompressTextures && compression != BlockCompression::NONE;
+
+        // embedded textures are already decoded, so they are uploaded directly. Their compressed form is not cached, as they have no source file
+        auto embedded = FindEmbeddedTexture(*impl, path);
+        CompressedImage compressed;
+        if (embedded != nullptr)
+        {
+            texture = GraphicFactory::Create<Texture>();
+            if (useCompression && !embedded->IsFloatingPoint())
+                texture->Load(TextureCompressor::Compress(*embedded, compression), format);
+            else
+                texture->Load(*embedded, format);
+            texture->SetPath(path);
+        }
+        // compressed mip chain is taken from .mxtex cache, which is built on first load
+        else if (useCompression && TextureCache::Import(path, compressed, compression))
+        {
+            texture = GraphicFactory::Create<Texture>();
+            texture->Load(compressed, format);
+            texture->SetPath(path);
+        }
+        else
+        {
+            texture = GraphicFactory::Create<Texture>(path, format);
+        }
+        CacheAsset(*impl, AssetType::TEXTURE, path, GetTextureVariant(format, usage), texture);
+        return texture;
     }
 
-    TextureHandle AssetManager::LoadTexture(const FilePath& path, TextureFormat format)
+    TextureHandle AssetManager::LoadTexture(const char* path, TextureFormat format, TextureUsage usage)
     {
-        return AssetManager::LoadTexture(ToMxString(path), format);
+        return AssetManager::LoadTexture(MxString(path), format, usage);
     }
 
-    TextureHandle AssetManager::LoadTexture(const MxString& path, TextureFormat format)
+    TextureHandle AssetManager::LoadTextureAsync(StringId hash, TextureFormat format, const Vector3& placeholder, TextureUsage usage)
     {
-        return GraphicFactory::Create<Texture>(path, format);
+        return AssetManager::LoadTextureAsync(FileManager::GetFilePath(hash), format, placeholder, usage);
     }
 
-    TextureHandle AssetManager::LoadTexture(const char* path, TextureFormat format)
+    TextureHandle AssetManager::LoadTextureAsync(const FilePath& path, TextureFormat format, const Vector3& placeholder, TextureUsage usage)
     {
-        return AssetManager::LoadTexture(MxString(path), format);
+        return AssetManager::LoadTextureAsync(ToMxString(path), format, placeholder, usage);
+    }
+
+    TextureHandle AssetManager::LoadTextureAsync(const MxString& path, TextureFormat format, const Vector3& placeholder, TextureUsage usage)
+    {
+        // streamed and synchronously loaded textures share cache entries, so texture may still be pending when returned by LoadTexture
+        auto texture = FindCachedAsset<Texture, GraphicFactory>(*impl, AssetType::TEXTURE, path, GetTextureVariant(format, usage));
+        if (texture.IsValid()) return texture;
+
+        // streamer owns image until it is uploaded, so shared embedded image is copied
+        auto embedded = FindEmbeddedTexture(*impl, path);
+        if (embedded != nullptr)
+            texture = TextureStreamer::Load(CopyImage(*embedded), path, format, placeholder);
+        else
+            texture = TextureStreamer::Load(path, format, placeholder);
+        CacheAsset(*impl, AssetType::TEXTURE, path, GetTextureVariant(format, usage), texture);
+        return texture;
+    }
+
+    TextureHandle AssetManager::LoadTextureAsync(const char* path, TextureFormat format, const Vector3& placeholder, TextureUsage usage)
+    {
+        return AssetManager::LoadTextureAsync(MxString(path), format, placeholder, usage);
     }
 
     ShaderHandle AssetManager::LoadShader(StringId vertex, StringId fragment)
@@ -178,7 +822,14 @@ namespace MxEngine
 
     MeshHandle AssetManager::LoadMesh(const MxString& path)
     {
-        return ResourceFactory::Create<Mesh>(path);
+        // pending mesh cannot be waited on main thread, so only completely loaded meshes are reused
+        size_t variant = GetMeshImportVariant(Mesh::GetImportSettings());
+        auto mesh = FindCachedAsset<Mesh, ResourceFactory>(*impl, AssetType::MESH, path, variant, [](const Mesh& mesh) { return mesh.IsReady(); });
+        if (mesh.IsValid()) return mesh;
+
+        mesh = ResourceFactory::Create<Mesh>(path);
+        CacheAsset(*impl, AssetType::MESH, path, variant, mesh);
+        return mesh;
     }
 
     MeshHandle AssetManager::LoadMesh(const char* path)
@@ -186,6 +837,48 @@ namespace MxEngine
         return AssetManager::LoadMesh(MxString(path));
     }
 
+    MeshHandle AssetManager::LoadMeshAsync(StringId hash)
+    {
+        return AssetManager::LoadMeshAsync(FileManager::GetFilePath(hash));
+    }
+
+    MeshHandle AssetManager::LoadMeshAsync(const FilePath& path)
+    {
+        return AssetManager::LoadMeshAsync(ToMxString(path));
+    }
+
+    MeshHandle AssetManager::LoadMeshAsync(const MxString& path)
+    {
+        auto settings = Mesh::GetImportSettings();
+        size_t variant = GetMeshImportVariant(settings);
+        auto mesh = FindCachedAsset<Mesh, ResourceFactory>(*impl, AssetType::MESH, path, variant, 
+            [](const Mesh& mesh) { return mesh.GetStatus() != MeshStatus::FAILED; });
+        if (mesh.IsValid()) return mesh;
+
+        mesh = ResourceFactory::Create<Mesh>();
+        CacheAsset(*impl, AssetType::MESH, path, variant, mesh);
+        auto state = MakeRef<MeshLoadingState>();
+        state->Path = path;
+        state->Settings = settings;
+        state->Start(mesh);
+        state->ImportGroup = ThreadPool::CreateTaskGroup();
+        impl->PendingMeshImports[MeshRenderer::GetMaterialLibraryPath(path)] = state;
+
+        // state is moved between tasks, so its last reference is always released on main thread
+        TaskGroup group = state->ImportGroup;
+        ThreadPool::Submit(group, [state = std::move(state)]() mutable
+        {
+            state->Import();
+            ThreadPool::SubmitToMainThread([state = std::move(state)]() mutable { state->UploadSubmesh(std::move(state)); });
+        });
+        return mesh;
+    }
+
+    MeshHandle AssetManager::LoadMeshAsync(const char* path)
+    {
+        return AssetManager::LoadMeshAsync(MxString(path));
+    }
+
     MxVector<MaterialHandle> AssetManager::LoadMaterials(StringId hash)
     {
         return AssetManager::LoadMaterials(FileManager::GetFilePath(hash));
@@ -206,6 +899,41 @@ namespace MxEngine
         return AssetManager::LoadMaterials(MxString(path));
     }
 
+    MaterialLibraryFuture AssetManager::LoadMaterialsAsync(StringId hash)
+    {
+        return AssetManager::LoadMaterialsAsync(FileManager::GetFilePath(hash));
+    }
+
+    MaterialLibraryFuture AssetManager::LoadMaterialsAsync(const FilePath& path)
+    {
+        return AssetManager::LoadMaterialsAsync(ToMxString(path));
+    }
+
+    MaterialLibraryFuture AssetManager::LoadMaterialsAsync(const MxString& path)
+    {
+        auto state = MakeRef<MaterialLoadingState>();
+        state->Path = MeshRenderer::GetMaterialLibraryPath(path);
+        auto& imports = AssetManager::GetImpl()->PendingMeshImports;
+        if (auto import = imports.find(state->Path); import != imports.end())
+        {
+            state->Dependency = import->second->ImportFuture;
+            state->DependencyGroup = import->second->ImportGroup;
+        }
+        auto future = state->Completion.get_future().share();
+
+        ThreadPool::Submit([state = std::move(state)]() mutable
+        {
+            state->Load();
+            ThreadPool::SubmitToMainThread([state = std::move(state)]() { state->CreateMaterials(); });
+        });
+        return future;
+    }
+
+    MaterialLibraryFuture AssetManager::LoadMaterialsAsync(const char* path)
+    {
+        return AssetManager::LoadMaterialsAsync(MxString(path));
+    }
+
     AudioBufferHandle AssetManager::LoadAudio(StringId hash)
     {
         return AssetManager::LoadAudio(FileManager::GetFilePath(hash));
@@ -218,8 +946,21 @@ namespace MxEngine
 
     AudioBufferHandle AssetManager::LoadAudio(const MxString& filepath)
     {
-        auto buffer = AudioFactory::Create<AudioBuffer>();
-        buffer->Load(filepath);
+        auto buffer = FindCachedAsset<AudioBuffer, AudioFactory>(*impl, AssetType::AUDIO, filepath, GetAudioVariant());
+        if (buffer.IsValid()) return buffer;
+
+        AudioLoadingState state;
+        state.Path = filepath;
+        state.UseCache = Application::GetImpl()->GetConfig().UseAudioCache;
+        state.Frequency = Application::GetImpl()->GetConfig().AudioSampleRate;
+        state.Decode();
+        if (state.Audio.data == nullptr)
+            MXLOG_ERROR("MxEngine::AssetManager", "audio file was not loaded: " + filepath);
+
+        buffer = AudioFactory::Create<AudioBuffer>();
+        state.Upload(*buffer);
+        state.Release();
+        CacheAsset(*impl, AssetType::AUDIO, filepath, GetAudioVariant(), buffer);
         return buffer;
     }
 
@@ -227,4 +968,57 @@ namespace MxEngine
     {
         return AssetManager::LoadAudio(MxString(filepath));
     }
+
+    AudioBufferHandle AssetManager::LoadAudioAsync(StringId hash)
+    {
+        return AssetManager::LoadAudioAsync(FileManager::GetFilePath(hash));
+    }
+
+    AudioBufferHandle AssetManager::LoadAudioAsync(const FilePath& filepath)
+    {
+        return AssetManager::LoadAudioAsync(ToMxString(filepath));
+    }
+
+    AudioBufferHandle AssetManager::LoadAudioAsync(const MxString& filepath)
+    {
+        // synchronously loaded and pending buffers share cache entries, so buffer may still be pending when returned by LoadAudio
+        auto buffer = FindCachedAsset<AudioBuffer, AudioFactory>(*impl, AssetType::AUDIO, filepath, GetAudioVariant(),
+            [](const AudioBuffer& buffer) { return buffer.GetStatus() != AudioBufferStatus::FAILED; });
+        if (buffer.IsValid()) return buffer;
+
+        buffer = AudioFactory::Create<AudioBuffer>();
+        buffer->SetPending();
+        CacheAsset(*impl, AssetType::AUDIO, filepath, GetAudioVariant(), buffer);
+
+        auto state = MakeRef<AudioLoadingState>();
+        state->BufferUUID = buffer.GetUUID();
+        state->ResourceHandle = buffer.GetHandle();
+        state->Path = filepath;
+        state->UseCache = Application::GetImpl()->GetConfig().UseAudioCache;
+        state->Frequency = Application::GetImpl()->GetConfig().AudioSampleRate;
+
+        // decoding, mono conversion and resampling are done by worker, samples are uploaded on main thread as audio resources are not thread-safe
+        ThreadPool::Submit([state = std::move(state)]() mutable
+        {
+            state->Decode();
+            ThreadPool::SubmitToMainThread([state = std::move(state)]()
+            {
+                MAKE_SCOPE_PROFILER("AssetManager::UploadAudio()");
+                AudioBufferHandle buffer(state->BufferUUID, state->ResourceHandle);
+                if (buffer.IsValid())
+                {
+                    if (state->Audio.data == nullptr)
+                        MXLOG_WARNING("MxEngine::AssetManager", "failed to load audio asynchronously: " + state->Path);
+                    state->Upload(*buffer);
+                }
+                state->Release();
+            });
+        });
+        return buffer;
+    }
+
+    AudioBufferHandle AssetManager::LoadAudioAsync(const char* filepath)
+    {
+        return AssetManager::LoadAudioAsync(MxString(filepath));
+    }
 }
\ No newline at end of file
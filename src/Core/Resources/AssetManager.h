@@ -33,6 +33,10 @@
 #include "Core/Resources/Material.h"
 #include "Platform/GraphicAPI.h"
 #include "Platform/AudioAPI.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/STL/MxHashMap.h"
+
+#include <mutex>
 
 namespace MxEngine
 {
@@ -40,10 +44,131 @@ namespace MxEngine
 
     using MaterialHandle = Resource<Material, ResourceFactory>;
     using MeshHandle = Resource<Mesh, ResourceFactory>;
+    using MaterialLibraryFuture = std::shared_future<MxVector<MaterialHandle>>;
+
+    struct MeshLoadingState;
+
+    enum class AssetType : uint8_t
+    {
+        TEXTURE,
+        CUBEMAP,
+        MESH,
+        AUDIO,
+    };
+
+    const char* EnumToString(AssetType type);
+
+    /*!
+    hint how texture is sampled, which selects block compression if texture compression is enabled.
+    Color textures use BC1 / BC3, normal maps store only X and Y in BC5 (Z is reconstructed in shaders),
+    data textures (height, roughness and etc.) are never compressed with formats which correlate channels
+    */
+    enum class TextureUsage : uint8_t
+    {
+        COLOR,
+        NORMAL,
+        DATA,
+    };
+
+    const char* EnumToString(TextureUsage usage);
+
+    /*!
+    weak reference to loaded asset. Cache does not own resources, so they are destroyed when last handle is released
+    */
+    struct AssetCacheEntry
+    {
+        MxString Path;
+        AssetType Type = AssetType::TEXTURE;
+        size_t Variant = 0; // texture format or mesh import flags
+        UUID ResourceUUID;
+        size_t ResourceHandle = 0;
+    };
+
+    struct AssetCacheRecord
+    {
+        MxString Path;
+        AssetType Type = AssetType::TEXTURE;
+        size_t ByteSize = 0;
+        size_t ReferenceCount = 0;
+    };
+
+    struct AssetCacheReport
+    {
+        MxVector<AssetCacheRecord> Records;
+        size_t TextureBytes = 0;
+        size_t CubeMapBytes = 0;
+        size_t MeshBytes = 0;
+        size_t AudioBytes = 0;
+        size_t TotalBytes = 0;
+        size_t ExpiredEntries = 0;
+        size_t CacheHits = 0;
+        size_t CacheMisses = 0;
+    };
 
+    /*!
+    decoded texture which was embedded into imported object. It is kept while object mesh stays in asset cache,
+    so materials of cached mesh can be created again after their textures were destroyed
+    */
+    struct EmbeddedTextureEntry
+    {
+        Ref<Image> Data;
+        MxString ObjectPath;
+    };
+
+    struct AssetManagerImpl
+    {
+        MxHashMap<size_t, AssetCacheEntry> Cache;
+        /*!
+        meshes which are imported by LoadMeshAsync, keyed by their material library path. Accessed only from main thread
+        */
+        MxHashMap<MxString, Ref<MeshLoadingState>> PendingMeshImports;
+        /*!
+        decoded textures which were embedded into imported objects, keyed by their normalized virtual path. Objects are imported on worker threads, so access is guarded by mutex
+        */
+        MxHashMap<MxString, EmbeddedTextureEntry> EmbeddedTextures;
+        std::mutex EmbeddedTexturesMutex;
+        size_t CacheHits = 0;
+        size_t CacheMisses = 0;
+    };
+
+    /*!
+    asset manager loads engine resources from files. Textures, cubemaps, meshes and audio buffers are cached by their path and format,
+    so repeated loads of the same file return the same handle. Cached resources are shared, so they should not be reloaded in place -
+    create resource using its factory directly if an independent copy is needed
+    */
     class AssetManager
     {
+        inline static AssetManagerImpl* impl = nullptr;
     public:
+        static void Init();
+        static void Destroy();
+        static AssetManagerImpl* GetImpl();
+        static void Clone(AssetManagerImpl* other);
+
+        /*!
+        removes all cache entries of the file, so next load of it creates new resource. Already loaded resources are not affected
+        \param path path to an asset file
+        */
+        static void EvictCache(const MxString& path);
+        /*!
+        removes cache entries of assets which were already destroyed
+        \returns number of removed entries
+        */
+        static size_t EvictExpiredCache();
+        static void ClearCache();
+        /*!
+        registers decoded textures which were embedded into object file, so materials can reference them without image files on disk.
+        Images are kept in memory until mesh of object is evicted from cache by EvictExpiredCache() or ClearCache(). Can be called from any thread
+        \param textures embedded textures of imported object. Images are moved out of the list
+        \param objectPath path to object file which textures were embedded into
+        */
+        static void AddEmbeddedTextures(MxVector<EmbeddedTexture>& textures, const MxString& objectPath);
+        /*!
+        collects memory usage of all alive cached assets. Byte sizes are estimated from resource dimensions
+        \returns report with per-asset records sorted by byte size
+        */
+        static AssetCacheReport GetCacheReport();
+
         static CubeMapHandle LoadCubeMap(StringId hash);
         static CubeMapHandle LoadCubeMap(const FilePath& path);
         static CubeMapHandle LoadCubeMap(const MxString& path);
@@ -53,10 +178,23 @@ namespace MxEngine
         static CubeMapHandle LoadCubeMap(const MxString& right, const MxString& left, const MxString& top, const MxString& bottom, const MxString& front, const MxString& back);
         static CubeMapHandle LoadCubeMap(const char* right, const char* left, const char* top, const char* bottom, const char* front, const char* back);
 
-        static TextureHandle LoadTexture(StringId hash, TextureFormat format = TextureFormat::RGB);
-        static TextureHandle LoadTexture(const FilePath& path, TextureFormat format = TextureFormat::RGB);
-        static TextureHandle LoadTexture(const MxString& path, TextureFormat format = TextureFormat::RGB);
-        static TextureHandle LoadTexture(const char* path, TextureFormat format = TextureFormat::RGB);
+        static TextureHandle LoadTexture(StringId hash, TextureFormat format = TextureFormat::RGB, TextureUsage usage = TextureUsage::COLOR);
+        static TextureHandle LoadTexture(const FilePath& path, TextureFormat format = TextureFormat::RGB, TextureUsage usage = TextureUsage::COLOR);
+        static TextureHandle LoadTexture(const MxString& path, TextureFormat format = TextureFormat::RGB, TextureUsage usage = TextureUsage::COLOR);
+        static TextureHandle LoadTexture(const char* path, TextureFormat format = TextureFormat::RGB, TextureUsage usage = TextureUsage::COLOR);
+
+        /*!
+        loads texture asynchronously. Image is decoded on worker thread and uploaded by TextureStreamer under per-frame byte budget
+        \param path path to an image file
+        \param format texture format
+        \param placeholder color which texture contains until upload is finished
+        \param usage sampling hint. Streamed textures are not compressed, but it is part of asset cache key shared with LoadTexture()
+        \returns texture handle which contains 1x1 placeholder until upload is finished (see TextureStreamer::IsPending())
+        */
+        static TextureHandle LoadTextureAsync(StringId hash, TextureFormat format = TextureFormat::RGB, const Vector3& placeholder = MakeVector3(0.5f), TextureUsage usage = TextureUsage::COLOR);
+        static TextureHandle LoadTextureAsync(const FilePath& path, TextureFormat format = TextureFormat::RGB, const Vector3& placeholder = MakeVector3(0.5f), TextureUsage usage = TextureUsage::COLOR);
+        static TextureHandle LoadTextureAsync(const MxString& path, TextureFormat format = TextureFormat::RGB, const Vector3& placeholder = MakeVector3(0.5f), TextureUsage usage = TextureUsage::COLOR);
+        static TextureHandle LoadTextureAsync(const char* path, TextureFormat format = TextureFormat::RGB, const Vector3& placeholder = MakeVector3(0.5f), TextureUsage usage = TextureUsage::COLOR);
 
         static ShaderHandle LoadShader(StringId vertex, StringId fragment);
         static ShaderHandle LoadShader(const FilePath& vertex, const FilePath& fragment);
@@ -77,14 +215,44 @@ namespace MxEngine
         static MeshHandle LoadMesh(const MxString& path);
         static MeshHandle LoadMesh(const char* path);
 
+        /*!
+        loads mesh asynchronously. Object is imported on worker thread, submeshes are uploaded on main thread under per-frame time budget
+        \param path path to an object file
+        \returns mesh handle in PENDING state. Mesh has no submeshes until it becomes READY (see Mesh::GetStatus())
+        */
+        static MeshHandle LoadMeshAsync(StringId hash);
+        static MeshHandle LoadMeshAsync(const FilePath& path);
+        static MeshHandle LoadMeshAsync(const MxString& path);
+        static MeshHandle LoadMeshAsync(const char* path);
+
         static MxVector<MaterialHandle> LoadMaterials(StringId hash);
         static MxVector<MaterialHandle> LoadMaterials(const FilePath& path);
         static MxVector<MaterialHandle> LoadMaterials(const MxString& path);
         static MxVector<MaterialHandle> LoadMaterials(const char* path);
 
+        /*!
+        loads material library asynchronously. If mesh with same path is being imported by LoadMeshAsync, materials are loaded after it
+        \param path path to an object file or to its material library
+        \returns future which holds materials when they are created on main thread, or exception if mesh import or library loading failed. Do not wait for it on main thread
+        */
+        static MaterialLibraryFuture LoadMaterialsAsync(StringId hash);
+        static MaterialLibraryFuture LoadMaterialsAsync(const FilePath& path);
+        static MaterialLibraryFuture LoadMaterialsAsync(const MxString& path);
+        static MaterialLibraryFuture LoadMaterialsAsync(const char* path);
+
         static AudioBufferHandle LoadAudio(StringId hash);
         static AudioBufferHandle LoadAudio(const FilePath& path);
         static AudioBufferHandle LoadAudio(const MxString& path);
         static AudioBufferHandle LoadAudio(const char* path);
+        /*!
+        loads audio file asynchronously. File is decoded, converted to mono and resampled to engine sampling rate on worker thread, samples are uploaded on main thread.
+        If audio cache is enabled in config, decoded samples are taken from or saved to .mxpcm file next to audio source
+        \param path path to audio file
+        \returns audio buffer handle which can be attached to audio source immediately. It starts playing when buffer is ready
+        */
+        static AudioBufferHandle LoadAudioAsync(StringId hash);
+        static AudioBufferHandle LoadAudioAsync(const FilePath& path);
+        static AudioBufferHandle LoadAudioAsync(const MxString& path);
+        static AudioBufferHandle LoadAudioAsync(const char* path);
     };
 }
\ No newline at end of file
@@ -31,7 +31,11 @@
 #include "Utilities/Profiler/Profiler.h"
 #include "Platform/GraphicAPI.h"
 #include "Utilities/LODGenerator/LODGenerator.h"
+#include "Utilities/MeshOptimizer/MeshOptimizer.h"
+#include "Utilities/MeshCache/MeshCache.h"
+#include "Core/Application/Application.h"
 #include "Utilities/Format/Format.h"
+#include "Utilities/Logging/Logger.h"
 #include "Core/Resources/AssetManager.h"
 #include "Core/Components/Rendering/MeshRenderer.h"
 
@@ -39,30 +43,64 @@
 
 namespace MxEngine
 {
-	void Mesh::LoadFromFile(const MxString& filepath)
+	const char* EnumToString(MeshStatus status)
 	{
-		ObjectInfo objectInfo = ObjectLoader::Load(filepath);
-		MxVector<TransformComponent::Handle> submeshTransforms;
-
-		submeshTransforms.reserve(objectInfo.meshes.size());
-		for (size_t i = 0; i < objectInfo.meshes.size(); i++)
+		switch (status)
 		{
-			submeshTransforms.push_back(ComponentFactory::CreateComponent<TransformComponent>());
+		case MeshStatus::READY:
+			return "READY";
+		case MeshStatus::PENDING:
+			return "PENDING";
+		case MeshStatus::FAILED:
+			return "FAILED";
+		default:
+			return "READY";
 		}
+	}
+
+	enum MeshImportFlags : uint32_t
+	{
+		MESH_IMPORT_OPTIMIZE = 1 << 0,
+		MESH_IMPORT_EXPORT_TEXTURES = 1 << 1,
+	};
 
-		MxVector<SubMesh::MaterialId> materialIds;
-		materialIds.reserve(objectInfo.meshes.size());
-		for (const auto& group : objectInfo.meshes)
+	MeshImportSettings Mesh::GetImportSettings()
+	{
+		const auto& config = Application::GetImpl()->GetConfig();
+		MeshImportSettings settings;
+		settings.UseCache = config.UseMeshCache;
+		settings.Optimize = config.OptimizeImportedMeshes;
+		settings.BuildClusters = config.BuildMeshClusters;
+		settings.ExportEmbeddedTextures = config.ExportEmbeddedTextures;
+		return settings;
+	}
+
+	ObjectInfo Mesh::ImportObject(const MxString& filepath, const MeshImportSettings& settings)
+	{
+		ObjectInfo objectInfo;
+		// cached objects are stored after optimization and texture export, so cache built with other settings must be rebuilt
+		uint32_t importFlags = (settings.Optimize ? MESH_IMPORT_OPTIMIZE : 0) | (settings.ExportEmbeddedTextures ? MESH_IMPORT_EXPORT_TEXTURES : 0);
+		if (!settings.UseCache || !MeshCache::Load(filepath, objectInfo, importFlags))
 		{
-			if (group.useTexture && group.material != nullptr)
+			objectInfo = ObjectLoader::Load(filepath, settings.ExportEmbeddedTextures);
+			if (settings.Optimize)
 			{
-				auto offset = size_t(group.material - objectInfo.materials.data());
-				materialIds.push_back(offset);
-			}
-			else
-			{
-				materialIds.push_back(std::numeric_limits<SubMesh::MaterialId>::max());
+				for (auto& meshInfo : objectInfo.meshes)
+				{
+					meshInfo.optimization = MeshOptimizer::Optimize(meshInfo.vertecies, meshInfo.indicies);
+					const auto& report = meshInfo.optimization;
+					MXLOG_DEBUG("MxEngine::Mesh", MxFormat("optimized submesh {0}: ACMR {1} -> {2}, ATVR {3} -> {4}", meshInfo.name.c_str(),
+						report.Before.ACMR, report.After.ACMR, report.Before.ATVR, report.After.ATVR));
+				}
 			}
+			if (settings.UseCache && !objectInfo.meshes.empty())
+				MeshCache::Save(objectInfo, filepath, importFlags);
+		}
+
+		if (settings.BuildClusters)
+		{
+			for (auto& meshInfo : objectInfo.meshes)
+				meshInfo.clusters = ClusterBuilder::Build(meshInfo.vertecies, meshInfo.indicies);
 		}
 
 		if (!objectInfo.materials.empty())
@@ -71,23 +109,41 @@ namespace MxEngine
 			auto materialLibPath = filepath + MeshRenderer::GetMaterialFileSuffix();
 			ObjectLoader::DumpMaterials(objectInfo.materials, materialLibPath);
 		}
-		
+		// embedded textures are referenced by materials through virtual paths, so they must be available before materials are loaded
+		if (!objectInfo.textures.empty())
+			AssetManager::AddEmbeddedTextures(objectInfo.textures, filepath);
+		return objectInfo;
+	}
+
+	SubMesh Mesh::CreateSubmesh(ObjectInfo& object, size_t index)
+	{
+		auto& meshInfo = object.meshes[index];
+		auto materialId = std::numeric_limits<SubMesh::MaterialId>::max();
+		if (meshInfo.useTexture && meshInfo.material != nullptr)
+			materialId = size_t(meshInfo.material - object.materials.data());
+
+		SubMesh submesh(materialId, ComponentFactory::CreateComponent<TransformComponent>());
+		submesh.Data.GetVertecies() = std::move(meshInfo.vertecies);
+		submesh.Data.GetIndicies() = std::move(meshInfo.indicies);
+		submesh.Data.BufferVertecies();
+		submesh.Data.BufferIndicies();
+		submesh.Data.UpdateBoundingGeometry();
+		if (!meshInfo.clusters.empty()) submesh.Data.SetClusters(std::move(meshInfo.clusters));
+		submesh.Name = std::move(meshInfo.name);
+		submesh.Optimization = meshInfo.optimization;
+		return submesh;
+	}
+
+	void Mesh::LoadFromFile(const MxString& filepath)
+	{
+		ObjectInfo objectInfo = Mesh::ImportObject(filepath, Mesh::GetImportSettings());
+
+		this->Submeshes.reserve(objectInfo.meshes.size());
 		for (size_t i = 0; i < objectInfo.meshes.size(); i++)
 		{
-			auto& meshData = objectInfo.meshes[i];
-			auto& materialId = materialIds[i];
-			auto& transform = submeshTransforms[i];
-
-			SubMesh submesh(materialId, transform);
-			submesh.Data.GetVertecies() = std::move(meshData.vertecies);
-			submesh.Data.GetIndicies() = std::move(meshData.indicies);
-			submesh.Data.BufferVertecies();
-			submesh.Data.BufferIndicies();
-			submesh.Data.UpdateBoundingGeometry();
-			submesh.Name = std::move(meshData.name);
-
-			this->Submeshes.push_back(std::move(submesh));
+			this->Submeshes.push_back(Mesh::CreateSubmesh(objectInfo, i));
 		}
+		this->status = objectInfo.meshes.empty() ? MeshStatus::FAILED : MeshStatus::READY;
 		this->UpdateBoundingGeometry(); // use submeshes boundings to update mesh boundings
 	}
 
@@ -126,6 +182,22 @@ namespace MxEngine
 		this->SphereBounding = MxEngine::BoundingSphere(center, maxRadius);
 	}
 
+	void Mesh::SetVertexFormat(VertexFormat format)
+	{
+		for (auto& mesh : this->Submeshes)
+		{
+			if (mesh.Data.GetVertexFormat() == format) continue;
+			mesh.Data.SetVertexFormat(format);
+			if (mesh.Data.GetVertexFormat() != format) continue; // format change was rejected
+
+			// VAO was recreated, so instanced buffers must be attached again
+			for (size_t i = 0; i < this->VBOs.size(); i++)
+			{
+				mesh.Data.GetVAO()->AddInstancedBuffer(*this->VBOs[i], *this->VBLs[i]);
+			}
+		}
+	}
+
 	size_t Mesh::AddInstancedBuffer(VertexBufferHandle vbo, VertexBufferLayoutHandle vbl)
 	{
 		this->VBOs.push_back(std::move(vbo));
@@ -154,6 +226,21 @@ namespace MxEngine
 		return this->VBOs.size();
     }
 
+    MeshStatus Mesh::GetStatus() const
+    {
+		return this->status;
+    }
+
+    bool Mesh::IsReady() const
+    {
+		return this->status == MeshStatus::READY;
+    }
+
+    std::shared_future<void> Mesh::GetFuture() const
+    {
+		return this->loadFuture;
+    }
+
     void Mesh::PopInstancedBuffer()
     {
 		MX_ASSERT(!this->VBOs.empty());
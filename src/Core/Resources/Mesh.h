@@ -34,10 +34,35 @@
 #include "Utilities/Memory/Memory.h"
 #include "Platform/GraphicAPI.h"
 #include "Core/Resources/SubMesh.h"
+#include "Utilities/ObjectLoader/ObjectLoader.h"
+
+#include <future>
 
 namespace MxEngine
 {
 	class MeshRenderer;
+
+	/*!
+	import settings which are applied to object data before it is uploaded to GPU
+	*/
+	struct MeshImportSettings
+	{
+		bool UseCache = true;
+		bool Optimize = false;
+		bool BuildClusters = false;
+		bool ExportEmbeddedTextures = false;
+	};
+
+	enum class MeshStatus : uint8_t
+	{
+		READY,
+		PENDING,
+		FAILED,
+	};
+
+	const char* EnumToString(MeshStatus status);
+
+	struct MeshLoadingState;
 	
 	class Mesh
 	{
@@ -45,8 +70,12 @@ namespace MxEngine
 		
 		MxVector<VertexBufferHandle> VBOs;
 		MxVector<VertexBufferLayoutHandle> VBLs;
+		std::shared_future<void> loadFuture;
+		MeshStatus status = MeshStatus::READY;
 
 		void LoadFromFile(const MxString& filepath);
+
+		friend struct MeshLoadingState;
 	public:
 		AABB BoxBounding;
 		BoundingSphere SphereBounding;
@@ -61,10 +90,37 @@ namespace MxEngine
 		
 		void Load(const MxString& filepath);
 		void UpdateBoundingGeometry();
+		void SetVertexFormat(VertexFormat format);
 		size_t AddInstancedBuffer(VertexBufferHandle vbo, VertexBufferLayoutHandle vbl);
 		VertexBufferHandle GetBufferByIndex(size_t index) const; 
 		VertexBufferLayoutHandle GetBufferLayoutByIndex(size_t index) const;
 		size_t GetBufferCount() const;
 		void PopInstancedBuffer();
+		MeshStatus GetStatus() const;
+		bool IsReady() const;
+		/*!
+		gets future of asynchronous mesh loading (see AssetManager::LoadMeshAsync)
+		\returns future which becomes ready when all submeshes are uploaded. Do not wait for it on main thread, as uploads are done there
+		*/
+		std::shared_future<void> GetFuture() const;
+
+		/*!
+		gets import settings specified in application config. Must be called from main thread
+		*/
+		static MeshImportSettings GetImportSettings();
+		/*!
+		loads object from disk (or from .mxmesh cache) and prepares it for upload. Does not create any engine resources, so can be called from worker threads
+		\param filepath path to an object file
+		\param settings import settings to apply to object data
+		\returns ObjectInfo instance. If loading failed, object contains no meshes. Embedded textures are moved to AssetManager, so object contains none
+		*/
+		static ObjectInfo ImportObject(const MxString& filepath, const MeshImportSettings& settings);
+		/*!
+		creates submesh from imported object data and uploads it to GPU. Must be called from main thread
+		\param object object info returned by ImportObject()
+		\param index index of mesh in object. Its CPU data is moved into created submesh
+		\returns submesh with buffered mesh data
+		*/
+		static SubMesh CreateSubmesh(ObjectInfo& object, size_t index);
 	};
 }
\ No newline at end of file
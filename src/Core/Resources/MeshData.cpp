@@ -27,22 +27,41 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "MeshData.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/GeometryKernels/GeometryKernels.h"
 
 namespace MxEngine
 {
+    VertexBufferLayoutHandle MeshData::MakeVertexLayout(VertexFormat format)
+    {
+        auto VBL = GraphicFactory::Create<VertexBufferLayout>();
+        if (format == VertexFormat::PACKED)
+        {
+            // attribute count must match full format, as instanced buffers are attached right after vertex attributes
+            VBL->PushUnsignedShort(3, true); // position relative to AABB
+            VBL->PushHalfFloat(2);           // texture
+            VBL->PushShort(2, true);         // octahedral normal
+            VBL->PushShort(2, true);         // octahedral tangent
+            VBL->PushShort(1, true);         // bitangent sign
+        }
+        else
+        {
+            VBL->PushFloat(3); // position //-V525
+            VBL->PushFloat(2); // texture
+            VBL->PushFloat(3); // normal
+            VBL->PushFloat(3); // tangent
+            VBL->PushFloat(3); // bitangent
+        }
+        return VBL;
+    }
+
     MeshData::MeshData()
     {
         this->VBO = GraphicFactory::Create<VertexBuffer>();
         this->VAO = GraphicFactory::Create<VertexArray>();
         this->IBO = GraphicFactory::Create<IndexBuffer>();
 
-        auto VBL = GraphicFactory::Create<VertexBufferLayout>();
-        VBL->PushFloat(3); // position //-V525
-        VBL->PushFloat(2); // texture
-        VBL->PushFloat(3); // normal
-        VBL->PushFloat(3); // tangent
-        VBL->PushFloat(3); // bitangent
-
+        auto VBL = MeshData::MakeVertexLayout(this->vertexFormat);
         this->VAO->AddBuffer(*this->VBO, *VBL);
     }
 
@@ -92,8 +111,90 @@ namespace MxEngine
 
     void MeshData::BufferVertecies(UsageType usageType)
     {
-        auto data = reinterpret_cast<float*>(this->vertecies.data());
-        this->VBO->Load(data, this->vertecies.size() * Vertex::Size, usageType);
+        if (this->vertexFormat == VertexFormat::PACKED)
+        {
+            this->packingBounds = ComputePackingBounds(this->vertecies);
+            auto packed = PackVertecies(this->vertecies, this->packingBounds);
+            auto data = reinterpret_cast<float*>(packed.data());
+            this->VBO->Load(data, packed.size() * PackedVertex::Size, usageType);
+            this->quantizationReport = ComputeQuantizationReport(this->vertecies);
+        }
+        else
+        {
+            auto data = reinterpret_cast<float*>(this->vertecies.data());
+            this->VBO->Load(data, this->vertecies.size() * Vertex::Size, usageType);
+            this->quantizationReport = VertexQuantizationReport{ };
+        }
+    }
+
+    void MeshData::SetVertexFormat(VertexFormat format)
+    {
+        if (this->vertexFormat == format) return;
+        if (this->vertecies.empty() && this->VBO->GetSize() > 0)
+        {
+            MXLOG_WARNING("MxEngine::MeshData", "vertex format cannot be changed as CPU copy of vertecies was freed");
+            return;
+        }
+        this->vertexFormat = format;
+
+        this->VAO = GraphicFactory::Create<VertexArray>();
+        auto VBL = MeshData::MakeVertexLayout(this->vertexFormat);
+        this->VAO->AddBuffer(*this->VBO, *VBL);
+
+        if (!this->vertecies.empty())
+            this->BufferVertecies();
+    }
+
+    VertexFormat MeshData::GetVertexFormat() const
+    {
+        return this->vertexFormat;
+    }
+
+    Vector4 MeshData::GetPositionDecodeOffset() const
+    {
+        if (this->vertexFormat == VertexFormat::PACKED)
+            return Vector4(this->packingBounds.Min, 0.0f);
+        else
+            return Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    Vector4 MeshData::GetPositionDecodeScale() const
+    {
+        if (this->vertexFormat == VertexFormat::PACKED)
+            return Vector4(this->packingBounds.Length(), 0.0f);
+        else
+            return Vector4(1.0f, 1.0f, 1.0f, 0.0f);
+    }
+
+    const VertexQuantizationReport& MeshData::GetQuantizationReport() const
+    {
+        return this->quantizationReport;
+    }
+
+    void MeshData::BuildClusters(size_t maxTrianglesPerCluster)
+    {
+        if (this->indicies.empty() && this->IBO->GetCount() != 0)
+        {
+            MXLOG_WARNING("MxEngine::MeshData", "cannot build clusters as mesh data copy was freed");
+            return;
+        }
+        this->clusters = ClusterBuilder::Build(this->vertecies, this->indicies, maxTrianglesPerCluster);
+        this->LoadIndexBuffer(); // indicies are reordered by clusters, which must be kept
+    }
+
+    void MeshData::SetClusters(MxVector<MeshCluster> clusters)
+    {
+        this->clusters = std::move(clusters);
+    }
+
+    void MeshData::ClearClusters()
+    {
+        this->clusters.clear();
+    }
+
+    const MxVector<MeshCluster>& MeshData::GetClusters() const
+    {
+        return this->clusters;
     }
 
     void MeshData::FreeMeshDataCopy()
@@ -102,123 +203,31 @@ namespace MxEngine
         this->vertecies.clear();
     }
 
-    void MeshData::BufferIndicies()
+    void MeshData::LoadIndexBuffer()
     {
         auto data = reinterpret_cast<uint32_t*>(this->indicies.data());
         this->IBO->Load(data, this->indicies.size());
     }
 
-    void MeshData::UpdateBoundingGeometry()
+    void MeshData::BufferIndicies()
     {
-        this->boundingBox = { MakeVector3(0.0f), MakeVector3(0.0f) };
-        if (vertecies.size() > 0)
-        {
-            this->boundingBox = { vertecies[0].Position, vertecies[0].Position };
-            for (const auto& vertex : vertecies)
-            {
-                this->boundingBox.Min = VectorMin(this->boundingBox.Min, vertex.Position);
-                this->boundingBox.Max = VectorMax(this->boundingBox.Max, vertex.Position);
-            }
-        }
+        // index buffer was changed by user, so cluster ranges are no longer valid even if index count is the same
+        this->LoadIndexBuffer();
+        this->ClearClusters();
+    }
 
-        auto center = this->boundingBox.GetCenter();
-        float maxRadius = 0.0f;
-        for (const auto& vertex : vertecies)
-        {
-            auto distance = vertex.Position - center;
-            maxRadius = Max(maxRadius, Length2(distance));
-        }
-        this->boundingSphere = BoundingSphere(center, std::sqrt(maxRadius));
+    void MeshData::UpdateBoundingGeometry()
+    {
+        GeometryKernels::ComputeBounds(this->vertecies, this->boundingBox, this->boundingSphere);
     }
 
     void MeshData::RegenerateNormals()
     {
-        // first set all normal-space vectors to 0
-        for (auto& vertex : vertecies)
-        {
-            vertex.Normal    = MakeVector3(0.0f);
-            vertex.Tangent   = MakeVector3(0.0f);
-            vertex.Bitangent = MakeVector3(0.0f);
-        }
-
-        // then compute normal space vectors for each triangle
-        for (size_t i = 0; i < indicies.size() / 3; i++)
-        {
-            std::array triangle = { // copy 3 vertecies
-                vertecies[indicies[3 * i + 0]],
-                vertecies[indicies[3 * i + 1]],
-                vertecies[indicies[3 * i + 2]],
-            };
-
-            auto normal = ComputeNormal(triangle[0].Position, triangle[1].Position, triangle[2].Position);
-            auto tanbitan = ComputeTangentSpace(
-                triangle[0].Position, triangle[1].Position, triangle[2].Position,
-                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
-            );
-
-            for (auto& vertex : triangle)
-            {
-                vertex.Normal += normal;
-                vertex.Tangent += tanbitan[0];
-                vertex.Bitangent += tanbitan[1];
-            }
-            
-            for (size_t j = 0; j < triangle.size(); j++)
-            {
-                vertecies[indicies[3 * i + j]] = triangle[j]; // reassign copied vertecies
-            }
-        }
-
-        // at the end normalize all normal-space vectors using vertex weights
-        for (size_t i = 0; i < vertecies.size(); i++)
-        {
-            vertecies[i].Normal    = Normalize(vertecies[i].Normal);
-            vertecies[i].Tangent   = Normalize(vertecies[i].Tangent);
-            vertecies[i].Bitangent = Normalize(vertecies[i].Bitangent);
-        }
+        GeometryKernels::ComputeTangentSpace(this->vertecies, this->indicies, true);
     }
 
-    // TODO: remove code dublication (see RegenerateNormals())
     void MeshData::RegenerateTangentSpace()
     {
-        // first set all normal-space vectors to 0
-        for (auto& vertex : vertecies)
-        {
-            vertex.Tangent = MakeVector3(0.0f);
-            vertex.Bitangent = MakeVector3(0.0f);
-        }
-
-        // then compute normal space vectors for each triangle
-        for (size_t i = 0; i < indicies.size() / 3; i++)
-        {
-            std::array triangle = { // copy 3 vertecies
-                vertecies[indicies[3 * i + 0]],
-                vertecies[indicies[3 * i + 1]],
-                vertecies[indicies[3 * i + 2]],
-            };
-
-            auto tanbitan = ComputeTangentSpace(
-                triangle[0].Position, triangle[1].Position, triangle[2].Position,
-                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
-            );
-
-            for (auto& vertex : triangle)
-            {
-                vertex.Tangent += tanbitan[0];
-                vertex.Bitangent += tanbitan[1];
-            }
-
-            for (size_t j = 0; j < triangle.size(); j++)
-            {
-                vertecies[indicies[3 * i + j]] = triangle[j]; // reassign copied vertecies
-            }
-        }
-
-        // at the end normalize all normal-space vectors using vertex weights
-        for (size_t i = 0; i < vertecies.size(); i++)
-        {
-            vertecies[i].Tangent = Normalize(vertecies[i].Tangent);
-            vertecies[i].Bitangent = Normalize(vertecies[i].Bitangent);
-        }
+        GeometryKernels::ComputeTangentSpace(this->vertecies, this->indicies, false);
     }
 }
\ No newline at end of file
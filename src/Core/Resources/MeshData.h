@@ -32,6 +32,8 @@
 #include "Platform/GraphicAPI.h"
 #include "Core/BoundingObjects/BoundingSphere.h"
 #include "Vertex.h"
+#include "PackedVertex.h"
+#include "Utilities/ClusterBuilder/ClusterBuilder.h"
 
 namespace MxEngine
 {
@@ -43,10 +45,17 @@ namespace MxEngine
         IndexData indicies;
         AABB boundingBox;
         BoundingSphere boundingSphere;
+        AABB packingBounds;
+        VertexFormat vertexFormat = VertexFormat::FULL;
+        MxVector<MeshCluster> clusters;
+        VertexQuantizationReport quantizationReport;
 
         VertexBufferHandle VBO;
         VertexArrayHandle VAO;
         IndexBufferHandle IBO;
+
+        static VertexBufferLayoutHandle MakeVertexLayout(VertexFormat format);
+        void LoadIndexBuffer();
     public:
         MeshData();
 
@@ -63,9 +72,43 @@ namespace MxEngine
         
         void BufferVertecies(UsageType usageType = UsageType::STATIC_DRAW);
         void FreeMeshDataCopy();
+        /*!
+        uploads indicies to GPU. Clusters reference ranges of old index buffer, so they are cleared and must be rebuilt or set again
+        */
         void BufferIndicies();
         void UpdateBoundingGeometry();
         void RegenerateNormals();
         void RegenerateTangentSpace();
+
+        /*!
+        changes vertex layout used on GPU side. CPU copy of vertecies is always stored in full precision
+        \warning VAO is recreated, so format must be set before any instanced buffers are attached (see Mesh::SetVertexFormat)
+        */
+        void SetVertexFormat(VertexFormat format);
+        VertexFormat GetVertexFormat() const;
+        /*!
+        vertex attribute values which shader uses to restore packed positions: object position = offset.xyz + scale.xyz * packed
+        for full precision format offset.w is equal to 1 (default attribute value), for packed format it is equal to 0
+        */
+        Vector4 GetPositionDecodeOffset() const;
+        Vector4 GetPositionDecodeScale() const;
+        /*!
+        gets precision loss of packed vertex format. Report is computed when packed vertecies are buffered, so it is cheap to query
+        \returns quantization report of last buffered vertecies. Empty if mesh uses full precision format
+        */
+        const VertexQuantizationReport& GetQuantizationReport() const;
+
+        /*!
+        splits mesh into clusters with their own bounds, so renderer can cull parts of mesh separately. Indicies are reordered and rebuffered
+        \param maxTrianglesPerCluster maximum number of triangles in one cluster (see ClusterBuilder)
+        */
+        void BuildClusters(size_t maxTrianglesPerCluster = ClusterBuilder::DefaultClusterSize);
+        /*!
+        sets clusters which were built in advance (for example by ClusterBuilder on worker thread)
+        \param clusters list of clusters. Must reference current index buffer, as indicies are not rebuffered
+        */
+        void SetClusters(MxVector<MeshCluster> clusters);
+        void ClearClusters();
+        const MxVector<MeshCluster>& GetClusters() const;
     };
 }
\ No newline at end of file
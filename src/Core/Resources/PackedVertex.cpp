@@ -0,0 +1,196 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "PackedVertex.h"
+
+#include <glm/gtc/packing.hpp>
+
+namespace MxEngine
+{
+    const char* EnumToString(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::FULL:
+            return "FULL";
+        case VertexFormat::PACKED:
+            return "PACKED";
+        default:
+            return "FULL";
+        }
+    }
+
+    static float SignNotZero(float x)
+    {
+        return x >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    static int16_t PackSnorm(float x)
+    {
+        return (int16_t)glm::packSnorm1x16(x);
+    }
+
+    static float UnpackSnorm(int16_t x)
+    {
+        return glm::unpackSnorm1x16((uint16_t)x);
+    }
+
+    static float AngleBetween(const Vector3& v1, const Vector3& v2)
+    {
+        float lengths = Length(v1) * Length(v2);
+        if (lengths == 0.0f) return 0.0f; //-V550
+        return Degrees(std::acos(Clamp(Dot(v1, v2) / lengths, -1.0f, 1.0f)));
+    }
+
+    Vector2 EncodeOctahedral(const Vector3& direction)
+    {
+        float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (sum == 0.0f) return MakeVector2(0.0f); //-V550
+
+        Vector3 n = direction / sum;
+        if (n.z >= 0.0f) return Vector2(n.x, n.y);
+        return Vector2(
+            (1.0f - std::abs(n.y)) * SignNotZero(n.x),
+            (1.0f - std::abs(n.x)) * SignNotZero(n.y)
+        );
+    }
+
+    Vector3 DecodeOctahedral(const Vector2& encoded)
+    {
+        Vector3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        if (n.z < 0.0f)
+        {
+            float x = (1.0f - std::abs(n.y)) * SignNotZero(n.x);
+            float y = (1.0f - std::abs(n.x)) * SignNotZero(n.y);
+            n.x = x;
+            n.y = y;
+        }
+        return Normalize(n);
+    }
+
+    PackedVertex PackVertex(const Vertex& vertex, const AABB& bounds)
+    {
+        PackedVertex result;
+        Vector3 length = bounds.Length();
+        for (int i = 0; i < 3; i++)
+        {
+            float t = length[i] > 0.0f ? (vertex.Position[i] - bounds.Min[i]) / length[i] : 0.0f;
+            result.Position[i] = glm::packUnorm1x16(t);
+        }
+
+        result.TexCoord[0] = glm::packHalf1x16(vertex.TexCoord.x);
+        result.TexCoord[1] = glm::packHalf1x16(vertex.TexCoord.y);
+
+        Vector2 normal = EncodeOctahedral(vertex.Normal);
+        Vector2 tangent = EncodeOctahedral(vertex.Tangent);
+        result.Normal[0] = PackSnorm(normal.x);
+        result.Normal[1] = PackSnorm(normal.y);
+        result.Tangent[0] = PackSnorm(tangent.x);
+        result.Tangent[1] = PackSnorm(tangent.y);
+
+        // bitangent is restored in shader as cross(N, T) * sign
+        float handedness = Dot(Cross(vertex.Normal, vertex.Tangent), vertex.Bitangent);
+        result.BitangentSign = PackSnorm(SignNotZero(handedness));
+        return result;
+    }
+
+    Vertex UnpackVertex(const PackedVertex& vertex, const AABB& bounds)
+    {
+        Vertex result;
+        Vector3 length = bounds.Length();
+        for (int i = 0; i < 3; i++)
+        {
+            float t = glm::unpackUnorm1x16(vertex.Position[i]);
+            result.Position[i] = bounds.Min[i] + t * length[i];
+        }
+
+        result.TexCoord.x = glm::unpackHalf1x16(vertex.TexCoord[0]);
+        result.TexCoord.y = glm::unpackHalf1x16(vertex.TexCoord[1]);
+
+        result.Normal = DecodeOctahedral(Vector2(UnpackSnorm(vertex.Normal[0]), UnpackSnorm(vertex.Normal[1])));
+        result.Tangent = DecodeOctahedral(Vector2(UnpackSnorm(vertex.Tangent[0]), UnpackSnorm(vertex.Tangent[1])));
+        result.Bitangent = Cross(result.Normal, result.Tangent) * SignNotZero(UnpackSnorm(vertex.BitangentSign));
+        return result;
+    }
+
+    AABB ComputePackingBounds(const MxVector<Vertex>& vertecies)
+    {
+        if (vertecies.empty()) return AABB{ };
+
+        AABB bounds{ vertecies.front().Position, vertecies.front().Position };
+        for (const auto& vertex : vertecies)
+        {
+            bounds.Min = VectorMin(bounds.Min, vertex.Position);
+            bounds.Max = VectorMax(bounds.Max, vertex.Position);
+        }
+        return bounds;
+    }
+
+    MxVector<PackedVertex> PackVertecies(const MxVector<Vertex>& vertecies, const AABB& bounds)
+    {
+        MxVector<PackedVertex> result;
+        result.reserve(vertecies.size());
+        for (const auto& vertex : vertecies)
+        {
+            result.push_back(PackVertex(vertex, bounds));
+        }
+        return result;
+    }
+
+    VertexQuantizationReport ComputeQuantizationReport(const MxVector<Vertex>& vertecies)
+    {
+        VertexQuantizationReport report;
+        report.VertexCount = vertecies.size();
+        report.FullSizeInBytes = vertecies.size() * sizeof(Vertex);
+        report.PackedSizeInBytes = vertecies.size() * sizeof(PackedVertex);
+
+        AABB bounds = ComputePackingBounds(vertecies);
+        float totalPositionError = 0.0f;
+        for (const auto& vertex : vertecies)
+        {
+            Vertex restored = UnpackVertex(PackVertex(vertex, bounds), bounds);
+
+            float positionError = Length(restored.Position - vertex.Position);
+            totalPositionError += positionError;
+            report.MaxPositionError = Max(report.MaxPositionError, positionError);
+
+            Vector2 texCoordError = restored.TexCoord - vertex.TexCoord;
+            report.MaxTexCoordError = Max(report.MaxTexCoordError, std::abs(texCoordError.x), std::abs(texCoordError.y));
+
+            report.MaxNormalError = Max(report.MaxNormalError, AngleBetween(restored.Normal, vertex.Normal));
+            report.MaxTangentError = Max(report.MaxTangentError, AngleBetween(restored.Tangent, vertex.Tangent));
+
+            if (Length2(vertex.Bitangent) > 0.0f && Dot(restored.Bitangent, vertex.Bitangent) < 0.0f)
+                report.BitangentSignMismatches++;
+        }
+        if (!vertecies.empty())
+            report.AveragePositionError = totalPositionError / (float)vertecies.size();
+
+        return report;
+    }
+}
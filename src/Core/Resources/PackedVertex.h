@@ -0,0 +1,85 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Vertex.h"
+#include "Core/BoundingObjects/AABB.h"
+#include "Utilities/STL/MxVector.h"
+
+namespace MxEngine
+{
+    enum class VertexFormat : uint8_t
+    {
+        FULL,
+        PACKED,
+    };
+
+    const char* EnumToString(VertexFormat format);
+
+    /*!
+    compact vertex representation, which is used as optional GPU layout for MeshData (20 bytes instead of 56 bytes)
+    position is stored as 16-bit unorm relative to submesh AABB, texture coordinates as half floats,
+    normal and tangent are octahedral-encoded 16-bit snorm pairs, bitangent is reconstructed from its sign in shader
+    */
+    struct PackedVertex
+    {
+        uint16_t Position[3];
+        uint16_t TexCoord[2];
+        int16_t Normal[2];
+        int16_t Tangent[2];
+        int16_t BitangentSign;
+
+        constexpr static size_t Size = 5; // in floats, to match Vertex::Size semantics
+    };
+    static_assert(sizeof(PackedVertex) == PackedVertex::Size * sizeof(float), "packed vertex must be tightly packed");
+
+    /*!
+    CPU-side quantization error report. Angles are measured in degrees, position error is measured in object space units
+    */
+    struct VertexQuantizationReport
+    {
+        size_t VertexCount = 0;
+        size_t FullSizeInBytes = 0;
+        size_t PackedSizeInBytes = 0;
+        float MaxPositionError = 0.0f;
+        float AveragePositionError = 0.0f;
+        float MaxTexCoordError = 0.0f;
+        float MaxNormalError = 0.0f;
+        float MaxTangentError = 0.0f;
+        size_t BitangentSignMismatches = 0;
+    };
+
+    Vector2 EncodeOctahedral(const Vector3& direction);
+    Vector3 DecodeOctahedral(const Vector2& encoded);
+    PackedVertex PackVertex(const Vertex& vertex, const AABB& bounds);
+    Vertex UnpackVertex(const PackedVertex& vertex, const AABB& bounds);
+    AABB ComputePackingBounds(const MxVector<Vertex>& vertecies);
+    MxVector<PackedVertex> PackVertecies(const MxVector<Vertex>& vertecies, const AABB& bounds);
+    VertexQuantizationReport ComputeQuantizationReport(const MxVector<Vertex>& vertecies);
+}
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "MeshData.h"
+#include "Utilities/MeshOptimizer/MeshOptimizer.h"
 
 namespace MxEngine
 {
@@ -42,6 +43,10 @@ namespace MxEngine
 	public:
 		MeshData Data;
 		MxString Name = "Main";
+		/*!
+		vertex cache statistics measured when submesh was last optimized. Empty if submesh was not optimized in this session
+		*/
+		MeshOptimizationReport Optimization;
 
 		const AABB& GetBoundingBox() const;
 		const BoundingSphere& GetBoundingSphere() const;
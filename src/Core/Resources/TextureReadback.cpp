@@ -0,0 +1,249 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TextureReadback.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace MxEngine
+{
+    void TextureReadback::Init()
+    {
+        impl = Alloc<TextureReadbackImpl>();
+        // copies and callbacks are submitted to own group, so Flush() helps with them only
+        impl->Tasks = ThreadPool::CreateTaskGroup();
+    }
+
+    void TextureReadback::Destroy()
+    {
+        // worker threads must be stopped before readback destruction, so copies are either finished or discarded
+        for (auto& request : impl->PendingRequests)
+        {
+            if (request.CopyFuture.valid()) request.CopyFuture.wait();
+        }
+        Free(impl);
+        impl = nullptr;
+    }
+
+    TextureReadbackImpl* TextureReadback::GetImpl()
+    {
+        return impl;
+    }
+
+    void TextureReadback::Clone(TextureReadbackImpl* other)
+    {
+        impl = other;
+    }
+
+    TextureReadbackRequest& TextureReadback::CreateRequest(const TextureHandle& texture)
+    {
+        if (impl->FreePixelBuffers.empty())
+        {
+            impl->FreePixelBuffers.emplace_back(PixelBufferType::PACK);
+            impl->Statistics.PixelBufferCount++;
+        }
+        TextureReadbackRequest request{ std::move(impl->FreePixelBuffers.back()) };
+        impl->FreePixelBuffers.pop_back();
+        impl->Statistics.RequestedReadbacks++;
+
+        // invalid requests are kept in queue without fence, so they fail on next frame as any other readback
+        if (!texture.IsValid())
+        {
+            MXLOG_WARNING("MxEngine::TextureReadback", "cannot read texture as its handle is invalid");
+        }
+        else if (texture->IsMultisampled())
+        {
+            MXLOG_WARNING("MxEngine::TextureReadback", "cannot read multisampled texture: " + texture->GetPath());
+        }
+        else if (texture->GetRawTextureDataSize() != 0)
+        {
+            request.Width = texture->GetWidth();
+            request.Height = texture->GetHeight();
+            request.Channels = texture->GetChannelCount();
+            request.IsFloatingPoint = texture->IsFloatingPoint();
+            texture->GetRawTextureData(request.Buffer);
+            request.CopyFence.Insert();
+        }
+
+        impl->PendingRequests.push_back(std::move(request));
+        return impl->PendingRequests.back();
+    }
+
+    std::future<Image> TextureReadback::Read(const TextureHandle& texture)
+    {
+        auto& request = TextureReadback::CreateRequest(texture);
+        return request.Result.get_future();
+    }
+
+    void TextureReadback::Read(const TextureHandle& texture, TextureReadbackCallback callback)
+    {
+        auto& request = TextureReadback::CreateRequest(texture);
+        request.Callback = std::move(callback);
+    }
+
+    void TextureReadback::FinishRequest(TextureReadbackRequest& request, Image image)
+    {
+        auto& statistics = impl->Statistics;
+        if (image.GetRawData() == nullptr)
+        {
+            statistics.FailedReadbacks++;
+        }
+        else
+        {
+            statistics.CompletedReadbacks++;
+            statistics.ReadBytes += image.GetTotalByteSize();
+        }
+
+        if (!request.Callback)
+        {
+            request.Result.set_value(std::move(image));
+        }
+        else if (ThreadPool::GetWorkerCount() > 0)
+        {
+            impl->PendingCallbacks.push_back(ThreadPool::Submit(impl->Tasks,
+                [callback = std::move(request.Callback), image = std::move(image)]() mutable { callback(std::move(image)); }));
+        }
+        else
+        {
+            request.Callback(std::move(image));
+        }
+    }
+
+    void TextureReadback::FinishCopies()
+    {
+        auto& requests = impl->PendingRequests;
+        for (size_t i = 0; i < requests.size();)
+        {
+            auto& request = requests[i];
+            if (!request.CopyFuture.valid() || request.CopyFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                i++;
+                continue;
+            }
+
+            bool isBufferValid = request.Buffer.Unmap();
+            Image image = request.CopyFuture.get();
+            if (!isBufferValid)
+            {
+                // buffer contents were lost while mapped (i.e. display mode change), so copied data is garbage
+                MXLOG_WARNING("MxEngine::TextureReadback", "pixel buffer was corrupted during readback");
+                image = Image();
+            }
+            TextureReadback::FinishRequest(request, std::move(image));
+
+            impl->FreePixelBuffers.push_back(std::move(request.Buffer));
+            requests.erase(requests.begin() + i);
+        }
+    }
+
+    void TextureReadback::StartCopies()
+    {
+        for (auto& request : impl->PendingRequests)
+        {
+            if (request.CopyFuture.valid() || !request.CopyFence.IsSignaled())
+                continue;
+
+            const uint8_t* source = request.CopyFence.IsInserted() ? request.Buffer.Map() : nullptr;
+            size_t width = request.Width, height = request.Height, channels = request.Channels;
+            bool isFloatingPoint = request.IsFloatingPoint;
+            auto copyImage = [source, width, height, channels, isFloatingPoint]()
+            {
+                if (source == nullptr) return Image();
+
+                size_t byteSize = width * height * channels * (isFloatingPoint ? sizeof(float) : sizeof(uint8_t));
+                auto data = (uint8_t*)std::malloc(byteSize);
+                std::memcpy(data, source, byteSize);
+                return Image(data, width, height, channels, isFloatingPoint);
+            };
+
+            if (source != nullptr && ThreadPool::GetWorkerCount() > 0)
+            {
+                request.CopyFuture = ThreadPool::Submit(impl->Tasks, std::move(copyImage));
+            }
+            else
+            {
+                std::promise<Image> copied;
+                copied.set_value(copyImage());
+                request.CopyFuture = copied.get_future();
+            }
+        }
+    }
+
+    void TextureReadback::ProcessReadbacks()
+    {
+        MAKE_SCOPE_PROFILER("TextureReadback::ProcessReadbacks()");
+        // copies started last frame are usually finished by now, so their pixel buffers can be reused by new requests
+        TextureReadback::FinishCopies();
+        TextureReadback::StartCopies();
+
+        auto& callbacks = impl->PendingCallbacks;
+        callbacks.erase(std::remove_if(callbacks.begin(), callbacks.end(), [](const std::future<void>& callback)
+        {
+            return callback.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), callbacks.end());
+    }
+
+    void TextureReadback::Flush()
+    {
+        MAKE_SCOPE_PROFILER("TextureReadback::Flush()");
+        for (auto& request : impl->PendingRequests)
+        {
+            if (!request.CopyFuture.valid()) request.CopyFence.Wait();
+        }
+        // all fences are signaled, so copy is started for every request
+        TextureReadback::StartCopies();
+        for (auto& request : impl->PendingRequests)
+        {
+            ThreadPool::Wait(request.CopyFuture, impl->Tasks);
+        }
+        TextureReadback::FinishCopies();
+
+        for (auto& callback : impl->PendingCallbacks)
+        {
+            ThreadPool::Wait(callback, impl->Tasks);
+        }
+        impl->PendingCallbacks.clear();
+    }
+
+    bool TextureReadback::IsIdle()
+    {
+        return impl->PendingRequests.empty() && impl->PendingCallbacks.empty();
+    }
+
+    TextureReadbackStatistics TextureReadback::GetStatistics()
+    {
+        auto statistics = impl->Statistics;
+        statistics.PendingReadbacks = impl->PendingRequests.size();
+        return statistics;
+    }
+}
@@ -0,0 +1,133 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Platform/GraphicAPI.h"
+#include "Platform/OpenGL/PixelBuffer.h"
+#include "Platform/OpenGL/Fence.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+
+#include <future>
+#include <functional>
+
+namespace MxEngine
+{
+    /*!
+    callback which receives texture image. It is invoked on worker thread, so it must not access engine resources
+    */
+    using TextureReadbackCallback = std::function<void(Image)>;
+
+    struct TextureReadbackStatistics
+    {
+        /*!
+        readbacks which are waiting for GPU or being copied from pixel buffers
+        */
+        size_t PendingReadbacks = 0;
+        size_t RequestedReadbacks = 0;
+        size_t CompletedReadbacks = 0;
+        size_t FailedReadbacks = 0;
+        size_t ReadBytes = 0;
+        size_t PixelBufferCount = 0;
+    };
+
+    /*!
+    texture copy which is performed by GPU into pixel pack buffer. Fence is signaled when copy is finished
+    */
+    struct TextureReadbackRequest
+    {
+        PixelBuffer Buffer;
+        Fence CopyFence;
+        size_t Width = 0;
+        size_t Height = 0;
+        size_t Channels = 0;
+        bool IsFloatingPoint = false;
+        std::promise<Image> Result;
+        TextureReadbackCallback Callback;
+        /*!
+        worker copy from mapped pixel buffer to client memory. Valid only after fence is signaled
+        */
+        std::future<Image> CopyFuture;
+    };
+
+    struct TextureReadbackImpl
+    {
+        MxVector<TextureReadbackRequest> PendingRequests;
+        MxVector<PixelBuffer> FreePixelBuffers;
+        MxVector<std::future<void>> PendingCallbacks;
+        TextureReadbackStatistics Statistics;
+        TaskGroup Tasks = 0;
+    };
+
+    /*!
+    texture readback is a global engine module which reads textures back from GPU without stalling main thread.
+    Texture is copied into pixel pack buffer guarded by fence, which is usually signaled a frame or two later.
+    Then pixel buffer is mapped and its contents are copied to client memory on worker thread
+    */
+    class TextureReadback
+    {
+        inline static TextureReadbackImpl* impl = nullptr;
+
+        static void StartCopies();
+        static void FinishCopies();
+        static void FinishRequest(TextureReadbackRequest& request, Image image);
+        static TextureReadbackRequest& CreateRequest(const TextureHandle& texture);
+    public:
+        static void Init();
+        static void Destroy();
+        static TextureReadbackImpl* GetImpl();
+        static void Clone(TextureReadbackImpl* other);
+
+        /*!
+        schedules asynchronous texture readback
+        \param texture texture to read. Its current contents are captured, so it can be modified or destroyed right after the call
+        \returns future which holds texture image. Future is fulfilled by ProcessReadbacks() method, so main thread must never block on it
+        */
+        static std::future<Image> Read(const TextureHandle& texture);
+        /*!
+        schedules asynchronous texture readback
+        \param texture texture to read. Its current contents are captured, so it can be modified or destroyed right after the call
+        \param callback function which is invoked on worker thread with texture image (i.e. for encoding and saving it to disk).
+        Image is empty if readback failed
+        */
+        static void Read(const TextureHandle& texture, TextureReadbackCallback callback);
+        /*!
+        finishes readbacks which are completed by GPU. Called by Application once per frame
+        */
+        static void ProcessReadbacks();
+        /*!
+        blocks until all pending readbacks and their callbacks are finished
+        */
+        static void Flush();
+        static bool IsIdle();
+        static TextureReadbackStatistics GetStatistics();
+    };
+}
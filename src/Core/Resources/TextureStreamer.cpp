@@ -0,0 +1,301 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TextureStreamer.h"
+#include "Library/Primitives/Colors.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <cstring>
+
+namespace MxEngine
+{
+    /*!
+    texture streaming request. Holds only CPU-side data, as it is accessed from worker threads
+    texture is recreated from its plain id on main thread when image is ready for upload
+    */
+    struct TextureStreamingRequest
+    {
+        UUID TextureUUID;
+        size_t TextureHandle = 0;
+        MxString Path;
+        TextureFormat Format = TextureFormat::RGB;
+        TextureWrap Wrap = TextureWrap::REPEAT;
+        bool GenerateMipmaps = true;
+        bool FlipImage = true;
+        Image DecodedImage;
+    };
+
+    void TextureStreamer::Init()
+    {
+        impl = Alloc<TextureStreamerImpl>();
+        impl->Statistics.UploadBudget = 16 * 1024 * 1024;
+    }
+
+    void TextureStreamer::Destroy()
+    {
+        // worker threads must be stopped before streamer destruction, so no new requests can be decoded
+        for (auto& copy : impl->CopyingRequests)
+        {
+            if (copy.CopyFuture.valid()) copy.CopyFuture.wait();
+        }
+        Free(impl);
+        impl = nullptr;
+    }
+
+    TextureStreamerImpl* TextureStreamer::GetImpl()
+    {
+        return impl;
+    }
+
+    void TextureStreamer::Clone(TextureStreamerImpl* other)
+    {
+        impl = other;
+    }
+
+    static Ref<TextureStreamingRequest> CreateRequest(TextureStreamerImpl& data, const TextureHandle& texture, const MxString& path, 
+        TextureFormat format, TextureWrap wrap, bool genMipmaps, bool flipImage)
+    {
+        auto request = MakeRef<TextureStreamingRequest>();
+        request->TextureUUID = texture.GetUUID();
+        request->TextureHandle = texture.GetHandle();
+        request->Path = path;
+        request->Format = format;
+        request->Wrap = wrap;
+        request->GenerateMipmaps = genMipmaps;
+        request->FlipImage = flipImage;
+
+        if (TextureStreamer::IsIdle())
+        {
+            data.BatchRequested = 0;
+            data.BatchFinished = 0;
+        }
+        data.BatchRequested++;
+        data.Statistics.RequestedTextures++;
+        data.PendingTextures[request->TextureHandle] = request->TextureUUID;
+        return request;
+    }
+
+    TextureHandle TextureStreamer::Load(const MxString& path, TextureFormat format, const Vector3& placeholder, TextureWrap wrap, bool genMipmaps, bool flipImage)
+    {
+        auto texture = Colors::MakeTexture(placeholder);
+        texture->SetPath(path);
+
+        auto request = CreateRequest(*impl, texture, path, format, wrap, genMipmaps, flipImage);
+        impl->PendingDecodes++;
+
+        ThreadPool::Submit([request = std::move(request), data = impl]() mutable
+        {
+            request->DecodedImage = ImageLoader::LoadImage(request->Path, request->FlipImage);
+            std::lock_guard<std::mutex> lock(data->DecodedMutex);
+            data->DecodedRequests.push_back(std::move(request));
+            data->PendingDecodes--;
+        });
+        return texture;
+    }
+
+    TextureHandle TextureStreamer::Load(Image image, const MxString& path, TextureFormat format, const Vector3& placeholder, TextureWrap wrap, bool genMipmaps)
+    {
+        auto texture = Colors::MakeTexture(placeholder);
+        texture->SetPath(path);
+
+        auto request = CreateRequest(*impl, texture, path, format, wrap, genMipmaps, false);
+        request->DecodedImage = std::move(image);
+        std::lock_guard<std::mutex> lock(impl->DecodedMutex);
+        impl->DecodedRequests.push_back(std::move(request));
+        return texture;
+    }
+
+    void TextureStreamer::FinishRequest(TextureStreamingRequest& request, bool isFailed)
+    {
+        auto pending = impl->PendingTextures.find(request.TextureHandle);
+        if (pending != impl->PendingTextures.end() && pending->second == request.TextureUUID)
+            impl->PendingTextures.erase(pending);
+
+        impl->BatchFinished++;
+        if (isFailed)
+            impl->Statistics.FailedTextures++;
+        else
+            impl->Statistics.CompletedTextures++;
+        request.DecodedImage = Image();
+    }
+
+    void TextureStreamer::FinishCopies()
+    {
+        auto& copies = impl->CopyingRequests;
+        for (size_t i = 0; i < copies.size();)
+        {
+            auto& copy = copies[i];
+            if (copy.CopyFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                i++;
+                continue;
+            }
+
+            auto& request = *copy.Request;
+            const auto& image = request.DecodedImage;
+            TextureHandle texture(request.TextureUUID, request.TextureHandle);
+            bool isBufferValid = copy.Buffer.Unmap();
+            if (texture.IsValid())
+            {
+                if (isBufferValid)
+                {
+                    texture->Load(copy.Buffer, (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), image.IsFloatingPoint(),
+                        request.Format, request.Wrap, request.GenerateMipmaps);
+                }
+                else
+                {
+                    // buffer contents were lost while mapped (i.e. display mode change), so image is uploaded directly
+                    texture->Load(image, request.Format, request.Wrap, request.GenerateMipmaps);
+                }
+                texture->SetPath(request.Path);
+            }
+            TextureStreamer::FinishRequest(request, false);
+
+            impl->FreePixelBuffers.push_back(std::move(copy.Buffer));
+            copies.erase(copies.begin() + i);
+        }
+    }
+
+    void TextureStreamer::StartUploads()
+    {
+        auto& statistics = impl->Statistics;
+        statistics.UploadedBytesLastFrame = 0;
+        while (statistics.UploadedBytesLastFrame == 0 || statistics.UploadedBytesLastFrame < statistics.UploadBudget)
+        {
+            Ref<TextureStreamingRequest> request;
+            {
+                std::lock_guard<std::mutex> lock(impl->DecodedMutex);
+                if (impl->DecodedRequests.empty()) break;
+                request = std::move(impl->DecodedRequests.front());
+                impl->DecodedRequests.pop_front();
+            }
+
+            if (request->DecodedImage.GetRawData() == nullptr)
+            {
+                MXLOG_ERROR("MxEngine::TextureStreamer", "cannot load texture from file: " + request->Path);
+                TextureStreamer::FinishRequest(*request, true);
+                continue;
+            }
+
+            TextureHandle texture(request->TextureUUID, request->TextureHandle);
+            if (!texture.IsValid())
+            {
+                // texture was destroyed while decoding, so there is no need to upload it
+                TextureStreamer::FinishRequest(*request, false);
+                continue;
+            }
+
+            if (impl->FreePixelBuffers.empty())
+            {
+                impl->FreePixelBuffers.emplace_back(PixelBufferType::UNPACK);
+                statistics.PixelBufferCount++;
+            }
+            TextureStreamingCopy copy{ nullptr, std::move(impl->FreePixelBuffers.back()), { } };
+            impl->FreePixelBuffers.pop_back();
+
+            size_t byteSize = request->DecodedImage.GetTotalByteSize();
+            copy.Buffer.Load(byteSize, UsageType::STREAM_DRAW);
+            uint8_t* destination = copy.Buffer.Map();
+            if (destination == nullptr)
+            {
+                // fallback to synchronous upload if buffer cannot be mapped
+                const auto& image = request->DecodedImage;
+                texture->Load(image, request->Format, request->Wrap, request->GenerateMipmaps);
+                texture->SetPath(request->Path);
+                TextureStreamer::FinishRequest(*request, false);
+                impl->FreePixelBuffers.push_back(std::move(copy.Buffer));
+            }
+            else
+            {
+                const uint8_t* source = request->DecodedImage.GetRawData();
+                if (ThreadPool::GetWorkerCount() > 0)
+                {
+                    copy.CopyFuture = ThreadPool::Submit([destination, source, byteSize]() { std::memcpy(destination, source, byteSize); });
+                }
+                else
+                {
+                    std::promise<void> copied;
+                    std::memcpy(destination, source, byteSize);
+                    copied.set_value();
+                    copy.CopyFuture = copied.get_future();
+                }
+                copy.Request = std::move(request);
+                impl->CopyingRequests.push_back(std::move(copy));
+            }
+            statistics.UploadedBytesLastFrame += byteSize;
+            statistics.UploadedBytes += byteSize;
+        }
+    }
+
+    void TextureStreamer::ProcessUploads()
+    {
+        MAKE_SCOPE_PROFILER("TextureStreamer::ProcessUploads()");
+        // copies started last frame are usually finished by now, so textures are created before new copies are scheduled
+        TextureStreamer::FinishCopies();
+        TextureStreamer::StartUploads();
+    }
+
+    void TextureStreamer::SetUploadBudget(size_t bytesPerFrame)
+    {
+        impl->Statistics.UploadBudget = bytesPerFrame;
+    }
+
+    size_t TextureStreamer::GetUploadBudget()
+    {
+        return impl->Statistics.UploadBudget;
+    }
+
+    bool TextureStreamer::IsPending(const TextureHandle& texture)
+    {
+        auto pending = impl->PendingTextures.find(texture.GetHandle());
+        return pending != impl->PendingTextures.end() && pending->second == texture.GetUUID();
+    }
+
+    bool TextureStreamer::IsIdle()
+    {
+        return impl->BatchFinished == impl->BatchRequested;
+    }
+
+    float TextureStreamer::GetProgress()
+    {
+        if (impl->BatchRequested == 0) return 1.0f;
+        return float(impl->BatchFinished) / float(impl->BatchRequested);
+    }
+
+    TextureStreamingStatistics TextureStreamer::GetStatistics()
+    {
+        auto statistics = impl->Statistics;
+        statistics.PendingDecodes = impl->PendingDecodes;
+        statistics.PendingUploads = impl->BatchRequested - impl->BatchFinished - statistics.PendingDecodes;
+        return statistics;
+    }
+}
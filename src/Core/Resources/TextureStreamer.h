@@ -0,0 +1,154 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Platform/GraphicAPI.h"
+#include "Platform/OpenGL/PixelBuffer.h"
+#include "Utilities/STL/MxHashMap.h"
+#include "Utilities/Memory/Memory.h"
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <future>
+
+namespace MxEngine
+{
+    struct TextureStreamingRequest;
+
+    struct TextureStreamingStatistics
+    {
+        /*!
+        textures which are waiting for decoding or being decoded on worker threads
+        */
+        size_t PendingDecodes = 0;
+        /*!
+        decoded textures which are waiting for upload or being copied to pixel buffers
+        */
+        size_t PendingUploads = 0;
+        size_t RequestedTextures = 0;
+        size_t CompletedTextures = 0;
+        size_t FailedTextures = 0;
+        size_t UploadedBytes = 0;
+        size_t UploadedBytesLastFrame = 0;
+        size_t UploadBudget = 0;
+        size_t PixelBufferCount = 0;
+    };
+
+    /*!
+    decoded image which is being copied into mapped pixel buffer on worker thread
+    */
+    struct TextureStreamingCopy
+    {
+        Ref<TextureStreamingRequest> Request;
+        PixelBuffer Buffer;
+        std::future<void> CopyFuture;
+    };
+
+    struct TextureStreamerImpl
+    {
+        std::mutex DecodedMutex;
+        std::deque<Ref<TextureStreamingRequest>> DecodedRequests;
+        MxVector<TextureStreamingCopy> CopyingRequests;
+        MxVector<PixelBuffer> FreePixelBuffers;
+        MxHashMap<size_t, UUID> PendingTextures;
+        std::atomic<size_t> PendingDecodes{ 0 };
+        size_t BatchRequested = 0;
+        size_t BatchFinished = 0;
+        TextureStreamingStatistics Statistics;
+    };
+
+    /*!
+    texture streamer is a global engine module which loads textures without blocking main thread.
+    Images are decoded on worker threads, then copied into pixel unpack buffers and uploaded to GPU across several frames under byte budget.
+    Until upload is finished, texture contains 1x1 placeholder color, so its handle can be used for rendering immediately
+    */
+    class TextureStreamer
+    {
+        inline static TextureStreamerImpl* impl = nullptr;
+
+        static void FinishCopies();
+        static void StartUploads();
+        static void FinishRequest(TextureStreamingRequest& request, bool isFailed);
+    public:
+        static void Init();
+        static void Destroy();
+        static TextureStreamerImpl* GetImpl();
+        static void Clone(TextureStreamerImpl* other);
+
+        /*!
+        starts texture streaming
+        \param path path to an image file
+        \param format texture format
+        \param placeholder color which texture contains until image is uploaded
+        \param wrap texture wrap type
+        \param genMipmaps should mipmaps be generated after upload
+        \param flipImage should the image be vertically flipped
+        \returns texture handle which can be used immediately
+        */
+        static TextureHandle Load(const MxString& path, TextureFormat format, const Vector3& placeholder = MakeVector3(0.5f),
+            TextureWrap wrap = TextureWrap::REPEAT, bool genMipmaps = true, bool flipImage = true);
+        /*!
+        starts streaming of already decoded image. Decoding step is skipped, image is uploaded under same byte budget
+        \param image decoded image. Image is expected to be already flipped, as all images loaded from files
+        \param path path which is assigned to texture
+        \param format texture format
+        \param placeholder color which texture contains until image is uploaded
+        \param wrap texture wrap type
+        \param genMipmaps should mipmaps be generated after upload
+        \returns texture handle which can be used immediately
+        */
+        static TextureHandle Load(Image image, const MxString& path, TextureFormat format, const Vector3& placeholder = MakeVector3(0.5f),
+            TextureWrap wrap = TextureWrap::REPEAT, bool genMipmaps = true);
+        /*!
+        performs pending uploads. Called by Application once per frame
+        */
+        static void ProcessUploads();
+        /*!
+        sets upload budget. At least one texture is uploaded each frame even if it exceeds the budget
+        \param bytesPerFrame maximum number of bytes uploaded to GPU each frame
+        */
+        static void SetUploadBudget(size_t bytesPerFrame);
+        static size_t GetUploadBudget();
+        /*!
+        checks if texture is still being streamed
+        \param texture texture handle returned by Load() method
+        \returns true if texture contains placeholder and waits for upload, false either
+        */
+        static bool IsPending(const TextureHandle& texture);
+        static bool IsIdle();
+        /*!
+        gets progress of current streaming batch (all textures requested since streamer was idle last time)
+        \returns value in range [0, 1], where 1 means that all requested textures are uploaded
+        */
+        static float GetProgress();
+        static TextureStreamingStatistics GetStatistics();
+    };
+}
@@ -44,6 +44,8 @@ namespace MxEngine
     {
         auto buffer = source.GetLoadedSource();
         json["source-id"] = buffer.IsValid() ? buffer.GetHandle() : size_t(-1);
+        auto stream = source.GetLoadedStream();
+        json["stream-id"] = stream.IsValid() ? stream.GetHandle() : size_t(-1);
         json["direction"] = source.GetDirection();
         json["inner-angle"] = source.GetInnerAngle();
         json["outer-angle"] = source.GetOuterAngle();
@@ -57,6 +57,7 @@
 #include "Utilities/Array/Array2D.h"
 #include "Utilities/Image/ImageConverter.h"
 #include "Utilities/Image/ImageManager.h"
+#include "Core/Resources/TextureReadback.h"
 #include "Utilities/Memory/Memory.h"
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/FileSystem/FileManager.h"
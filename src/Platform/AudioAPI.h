@@ -33,17 +33,19 @@
 #if defined(MXENGINE_USE_OPENAL)
 #include "Platform/OpenAL/AudioBuffer.h"
 #include "Platform/OpenAL/AudioPlayer.h"
+#include "Platform/OpenAL/AudioStream.h"
 #endif
 
 #include "Utilities/AbstractFactory/AbstractFactory.h"
 
 namespace MxEngine
 {
-    using AudioFactory = AbstractFactoryImpl<AudioPlayer, AudioBuffer>;
+    using AudioFactory = AbstractFactoryImpl<AudioPlayer, AudioBuffer, AudioStream>;
 
     template<typename T>
     using AResource = Resource<T, AudioFactory>;
 
     using AudioBufferHandle = AResource<AudioBuffer>;
     using AudioPlayerHandle = AResource<AudioPlayer>;
+    using AudioStreamHandle = AResource<AudioStream>;
 }
\ No newline at end of file
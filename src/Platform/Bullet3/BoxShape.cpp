@@ -33,20 +33,18 @@ namespace MxEngine
 {
     BoxShape::BoxShape(const BoundingBox& boundingBox)
     {
-        this->CreateShape<btBoxShape>(ToBulletVector3(boundingBox.Length() * 0.5f));
+        this->AcquireShape({ ShapeType::BOX, boundingBox.Length() * 0.5f });
     }
 
     BoxShape::BoxShape(BoxShape&& other) noexcept
     {
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
     }
 
     BoxShape& BoxShape::operator=(BoxShape&& other) noexcept
     {
         this->DestroyShape();
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
         return *this;
     }
 
@@ -9,6 +9,7 @@ namespace MxEngine
 {
     inline btVector3 ToBulletVector3(const Vector3& v) { return btVector3(v.x, v.y, v.z); }
     inline Vector3 FromBulletVector3(const btVector3& v) { return MakeVector3(v.x(), v.y(), v.z()); }
+    inline btQuaternion ToBulletQuaternion(const Quaternion& q) { return btQuaternion(q.x, q.y, q.z, q.w); }
 
     inline void FromBulletTransform(TransformComponent& to, const btTransform& from)
     {
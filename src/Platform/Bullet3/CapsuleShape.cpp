@@ -39,28 +39,26 @@ namespace MxEngine
         switch (capsule.Orientation)
         {
         case Capsule::Axis::X:
-            this->CreateShape<btCapsuleShapeX>(capsule.Radius, capsule.Height);
+            this->AcquireShape({ ShapeType::CAPSULE_X, MakeVector3(capsule.Radius, capsule.Height, 0.0f) });
             break;
         case Capsule::Axis::Y:
-            this->CreateShape<btCapsuleShapeY>(capsule.Radius, capsule.Height);
+            this->AcquireShape({ ShapeType::CAPSULE_Y, MakeVector3(capsule.Radius, capsule.Height, 0.0f) });
             break;
         case Capsule::Axis::Z:
-            this->CreateShape<btCapsuleShapeZ>(capsule.Radius, capsule.Height);
+            this->AcquireShape({ ShapeType::CAPSULE_Z, MakeVector3(capsule.Radius, capsule.Height, 0.0f) });
             break;
         }
     }
 
     CapsuleShape::CapsuleShape(CapsuleShape&& other) noexcept
     {
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
     }
 
     CapsuleShape& CapsuleShape::operator=(CapsuleShape&& other) noexcept
     {
         this->DestroyShape();
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
         return *this;
     }
 
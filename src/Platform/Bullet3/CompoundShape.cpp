@@ -57,14 +57,13 @@ namespace MxEngine
 
     CompoundShape::CompoundShape(CompoundShape&& other) noexcept
     {
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
     }
 
     CompoundShape& CompoundShape::operator=(CompoundShape&& other) noexcept
     {
         this->DestroyShape();
-        this->collider = other.collider;
+        this->TakeShape(other);
         return *this;
     }
 
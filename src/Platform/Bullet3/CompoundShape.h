@@ -84,6 +84,8 @@ namespace MxEngine
         template<typename Shape, typename Factory>
         void AddShape(Resource<Shape, Factory> shape, const TransformComponent& relativeTransform)
         {
+            // compound shape writes user pointer and scale of its children, so they cannot be shared
+            shape->MakeUnique();
             this->AddShapeImpl(shape->GetNativeHandle(), shape.GetHandle(), relativeTransform);
         }
     };
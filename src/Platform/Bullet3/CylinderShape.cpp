@@ -35,36 +35,30 @@ namespace MxEngine
 {
     CylinderShape::CylinderShape(const Cylinder& cylinder)
     {
-        btVector3 boundings{ 0.0f, 0.0f, 0.0f };
         this->orientation = cylinder.Orientation;
         switch (cylinder.Orientation)
         {
         case Cylinder::Axis::X:
-            boundings.setValue(cylinder.Height * 0.5f, cylinder.RadiusX, cylinder.RadiusZ);
-            this->CreateShape<btCylinderShapeX>(boundings);
+            this->AcquireShape({ ShapeType::CYLINDER_X, MakeVector3(cylinder.Height * 0.5f, cylinder.RadiusX, cylinder.RadiusZ) });
             break;
         case Cylinder::Axis::Y:
-            boundings.setValue(cylinder.RadiusX, cylinder.Height * 0.5f, cylinder.RadiusZ);
-            this->CreateShape<btCylinderShapeY>(boundings);
+            this->AcquireShape({ ShapeType::CYLINDER_Y, MakeVector3(cylinder.RadiusX, cylinder.Height * 0.5f, cylinder.RadiusZ) });
             break;
         case Cylinder::Axis::Z:
-            boundings.setValue(cylinder.RadiusX, cylinder.RadiusZ, cylinder.Height * 0.5f);
-            this->CreateShape<btCylinderShapeZ>(boundings);
+            this->AcquireShape({ ShapeType::CYLINDER_Z, MakeVector3(cylinder.RadiusX, cylinder.RadiusZ, cylinder.Height * 0.5f) });
             break;
         }
     }
 
     CylinderShape::CylinderShape(CylinderShape&& other) noexcept
     {
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
     }
 
     CylinderShape& CylinderShape::operator=(CylinderShape&& other) noexcept
     {
         this->DestroyShape();
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
         return *this;
     }
 
@@ -31,23 +31,62 @@
 #include "Utilities/Memory/Memory.h"
 #include "Utilities/Logging/Logger.h"
 #include "Core/Application/Physics.h"
+#include "Platform/Modules/PhysicsModule.h"
+
+#include <algorithm>
 
 namespace MxEngine
 {
     class MotionStateNotifier : public btDefaultMotionState
     {
     public:
-        MotionStateNotifier(btTransform& tr) : btDefaultMotionState(tr) { }
+        MotionStateNotifier(btTransform& tr, btRigidBody* body) : btDefaultMotionState(tr), Body(body), PreviousTransform(tr) { }
 
-        bool TransformUpdated = true;
+        btRigidBody* Body;
+        btTransform PreviousTransform; // transform before last simulation step, used for interpolation by threaded simulation
+        bool TransformUpdated = false;
+        bool ColliderUpdated = false;
+        bool TransformPending = false; // body was moved outside of simulation and was not stepped since
 
+        // invoked by bullet only for active non-kinematic bodies, so sleeping bodies never get into the list
         virtual void setWorldTransform(const btTransform& centerOfMassWorldTrans) override
         {
-            this->TransformUpdated = true;
+            this->TransformPending = false;
+            this->PreviousTransform = this->m_graphicsWorldTransform;
             btDefaultMotionState::setWorldTransform(centerOfMassWorldTrans);
+            if (!this->TransformUpdated)
+            {
+                this->TransformUpdated = true;
+                PhysicsModule::GetImpl()->MovedBodies.push_back(this->Body);
+            }
         }
     };
 
+    void ConsumeMotionState(btRigidBody* body, PhysicsBodyState& state)
+    {
+        auto motionState = static_cast<MotionStateNotifier*>(body->getMotionState());
+        auto& previous = motionState->PreviousTransform;
+        auto& current = motionState->m_graphicsWorldTransform;
+
+        state.PreviousPosition = FromBulletVector3(previous.getOrigin());
+        state.CurrentPosition = FromBulletVector3(current.getOrigin());
+        auto previousRotation = previous.getRotation();
+        auto currentRotation = current.getRotation();
+        state.PreviousRotation = Quaternion(previousRotation.w(), previousRotation.x(), previousRotation.y(), previousRotation.z());
+        state.CurrentRotation = Quaternion(currentRotation.w(), currentRotation.x(), currentRotation.y(), currentRotation.z());
+        motionState->TransformUpdated = false;
+    }
+
+    static void RemoveFromList(MxVector<btRigidBody*>& bodies, btRigidBody* body)
+    {
+        auto it = std::find(bodies.begin(), bodies.end(), body);
+        if (it != bodies.end())
+        {
+            *it = bodies.back();
+            bodies.pop_back();
+        }
+    }
+
     void NativeRigidBody::DestroyBody()
     {
         if (this->bodyAllocation != nullptr)
@@ -57,6 +96,14 @@ namespace MxEngine
             Physics::ActiveRigidBodyIsland(body);
             Physics::RemoveRigidBody(body);
 
+            // update lists are cleared every frame, so they are almost always empty here
+            auto data = PhysicsModule::GetImpl();
+            RemoveFromList(data->MovedBodies, body);
+            RemoveFromList(data->ColliderUpdates, body);
+            if (body->isKinematicObject())
+                RemoveFromList(data->KinematicBodies, body);
+            PhysicsModule::RemoveBodyState(body);
+
             ((MotionStateNotifier*)body->getMotionState())->~MotionStateNotifier();
             body->~btRigidBody();
 
@@ -90,8 +137,9 @@ namespace MxEngine
         ToBulletTransform(tr, transform);
 
         this->bodyAllocation = new uint8_t[sizeof(btRigidBody) + sizeof(MotionStateNotifier)];
-        auto state = new(this->bodyAllocation + sizeof(btRigidBody)) MotionStateNotifier(tr);
+        auto state = new(this->bodyAllocation + sizeof(btRigidBody)) MotionStateNotifier(tr, reinterpret_cast<btRigidBody*>(this->bodyAllocation));
         auto body = new(this->bodyAllocation) btRigidBody(0.0f, state, nullptr);
+        body->setUserIndex(CollisionCallbackMask::NONE); // user index stores collision callbacks registered by RigidBody
 
         Physics::AddRigidBody(body, this->group, this->mask);
     }
@@ -167,6 +215,16 @@ namespace MxEngine
         return this->mask;
     }
 
+    void NativeRigidBody::SetCollisionCallbackMask(uint32_t mask)
+    {
+        this->GetNativeHandle()->setUserIndex((int)mask);
+    }
+
+    uint32_t NativeRigidBody::GetCollisionCallbackMask() const
+    {
+        return (uint32_t)this->GetNativeHandle()->getUserIndex();
+    }
+
     bool NativeRigidBody::HasTransformUpdate() const
     {
         return static_cast<const MotionStateNotifier*>(this->GetMotionState())->TransformUpdated;
@@ -174,7 +232,52 @@ namespace MxEngine
 
     void NativeRigidBody::SetTransformUpdateFlag(bool value)
     {
-        static_cast<MotionStateNotifier*>(this->GetMotionState())->TransformUpdated = value;
+        auto state = static_cast<MotionStateNotifier*>(this->GetMotionState());
+        if (value && !state->TransformUpdated)
+            PhysicsModule::GetImpl()->MovedBodies.push_back(this->GetNativeHandle());
+        state->TransformUpdated = value;
+    }
+
+    bool NativeRigidBody::HasColliderUpdate() const
+    {
+        return static_cast<const MotionStateNotifier*>(this->GetMotionState())->ColliderUpdated;
+    }
+
+    void NativeRigidBody::SetColliderUpdateFlag(bool value)
+    {
+        auto state = static_cast<MotionStateNotifier*>(this->GetMotionState());
+        if (value && !state->ColliderUpdated)
+            PhysicsModule::GetImpl()->ColliderUpdates.push_back(this->GetNativeHandle());
+        state->ColliderUpdated = value;
+    }
+
+    void NativeRigidBody::SetKinematicTransform(const TransformComponent& transform)
+    {
+        btTransform tr;
+        ToBulletTransform(tr, transform);
+        // bypass notifier, as transform comes from engine and should not be fetched back
+        static_cast<MotionStateNotifier*>(this->GetMotionState())->btDefaultMotionState::setWorldTransform(tr);
+    }
+
+    void NativeRigidBody::SetWorldTransform(const TransformComponent& transform)
+    {
+        btTransform tr;
+        ToBulletTransform(tr, transform);
+        auto body = this->GetNativeHandle();
+        body->setWorldTransform(tr);
+        body->setInterpolationWorldTransform(tr);
+        body->activate(true);
+
+        // notifier is bypassed, so interpolation of next simulation step starts from the new transform
+        auto state = static_cast<MotionStateNotifier*>(this->GetMotionState());
+        state->btDefaultMotionState::setWorldTransform(tr);
+        state->PreviousTransform = tr;
+        state->TransformPending = true;
+    }
+
+    bool NativeRigidBody::HasPendingTransform() const
+    {
+        return static_cast<const MotionStateNotifier*>(this->GetMotionState())->TransformPending;
     }
 
     Vector3 NativeRigidBody::GetScale() const
@@ -203,6 +306,8 @@ namespace MxEngine
     void NativeRigidBody::SetKinematicFlag()
     {
         auto body = this->GetNativeHandle();
+        if (!body->isKinematicObject())
+            PhysicsModule::GetImpl()->KinematicBodies.push_back(body);
         body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
         this->SetActivationState(ActivationState::DISABLE_DEACTIVATION);
     }
@@ -216,18 +321,13 @@ namespace MxEngine
     void NativeRigidBody::UnsetAllFlags()
     {
         auto body = this->GetNativeHandle();
+        if (body->isKinematicObject())
+            RemoveFromList(PhysicsModule::GetImpl()->KinematicBodies, body);
         body->setCollisionFlags(body->getCollisionFlags() &
             ~(btCollisionObject::CF_KINEMATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE));
         this->SetActivationState(ActivationState::ACTIVE_TAG);
     }
 
-    void NativeRigidBody::SetScale(const Vector3& scale)
-    {
-        auto* collider = this->GetCollisionShape();
-        if (collider != nullptr)
-            collider->setLocalScaling(ToBulletVector3(scale));
-    }
-
     float NativeRigidBody::GetMass() const
     {
         return this->GetNativeHandle()->getMass();
@@ -253,6 +353,16 @@ namespace MxEngine
         this->GetNativeHandle()->activate(true);
     }
 
+    void NativeRigidBody::ApplyForce(const Vector3& force, const Vector3& relativePosition)
+    {
+        PhysicsModule::ApplyForce(this->GetNativeHandle(), force, relativePosition, MakeVector3(0.0f));
+    }
+
+    void NativeRigidBody::ApplyTorque(const Vector3& torque)
+    {
+        PhysicsModule::ApplyForce(this->GetNativeHandle(), MakeVector3(0.0f), MakeVector3(0.0f), torque);
+    }
+
     bool NativeRigidBody::IsActive() const
     {
         return this->GetNativeHandle()->isActive();
@@ -62,6 +62,17 @@ namespace MxEngine
         };
     }
 
+    namespace CollisionCallbackMask
+    {
+        enum Mask : uint32_t
+        {
+            NONE = 0,
+            COLLISION = 1,
+            COLLISION_ENTER = 1 << 1,
+            COLLISION_EXIT = 1 << 2,
+        };
+    }
+
     const char* EnumToString(CollisionGroup::Group mask);
     const char* EnumToString(CollisionMask::Mask group);
 
@@ -98,6 +109,15 @@ namespace MxEngine
         const btMotionState* GetMotionState() const;
         bool HasTransformUpdate() const;
         void SetTransformUpdateFlag(bool value);
+        bool HasColliderUpdate() const;
+        void SetColliderUpdateFlag(bool value);
+        void SetKinematicTransform(const TransformComponent& transform);
+        /*!
+        moves body outside of simulation. Body is marked as having pending transform until physics engine steps it from the new one
+        \param transform new transform of body
+        */
+        void SetWorldTransform(const TransformComponent& transform);
+        bool HasPendingTransform() const;
 
         btCollisionShape* GetCollisionShape();
         const btCollisionShape* GetCollisionShape() const;
@@ -105,18 +125,30 @@ namespace MxEngine
         void SetCollisionFilter(uint32_t group, uint32_t mask);
         uint32_t GetCollisionGroup() const;
         uint32_t GetCollisionMask() const;
+        void SetCollisionCallbackMask(uint32_t mask);
+        uint32_t GetCollisionCallbackMask() const;
         Vector3 GetScale() const;
         bool IsMoving() const;
         bool HasCollisionResponce() const;
         void SetKinematicFlag();
         void SetTriggerFlag();
         void UnsetAllFlags();
-        void SetScale(const Vector3& scale);
         float GetMass() const;
         void SetMass(float mass);
         void SetActivationState(ActivationState state);
         ActivationState GetActivationState() const;
         void Activate();
+        /*!
+        applies force to body. If physics is simulated on dedicated thread, force is queued and applied before each step until next frame
+        \param force force in world space
+        \param relativePosition point of force application relative to body center of mass
+        */
+        void ApplyForce(const Vector3& force, const Vector3& relativePosition);
+        /*!
+        applies torque to body. If physics is simulated on dedicated thread, torque is queued in the same way as forces
+        \param torque torque in world space
+        */
+        void ApplyTorque(const Vector3& torque);
         bool IsActive() const;
     };
 }
\ No newline at end of file
@@ -35,13 +35,57 @@ namespace MxEngine
     {
         if (this->collider != nullptr)
         {
-            Free(this->collider);
+            if (this->isShared)
+                ShapeCache::Release(this->cacheKey);
+            else
+                ShapeCache::DestroyUnique(this->collider);
+            this->collider = nullptr;
         }
     }
 
-    void ShapeBase::SetScale(const Vector3& scale)
+    void ShapeBase::AcquireShape(const ShapeCacheKey& key)
     {
-        this->collider->setLocalScaling(ToBulletVector3(scale));
+        this->collider = ShapeCache::Acquire(key);
+        this->cacheKey = key;
+        this->isShared = true;
+    }
+
+    void ShapeBase::TakeShape(ShapeBase& other)
+    {
+        this->collider = other.collider;
+        this->cacheKey = other.cacheKey;
+        this->isShared = other.isShared;
+        other.collider = nullptr;
+    }
+
+    void ShapeBase::MakeUnique()
+    {
+        if (!this->isShared) return;
+
+        auto shape = ShapeCache::CreateUnique(this->cacheKey);
+        ShapeCache::Release(this->cacheKey);
+        this->collider = shape;
+        this->isShared = false;
+    }
+
+    bool ShapeBase::ReplaceScaledShape(const Vector3& scale)
+    {
+        if (this->isShared)
+        {
+            if (scale == this->cacheKey.Scale) return false;
+
+            // previous shape is released by caller only after it is no longer used by rigid body
+            auto key = this->cacheKey;
+            key.Scale = scale;
+            this->collider = ShapeCache::Acquire(key);
+            this->cacheKey = key;
+            return true;
+        }
+        else
+        {
+            this->collider->setLocalScaling(ToBulletVector3(scale));
+            return false;
+        }
     }
 
     Vector3 ShapeBase::GetScale() const
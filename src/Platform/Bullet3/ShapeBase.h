@@ -31,6 +31,7 @@
 #include "Core/BoundingObjects/BoundingSphere.h"
 #include "Utilities/Memory/Memory.h"
 #include "Core/Components/Transform.h"
+#include "ShapeCache.h"
 
 class btCollisionShape;
 
@@ -40,17 +41,42 @@ namespace MxEngine
     {
     protected:
         btCollisionShape* collider = nullptr;
+        ShapeCacheKey cacheKey;
+        bool isShared = false;
 
         void DestroyShape();
+        void AcquireShape(const ShapeCacheKey& key);
+        void TakeShape(ShapeBase& other);
+        bool ReplaceScaledShape(const Vector3& scale);
 
         template<typename T, typename... Args>
         T* CreateShape(Args&&... args)
         {
             this->collider = Alloc<T>(std::forward<Args>(args)...);
+            this->isShared = false;
+            ShapeCache::RegisterUnique(this->collider);
             return static_cast<T*>(this->collider);
         }
     public:
-        void SetScale(const Vector3& scale);
+        /*!
+        replaces shared shape with a copy owned by this object, so it can be modified. Used by compound shapes, which change scale of their children
+        */
+        void MakeUnique();
+        /*!
+        sets scale of shape. Shared shapes are not modified, instead shape with the same dimensions and new scale is acquired from cache,
+        so GetNativeHandle() may return other pointer after this call
+        \param scale new local scale of shape
+        \param applyShape callable with (btCollisionShape*) signature, which sets new shape to its users. It is invoked before previous
+        shared shape is released, as the shape may be destroyed by release while rigid body still references it
+        */
+        template<typename F>
+        void SetScale(const Vector3& scale, F&& applyShape)
+        {
+            auto previousKey = this->cacheKey;
+            bool isReplaced = this->ReplaceScaledShape(scale);
+            applyShape(this->collider);
+            if (isReplaced) ShapeCache::Release(previousKey);
+        }
         Vector3 GetScale() const;
         btCollisionShape* GetNativeHandle();
         AABB GetAABB(const TransformComponent& transform) const;
@@ -0,0 +1,193 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ShapeCache.h"
+#include "Bullet3Utils.h"
+#include "Utilities/Memory/Memory.h"
+#include "Platform/Modules/PhysicsModule.h"
+
+#include <cstring>
+
+using btCylinderShapeY = btCylinderShape;
+using btCapsuleShapeY = btCapsuleShape;
+
+namespace MxEngine
+{
+    bool ShapeCacheKey::operator==(const ShapeCacheKey& other) const
+    {
+        return this->Type == other.Type && this->Dimensions == other.Dimensions && this->Scale == other.Scale;
+    }
+
+    size_t ShapeCacheKeyHash::operator()(const ShapeCacheKey& key) const
+    {
+        // floats are hashed by their bits. Negative zero is equal to positive one, so it is normalized before hashing
+        float values[] = {
+            key.Dimensions.x, key.Dimensions.y, key.Dimensions.z,
+            key.Scale.x, key.Scale.y, key.Scale.z,
+        };
+        uint64_t hash = 14695981039346656037ull ^ (uint64_t)key.Type;
+        for (float value : values)
+        {
+            if (value == 0.0f) value = 0.0f;
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211ull;
+        }
+        return (size_t)hash;
+    }
+
+    static ShapeCacheData& GetCache()
+    {
+        return PhysicsModule::GetImpl()->Shapes;
+    }
+
+    static size_t GetShapeByteSize(const btCollisionShape* shape)
+    {
+        switch (shape->getShapeType())
+        {
+        case BOX_SHAPE_PROXYTYPE:
+            return sizeof(btBoxShape);
+        case SPHERE_SHAPE_PROXYTYPE:
+            return sizeof(btSphereShape);
+        case CYLINDER_SHAPE_PROXYTYPE:
+            return sizeof(btCylinderShape);
+        case CAPSULE_SHAPE_PROXYTYPE:
+            return sizeof(btCapsuleShape);
+        case COMPOUND_SHAPE_PROXYTYPE:
+            return sizeof(btCompoundShape); // children are accounted separately
+        default:
+            return sizeof(btCollisionShape);
+        }
+    }
+
+    static btCollisionShape* CreateShape(const ShapeCacheKey& key)
+    {
+        btCollisionShape* shape = nullptr;
+        auto dimensions = ToBulletVector3(key.Dimensions);
+        switch (key.Type)
+        {
+        case ShapeType::BOX:
+            shape = Alloc<btBoxShape>(dimensions);
+            break;
+        case ShapeType::SPHERE:
+            shape = Alloc<btSphereShape>(key.Dimensions.x);
+            break;
+        case ShapeType::CYLINDER_X:
+            shape = Alloc<btCylinderShapeX>(dimensions);
+            break;
+        case ShapeType::CYLINDER_Y:
+            shape = Alloc<btCylinderShapeY>(dimensions);
+            break;
+        case ShapeType::CYLINDER_Z:
+            shape = Alloc<btCylinderShapeZ>(dimensions);
+            break;
+        case ShapeType::CAPSULE_X:
+            shape = Alloc<btCapsuleShapeX>(key.Dimensions.x, key.Dimensions.y);
+            break;
+        case ShapeType::CAPSULE_Y:
+            shape = Alloc<btCapsuleShapeY>(key.Dimensions.x, key.Dimensions.y);
+            break;
+        case ShapeType::CAPSULE_Z:
+            shape = Alloc<btCapsuleShapeZ>(key.Dimensions.x, key.Dimensions.y);
+            break;
+        }
+        shape->setLocalScaling(ToBulletVector3(key.Scale));
+
+        auto& stats = GetCache().Stats;
+        stats.CreatedShapeCount++;
+        stats.ShapeMemory += GetShapeByteSize(shape);
+        return shape;
+    }
+
+    static void FreeShape(btCollisionShape* shape)
+    {
+        GetCache().Stats.ShapeMemory -= GetShapeByteSize(shape);
+        Free(shape);
+    }
+
+    btCollisionShape* ShapeCache::Acquire(const ShapeCacheKey& key)
+    {
+        auto& cache = GetCache();
+        auto& entry = cache.Shapes[key];
+        if (entry.Shape == nullptr)
+        {
+            entry.Shape = CreateShape(key);
+            cache.Stats.SharedShapeCount++;
+        }
+        else
+        {
+            cache.Stats.CacheHitCount++;
+        }
+        entry.ReferenceCount++;
+        cache.Stats.SharedReferenceCount++;
+        return entry.Shape;
+    }
+
+    void ShapeCache::Release(const ShapeCacheKey& key)
+    {
+        auto& cache = GetCache();
+        auto it = cache.Shapes.find(key);
+        MX_ASSERT(it != cache.Shapes.end());
+
+        auto& entry = it->second;
+        cache.Stats.SharedReferenceCount--;
+        entry.ReferenceCount--;
+        if (entry.ReferenceCount == 0)
+        {
+            FreeShape(entry.Shape);
+            cache.Shapes.erase(it);
+            cache.Stats.SharedShapeCount--;
+        }
+    }
+
+    btCollisionShape* ShapeCache::CreateUnique(const ShapeCacheKey& key)
+    {
+        GetCache().Stats.UniqueShapeCount++;
+        return CreateShape(key);
+    }
+
+    void ShapeCache::RegisterUnique(btCollisionShape* shape)
+    {
+        auto& stats = GetCache().Stats;
+        stats.UniqueShapeCount++;
+        stats.CreatedShapeCount++;
+        stats.ShapeMemory += GetShapeByteSize(shape);
+    }
+
+    void ShapeCache::DestroyUnique(btCollisionShape* shape)
+    {
+        GetCache().Stats.UniqueShapeCount--;
+        FreeShape(shape);
+    }
+
+    ShapeCacheStats ShapeCache::GetStats()
+    {
+        return GetCache().Stats;
+    }
+}
@@ -0,0 +1,123 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/Math/Math.h"
+#include "Utilities/STL/MxHashMap.h"
+
+class btCollisionShape;
+
+namespace MxEngine
+{
+    enum class ShapeType : uint8_t
+    {
+        BOX,
+        SPHERE,
+        CYLINDER_X,
+        CYLINDER_Y,
+        CYLINDER_Z,
+        CAPSULE_X,
+        CAPSULE_Y,
+        CAPSULE_Z,
+    };
+
+    /*!
+    identifies shared collision shape. Dimensions are arguments of bullet shape constructor:
+    half extents for boxes and cylinders, radius in x for spheres, radius and height in x and y for capsules
+    */
+    struct ShapeCacheKey
+    {
+        ShapeType Type = ShapeType::BOX;
+        Vector3 Dimensions{ 0.0f };
+        Vector3 Scale{ 1.0f };
+
+        bool operator==(const ShapeCacheKey& other) const;
+    };
+
+    struct ShapeCacheKeyHash
+    {
+        size_t operator()(const ShapeCacheKey& key) const;
+    };
+
+    struct ShapeCacheStats
+    {
+        size_t SharedShapeCount = 0;
+        size_t SharedReferenceCount = 0;
+        size_t UniqueShapeCount = 0; // compound shapes and their children are never shared
+        size_t CreatedShapeCount = 0;
+        size_t CacheHitCount = 0;
+        size_t ShapeMemory = 0; // approximate size of all alive shapes in bytes
+    };
+
+    struct ShapeCacheEntry
+    {
+        btCollisionShape* Shape = nullptr;
+        size_t ReferenceCount = 0;
+    };
+
+    struct ShapeCacheData
+    {
+        MxHashMap<ShapeCacheKey, ShapeCacheEntry, ShapeCacheKeyHash> Shapes;
+        ShapeCacheStats Stats;
+    };
+
+    /*!
+    owns bullet shapes of colliders. Shapes with same type, dimensions and scale are created once and shared by all colliders.
+    Shared shapes are never modified, scale change acquires shape with new scale instead of changing local scaling
+    */
+    class ShapeCache
+    {
+    public:
+        /*!
+        returns shared shape for key, creating it if no collider uses it yet
+        \param key type, dimensions and scale of shape
+        \returns shape which must be released with Release() using the same key
+        */
+        static btCollisionShape* Acquire(const ShapeCacheKey& key);
+        /*!
+        decrements reference count of shared shape and destroys it if it is no longer used
+        \param key key which was used to acquire shape
+        */
+        static void Release(const ShapeCacheKey& key);
+        /*!
+        creates shape which is owned by caller and can be modified, for example when it is added to compound shape
+        \param key type, dimensions and scale of shape
+        \returns shape which must be destroyed with DestroyUnique()
+        */
+        static btCollisionShape* CreateUnique(const ShapeCacheKey& key);
+        /*!
+        registers shape created outside of cache, so it is accounted in statistics
+        \param shape newly created shape
+        */
+        static void RegisterUnique(btCollisionShape* shape);
+        static void DestroyUnique(btCollisionShape* shape);
+        static ShapeCacheStats GetStats();
+    };
+}
@@ -34,7 +34,7 @@ namespace MxEngine
 {
     SphereShape::SphereShape(float radius)
     {
-        this->CreateShape<btSphereShape>(radius);
+        this->AcquireShape({ ShapeType::SPHERE, MakeVector3(radius, 0.0f, 0.0f) });
     }
 
     SphereShape::SphereShape(const BoundingSphere& sphere)
@@ -45,15 +45,13 @@ namespace MxEngine
 
     SphereShape::SphereShape(SphereShape&& other) noexcept
     {
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
     }
 
     SphereShape& SphereShape::operator=(SphereShape&& other) noexcept
     {
         this->DestroyShape();
-        this->collider = other.collider;
-        other.collider = nullptr;
+        this->TakeShape(other);
         return *this;
     }
 
@@ -0,0 +1,111 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ThreadPoolTaskScheduler.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Math/Math.h"
+
+namespace MxEngine
+{
+    ThreadPoolTaskScheduler::ThreadPoolTaskScheduler()
+        : btITaskScheduler("MxEngine::ThreadPool")
+    {
+        // bullet assigns thread indices in order of first use, and expects main thread to have zero index
+        (void)btGetCurrentThreadIndex();
+        this->threadCount = this->GetMaxConcurrency();
+    }
+
+    size_t ThreadPoolTaskScheduler::GetGranularity(int iBegin, int iEnd, int grainSize) const
+    {
+        // range is split into at most threadCount chunks, but chunks are never smaller than bullet grain size
+        size_t count = size_t(iEnd - iBegin);
+        size_t threads = (size_t)this->GetConcurrency();
+        return Max((size_t)Max(grainSize, 1), (count + threads - 1) / threads);
+    }
+
+    int ThreadPoolTaskScheduler::getMaxNumThreads() const
+    {
+        return (int)BT_MAX_THREAD_COUNT;
+    }
+
+    int ThreadPoolTaskScheduler::getNumThreads() const
+    {
+        // thread indices are not bound to thread pool size, so per-thread storage of bullet must cover all of them
+        return (int)BT_MAX_THREAD_COUNT;
+    }
+
+    void ThreadPoolTaskScheduler::setNumThreads(int numThreads)
+    {
+        this->threadCount = Clamp(numThreads, 1, this->GetMaxConcurrency());
+    }
+
+    int ThreadPoolTaskScheduler::GetConcurrency() const
+    {
+        // thread pool may be resized after thread count was set
+        return Min(this->threadCount, this->GetMaxConcurrency());
+    }
+
+    int ThreadPoolTaskScheduler::GetMaxConcurrency() const
+    {
+        return Min((int)ThreadPool::GetWorkerCount() + 1, (int)BT_MAX_THREAD_COUNT);
+    }
+
+    void ThreadPoolTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+    {
+        MAKE_SCOPE_PROFILER("ThreadPoolTaskScheduler::parallelFor()");
+        if (iEnd <= iBegin) return;
+
+        size_t granularity = this->GetGranularity(iBegin, iEnd, grainSize);
+        ThreadPool::ParallelFor(size_t(iEnd - iBegin), granularity, [iBegin, &body](size_t begin, size_t end)
+        {
+            body.forLoop(iBegin + (int)begin, iBegin + (int)end);
+        });
+    }
+
+    btScalar ThreadPoolTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+    {
+        MAKE_SCOPE_PROFILER("ThreadPoolTaskScheduler::parallelSum()");
+        if (iEnd <= iBegin) return btScalar(0);
+
+        size_t count = size_t(iEnd - iBegin);
+        size_t granularity = this->GetGranularity(iBegin, iEnd, grainSize);
+        MxVector<btScalar> sums((count + granularity - 1) / granularity, btScalar(0));
+        ThreadPool::ParallelFor(count, granularity, [iBegin, granularity, &body, &sums](size_t begin, size_t end)
+        {
+            sums[begin / granularity] = body.sumLoop(iBegin + (int)begin, iBegin + (int)end);
+        });
+
+        // partial sums are added in fixed order, so result does not depend on thread scheduling
+        btScalar sum = btScalar(0);
+        for (btScalar partial : sums)
+            sum += partial;
+        return sum;
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <LinearMath/btThreads.h>
+
+namespace MxEngine
+{
+    /*!
+    bullet task scheduler which executes parallel loops of multithreaded dynamics world on engine thread pool.
+    Calling thread always participates in loop processing, so one thread is used even if thread pool has no workers.
+    Bullet sizes its per-thread storage by getNumThreads() and indexes it by btGetCurrentThreadIndex(), which is assigned to each thread
+    on first use. As any pool worker (including ones started after resize) and physics thread may run loop chunks, scheduler always reports
+    BT_MAX_THREAD_COUNT threads to bullet, and user-defined thread count only limits number of chunks each loop is split into
+    */
+    class ThreadPoolTaskScheduler : public btITaskScheduler
+    {
+        int threadCount = 1;
+
+        size_t GetGranularity(int iBegin, int iEnd, int grainSize) const;
+    public:
+        ThreadPoolTaskScheduler();
+
+        /*!
+        \returns BT_MAX_THREAD_COUNT, as any thread which can be assigned bullet thread index may process loop chunks
+        */
+        virtual int getMaxNumThreads() const override;
+        /*!
+        \returns BT_MAX_THREAD_COUNT, as any thread which can be assigned bullet thread index may process loop chunks
+        */
+        virtual int getNumThreads() const override;
+        /*!
+        sets maximal number of chunks which one parallel loop is split into. Value is clamped to [1, GetMaxConcurrency()]
+        */
+        virtual void setNumThreads(int numThreads) override;
+        /*!
+        \returns number of threads which process one parallel loop, i.e. value set by setNumThreads() limited by current thread pool size
+        */
+        int GetConcurrency() const;
+        /*!
+        \returns number of thread pool workers plus calling thread (limited by BT_MAX_THREAD_COUNT)
+        */
+        int GetMaxConcurrency() const;
+        virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+        virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+    };
+}
@@ -25,47 +25,120 @@
 // CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
 // OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-
 #include "PhysicsModule.h"
 #include "Utilities/Memory/Memory.h"
 #include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
 #include "Platform/Bullet3/Bullet3Utils.h"
+#include "Platform/Bullet3/ThreadPoolTaskScheduler.h"
+
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+
+#include <random>
+#include <cmath>
+#include <algorithm>
 
 namespace MxEngine
 {
     // defined in Core/Application/Physics.cpp
     void OnCollisionCallback();
+    void SubmitRigidBodyUpdates();
+    void FetchRigidBodyTransforms();
+    void ApplyInterpolatedRigidBodyTransforms(const MxVector<PhysicsBodyState>& states, float alpha);
+
+    // defined in Platform/Bullet3/NativeRigidBody.cpp
+    void ConsumeMotionState(btRigidBody* body, PhysicsBodyState& state);
+
+    void PhysicsModule::CreateWorld(PhysicsWorldData& world, bool isMultithreaded)
+    {
+        world.IsMultithreaded = isMultithreaded;
+        if (isMultithreaded)
+        {
+            // pools are shared by all threads, so they are preallocated to avoid locking on allocation
+            btDefaultCollisionConstructionInfo info;
+            info.m_defaultMaxPersistentManifoldPoolSize = 80000;
+            info.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+            constexpr int collisionGrainSize = 40;
+
+            world.CollisionConfiguration = Alloc<btDefaultCollisionConfiguration>(info);
+            world.Dispatcher = Alloc<btCollisionDispatcherMt>(world.CollisionConfiguration, collisionGrainSize);
+            world.Broadphase = Alloc<btDbvtBroadphase>();
+            world.SolverPool = Alloc<btConstraintSolverPoolMt>(BT_MAX_THREAD_COUNT);
+            auto solver = Alloc<btSequentialImpulseConstraintSolverMt>();
+            world.Solver = solver;
+            world.World = Alloc<btDiscreteDynamicsWorldMt>(
+                world.Dispatcher, world.Broadphase, world.SolverPool, solver, world.CollisionConfiguration
+            );
+        }
+        else
+        {
+            world.CollisionConfiguration = Alloc<btDefaultCollisionConfiguration>();
+            world.Dispatcher = Alloc<btCollisionDispatcher>(world.CollisionConfiguration);
+            world.Broadphase = Alloc<btDbvtBroadphase>();
+            world.Solver = Alloc<btSequentialImpulseConstraintSolver>();
+            world.SolverPool = nullptr;
+            world.World = Alloc<btDiscreteDynamicsWorld>(
+                world.Dispatcher, world.Broadphase, world.Solver, world.CollisionConfiguration
+            );
+        }
+        world.Solver->reset();
+        world.World->setGravity(btVector3(0.0f, -9.8f, 0.0f));
+    }
+
+    void PhysicsModule::DestroyWorld(PhysicsWorldData& world)
+    {
+        Free(world.World);
+        Free(world.Solver);
+        if (world.SolverPool != nullptr) Free(world.SolverPool);
+        Free(world.Broadphase);
+        Free(world.Dispatcher);
+        Free(world.CollisionConfiguration);
+        world.SolverPool = nullptr;
+    }
 
     void PhysicsModule::Init()
     {
         data = Alloc<PhysicsModuleData>();
-        data->CollisionConfiguration = Alloc<btDefaultCollisionConfiguration>();
-        data->Dispatcher = Alloc<btCollisionDispatcher>(data->CollisionConfiguration);
-        data->Broadphase = Alloc<btDbvtBroadphase>();
-        data->Solver = Alloc<btSequentialImpulseConstraintSolver>();
-        data->Solver->reset();
-        data->World = Alloc<btDiscreteDynamicsWorld>(
-            data->Dispatcher, data->Broadphase, data->Solver, data->CollisionConfiguration
-        );
-
-        data->World->setGravity(btVector3(0.0f, -9.8f, 0.0f));
+        // scheduler is global for bullet, so it is installed once and used by all multithreaded worlds
+        data->TaskScheduler = Alloc<ThreadPoolTaskScheduler>();
+        btSetTaskScheduler(data->TaskScheduler);
+        PhysicsModule::CreateWorld(*data, false);
     }
 
     void PhysicsModule::Destroy()
     {
-        Free(data->World);
-        Free(data->Solver);
-        Free(data->Broadphase);
-        Free(data->Dispatcher);
-        Free(data->CollisionConfiguration);
+        if (data->SimulationThread.IsRunning)
+            PhysicsModule::StopSimulationThread();
+        PhysicsModule::DestroyWorld(*data);
+        btSetTaskScheduler(btGetSequentialTaskScheduler());
+        Free(data->TaskScheduler);
         Free(data);
     }
 
     void PhysicsModule::OnUpdate(float dt)
     {
+        SubmitRigidBodyUpdates();
+        auto& thread = data->SimulationThread;
+        if (thread.IsRunning)
+        {
+            // world is locked by BeginFrame(), requested time is simulated by physics thread after EndFrame()
+            PhysicsModule::FetchBodyStates();
+            OnCollisionCallback();
+            if (data->simulationStep != 0.0f)
+            {
+                constexpr float maxSubSteps = 10.0f;
+                thread.StepBudget = Min(thread.StepBudget + dt, maxSubSteps * thread.FixedStep);
+            }
+            return;
+        }
+
         if (data->simulationStep != 0.0f)
         {
             PhysicsModule::PerformSimulationStep(Min(dt, data->simulationStep));
+            FetchRigidBodyTransforms();
             OnCollisionCallback();
         }
     }
@@ -75,6 +148,10 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("Physics::SimulationStep()");
         constexpr int maxSubSteps = 10;
         data->World->stepSimulation(dt, maxSubSteps);
+
+        // extra steps done by main thread are published in the same way as steps of physics thread
+        if (data->SimulationThread.IsRunning)
+            PhysicsModule::PublishBodyStates();
     }
 
     void PhysicsModule::SetSimulationStep(float timedelta)
@@ -87,6 +164,353 @@ namespace MxEngine
         return data->simulationStep;
     }
 
+    void PhysicsModule::SetMultithreading(bool isEnabled, size_t threadCount)
+    {
+        int previousThreadCount = data->TaskScheduler->GetConcurrency();
+        int maxThreadCount = data->TaskScheduler->GetMaxConcurrency();
+        data->TaskScheduler->setNumThreads(threadCount == 0 ? maxThreadCount : (int)Min(threadCount, (size_t)maxThreadCount));
+
+        // solver and dispatcher of multithreaded world are configured for thread count at construction, so world is rebuilt when it changes
+        bool isThreadCountChanged = data->TaskScheduler->GetConcurrency() != previousThreadCount;
+        if (data->IsMultithreaded == isEnabled && !(isEnabled && isThreadCountChanged)) return;
+
+        PhysicsWorldData world;
+        PhysicsModule::CreateWorld(world, isEnabled);
+        world.World->setGravity(data->World->getGravity());
+
+        // bodies are moved with their collision filters. Objects are removed from the end, as removal swaps with the last element
+        auto& objects = data->World->getCollisionObjectArray();
+        for (int i = objects.size() - 1; i >= 0; i--)
+        {
+            btCollisionObject* object = objects[i];
+            auto handle = object->getBroadphaseHandle();
+            int group = handle->m_collisionFilterGroup;
+            int mask = handle->m_collisionFilterMask;
+
+            btRigidBody* body = btRigidBody::upcast(object);
+            if (body != nullptr)
+            {
+                data->World->removeRigidBody(body);
+                world.World->addRigidBody(body, group, mask);
+            }
+            else
+            {
+                data->World->removeCollisionObject(object);
+                world.World->addCollisionObject(object, group, mask);
+            }
+        }
+
+        PhysicsModule::DestroyWorld(*data);
+        static_cast<PhysicsWorldData&>(*data) = world;
+        MXLOG_INFO("MxEngine::PhysicsModule", MxFormat("switched to {0} dynamics world, {1} threads",
+            isEnabled ? "multithreaded" : "single-threaded", PhysicsModule::GetThreadCount()));
+    }
+
+    bool PhysicsModule::IsMultithreaded()
+    {
+        return data->IsMultithreaded;
+    }
+
+    size_t PhysicsModule::GetThreadCount()
+    {
+        return data->IsMultithreaded ? (size_t)data->TaskScheduler->GetConcurrency() : 1;
+    }
+
+    void PhysicsModule::RunSimulationThread()
+    {
+        auto& thread = data->SimulationThread;
+        std::unique_lock<std::mutex> lock(thread.WorldMutex);
+        while (true)
+        {
+            thread.StepRequested.wait(lock, [&thread]() { return !thread.IsRunning || thread.StepBudget >= thread.FixedStep; });
+            if (!thread.IsRunning) break;
+
+            // forces are cleared by bullet after each step, so they are reapplied until main thread submits new ones
+            for (const auto& command : thread.ForceCommands)
+            {
+                command.Body->activate(true);
+                command.Body->applyForce(ToBulletVector3(command.Force), ToBulletVector3(command.RelativePosition));
+                command.Body->applyTorque(ToBulletVector3(command.Torque));
+            }
+
+            // loops of multithreaded world wait only for their own task group, so world is never held while unrelated pool tasks run
+            data->World->stepSimulation(thread.FixedStep, 1, thread.FixedStep);
+            PhysicsModule::PublishBodyStates();
+            thread.StepBudget -= thread.FixedStep;
+        }
+    }
+
+    void PhysicsModule::StopSimulationThread()
+    {
+        auto& thread = data->SimulationThread;
+        if (!thread.IsInsideFrame) thread.WorldMutex.lock();
+        thread.IsRunning = false;
+        thread.WorldMutex.unlock();
+        thread.StepRequested.notify_one();
+        thread.Thread.join();
+    }
+
+    void PhysicsModule::PublishBodyStates()
+    {
+        auto& thread = data->SimulationThread;
+        thread.StepCount++;
+
+        for (auto body : data->MovedBodies)
+        {
+            // user index 2 stores position of body state in back buffer. It is validated, as buffer is cleared when states are fetched
+            int index = body->getUserIndex2();
+            if (index < 0 || index >= (int)thread.BackStates.size() || thread.BackStates[index].Body != body)
+            {
+                index = (int)thread.BackStates.size();
+                thread.BackStates.push_back(PhysicsBodyState{ });
+                thread.BackStates.back().Body = body;
+                body->setUserIndex2(index);
+            }
+            auto& state = thread.BackStates[index];
+            ConsumeMotionState(body, state);
+            state.LastStep = thread.StepCount;
+        }
+        data->MovedBodies.clear();
+
+        // bodies which stopped are kept until states are fetched, so main thread gets their final transforms
+        for (auto& state : thread.BackStates)
+        {
+            if (state.LastStep != thread.StepCount)
+            {
+                state.PreviousPosition = state.CurrentPosition;
+                state.PreviousRotation = state.CurrentRotation;
+            }
+        }
+    }
+
+    void PhysicsModule::FetchBodyStates()
+    {
+        MAKE_SCOPE_PROFILER("Physics::FetchBodyStates()");
+        auto& thread = data->SimulationThread;
+        if (thread.FetchedStepCount != thread.StepCount)
+        {
+            // bodies which did not move since last fetch are not published again, so they are moved to their final transforms
+            ApplyInterpolatedRigidBodyTransforms(thread.FrontStates, 1.0f);
+            std::swap(thread.FrontStates, thread.BackStates);
+            thread.BackStates.clear();
+            thread.FetchedStepCount = thread.StepCount;
+        }
+
+        // rendered state lags one step behind simulation, remaining budget is time passed since last step
+        float alpha = Clamp(thread.StepBudget / thread.FixedStep, 0.0f, 1.0f);
+        ApplyInterpolatedRigidBodyTransforms(thread.FrontStates, alpha);
+    }
+
+    void PhysicsModule::SetThreadedSimulation(bool isEnabled, float fixedStep)
+    {
+        auto& thread = data->SimulationThread;
+        if (!isEnabled && !thread.IsRunning) return;
+        if (thread.IsRunning)
+        {
+            PhysicsModule::StopSimulationThread();
+            ApplyInterpolatedRigidBodyTransforms(thread.FrontStates, 1.0f);
+            ApplyInterpolatedRigidBodyTransforms(thread.BackStates, 1.0f);
+            thread.FrontStates.clear();
+            thread.BackStates.clear();
+            thread.ForceCommands.clear();
+        }
+
+        if (isEnabled)
+        {
+            MX_ASSERT(fixedStep > 0.0f);
+            thread.FixedStep = fixedStep;
+            thread.StepBudget = 0.0f;
+            thread.FetchedStepCount = thread.StepCount;
+            thread.IsRunning = true;
+
+            // if called during frame update, physics thread must wait until frame is finished
+            if (thread.IsInsideFrame) thread.WorldMutex.lock();
+            thread.Thread = std::thread(&PhysicsModule::RunSimulationThread);
+        }
+        MXLOG_INFO("MxEngine::PhysicsModule", MxFormat("physics thread {0}, fixed step {1} ms",
+            isEnabled ? "enabled" : "disabled", thread.FixedStep * 1000.0f));
+    }
+
+    bool PhysicsModule::IsThreadedSimulation()
+    {
+        return data->SimulationThread.IsRunning;
+    }
+
+    void PhysicsModule::BeginFrame()
+    {
+        auto& thread = data->SimulationThread;
+        if (thread.IsInsideFrame) return;
+
+        thread.IsInsideFrame = true;
+        if (thread.IsRunning)
+        {
+            MAKE_SCOPE_PROFILER("Physics::WaitForSimulationStep()");
+            thread.WorldMutex.lock();
+            thread.ForceCommands.clear();
+        }
+    }
+
+    void PhysicsModule::EndFrame()
+    {
+        auto& thread = data->SimulationThread;
+        if (!thread.IsInsideFrame) return;
+
+        thread.IsInsideFrame = false;
+        if (thread.IsRunning)
+        {
+            thread.WorldMutex.unlock();
+            thread.StepRequested.notify_one();
+        }
+    }
+
+    void PhysicsModule::ApplyForce(btRigidBody* body, const Vector3& force, const Vector3& relativePosition, const Vector3& torque)
+    {
+        if (data->SimulationThread.IsRunning)
+        {
+            data->SimulationThread.ForceCommands.push_back(PhysicsForceCommand{ body, force, relativePosition, torque });
+        }
+        else
+        {
+            body->activate(true);
+            body->applyForce(ToBulletVector3(force), ToBulletVector3(relativePosition));
+            body->applyTorque(ToBulletVector3(torque));
+        }
+    }
+
+    void PhysicsModule::RemoveBodyState(btRigidBody* body)
+    {
+        auto& thread = data->SimulationThread;
+        for (size_t i = 0; i < thread.BackStates.size(); i++)
+        {
+            if (thread.BackStates[i].Body != body) continue;
+            thread.BackStates[i] = thread.BackStates.back();
+            thread.BackStates.pop_back();
+            if (i < thread.BackStates.size())
+                thread.BackStates[i].Body->setUserIndex2((int)i);
+            break;
+        }
+        for (size_t i = 0; i < thread.FrontStates.size(); i++)
+        {
+            if (thread.FrontStates[i].Body != body) continue;
+            thread.FrontStates[i] = thread.FrontStates.back();
+            thread.FrontStates.pop_back();
+            break;
+        }
+
+        auto& commands = thread.ForceCommands;
+        commands.erase(std::remove_if(commands.begin(), commands.end(),
+            [body](const PhysicsForceCommand& command) { return command.Body == body; }), commands.end());
+    }
+
+    /*!
+    steps benchmark scene and measures step time. Half of columns are neat box stacks, other half are jumbled boxes with random rotations
+    */
+    static PhysicsBenchmarkTiming RunBenchmarkWorld(btDiscreteDynamicsWorld& world, size_t bodyCount, size_t stepCount)
+    {
+        constexpr size_t columnHeight = 10;
+        constexpr float boxSize = 1.0f;
+        constexpr float timeStep = 1.0f / 60.0f;
+
+        btBoxShape groundShape(btVector3(1000.0f, 1.0f, 1000.0f));
+        btBoxShape boxShape(btVector3(0.5f * boxSize, 0.5f * boxSize, 0.5f * boxSize));
+        btVector3 inertia;
+        boxShape.calculateLocalInertia(1.0f, inertia);
+
+        btRigidBody ground(0.0f, nullptr, &groundShape);
+        ground.setWorldTransform(btTransform(btQuaternion::getIdentity(), btVector3(0.0f, -1.0f, 0.0f)));
+        world.addRigidBody(&ground);
+
+        size_t columnCount = (bodyCount + columnHeight - 1) / columnHeight;
+        size_t columnsPerRow = (size_t)std::ceil(std::sqrt((float)columnCount));
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+        std::uniform_real_distribution<float> angle(0.0f, TwoPi<float>());
+
+        MxVector<btRigidBody*> bodies;
+        bodies.reserve(bodyCount);
+        for (size_t i = 0; i < bodyCount; i++)
+        {
+            size_t column = i / columnHeight;
+            size_t level = i % columnHeight;
+            bool isJumbled = column % 2 == 1;
+
+            btVector3 position(
+                (float(column % columnsPerRow) - 0.5f * float(columnsPerRow)) * 2.0f * boxSize,
+                (float(level) + 0.5f) * boxSize * (isJumbled ? 1.5f : 1.0f),
+                (float(column / columnsPerRow) - 0.5f * float(columnsPerRow)) * 2.0f * boxSize
+            );
+            btQuaternion rotation = btQuaternion::getIdentity();
+            if (isJumbled)
+            {
+                position += btVector3(offset(generator), 0.0f, offset(generator));
+                rotation.setEuler(angle(generator), angle(generator), angle(generator));
+            }
+
+            auto body = Alloc<btRigidBody>(1.0f, nullptr, &boxShape, inertia);
+            body->setWorldTransform(btTransform(rotation, position));
+            world.addRigidBody(body);
+            bodies.push_back(body);
+        }
+
+        PhysicsBenchmarkTiming result;
+        TimeStep totalTime = 0.0f;
+        for (size_t step = 0; step < stepCount; step++)
+        {
+            TimeStep start = Time::Current();
+            world.stepSimulation(timeStep, 1, timeStep);
+            TimeStep stepTime = Time::Current() - start;
+            totalTime += stepTime;
+            result.MaxStepTime = Max(result.MaxStepTime, stepTime);
+        }
+        result.AverageStepTime = totalTime / float(Max(stepCount, (size_t)1));
+
+        float totalHeight = 0.0f;
+        for (auto body : bodies)
+        {
+            totalHeight += body->getWorldTransform().getOrigin().y();
+            world.removeRigidBody(body);
+            Free(body);
+        }
+        world.removeRigidBody(&ground);
+        result.AverageHeight = totalHeight / float(Max(bodyCount, (size_t)1));
+        return result;
+    }
+
+    PhysicsBenchmark PhysicsModule::RunBenchmark(size_t bodyCount, size_t stepCount)
+    {
+        MAKE_SCOPE_PROFILER("PhysicsModule::RunBenchmark()");
+        PhysicsBenchmark result;
+        result.BodyCount = bodyCount;
+        result.StepCount = stepCount;
+
+        auto measure = [&](bool isMultithreaded, int threadCount)
+        {
+            data->TaskScheduler->setNumThreads(threadCount);
+            PhysicsWorldData world;
+            PhysicsModule::CreateWorld(world, isMultithreaded);
+            auto timing = RunBenchmarkWorld(*world.World, bodyCount, stepCount);
+            timing.IsMultithreaded = isMultithreaded;
+            timing.ThreadCount = isMultithreaded ? (size_t)data->TaskScheduler->GetConcurrency() : 1;
+            PhysicsModule::DestroyWorld(world);
+
+            MXLOG_INFO("MxEngine::PhysicsModule", MxFormat("benchmark {0} bodies, {1} world, {2} threads: step {3} ms avg, {4} ms max, average height {5}",
+                bodyCount, isMultithreaded ? "multithreaded" : "single-threaded", timing.ThreadCount,
+                timing.AverageStepTime * 1000.0f, timing.MaxStepTime * 1000.0f, timing.AverageHeight));
+            result.Timings.push_back(timing);
+        };
+
+        // scheduler is shared with engine world, so its thread count is restored after benchmark
+        int engineThreadCount = data->TaskScheduler->GetConcurrency();
+        int maxThreadCount = data->TaskScheduler->GetMaxConcurrency();
+        measure(false, 1);
+        for (int threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+            measure(true, threadCount);
+        measure(true, maxThreadCount);
+        data->TaskScheduler->setNumThreads(engineThreadCount);
+
+        return result;
+    }
+
     PhysicsModuleData* PhysicsModule::GetImpl()
     {
         return PhysicsModule::data;
@@ -96,4 +520,4 @@ namespace MxEngine
     {
         PhysicsModule::data = impl;
     }
-}
\ No newline at end of file
+}
@@ -28,28 +28,119 @@
 
 #pragma once
 
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+#include "Utilities/Math/Math.h"
+#include "Platform/Bullet3/ShapeCache.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 class btCollisionConfiguration;
 class btDispatcher;
 class btBroadphaseInterface;
 class btConstraintSolver;
 class btDiscreteDynamicsWorld;
+class btConstraintSolverPoolMt;
 class btRigidBody;
 
 namespace MxEngine
 {
-	struct PhysicsModuleData //-V730
+	class ThreadPoolTaskScheduler;
+
+	struct PhysicsWorldData //-V730
 	{
 		btCollisionConfiguration* CollisionConfiguration;
 		btDispatcher* Dispatcher;
 		btBroadphaseInterface*  Broadphase;
 		btConstraintSolver* Solver;
+		btConstraintSolverPoolMt* SolverPool = nullptr; // used only by multithreaded world
 		btDiscreteDynamicsWorld* World;
+		bool IsMultithreaded = false;
+	};
+
+	/*!
+	transforms of body after two last simulation steps, published by physics thread and interpolated by main thread
+	*/
+	struct PhysicsBodyState
+	{
+		btRigidBody* Body = nullptr;
+		size_t LastStep = 0;
+		Vector3 PreviousPosition{ 0.0f };
+		Vector3 CurrentPosition{ 0.0f };
+		Quaternion PreviousRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+		Quaternion CurrentRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	/*!
+	force and torque applied to body before each step of threaded simulation until next frame
+	*/
+	struct PhysicsForceCommand
+	{
+		btRigidBody* Body = nullptr;
+		Vector3 Force{ 0.0f };
+		Vector3 RelativePosition{ 0.0f };
+		Vector3 Torque{ 0.0f };
+	};
+
+	struct PhysicsThreadData
+	{
+		std::thread Thread;
+		std::mutex WorldMutex; // held by physics thread during steps and by main thread during frame update
+		std::condition_variable StepRequested;
+		bool IsRunning = false;
+		bool IsInsideFrame = false; // world mutex is held by main thread if physics thread is running, accessed only by main thread
+		float FixedStep = 1.0f / 60.0f;
+		float StepBudget = 0.0f; // simulation time requested by main thread but not yet stepped
+		size_t StepCount = 0;
+		size_t FetchedStepCount = 0;
+		MxVector<PhysicsBodyState> BackStates; // bodies moved since states were last fetched, written by physics thread
+		MxVector<PhysicsBodyState> FrontStates; // bodies interpolated by main thread
+		MxVector<PhysicsForceCommand> ForceCommands; // filled by main thread each frame
+	};
+
+	struct PhysicsModuleData : PhysicsWorldData
+	{
+		ThreadPoolTaskScheduler* TaskScheduler = nullptr;
+		MxVector<btRigidBody*> MovedBodies; // filled by motion states of active bodies during simulation step
+		MxVector<btRigidBody*> KinematicBodies; // transforms of these bodies are submitted before each simulation step
+		MxVector<btRigidBody*> ColliderUpdates; // bodies which colliders were changed since last simulation step
+		PhysicsThreadData SimulationThread;
+		ShapeCacheData Shapes;
 		float simulationStep = 1.0f;
 	};
 
+	/*!
+	step time of one physics benchmark run. Single-threaded world is always measured with one thread.
+	Average height of bodies after last step is used to check that simulation did not explode
+	*/
+	struct PhysicsBenchmarkTiming
+	{
+		bool IsMultithreaded = false;
+		size_t ThreadCount = 1;
+		TimeStep AverageStepTime = 0.0f;
+		TimeStep MaxStepTime = 0.0f;
+		float AverageHeight = 0.0f;
+	};
+
+	struct PhysicsBenchmark
+	{
+		size_t BodyCount = 0;
+		size_t StepCount = 0;
+		MxVector<PhysicsBenchmarkTiming> Timings;
+	};
+
 	class PhysicsModule
 	{
 		inline static PhysicsModuleData* data = nullptr;
+
+		static void CreateWorld(PhysicsWorldData& world, bool isMultithreaded);
+		static void DestroyWorld(PhysicsWorldData& world);
+		static void RunSimulationThread();
+		static void StopSimulationThread();
+		static void PublishBodyStates();
+		static void FetchBodyStates();
 	public:
 		static void Init();
 		static void Destroy();
@@ -58,6 +149,52 @@ namespace MxEngine
 		static void SetSimulationStep(float timedelta);
 		static float GetSimulationStep();
 
+		/*!
+		switches between single-threaded and multithreaded dynamics worlds. All bodies are moved to the new world
+		\param isEnabled if btDiscreteDynamicsWorldMt should be used. Requires bullet built with BT_THREADSAFE
+		\param threadCount maximal number of threads which process physics loops. Zero means all thread pool workers and main thread
+		*/
+		static void SetMultithreading(bool isEnabled, size_t threadCount = 0);
+		static bool IsMultithreaded();
+		static size_t GetThreadCount();
+
+		/*!
+		switches between stepping physics inline in OnUpdate and stepping it on dedicated thread with fixed timestep.
+		Physics thread runs while main thread renders frame, world is locked between BeginFrame() and EndFrame()
+		\param isEnabled if physics should be simulated on dedicated thread
+		\param fixedStep time of one simulation step in seconds
+		*/
+		static void SetThreadedSimulation(bool isEnabled, float fixedStep = 1.0f / 60.0f);
+		static bool IsThreadedSimulation();
+		/*!
+		waits for current step of physics thread to finish and locks world until EndFrame() is called. Does nothing if simulation is not threaded
+		*/
+		static void BeginFrame();
+		/*!
+		unlocks world and lets physics thread simulate time requested by OnUpdate(). Does nothing if simulation is not threaded
+		*/
+		static void EndFrame();
+		/*!
+		applies force and torque to body. For threaded simulation they are queued and applied before each step until next frame
+		\param body rigid body to apply force to
+		\param force force in world space
+		\param relativePosition point of force application relative to body center of mass
+		\param torque torque in world space
+		*/
+		static void ApplyForce(btRigidBody* body, const Vector3& force, const Vector3& relativePosition, const Vector3& torque);
+		/*!
+		removes all published states and queued forces of body. Called when body is destroyed
+		\param body rigid body which is being destroyed
+		*/
+		static void RemoveBodyState(btRigidBody* body);
+		/*!
+		steps headless worlds with stacked and jumbled boxes using single-threaded world and multithreaded world with different thread counts
+		\param bodyCount number of dynamic bodies
+		\param stepCount number of fixed 1/60s simulation steps in each run
+		\returns benchmark timings for each world and thread count
+		*/
+		static PhysicsBenchmark RunBenchmark(size_t bodyCount = 10000, size_t stepCount = 60);
+
 		static PhysicsModuleData* GetImpl();
 		static void Clone(PhysicsModuleData* impl);
 	};
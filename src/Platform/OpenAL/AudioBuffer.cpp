@@ -33,6 +33,21 @@
 
 namespace MxEngine
 {
+    const char* EnumToString(AudioBufferStatus status)
+    {
+        switch (status)
+        {
+        case AudioBufferStatus::READY:
+            return "READY";
+        case AudioBufferStatus::PENDING:
+            return "PENDING";
+        case AudioBufferStatus::FAILED:
+            return "FAILED";
+        default:
+            return "READY";
+        }
+    }
+
     void AudioBuffer::FreeAudioBuffer()
     {
         if (id != 0)
@@ -66,6 +81,7 @@ namespace MxEngine
         this->sampleCount = other.sampleCount;
         this->frequency = other.frequency;
         this->nativeFormat = other.nativeFormat;
+        this->status = other.status;
         other.id = 0;
     }
 
@@ -80,39 +96,60 @@ namespace MxEngine
         this->sampleCount = other.sampleCount;
         this->frequency = other.frequency;
         this->nativeFormat = other.nativeFormat;
+        this->status = other.status;
         other.id = 0;
         return *this;
     }
 
     void AudioBuffer::Load(const MxString& path)
     {
-        auto audio = AudioLoader::Load(path);
+        auto audio = AudioLoader::LoadMono(path);
         if (audio.data != nullptr)
         {
-            if (audio.channels != 1)
-            {
-                auto copy = audio;
-                audio = AudioLoader::ConvertToMono(audio);
-                AudioLoader::Free(copy);
-            }
-
-            this->nativeFormat = AL_FORMAT_MONO16;
-            this->channels = (uint8_t)audio.channels;
-            this->frequency = audio.frequency;
-            this->type = audio.type;
-            this->sampleCount = audio.sampleCount;
-            this->filepath = path;
-
-            ALCALL(alBufferData(id, (ALenum) this->nativeFormat, audio.data, ALsizei(audio.sampleCount * sizeof(int16_t)), (ALsizei) audio.frequency));
-
+            this->Load(audio, path);
             AudioLoader::Free(audio);
         }
         else
         {
             MXLOG_ERROR("MxEngine::AudioLoader", "audio file was not loaded: " + path);
+            this->status = AudioBufferStatus::FAILED;
         }
     }
 
+    void AudioBuffer::Load(const AudioData& audio, const MxString& path)
+    {
+        MX_ASSERT(audio.channels == 1 || audio.channels == 2);
+        this->nativeFormat = audio.channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+        this->channels = (uint8_t)audio.channels;
+        this->frequency = audio.frequency;
+        this->type = audio.type;
+        this->sampleCount = audio.sampleCount;
+        this->filepath = path;
+        this->status = AudioBufferStatus::READY;
+
+        ALCALL(alBufferData(id, (ALenum) this->nativeFormat, audio.data, ALsizei(audio.sampleCount * sizeof(int16_t)), (ALsizei) audio.frequency));
+    }
+
+    void AudioBuffer::SetPending()
+    {
+        this->status = AudioBufferStatus::PENDING;
+    }
+
+    void AudioBuffer::SetFailed()
+    {
+        this->status = AudioBufferStatus::FAILED;
+    }
+
+    AudioBufferStatus AudioBuffer::GetStatus() const
+    {
+        return this->status;
+    }
+
+    bool AudioBuffer::IsReady() const
+    {
+        return this->status == AudioBufferStatus::READY;
+    }
+
     AudioBuffer::BindableId AudioBuffer::GetNativeHandle() const
     {
         return id;
@@ -33,6 +33,17 @@
 
 namespace MxEngine
 {
+    struct AudioData;
+
+    enum class AudioBufferStatus : uint8_t
+    {
+        READY,
+        PENDING,
+        FAILED,
+    };
+
+    const char* EnumToString(AudioBufferStatus status);
+
     class AudioBuffer
     {
         using BindableId = unsigned int;
@@ -44,6 +55,7 @@ namespace MxEngine
         size_t frequency = 0;
         size_t sampleCount = 0;
         size_t nativeFormat = 0;
+        AudioBufferStatus status = AudioBufferStatus::READY;
 
         void FreeAudioBuffer();
     public:
@@ -55,6 +67,22 @@ namespace MxEngine
         AudioBuffer& operator=(AudioBuffer&&) noexcept;
 
         void Load(const MxString& path);
+        /*!
+        uploads already decoded samples to buffer. Must be called on main thread, while buffer is not attached to any player
+        \param audio decoded mono or stereo 16-bit samples. Data is copied, so it can be freed after call
+        \param path path of audio file, which is assigned to buffer
+        */
+        void Load(const AudioData& audio, const MxString& path);
+        /*!
+        marks buffer as being loaded asynchronously. Pending buffer must not be attached to players until it is ready
+        */
+        void SetPending();
+        /*!
+        marks pending buffer as failed, if its asynchronous loading did not succeed
+        */
+        void SetFailed();
+        AudioBufferStatus GetStatus() const;
+        bool IsReady() const;
         BindableId GetNativeHandle() const;
         size_t GetChannelCount() const;
         size_t GetFrequency() const;
@@ -151,6 +151,11 @@ namespace MxEngine
         ALCALL(alSourcef(id, AL_PITCH, speed));
     }
 
+    void AudioPlayer::SetPlaybackPosition(float seconds)
+    {
+        ALCALL(alSourcef(id, AL_SEC_OFFSET, seconds));
+    }
+
     void AudioPlayer::SetRollofFactor(float factor)
     {
         ALCALL(alSourcef(id, AL_ROLLOFF_FACTOR, factor));
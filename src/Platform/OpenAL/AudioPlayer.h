@@ -61,6 +61,7 @@ namespace MxEngine
         void SetPosition(float x, float y, float z);
         void SetDirection(float x, float y, float z);
         void SetSpeed(float speed);
+        void SetPlaybackPosition(float seconds);
         void SetRollofFactor(float factor);
         void SetReferenceDistance(float distance);
         BindableId GetNativeHandle() const;
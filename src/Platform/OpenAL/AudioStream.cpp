@@ -0,0 +1,324 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "AudioStream.h"
+#include "ALUtilities.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Math/Math.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/AudioKernels/AudioKernels.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    static void DecodeBlocks(AudioStreamState& state)
+    {
+        MAKE_SCOPE_PROFILER("AudioStream::DecodeBlocks");
+        std::lock_guard<std::mutex> lock(state.DecoderMutex);
+
+        auto& decoder = state.Decoder;
+        size_t channels = decoder.GetChannelCount();
+        bool isEndOfStream = state.IsEndOfStream;
+        while (!isEndOfStream)
+        {
+            auto& block = state.Blocks[state.WriteIndex];
+            if (block.IsFilled.load(std::memory_order_acquire)) break;
+
+            size_t frameCount = 0;
+            bool isRewound = false;
+            while (frameCount < AudioStreamBlockFrames)
+            {
+                size_t read = decoder.ReadFrames(state.DecodedFrames.data() + frameCount * channels, AudioStreamBlockFrames - frameCount);
+                frameCount += read;
+                if (frameCount == AudioStreamBlockFrames) break;
+
+                // end of file reached. Looping stream continues from the beginning, unless file contains no frames at all
+                if (!state.IsLooping || (read == 0 && isRewound) || !decoder.Seek(0))
+                {
+                    isEndOfStream = true;
+                    break;
+                }
+                isRewound = true;
+            }
+
+            if (frameCount > 0)
+            {
+                block.Samples.resize(frameCount);
+                AudioKernels::Downmix(state.DecodedFrames.data(), block.Samples.data(), frameCount, channels);
+                block.IsFilled.store(true, std::memory_order_release);
+                state.WriteIndex = (state.WriteIndex + 1) % AudioStreamBlockCount;
+            }
+        }
+        // end of stream is published after last block, so main thread does not consider stream finished before it is queued
+        state.IsEndOfStream = isEndOfStream;
+        state.IsDecoding = false;
+    }
+
+    void AudioStream::FreeAudioStream()
+    {
+        if (this->buffers[0] != 0)
+        {
+            ALCALL(alDeleteBuffers((ALsizei)this->buffers.size(), this->buffers.data()));
+        }
+    }
+
+    AudioStream::AudioStream()
+    {
+        if (!ALIsInitialized())
+        {
+            MXLOG_ERROR("OpenAL::AudioStream", "stream cannot be created as there is no audio device available");
+            return;
+        }
+        ALCALL(alGenBuffers((ALsizei)this->buffers.size(), this->buffers.data()));
+        this->freeBuffers.assign(this->buffers.begin(), this->buffers.end());
+        MXLOG_DEBUG("OpenAL::AudioStream", "created audio stream with buffer ids = " + ToMxString(this->buffers[0]) + "..." + ToMxString(this->buffers.back()));
+    }
+
+    AudioStream::~AudioStream()
+    {
+        this->FreeAudioStream();
+    }
+
+    AudioStream::AudioStream(AudioStream&& other) noexcept
+    {
+        this->state = std::move(other.state);
+        this->buffers = other.buffers;
+        this->freeBuffers = std::move(other.freeBuffers);
+        this->filepath = std::move(other.filepath);
+        this->type = other.type;
+        this->channels = other.channels;
+        this->frequency = other.frequency;
+        this->frameCount = other.frameCount;
+        this->readIndex = other.readIndex;
+        this->queuedBufferCount = other.queuedBufferCount;
+        this->isLooping = other.isLooping;
+        other.buffers.fill(0);
+    }
+
+    AudioStream& AudioStream::operator=(AudioStream&& other) noexcept
+    {
+        this->FreeAudioStream();
+
+        this->state = std::move(other.state);
+        this->buffers = other.buffers;
+        this->freeBuffers = std::move(other.freeBuffers);
+        this->filepath = std::move(other.filepath);
+        this->type = other.type;
+        this->channels = other.channels;
+        this->frequency = other.frequency;
+        this->frameCount = other.frameCount;
+        this->readIndex = other.readIndex;
+        this->queuedBufferCount = other.queuedBufferCount;
+        this->isLooping = other.isLooping;
+        other.buffers.fill(0);
+        return *this;
+    }
+
+    void AudioStream::Load(const MxString& path)
+    {
+        MXLOG_INFO("MxEngine::AudioStream", "streaming audio from file: " + path);
+
+        // previous state may still be used by decoding job, so new one is created instead of resetting it
+        auto newState = MakeRef<AudioStreamState>();
+        if (!newState->Decoder.Open(path) || newState->Decoder.GetChannelCount() == 0)
+        {
+            MXLOG_ERROR("MxEngine::AudioStream", "audio file cannot be streamed: " + path);
+            return;
+        }
+
+        auto& decoder = newState->Decoder;
+        this->filepath = path;
+        this->type = decoder.GetAudioType();
+        this->channels = decoder.GetChannelCount();
+        this->frequency = decoder.GetFrequency();
+        this->frameCount = decoder.GetFrameCount();
+        this->readIndex = 0;
+
+        newState->DecodedFrames.resize(AudioStreamBlockFrames * this->channels);
+        newState->IsLooping = this->isLooping;
+        this->state = std::move(newState);
+        this->ScheduleDecoding();
+    }
+
+    void AudioStream::Attach(const AudioPlayer& player)
+    {
+        player.Stop();
+        this->UnqueueBuffers(player, true);
+        ALCALL(alSourcei(player.GetNativeHandle(), AL_LOOPING, AL_FALSE));
+    }
+
+    void AudioStream::UnqueueBuffers(const AudioPlayer& player, bool unqueueAll)
+    {
+        auto id = player.GetNativeHandle();
+        if (unqueueAll)
+        {
+            // detaching buffer from stopped source removes whole queue
+            ALCALL(alSourcei(id, AL_BUFFER, 0));
+            this->freeBuffers.assign(this->buffers.begin(), this->buffers.end());
+            this->queuedBufferCount = 0;
+            return;
+        }
+
+        ALint processed = 0;
+        ALCALL(alGetSourcei(id, AL_BUFFERS_PROCESSED, &processed));
+        for (ALint i = 0; i < processed; i++)
+        {
+            BindableId buffer = 0;
+            ALCALL(alSourceUnqueueBuffers(id, 1, &buffer));
+            this->freeBuffers.push_back(buffer);
+            this->queuedBufferCount--;
+        }
+    }
+
+    void AudioStream::QueueBlocks(const AudioPlayer& player)
+    {
+        while (!this->freeBuffers.empty())
+        {
+            auto& block = this->state->Blocks[this->readIndex];
+            if (!block.IsFilled.load(std::memory_order_acquire)) break;
+
+            auto buffer = this->freeBuffers.back();
+            this->freeBuffers.pop_back();
+            ALCALL(alBufferData(buffer, AL_FORMAT_MONO16, block.Samples.data(), ALsizei(block.Samples.size() * sizeof(int16_t)), (ALsizei)this->frequency));
+            ALCALL(alSourceQueueBuffers(player.GetNativeHandle(), 1, &buffer));
+            this->queuedBufferCount++;
+
+            block.IsFilled.store(false, std::memory_order_release);
+            this->readIndex = (this->readIndex + 1) % AudioStreamBlockCount;
+        }
+    }
+
+    void AudioStream::ScheduleDecoding()
+    {
+        auto& state = *this->state;
+        if (state.IsEndOfStream || state.IsDecoding) return;
+
+        bool hasFreeBlock = false;
+        for (const auto& block : state.Blocks)
+            hasFreeBlock |= !block.IsFilled.load(std::memory_order_acquire);
+        if (!hasFreeBlock) return;
+
+        state.IsDecoding = true;
+        if (ThreadPool::GetWorkerCount() == 0)
+            DecodeBlocks(state);
+        else
+            ThreadPool::Submit([state = this->state]() { DecodeBlocks(*state); });
+    }
+
+    void AudioStream::Update(const AudioPlayer& player, bool isPlaying)
+    {
+        if (this->state == nullptr) return;
+
+        this->UnqueueBuffers(player, false);
+        this->QueueBlocks(player);
+        this->ScheduleDecoding();
+
+        if (isPlaying && this->queuedBufferCount > 0)
+        {
+            // source stops by itself if all queued buffers were played before next block was decoded
+            ALint sourceState = AL_PLAYING;
+            ALCALL(alGetSourcei(player.GetNativeHandle(), AL_SOURCE_STATE, &sourceState));
+            if (sourceState != AL_PLAYING && sourceState != AL_PAUSED)
+                player.Play();
+        }
+    }
+
+    void AudioStream::Seek(const AudioPlayer& player, float seconds)
+    {
+        if (this->state == nullptr) return;
+
+        player.Stop();
+        this->UnqueueBuffers(player, true);
+
+        size_t frame = size_t(Max(seconds, 0.0f) * (float)this->frequency);
+        if (this->frameCount != 0) frame = Min(frame, this->frameCount);
+        {
+            // waits until running decoding job is finished
+            std::lock_guard<std::mutex> lock(this->state->DecoderMutex);
+            this->state->Decoder.Seek(frame);
+            for (auto& block : this->state->Blocks)
+                block.IsFilled = false;
+            this->state->WriteIndex = 0;
+            this->state->IsEndOfStream = false;
+        }
+        this->readIndex = 0;
+        this->ScheduleDecoding();
+    }
+
+    void AudioStream::SetLooping(bool value)
+    {
+        this->isLooping = value;
+        if (this->state == nullptr) return;
+
+        std::lock_guard<std::mutex> lock(this->state->DecoderMutex);
+        this->state->IsLooping = value;
+        // decoder already stopped at the end of file, so it is rewound to continue stream
+        if (value && this->state->IsEndOfStream && this->state->Decoder.Seek(0))
+            this->state->IsEndOfStream = false;
+    }
+
+    bool AudioStream::IsLooping() const
+    {
+        return this->isLooping;
+    }
+
+    bool AudioStream::IsFinished() const
+    {
+        if (this->state == nullptr) return true;
+        return this->state->IsEndOfStream && this->queuedBufferCount == 0 &&
+            !this->state->Blocks[this->readIndex].IsFilled.load(std::memory_order_acquire);
+    }
+
+    size_t AudioStream::GetChannelCount() const
+    {
+        return this->channels;
+    }
+
+    size_t AudioStream::GetFrequency() const
+    {
+        return this->frequency;
+    }
+
+    size_t AudioStream::GetFrameCount() const
+    {
+        return this->frameCount;
+    }
+
+    AudioType AudioStream::GetAudioType() const
+    {
+        return this->type;
+    }
+
+    const MxString& AudioStream::GetFilePath() const
+    {
+        return this->filepath;
+    }
+}
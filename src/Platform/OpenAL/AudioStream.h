@@ -0,0 +1,138 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "AudioPlayer.h"
+#include "Utilities/Audio/AudioDecoder.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/STL/MxVector.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace MxEngine
+{
+    /*!
+    block of decoded mono samples, passed from decoding job to main thread which uploads it to OpenAL
+    */
+    struct AudioStreamBlock
+    {
+        MxVector<int16_t> Samples;
+        std::atomic<bool> IsFilled{ false };
+    };
+
+    constexpr size_t AudioStreamBlockCount = 4;
+    constexpr size_t AudioStreamBlockFrames = 16384;
+
+    /*!
+    state shared with decoding jobs. It is reference counted, so stream can be destroyed while job is still running
+    */
+    struct AudioStreamState
+    {
+        std::mutex DecoderMutex;
+        AudioDecoder Decoder;
+        MxVector<int16_t> DecodedFrames;
+        std::array<AudioStreamBlock, AudioStreamBlockCount> Blocks;
+        size_t WriteIndex = 0;
+        std::atomic<bool> IsDecoding{ false };
+        std::atomic<bool> IsEndOfStream{ false };
+        std::atomic<bool> IsLooping{ false };
+    };
+
+    /*!
+    audio stream plays long audio files without decoding them fully. File is decoded in small blocks on worker threads,
+    which are uploaded into a ring of OpenAL buffers queued to the player. Memory usage is bounded by block size and count,
+    independent of file length. Stream must be updated each frame to keep player queue filled
+    */
+    class AudioStream
+    {
+        using BindableId = unsigned int;
+
+        Ref<AudioStreamState> state;
+        std::array<BindableId, AudioStreamBlockCount> buffers{ };
+        MxVector<BindableId> freeBuffers;
+        MxString filepath;
+        AudioType type = AudioType::WAV;
+        size_t channels = 0;
+        size_t frequency = 0;
+        size_t frameCount = 0;
+        size_t readIndex = 0;
+        size_t queuedBufferCount = 0;
+        bool isLooping = false;
+
+        void FreeAudioStream();
+        void UnqueueBuffers(const AudioPlayer& player, bool unqueueAll);
+        void QueueBlocks(const AudioPlayer& player);
+        void ScheduleDecoding();
+    public:
+        AudioStream();
+        ~AudioStream();
+        AudioStream(const AudioStream&) = delete;
+        AudioStream(AudioStream&&) noexcept;
+        AudioStream& operator=(const AudioStream&) = delete;
+        AudioStream& operator=(AudioStream&&) noexcept;
+
+        /*!
+        opens audio file for streaming and starts decoding of its first blocks
+        \param path path to wav, mp3, flac or ogg file
+        */
+        void Load(const MxString& path);
+        /*!
+        attaches stream to player. Player must not have static buffer attached and must not loop by itself
+        \param player player which will play queued stream buffers
+        */
+        void Attach(const AudioPlayer& player);
+        /*!
+        unqueues played buffers, queues newly decoded blocks and schedules decoding of next ones
+        \param player player to which stream is attached
+        \param isPlaying should player be playing. If queue was drained because decoding was late, playback is resumed
+        */
+        void Update(const AudioPlayer& player, bool isPlaying);
+        /*!
+        stops player and moves stream to the specified position. Queued blocks are dropped and decoded again from new position
+        \param player player to which stream is attached
+        \param seconds position in seconds from the beginning of file
+        */
+        void Seek(const AudioPlayer& player, float seconds);
+        void SetLooping(bool value);
+        bool IsLooping() const;
+        /*!
+        checks if stream reached end of file and all its buffers were played. Looping stream never finishes
+        \returns true if nothing is left to play
+        */
+        bool IsFinished() const;
+        size_t GetChannelCount() const;
+        size_t GetFrequency() const;
+        size_t GetFrameCount() const;
+        AudioType GetAudioType() const;
+        const MxString& GetFilePath() const;
+    };
+}
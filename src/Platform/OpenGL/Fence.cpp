@@ -0,0 +1,110 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Fence.h"
+#include "Platform/OpenGL/GLUtilities.h"
+
+namespace MxEngine
+{
+	void Fence::FreeFence()
+	{
+		if (this->sync != nullptr)
+		{
+			GLCALL(glDeleteSync((GLsync)this->sync));
+		}
+		this->sync = nullptr;
+		this->isFlushed = false;
+	}
+
+	Fence::~Fence()
+	{
+		this->FreeFence();
+	}
+
+	Fence::Fence(Fence&& fence) noexcept
+	{
+		this->sync = fence.sync;
+		this->isFlushed = fence.isFlushed;
+		fence.sync = nullptr;
+		fence.isFlushed = false;
+	}
+
+	Fence& Fence::operator=(Fence&& fence) noexcept
+	{
+		this->FreeFence();
+
+		this->sync = fence.sync;
+		this->isFlushed = fence.isFlushed;
+		fence.sync = nullptr;
+		fence.isFlushed = false;
+		return *this;
+	}
+
+	void Fence::Insert()
+	{
+		this->FreeFence();
+		GLCALL(this->sync = (NativeHandle)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+
+	bool Fence::IsSignaled()
+	{
+		if (this->sync == nullptr) return true;
+
+		// without flush fence may stay in driver command queue forever, so it is performed once
+		GLbitfield flags = this->isFlushed ? 0 : GL_SYNC_FLUSH_COMMANDS_BIT;
+		this->isFlushed = true;
+
+		GLenum status = GL_WAIT_FAILED;
+		GLCALL(status = glClientWaitSync((GLsync)this->sync, flags, 0));
+		return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+	}
+
+	void Fence::Wait()
+	{
+		if (this->sync == nullptr) return;
+
+		constexpr GLuint64 timeout = 1000000000; // 1 second in nanoseconds
+		GLenum status = GL_TIMEOUT_EXPIRED;
+		while (status == GL_TIMEOUT_EXPIRED)
+		{
+			GLCALL(status = glClientWaitSync((GLsync)this->sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout));
+		}
+		this->isFlushed = true;
+	}
+
+	bool Fence::IsInserted() const
+	{
+		return this->sync != nullptr;
+	}
+
+	Fence::NativeHandle Fence::GetNativeHandle() const
+	{
+		return this->sync;
+	}
+}
@@ -0,0 +1,69 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+namespace MxEngine
+{
+	/*!
+	fence is a GPU synchronization object. It is signaled when all GPU commands issued before its insertion are completed
+	*/
+	class Fence
+	{
+		using NativeHandle = void*;
+
+		NativeHandle sync = nullptr;
+		bool isFlushed = false;
+
+		void FreeFence();
+	public:
+		Fence() = default;
+		~Fence();
+		Fence(const Fence&) = delete;
+		Fence(Fence&& fence) noexcept;
+		Fence& operator=(const Fence&) = delete;
+		Fence& operator=(Fence&& fence) noexcept;
+
+		/*!
+		inserts fence into GPU command stream. Previously inserted fence is deleted
+		*/
+		void Insert();
+		/*!
+		checks fence state without blocking. Command stream is flushed on first call, so fence is guaranteed to be signaled eventually
+		\returns true if all commands before fence are completed or if fence was never inserted
+		*/
+		bool IsSignaled();
+		/*!
+		blocks calling thread until fence is signaled
+		*/
+		void Wait();
+		bool IsInserted() const;
+		NativeHandle GetNativeHandle() const;
+	};
+}
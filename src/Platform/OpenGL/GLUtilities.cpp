@@ -69,6 +69,12 @@ namespace MxEngine
 			return sizeof(GLuint);
 		case GL_UNSIGNED_BYTE:
 			return sizeof(GLubyte);
+		case GL_UNSIGNED_SHORT:
+			return sizeof(GLushort);
+		case GL_SHORT:
+			return sizeof(GLshort);
+		case GL_HALF_FLOAT:
+			return sizeof(GLhalf);
 		default:
 			return 0;
 		}
@@ -132,6 +138,18 @@ namespace MxEngine
 		return "uint";
 	}
 
+	template<>
+	const char* TypeToString<unsigned short>()
+	{
+		return "ushort";
+	}
+
+	template<>
+	const char* TypeToString<short>()
+	{
+		return "short";
+	}
+
 	template<>
 	const char* TypeToString<float>()
 	{
@@ -155,4 +173,16 @@ namespace MxEngine
 	{
 		return GL_UNSIGNED_BYTE;
 	}
+
+	template<>
+	unsigned int GetGLType<unsigned short>()
+	{
+		return GL_UNSIGNED_SHORT;
+	}
+
+	template<>
+	unsigned int GetGLType<short>()
+	{
+		return GL_SHORT;
+	}
 }
\ No newline at end of file
@@ -33,6 +33,15 @@
 
 namespace MxEngine
 {
+	/*!
+	contiguous range of index buffer which can be drawn separately from other parts of buffer
+	*/
+	struct IndexRange
+	{
+		size_t Offset = 0;
+		size_t Count = 0;
+	};
+
 	class IndexBuffer
 	{
 		using BindableId = unsigned int;
@@ -0,0 +1,174 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "PixelBuffer.h"
+#include "Platform/OpenGL/GLUtilities.h"
+#include "Utilities/Logging/Logger.h"
+#include "Core/Macro/Macro.h"
+
+namespace MxEngine
+{
+	GLenum PixelBufferTargetTable[] =
+	{
+		GL_PIXEL_PACK_BUFFER,
+		GL_PIXEL_UNPACK_BUFFER,
+	};
+
+	GLenum PixelBufferUsageTable[] =
+	{
+		GL_STREAM_DRAW,
+		GL_STREAM_READ,
+		GL_STREAM_COPY,
+		GL_STATIC_DRAW,
+		GL_STATIC_READ,
+		GL_STATIC_COPY,
+		GL_DYNAMIC_DRAW,
+		GL_DYNAMIC_READ,
+		GL_DYNAMIC_COPY,
+	};
+
+	void PixelBuffer::FreePixelBuffer()
+	{
+		if (this->id != 0)
+		{
+			if (this->IsMapped()) this->Unmap();
+			GLCALL(glDeleteBuffers(1, &id));
+		}
+		this->id = 0;
+	}
+
+	PixelBuffer::PixelBuffer(PixelBufferType type)
+		: type(type)
+	{
+		GLCALL(glGenBuffers(1, &id));
+		MXLOG_DEBUG("OpenGL::PixelBuffer", "created pixel buffer with id = " + ToMxString(id));
+	}
+
+	PixelBuffer::~PixelBuffer()
+	{
+		this->FreePixelBuffer();
+	}
+
+	PixelBuffer::PixelBuffer(PixelBuffer&& pbo) noexcept
+	{
+		this->id = pbo.id;
+		this->size = pbo.size;
+		this->mappedData = pbo.mappedData;
+		this->type = pbo.type;
+		pbo.id = 0;
+		pbo.size = 0;
+		pbo.mappedData = nullptr;
+	}
+
+	PixelBuffer& PixelBuffer::operator=(PixelBuffer&& pbo) noexcept
+	{
+		this->FreePixelBuffer();
+
+		this->id = pbo.id;
+		this->size = pbo.size;
+		this->mappedData = pbo.mappedData;
+		this->type = pbo.type;
+		pbo.id = 0;
+		pbo.size = 0;
+		pbo.mappedData = nullptr;
+		return *this;
+	}
+
+	PixelBuffer::BindableId PixelBuffer::GetNativeHandle() const
+	{
+		return this->id;
+	}
+
+	void PixelBuffer::Bind() const
+	{
+		GLCALL(glBindBuffer(PixelBufferTargetTable[(int)this->type], id));
+	}
+
+	void PixelBuffer::Unbind() const
+	{
+		GLCALL(glBindBuffer(PixelBufferTargetTable[(int)this->type], 0));
+	}
+
+	void PixelBuffer::Load(size_t sizeInBytes, UsageType usage)
+	{
+		MX_ASSERT(!this->IsMapped());
+		this->size = sizeInBytes;
+		this->Bind();
+		GLCALL(glBufferData(PixelBufferTargetTable[(int)this->type], (GLsizeiptr)sizeInBytes, nullptr, PixelBufferUsageTable[(int)usage]));
+		this->Unbind();
+	}
+
+	uint8_t* PixelBuffer::Map()
+	{
+		if (this->IsMapped()) return this->mappedData;
+		if (this->size == 0) return nullptr;
+
+		GLbitfield access = this->type == PixelBufferType::UNPACK ?
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_READ_BIT;
+
+		this->Bind();
+		GLCALL(this->mappedData = (uint8_t*)glMapBufferRange(PixelBufferTargetTable[(int)this->type], 0, (GLsizeiptr)this->size, access));
+		this->Unbind();
+		if (this->mappedData == nullptr)
+			MXLOG_ERROR("OpenGL::PixelBuffer", "cannot map pixel buffer with id = " + ToMxString(id));
+		return this->mappedData;
+	}
+
+	bool PixelBuffer::Unmap()
+	{
+		if (!this->IsMapped()) return true;
+
+		this->Bind();
+		GLboolean isValid = GL_TRUE;
+		GLCALL(isValid = glUnmapBuffer(PixelBufferTargetTable[(int)this->type]));
+		this->Unbind();
+		this->mappedData = nullptr;
+		return isValid == GL_TRUE;
+	}
+
+	bool PixelBuffer::IsMapped() const
+	{
+		return this->mappedData != nullptr;
+	}
+
+	uint8_t* PixelBuffer::GetMappedData() const
+	{
+		return this->mappedData;
+	}
+
+	size_t PixelBuffer::GetSize() const
+	{
+		return this->size;
+	}
+
+	PixelBufferType PixelBuffer::GetType() const
+	{
+		return this->type;
+	}
+}
@@ -0,0 +1,90 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Platform/OpenGL/VertexBuffer.h"
+
+#include <cstdint>
+
+namespace MxEngine
+{
+	enum class PixelBufferType : uint8_t
+	{
+		PACK,
+		UNPACK,
+	};
+
+	/*!
+	pixel buffer is a GPU buffer used for asynchronous pixel transfers.
+	UNPACK buffers are sources of texture uploads, PACK buffers are destinations of texture readbacks
+	*/
+	class PixelBuffer
+	{
+		using BindableId = unsigned int;
+
+		BindableId id = 0;
+		size_t size = 0;
+		uint8_t* mappedData = nullptr;
+		PixelBufferType type = PixelBufferType::UNPACK;
+
+		void FreePixelBuffer();
+	public:
+		explicit PixelBuffer(PixelBufferType type = PixelBufferType::UNPACK);
+		~PixelBuffer();
+		PixelBuffer(const PixelBuffer&) = delete;
+		PixelBuffer(PixelBuffer&& pbo) noexcept;
+		PixelBuffer& operator=(const PixelBuffer&) = delete;
+		PixelBuffer& operator=(PixelBuffer&& pbo) noexcept;
+
+		BindableId GetNativeHandle() const;
+		void Bind() const;
+		void Unbind() const;
+		/*!
+		allocates new buffer storage. Old storage is orphaned, so it can be reused by driver without stalls
+		\param sizeInBytes size of new storage
+		\param usage buffer usage hint
+		*/
+		void Load(size_t sizeInBytes, UsageType usage);
+		/*!
+		maps whole buffer into client memory. UNPACK buffers are mapped for writing, PACK buffers for reading
+		\returns pointer to mapped memory or nullptr if mapping failed
+		*/
+		uint8_t* Map();
+		/*!
+		unmaps buffer. Buffer must be unmapped before it is used by any GPU command
+		\returns false if buffer contents were corrupted while it was mapped and must be reuploaded
+		*/
+		bool Unmap();
+		bool IsMapped() const;
+		uint8_t* GetMappedData() const;
+		size_t GetSize() const;
+		PixelBufferType GetType() const;
+	};
+}
@@ -32,6 +32,7 @@
 #include "Platform/Modules/GraphicModule.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/Format/Format.h"
+#include "Utilities/STL/MxVector.h"
 
 namespace MxEngine
 {
@@ -66,6 +67,30 @@ namespace MxEngine
 		GLCALL(glDrawElements(GL_TRIANGLES, (GLsizei)ibo.GetCount(), (GLenum)ibo.GetIndexTypeId(), nullptr));
 	}
 
+	void Renderer::DrawTriangles(const VertexArray& vao, const IndexBuffer& ibo, const IndexRange* ranges, size_t rangeCount, const Shader& shader) const
+	{
+		if (rangeCount == 0) return;
+
+		vao.Bind();
+		ibo.Bind();
+		shader.Bind();
+		if (rangeCount == 1)
+		{
+			auto offset = reinterpret_cast<const void*>(ranges[0].Offset * sizeof(IndexBuffer::IndexType));
+			GLCALL(glDrawElements(GL_TRIANGLES, (GLsizei)ranges[0].Count, (GLenum)ibo.GetIndexTypeId(), offset));
+			return;
+		}
+
+		MxVector<GLsizei> counts(rangeCount);
+		MxVector<const void*> offsets(rangeCount);
+		for (size_t i = 0; i < rangeCount; i++)
+		{
+			counts[i] = (GLsizei)ranges[i].Count;
+			offsets[i] = reinterpret_cast<const void*>(ranges[i].Offset * sizeof(IndexBuffer::IndexType));
+		}
+		GLCALL(glMultiDrawElements(GL_TRIANGLES, counts.data(), (GLenum)ibo.GetIndexTypeId(), offsets.data(), (GLsizei)rangeCount));
+	}
+
 	void Renderer::DrawTriangles(const VertexArray& vao, size_t vertexCount, const Shader& shader) const
 	{
 		vao.Bind();
@@ -69,6 +69,7 @@ namespace MxEngine
 
 		void DrawTriangles(const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader) const;
 		void DrawTriangles(const VertexArray& vao, size_t vertexCount, const Shader& shader) const;
+		void DrawTriangles(const VertexArray& vao, const IndexBuffer& ibo, const IndexRange* ranges, size_t rangeCount, const Shader& shader) const;
 		void DrawTrianglesInstanced(const VertexArray& vao, const IndexBuffer& ibo, const Shader& shader, size_t count) const;
 		void DrawTrianglesInstanced(const VertexArray& vao, size_t vertexCount, const Shader& shader, size_t count) const;
 		void DrawLines(const VertexArray& vao, size_t vertexCount, const Shader& shader) const;
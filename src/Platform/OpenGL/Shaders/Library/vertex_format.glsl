@@ -0,0 +1,38 @@
+// not stored in vertex buffer, set per draw call. offset.w is 1.0 (default attribute value) for full precision vertecies and 0.0 for packed ones
+layout(location = 13) in vec4 positionDecodeOffset;
+layout(location = 14) in vec4 positionDecodeScale;
+
+bool isVertexPacked()
+{
+	return positionDecodeOffset.w == 0.0f;
+}
+
+vec3 decodeOctahedral(vec2 e)
+{
+	vec3 v = vec3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+	if (v.z < 0.0f)
+	{
+		vec2 signNotZero = vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+		v.xy = (1.0f - abs(v.yx)) * signNotZero;
+	}
+	return normalize(v);
+}
+
+vec4 decodePosition(vec4 position)
+{
+	if (!isVertexPacked()) return position;
+	return vec4(positionDecodeOffset.xyz + positionDecodeScale.xyz * position.xyz, 1.0f);
+}
+
+vec3 decodeDirection(vec3 direction)
+{
+	if (!isVertexPacked()) return direction;
+	return decodeOctahedral(direction.xy);
+}
+
+vec3 decodeBitangent(vec3 bitangent, vec3 normal, vec3 tangent)
+{
+	// packed vertex stores only bitangent sign
+	if (!isVertexPacked()) return bitangent;
+	return cross(normal, tangent) * (bitangent.x < 0.0f ? -1.0f : 1.0f);
+}
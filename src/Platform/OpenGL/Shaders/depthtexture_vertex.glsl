@@ -1,4 +1,5 @@
 #include "Library/displacement.glsl"
+#include "Library/vertex_format.glsl"
 
 layout(location = 0)  in vec4 position;
 layout(location = 1)  in vec2 texCoord;
@@ -13,8 +14,8 @@ uniform sampler2D map_height;
 
 void main()
 {
-    vec4 modelPos = model * position;
-    vec3 normalObjectSpace = normalMatrix * normal;
+    vec4 modelPos = model * decodePosition(position);
+    vec3 normalObjectSpace = normalMatrix * decodeDirection(normal);
     modelPos.xyz += normalObjectSpace * getDisplacement(uvMultipliers * texCoord, uvMultipliers, map_height, displacement);
     gl_Position = LightProjMatrix * modelPos;
 }
\ No newline at end of file
@@ -31,8 +31,10 @@ uniform float gamma;
 
 vec3 calcNormal(vec2 texcoord, mat3 TBN, sampler2D normalMap)
 {
-	vec3 normal = texture(normalMap, texcoord).rgb;
-	normal = normalize(normal * 2.0f - 1.0f);
+	// only X and Y are used, as block-compressed normal maps do not store Z
+	vec2 xy = texture(normalMap, texcoord).rg * 2.0f - 1.0f;
+	// compression error may move xy outside of unit circle, so normal is normalized after Z is restored
+	vec3 normal = normalize(vec3(xy, sqrt(max(1.0f - dot(xy, xy), 0.0f))));
 	return TBN * normal;
 }
 
@@ -1,4 +1,5 @@
 #include "Library/displacement.glsl"
+#include "Library/vertex_format.glsl"
 
 layout(location = 0)  in vec4 position;
 layout(location = 1)  in vec2 texCoord;
@@ -25,10 +26,14 @@ out VSout
 
 void main()
 {
-	vec4 modelPos = model * position;
-	vec3 T = normalize(vec3(normalMatrix * tangent));
-	vec3 B = normalize(vec3(normalMatrix * bitangent));
-	vec3 N = normalize(vec3(normalMatrix * normal));
+	vec3 objectNormal = decodeDirection(normal);
+	vec3 objectTangent = decodeDirection(tangent);
+	vec3 objectBitangent = decodeBitangent(bitangent, objectNormal, objectTangent);
+
+	vec4 modelPos = model * decodePosition(position);
+	vec3 T = normalize(vec3(normalMatrix * objectTangent));
+	vec3 B = normalize(vec3(normalMatrix * objectBitangent));
+	vec3 N = normalize(vec3(normalMatrix * objectNormal));
 
 	vsout.TBN = mat3(T, B, N);
 	vsout.TexCoord = texCoord;
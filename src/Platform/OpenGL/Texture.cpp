@@ -28,9 +28,13 @@
 
 #include "Texture.h"
 #include "Platform/OpenGL/GLUtilities.h"
+#include "Platform/OpenGL/PixelBuffer.h"
+#include "Core/Macro/Macro.h"
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/Time/Time.h"
 #include "Utilities/Image/ImageLoader.h"
+#include "Utilities/TextureCompressor/TextureCompressor.h"
+#include "Utilities/Format/Format.h"
 
 namespace MxEngine
 {
@@ -89,6 +93,7 @@ namespace MxEngine
 		this->wrapType = texture.wrapType;
 		this->samples = texture.samples;
 		this->format = texture.format;
+		this->compression = texture.compression;
 		this->id = texture.id;
 
 		texture.id = 0;
@@ -110,6 +115,7 @@ namespace MxEngine
 		this->wrapType = texture.wrapType;
 		this->samples = texture.samples;
 		this->format = texture.format;
+		this->compression = texture.compression;
 		this->id = texture.id;
 		
 		texture.id = 0;
@@ -140,6 +146,7 @@ namespace MxEngine
 		this->filepath = filepath;
 		this->wrapType = wrap;
 		this->format = format;
+		this->compression = BlockCompression::NONE;
 
 		if (image.GetRawData() == nullptr)
 		{
@@ -189,6 +196,7 @@ namespace MxEngine
 		this->textureType = GL_TEXTURE_2D;
 		this->format = format;
 		this->wrapType = wrap;
+		this->compression = BlockCompression::NONE;
 
 		GLenum type = isFloating ? GL_FLOAT : GL_UNSIGNED_BYTE;
 
@@ -212,8 +220,14 @@ namespace MxEngine
 			break;
 		}
 
+		// rows of tightly packed single-channel images are not always aligned at 4 bytes, as OpenGL expects by default
+		size_t rowSize = (size_t)width * channels * (isFloating ? sizeof(float) : sizeof(uint8_t));
+		GLint unpackAlignment = rowSize % 4 == 0 ? 4 : 1;
+
 		GLCALL(glBindTexture(GL_TEXTURE_2D, id));
+		GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment));
 		GLCALL(glTexImage2D(GL_TEXTURE_2D, 0, formatTable[(int)this->format], (GLsizei)width, (GLsizei)height, 0, dataChannels, type, data));
+		GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
 
 		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapTable[(int)this->wrapType]));
 		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapTable[(int)this->wrapType]));
@@ -226,6 +240,96 @@ namespace MxEngine
 		this->Load(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), image.GetChannelCount(), image.IsFloatingPoint(), format, wrap, genMipmaps);
     }
 
+	void Texture::Load(const PixelBuffer& buffer, int width, int height, int channels, bool isFloating, TextureFormat format, TextureWrap wrap, bool genMipmaps)
+	{
+		MX_ASSERT(buffer.GetType() == PixelBufferType::UNPACK && !buffer.IsMapped());
+		// with unpack buffer bound, null data pointer is treated as zero offset into buffer storage
+		buffer.Bind();
+		this->Load(nullptr, width, height, channels, isFloating, format, wrap, genMipmaps);
+		buffer.Unbind();
+	}
+
+	GLenum compressedFormatTable[] =
+	{
+		GL_NONE,
+		GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+		GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+		GL_COMPRESSED_RED_RGTC1,
+		GL_COMPRESSED_RG_RGTC2,
+	};
+
+	bool Texture::IsCompressionSupported(BlockCompression compression)
+	{
+		switch (compression)
+		{
+		case BlockCompression::BC1:
+		case BlockCompression::BC3:
+			return GLEW_EXT_texture_compression_s3tc;
+		case BlockCompression::BC4:
+		case BlockCompression::BC5:
+			return true; // RGTC is part of core profile since OpenGL 3.0
+		default:
+			return false;
+		}
+	}
+
+	void Texture::Load(const CompressedImage& image, TextureFormat format, TextureWrap wrap)
+	{
+		MX_ASSERT(!image.Levels.empty());
+		this->filepath = "[[compressed]]";
+		this->width = image.Levels.front().Width;
+		this->height = image.Levels.front().Height;
+		this->textureType = GL_TEXTURE_2D;
+		this->format = format;
+		this->wrapType = wrap;
+		this->compression = BlockCompression::NONE;
+
+		GLCALL(glBindTexture(GL_TEXTURE_2D, id));
+		if (Texture::IsCompressionSupported(image.Compression))
+		{
+			this->compression = image.Compression;
+			for (size_t level = 0; level < image.Levels.size(); level++)
+			{
+				const auto& entry = image.Levels[level];
+				GLCALL(glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, compressedFormatTable[(int)image.Compression], 
+					(GLsizei)entry.Width, (GLsizei)entry.Height, 0, (GLsizei)entry.ByteSize, image.Data.data() + entry.Offset));
+			}
+		}
+		else
+		{
+			// driver cannot sample compressed format, so levels are decoded on CPU and uploaded uncompressed
+			MXLOG_WARNING("OpenGL::Texture", MxFormat("{0} compression is not supported, texture is uploaded uncompressed", EnumToString(image.Compression)));
+			GLenum dataChannels = GL_RGBA;
+			switch (TextureCompressor::GetChannelCount(image.Compression))
+			{
+			case 1:
+				dataChannels = GL_RED;
+				break;
+			case 2:
+				dataChannels = GL_RG;
+				break;
+			default:
+				dataChannels = GL_RGBA;
+				break;
+			}
+
+			GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+			for (size_t level = 0; level < image.Levels.size(); level++)
+			{
+				auto decoded = TextureCompressor::Decompress(image, level);
+				GLCALL(glTexImage2D(GL_TEXTURE_2D, (GLint)level, formatTable[(int)this->format], (GLsizei)decoded.GetWidth(), (GLsizei)decoded.GetHeight(), 
+					0, dataChannels, GL_UNSIGNED_BYTE, decoded.GetRawData()));
+			}
+			GLCALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+		}
+
+		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapTable[(int)this->wrapType]));
+		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapTable[(int)this->wrapType]));
+		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.Levels.size() - 1));
+		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, image.Levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	}
+
 	void Texture::LoadDepth(int width, int height, TextureFormat format, TextureWrap wrap)
 	{
 		this->filepath = "[[depth]]";
@@ -234,6 +338,7 @@ namespace MxEngine
 		this->textureType = GL_TEXTURE_2D;
 		this->format = format;
 		this->wrapType = wrap;
+		this->compression = BlockCompression::NONE;
 
 		this->Bind();
 
@@ -258,16 +363,15 @@ namespace MxEngine
 		return Log2(Max(this->width, this->height));
 	}
 
-	Image Texture::GetRawTextureData() const
+	size_t Texture::GetRawTextureDataSize() const
 	{
-		if (this->height == 0 || this->width == 0)
-			return Image();
-
-		GLenum type = this->IsFloatingPoint() ? GL_FLOAT : GL_UNSIGNED_BYTE;
 		size_t pixelSize = this->GetChannelCount() * (this->IsFloatingPoint() ? sizeof(float) : sizeof(uint8_t));
-		size_t totalByteSize = this->width * this->height * pixelSize;
-		auto result = (uint8_t*)std::malloc(totalByteSize);
+		return this->width * this->height * pixelSize;
+	}
 
+	void Texture::ReadTextureData(void* destination) const
+	{
+		GLenum type = this->IsFloatingPoint() ? GL_FLOAT : GL_UNSIGNED_BYTE;
 		GLenum readFormat = GL_RGBA;
 		switch (this->GetChannelCount())
 		{
@@ -290,15 +394,40 @@ namespace MxEngine
 
 		this->Bind(0);
 		GLCALL(glPixelStorei(GL_PACK_ALIGNMENT, 1));
-		GLCALL(glGetTexImage(this->textureType, 0, readFormat, type, (void*)result));
+		GLCALL(glGetTexImage(this->textureType, 0, readFormat, type, destination));
+	}
+
+	Image Texture::GetRawTextureData() const
+	{
+		if (this->height == 0 || this->width == 0)
+			return Image();
+
+		auto result = (uint8_t*)std::malloc(this->GetRawTextureDataSize());
+		this->ReadTextureData((void*)result);
 		return Image(result, this->width, this->height, this->GetChannelCount(), this->IsFloatingPoint());
-    }
+	}
+
+	void Texture::GetRawTextureData(PixelBuffer& buffer) const
+	{
+		MX_ASSERT(buffer.GetType() == PixelBufferType::PACK && !buffer.IsMapped());
+		size_t byteSize = this->GetRawTextureDataSize();
+		if (byteSize == 0) return;
+
+		if (buffer.GetSize() != byteSize)
+			buffer.Load(byteSize, UsageType::STREAM_READ);
+
+		// with pack buffer bound, null data pointer is treated as zero offset into buffer storage, so the call returns immediately
+		buffer.Bind();
+		this->ReadTextureData(nullptr);
+		buffer.Unbind();
+	}
 
 	void Texture::GenerateMipmaps()
 	{
 		this->Bind(0);
 		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
 		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GLCALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000)); // reset limit set by compressed image upload
 		GLCALL(glGenerateMipmap(GL_TEXTURE_2D));
 	}
 
@@ -424,6 +553,11 @@ namespace MxEngine
 		return this->wrapType;
 	}
 
+	BlockCompression Texture::GetCompression() const
+	{
+		return this->compression;
+	}
+
 	void Texture::Bind() const
 	{
 		GLCALL(glActiveTexture(GL_TEXTURE0 + this->activeId));
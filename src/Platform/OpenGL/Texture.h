@@ -68,6 +68,10 @@ namespace MxEngine
 	const char* EnumToString(TextureFormat format);
 	const char* EnumToString(TextureWrap wrap);
 
+	class PixelBuffer;
+	struct CompressedImage;
+	enum class BlockCompression : uint8_t;
+
 	class Texture
 	{
 		using BindableId = unsigned int;
@@ -79,9 +83,11 @@ namespace MxEngine
 		unsigned int textureType = 0;
 		TextureFormat format = TextureFormat::RGB;
 		TextureWrap wrapType = TextureWrap::REPEAT;
+		BlockCompression compression{ };
 		uint8_t samples = 0;
 
 		void FreeTexture();
+		void ReadTextureData(void* destination) const;
 	public:
 		using RawData = uint8_t;
 		using RawDataPointer = RawData*;
@@ -103,10 +109,19 @@ namespace MxEngine
 		void Load(const MxString& filepath, TextureFormat format, TextureWrap wrap = TextureWrap::REPEAT, bool genMipmaps = true, bool flipImage = true);
 		void Load(RawDataPointer data, int width, int height, int channels, bool isFloating, TextureFormat format = TextureFormat::RGB, TextureWrap wrap = TextureWrap::REPEAT, bool genMipmaps = true);
 		void Load(const Image& image, TextureFormat format = TextureFormat::RGB, TextureWrap wrap = TextureWrap::REPEAT, bool genMipmaps = true);
+		void Load(const PixelBuffer& buffer, int width, int height, int channels, bool isFloating, TextureFormat format = TextureFormat::RGB, TextureWrap wrap = TextureWrap::REPEAT, bool genMipmaps = true);
+		void Load(const CompressedImage& image, TextureFormat format = TextureFormat::RGB, TextureWrap wrap = TextureWrap::REPEAT);
+		static bool IsCompressionSupported(BlockCompression compression);
 		void LoadDepth(int width, int height, TextureFormat format = TextureFormat::DEPTH, TextureWrap wrap = TextureWrap::CLAMP_TO_BORDER);
 		void SetSamplingFromLOD(size_t lod);
 		size_t GetMaxTextureLOD() const;
 		Image GetRawTextureData() const;
+		/*!
+		schedules copy of texture data into pixel buffer. Copy is performed by GPU asynchronously, so buffer must be mapped only after fence is signaled
+		\param buffer PACK pixel buffer. Its storage is reallocated if its size does not match texture data size
+		*/
+		void GetRawTextureData(PixelBuffer& buffer) const;
+		size_t GetRawTextureDataSize() const;
 		void GenerateMipmaps();
 		void SetBorderColor(const Vector3& color);
 		bool IsMultisampled() const;
@@ -116,6 +131,7 @@ namespace MxEngine
 		size_t GetPixelSize() const;
 		TextureFormat GetFormat() const;
 		TextureWrap GetWrapType() const;
+		BlockCompression GetCompression() const;
 		const MxString& GetPath() const;
 		void SetPath(const MxString& newPath);
 		unsigned int GetTextureType() const;
@@ -63,6 +63,33 @@ namespace MxEngine
 		this->stride -= StrideType(sizeof(float) * count);
 	}
 
+	void VertexBufferLayout::PushHalfFloat(size_t count)
+	{
+		#if defined(MXENGINE_DEBUG)
+		this->layoutString += "half" + ToMxString(count) + ", ";
+		#endif
+		this->elements.push_back({ (unsigned int)count, GL_HALF_FLOAT, false });
+		this->stride += StrideType(sizeof(GLhalf) * count);
+	}
+
+	void VertexBufferLayout::PushShort(size_t count, bool normalized)
+	{
+		#if defined(MXENGINE_DEBUG)
+		this->layoutString += TypeToString<short>() + ToMxString(count) + ", ";
+		#endif
+		this->elements.push_back({ (unsigned int)count, GetGLType<short>(), normalized });
+		this->stride += StrideType(sizeof(short) * count);
+	}
+
+	void VertexBufferLayout::PushUnsignedShort(size_t count, bool normalized)
+	{
+		#if defined(MXENGINE_DEBUG)
+		this->layoutString += TypeToString<unsigned short>() + ToMxString(count) + ", ";
+		#endif
+		this->elements.push_back({ (unsigned int)count, GetGLType<unsigned short>(), normalized });
+		this->stride += StrideType(sizeof(unsigned short) * count);
+	}
+
 	template<>
 	void VertexBufferLayout::Push<float>()
 	{
@@ -63,6 +63,9 @@ namespace MxEngine
 		StrideType GetStride() const;
 		void PushFloat(size_t count);
 		void PopFloat(size_t count);
+		void PushHalfFloat(size_t count);
+		void PushShort(size_t count, bool normalized);
+		void PushUnsignedShort(size_t count, bool normalized);
 		
 		template<typename T>
 		void Push();
@@ -0,0 +1,232 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "AudioDecoder.h"
+
+#include "Utilities/FileSystem/File.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Memory/Memory.h"
+
+// implementations are compiled in AudioLoader.cpp
+#include <dr_flac.h>
+#include <dr_mp3.h>
+#include <dr_wav.h>
+
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis.c>
+
+namespace MxEngine
+{
+    AudioDecoder::AudioDecoder(AudioDecoder&& other) noexcept
+    {
+        this->decoder = other.decoder;
+        this->type = other.type;
+        this->channels = other.channels;
+        this->frequency = other.frequency;
+        this->frameCount = other.frameCount;
+        other.decoder = nullptr;
+    }
+
+    AudioDecoder& AudioDecoder::operator=(AudioDecoder&& other) noexcept
+    {
+        this->Close();
+
+        this->decoder = other.decoder;
+        this->type = other.type;
+        this->channels = other.channels;
+        this->frequency = other.frequency;
+        this->frameCount = other.frameCount;
+        other.decoder = nullptr;
+        return *this;
+    }
+
+    AudioDecoder::~AudioDecoder()
+    {
+        this->Close();
+    }
+
+    bool AudioDecoder::Open(const MxString& path)
+    {
+        this->Close();
+        auto ext = FilePath(path.c_str()).extension();
+
+        if (ext == ".wav")
+        {
+            auto wav = Alloc<drwav>();
+            if (!drwav_init_file(wav, path.c_str(), nullptr))
+            {
+                Free(wav);
+                return false;
+            }
+            this->decoder = wav;
+            this->type = AudioType::WAV;
+            this->channels = wav->channels;
+            this->frequency = wav->sampleRate;
+            this->frameCount = (size_t)wav->totalPCMFrameCount;
+        }
+        else if (ext == ".mp3")
+        {
+            auto mp3 = Alloc<drmp3>();
+            if (!drmp3_init_file(mp3, path.c_str(), nullptr))
+            {
+                Free(mp3);
+                return false;
+            }
+            this->decoder = mp3;
+            this->type = AudioType::MP3;
+            this->channels = mp3->channels;
+            this->frequency = mp3->sampleRate;
+            // mp3 has no frame count in header, so whole file is scanned. Read position is restored by drmp3
+            this->frameCount = (size_t)drmp3_get_pcm_frame_count(mp3);
+        }
+        else if (ext == ".flac")
+        {
+            auto flac = drflac_open_file(path.c_str(), nullptr);
+            if (flac == nullptr)
+                return false;
+
+            this->decoder = flac;
+            this->type = AudioType::FLAC;
+            this->channels = flac->channels;
+            this->frequency = flac->sampleRate;
+            this->frameCount = (size_t)flac->totalPCMFrameCount;
+        }
+        else if (ext == ".ogg")
+        {
+            int error = 0;
+            auto vorbis = stb_vorbis_open_filename(path.c_str(), &error, nullptr);
+            if (vorbis == nullptr)
+                return false;
+
+            auto info = stb_vorbis_get_info(vorbis);
+            this->decoder = vorbis;
+            this->type = AudioType::OGG;
+            this->channels = (size_t)info.channels;
+            this->frequency = (size_t)info.sample_rate;
+            this->frameCount = (size_t)stb_vorbis_stream_length_in_samples(vorbis);
+        }
+        else
+        {
+            MXLOG_WARNING("MxEngine::AudioDecoder", "file cannot be decoded as extension is unknown: " + ToMxString(ext));
+            return false;
+        }
+        return true;
+    }
+
+    void AudioDecoder::Close()
+    {
+        if (this->decoder == nullptr) return;
+
+        switch (this->type)
+        {
+        case AudioType::WAV:
+            drwav_uninit((drwav*)this->decoder);
+            Free((drwav*)this->decoder);
+            break;
+        case AudioType::MP3:
+            drmp3_uninit((drmp3*)this->decoder);
+            Free((drmp3*)this->decoder);
+            break;
+        case AudioType::FLAC:
+            drflac_close((drflac*)this->decoder);
+            break;
+        case AudioType::OGG:
+            stb_vorbis_close((stb_vorbis*)this->decoder);
+            break;
+        }
+        this->decoder = nullptr;
+        this->channels = 0;
+        this->frequency = 0;
+        this->frameCount = 0;
+    }
+
+    size_t AudioDecoder::ReadFrames(int16_t* frames, size_t frameCount)
+    {
+        if (this->decoder == nullptr) return 0;
+
+        switch (this->type)
+        {
+        case AudioType::WAV:
+            return (size_t)drwav_read_pcm_frames_s16((drwav*)this->decoder, frameCount, frames);
+        case AudioType::MP3:
+            return (size_t)drmp3_read_pcm_frames_s16((drmp3*)this->decoder, frameCount, frames);
+        case AudioType::FLAC:
+            return (size_t)drflac_read_pcm_frames_s16((drflac*)this->decoder, frameCount, frames);
+        case AudioType::OGG:
+            return (size_t)stb_vorbis_get_samples_short_interleaved((stb_vorbis*)this->decoder,
+                (int)this->channels, frames, int(frameCount * this->channels));
+        default:
+            return 0;
+        }
+    }
+
+    bool AudioDecoder::Seek(size_t frame)
+    {
+        if (this->decoder == nullptr) return false;
+
+        switch (this->type)
+        {
+        case AudioType::WAV:
+            return drwav_seek_to_pcm_frame((drwav*)this->decoder, frame);
+        case AudioType::MP3:
+            return drmp3_seek_to_pcm_frame((drmp3*)this->decoder, frame);
+        case AudioType::FLAC:
+            return drflac_seek_to_pcm_frame((drflac*)this->decoder, frame);
+        case AudioType::OGG:
+            return stb_vorbis_seek((stb_vorbis*)this->decoder, (unsigned int)frame) != 0;
+        default:
+            return false;
+        }
+    }
+
+    bool AudioDecoder::IsOpen() const
+    {
+        return this->decoder != nullptr;
+    }
+
+    AudioType AudioDecoder::GetAudioType() const
+    {
+        return this->type;
+    }
+
+    size_t AudioDecoder::GetChannelCount() const
+    {
+        return this->channels;
+    }
+
+    size_t AudioDecoder::GetFrequency() const
+    {
+        return this->frequency;
+    }
+
+    size_t AudioDecoder::GetFrameCount() const
+    {
+        return this->frameCount;
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "SupportedAudioTypes.h"
+#include "Utilities/STL/MxString.h"
+
+namespace MxEngine
+{
+    /*!
+    incremental audio decoder. Unlike AudioLoader, which decodes whole file at once, it reads fixed number of frames per call,
+    so long tracks can be played without keeping them in memory. Decoder is not thread-safe, but can be used from any single thread
+    */
+    class AudioDecoder
+    {
+        void* decoder = nullptr;
+        AudioType type = AudioType::WAV;
+        size_t channels = 0;
+        size_t frequency = 0;
+        size_t frameCount = 0;
+    public:
+        AudioDecoder() = default;
+        AudioDecoder(const AudioDecoder&) = delete;
+        AudioDecoder(AudioDecoder&&) noexcept;
+        AudioDecoder& operator=(const AudioDecoder&) = delete;
+        AudioDecoder& operator=(AudioDecoder&&) noexcept;
+        ~AudioDecoder();
+
+        /*!
+        opens audio file for decoding. Previously opened file is closed
+        \param path path to wav, mp3, flac or ogg file
+        \returns true if file was opened, false otherwise
+        */
+        bool Open(const MxString& path);
+        void Close();
+        /*!
+        decodes next frames of audio file into interleaved 16-bit samples
+        \param frames output buffer of at least frameCount * GetChannelCount() samples
+        \param frameCount maximum number of frames to decode
+        \returns number of decoded frames. Value less than frameCount means that end of file was reached
+        */
+        size_t ReadFrames(int16_t* frames, size_t frameCount);
+        /*!
+        moves read position of decoder
+        \param frame index of frame from which next ReadFrames() call will decode
+        \returns true if seek succeeded, false otherwise
+        */
+        bool Seek(size_t frame);
+        bool IsOpen() const;
+        AudioType GetAudioType() const;
+        size_t GetChannelCount() const;
+        size_t GetFrequency() const;
+        size_t GetFrameCount() const;
+    };
+}
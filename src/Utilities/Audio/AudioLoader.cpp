@@ -30,6 +30,7 @@
 
 #include "Utilities/FileSystem/File.h"
 #include "Utilities/Profiler/Profiler.h"
+#include "Utilities/AudioKernels/AudioKernels.h"
 #include "Core/Macro/Macro.h"
 
 #define DR_FLAC_IMPLEMENTATION
@@ -115,6 +116,20 @@ namespace MxEngine
         return result;
     }
 
+    AudioData AudioLoader::LoadMono(const MxString& path)
+    {
+        auto audio = AudioLoader::Load(path);
+        if (audio.data == nullptr || audio.channels <= 1) return audio;
+
+        MAKE_SCOPE_PROFILER("AudioLoader::DownmixToMono");
+        // each mono sample is written before or at position of its first source sample, so data can be overwritten in place
+        size_t frameCount = audio.sampleCount / audio.channels;
+        AudioKernels::Downmix(audio.data, audio.data, frameCount, audio.channels);
+        audio.sampleCount = frameCount;
+        audio.channels = 1;
+        return audio;
+    }
+
     AudioData AudioLoader::ConvertToMono(AudioData& audio)
     {
         AudioData result;
@@ -126,17 +141,37 @@ namespace MxEngine
         result.type = audio.type;
         MX_ASSERT(audio.data != nullptr);
 
-        for (size_t i = 0, j = 0; i < audio.sampleCount; i += 2, j++)
-        {
-            auto left = audio.data[i];
-            auto right = audio.data[i + 1];
-            result.data[j] = (int(left) + int(right)) / 2; //-V522
-        }
+        AudioKernels::Downmix(audio.data, result.data, result.sampleCount, audio.channels);
         return result;
     }
 
+    bool AudioLoader::Resample(AudioData& audio, size_t frequency)
+    {
+        if (audio.data == nullptr || frequency == 0 || audio.frequency == 0 || audio.frequency == frequency) return false;
+        MX_ASSERT(audio.channels == 1);
+
+        MAKE_SCOPE_PROFILER("AudioLoader::Resample");
+        size_t resampledCount = AudioKernels::GetResampledCount(audio.sampleCount, audio.frequency, frequency);
+        auto resampled = (int16_t*)std::malloc(resampledCount * sizeof(int16_t));
+        if (resampled == nullptr) return false;
+        AudioKernels::Resample(audio.data, audio.sampleCount, audio.frequency, resampled, frequency);
+
+        AudioLoader::Free(audio);
+        audio.data = resampled;
+        audio.sampleCount = resampledCount;
+        audio.frequency = frequency;
+        audio.isResampled = true;
+        return true;
+    }
+
     void AudioLoader::Free(AudioData& audio)
     {
+        if (audio.isResampled)
+        {
+            std::free((void*)audio.data);
+            return;
+        }
+
         switch (audio.type)
         {
         case AudioType::WAV:
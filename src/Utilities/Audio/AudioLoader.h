@@ -40,13 +40,27 @@ namespace MxEngine
         size_t sampleCount = 0;
         size_t channels = 0;
         size_t frequency = 0;
+        bool isResampled = false; // samples were replaced by resampler and are owned by AudioLoader, not by decoder
     };
 
     class AudioLoader
     {
     public:
         static AudioData Load(const MxString& path);
+        /*!
+        loads audio file and downmixes it to mono. Samples are averaged in place, so no second copy of audio is allocated
+        \param path path to wav, mp3, flac or ogg file
+        \returns mono audio data or audio data with nullptr samples if file cannot be loaded. Must be freed by Free() method
+        */
+        static AudioData LoadMono(const MxString& path);
         static AudioData ConvertToMono(AudioData& audio);
+        /*!
+        resamples mono audio to other sampling rate. Samples are replaced by newly allocated ones, old samples are freed
+        \param audio mono audio data loaded by AudioLoader
+        \param frequency target sampling rate. Zero means that audio keeps its sampling rate
+        \returns true if audio was resampled, false if it already has requested sampling rate or cannot be resampled
+        */
+        static bool Resample(AudioData& audio, size_t frequency);
         static void Free(AudioData& audio);
     };
 }
\ No newline at end of file
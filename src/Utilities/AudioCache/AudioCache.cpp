@@ -0,0 +1,181 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "AudioCache.h"
+#include "Utilities/FileSystem/CacheFile.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <cstring>
+#include <cstddef>
+
+namespace MxEngine
+{
+    constexpr uint8_t AudioCacheMagic[8] = { 'M', 'X', 'P', 'C', 'M', '\0', '\0', '\0' };
+
+    struct AudioCacheHeader
+    {
+        uint8_t Magic[8];
+        uint32_t Version;
+        uint32_t SourceType;
+        SourceStamp Source;
+        uint32_t Frequency;
+        uint32_t Channels;
+        uint32_t TargetFrequency;
+        uint32_t Reserved;
+        uint64_t SampleCount;
+        uint64_t DataOffset;
+        uint64_t FileSize;
+    };
+
+    MxString AudioCache::GetCachePath(const MxString& path)
+    {
+        return path + ".mxpcm";
+    }
+
+    bool AudioCache::Map(const MxString& path, size_t targetFrequency, MappedFile& file, AudioData& audio)
+    {
+        MAKE_SCOPE_PROFILER("AudioCache::Map()");
+        auto cachePath = ToFilePath(AudioCache::GetCachePath(path));
+        if (!File::IsFile(cachePath)) return false;
+
+        MappedFile cache(cachePath);
+        const uint8_t* bytes = cache.GetData();
+        const uint64_t fileSize = (uint64_t)cache.GetSize();
+        if (bytes == nullptr || fileSize < sizeof(AudioCacheHeader))
+        {
+            MXLOG_WARNING("MxEngine::AudioCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+
+        AudioCacheHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.Magic, AudioCacheMagic, sizeof(AudioCacheMagic)) != 0 || header.FileSize != fileSize)
+        {
+            MXLOG_WARNING("MxEngine::AudioCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+        if (header.Version != AudioCache::FormatVersion || header.TargetFrequency != (uint32_t)targetFrequency)
+        {
+            MXLOG_DEBUG("MxEngine::AudioCache", "cache was built with other engine version or sampling rate: " + ToMxString(cachePath));
+            return false;
+        }
+
+        SourceStamp source;
+        auto sourceState = CacheFile::ValidateSource(ToFilePath(path), header.Source, source);
+        if (sourceState == SourceState::MODIFIED)
+        {
+            MXLOG_DEBUG("MxEngine::AudioCache", "cache is outdated: " + ToMxString(cachePath));
+            return false;
+        }
+
+        bool isDataInRange = header.DataOffset <= fileSize && header.DataOffset % alignof(int16_t) == 0 &&
+            header.SampleCount <= (fileSize - header.DataOffset) / sizeof(int16_t);
+        if (!isDataInRange || header.Channels == 0 || header.Frequency == 0 || header.SampleCount % header.Channels != 0)
+        {
+            MXLOG_WARNING("MxEngine::AudioCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+
+        if (sourceState == SourceState::TOUCHED)
+        {
+            // mapping does not share write access, so stamp is updated while file is closed and then it is mapped again
+            cache.Close();
+            CacheFile::UpdateSourceStamp(cachePath, offsetof(AudioCacheHeader, Source), source);
+            if (!cache.Open(cachePath) || (uint64_t)cache.GetSize() != fileSize)
+            {
+                MXLOG_WARNING("MxEngine::AudioCache", "cache file was changed while loading: " + ToMxString(cachePath));
+                return false;
+            }
+            bytes = cache.GetData();
+        }
+
+        // samples are not copied, they stay in mapped view until file is closed
+        audio.data = (int16_t*)(bytes + header.DataOffset);
+        audio.type = (AudioType)header.SourceType;
+        audio.sampleCount = (size_t)header.SampleCount;
+        audio.channels = (size_t)header.Channels;
+        audio.frequency = (size_t)header.Frequency;
+        file = std::move(cache);
+
+        MXLOG_DEBUG("MxEngine::AudioCache", "loaded audio from cache: " + ToMxString(cachePath));
+        return true;
+    }
+
+    bool AudioCache::Save(const AudioData& audio, const MxString& path, size_t targetFrequency)
+    {
+        MAKE_SCOPE_PROFILER("AudioCache::Save()");
+        auto sourcePath = ToFilePath(path);
+        auto cachePath = ToFilePath(AudioCache::GetCachePath(path));
+        SourceStamp source;
+        if (!CacheFile::GetSourceStamp(sourcePath, source))
+        {
+            MXLOG_WARNING("MxEngine::AudioCache", "cannot create cache for non-existing file: " + path);
+            return false;
+        }
+        if (audio.data == nullptr || audio.channels == 0)
+        {
+            MXLOG_WARNING("MxEngine::AudioCache", "cannot create cache for empty audio: " + path);
+            return false;
+        }
+
+        AudioCacheHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.Magic, AudioCacheMagic, sizeof(AudioCacheMagic));
+        header.Version = AudioCache::FormatVersion;
+        header.SourceType = (uint32_t)audio.type;
+        header.Source = source;
+        header.Frequency = (uint32_t)audio.frequency;
+        header.Channels = (uint32_t)audio.channels;
+        header.TargetFrequency = (uint32_t)targetFrequency;
+        header.SampleCount = (uint64_t)audio.sampleCount;
+
+        // layout: header | aligned samples
+        header.DataOffset = CacheFile::AlignOffset(sizeof(AudioCacheHeader), AudioCache::DataAlignment);
+        header.FileSize = header.DataOffset + header.SampleCount * sizeof(int16_t);
+
+        bool isWritten = CacheFile::Write(cachePath, [&](CacheWriter& writer)
+        {
+            writer.WriteAt(0, &header, sizeof(header));
+            writer.WriteAt(header.DataOffset, audio.data, audio.sampleCount * sizeof(int16_t));
+        });
+        if (!isWritten) return false;
+
+        MXLOG_DEBUG("MxEngine::AudioCache", MxFormat("created cache {0} ({1} Hz, {2} channels, {3} bytes)",
+            ToMxString(cachePath).c_str(), header.Frequency, header.Channels, header.FileSize));
+        return true;
+    }
+
+    void AudioCache::Invalidate(const MxString& path)
+    {
+        std::error_code error;
+        std::filesystem::remove(ToFilePath(AudioCache::GetCachePath(path)), error);
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/Audio/AudioLoader.h"
+#include "Utilities/FileSystem/MappedFile.h"
+
+namespace MxEngine
+{
+    /*!
+    AudioCache stores decoded 16-bit PCM samples in engine-native .mxpcm format next to their compressed source files.
+    Cache file consists of versioned header with sample rate and channel count, followed by aligned sample data,
+    so it can be memory-mapped and uploaded to audio API without decoding or copying.
+    Source file is checked with CacheFile::ValidateSource(), so re-encoded audio invalidates cache
+    */
+    class AudioCache
+    {
+    public:
+        /*!
+        version of .mxpcm format. Caches with other versions are ignored and rebuilt
+        */
+        constexpr static uint32_t FormatVersion = 2;
+        /*!
+        alignment in bytes of sample data inside cache file
+        */
+        constexpr static size_t DataAlignment = 64;
+
+        /*!
+        gets path of cache file for audio source file
+        \param path path to audio source file
+        \returns path to .mxpcm file
+        */
+        static MxString GetCachePath(const MxString& path);
+        /*!
+        maps cache file if it exists and is up-to-date with its source
+        \param path path to audio source file (not to the cache itself)
+        \param targetFrequency sampling rate requested by engine settings, 0 for source sampling rate. Cache built for other rate is treated as outdated
+        \param file mapped file which owns samples. Samples are valid until it is closed
+        \param audio audio data which is filled with pointer to mapped samples. Must not be freed by AudioLoader::Free()
+        \returns true if cache was mapped, false either
+        */
+        static bool Map(const MxString& path, size_t targetFrequency, MappedFile& file, AudioData& audio);
+        /*!
+        writes decoded samples to cache file atomically
+        \param audio decoded audio to save
+        \param path path to audio source file (not to the cache itself)
+        \param targetFrequency sampling rate which was requested when audio was decoded, 0 for source sampling rate
+        \returns true if cache was written successfully, false either
+        */
+        static bool Save(const AudioData& audio, const MxString& path, size_t targetFrequency);
+        /*!
+        removes cache file of audio source file if it exists
+        \param path path to audio source file
+        */
+        static void Invalidate(const MxString& path);
+    };
+}
@@ -0,0 +1,677 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "AudioKernels.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+#include "Utilities/KernelBenchmark/KernelBenchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_AUDIO_KERNELS_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MXENGINE_AUDIO_KERNELS_AVX2
+#define MXENGINE_TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__GNUC__) || defined(__clang__)
+// AVX2 kernels are compiled for AVX2 target separately, so engine does not require AVX2 capable CPU
+#define MXENGINE_AUDIO_KERNELS_AVX2
+#define MXENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+namespace MxEngine
+{
+    const char* EnumToString(AudioInstructionSet set)
+    {
+        switch (set)
+        {
+        case AudioInstructionSet::SCALAR:
+            return "SCALAR";
+        case AudioInstructionSet::SSE2:
+            return "SSE2";
+        case AudioInstructionSet::AVX2:
+            return "AVX2";
+        default:
+            return "SCALAR";
+        }
+    }
+
+    constexpr size_t TapCount = AudioKernels::ResamplerTapCount;
+    constexpr size_t TapPadding = TapCount / 2 - 1; // number of silent samples placed before source, so first taps never read outside of it
+    constexpr size_t ResampleChunkSize = 4096;
+    constexpr float ResamplerKaiserAlpha = 8.0f;
+    constexpr float ResamplerCutoff = 0.9f; // relative to Nyquist frequency of lower sampling rate
+    static_assert(TapCount % 16 == 0, "vectorized resampler kernels expect tap count to be multiple of 16");
+
+    /*!
+    precomputed polyphase filter. Resampled sample i is placed at source position i * Decimation / Interpolation,
+    each phase contains weights for one fractional part of this position
+    */
+    struct ResamplingFilter
+    {
+        size_t Interpolation = 1;
+        size_t Decimation = 1;
+        size_t PhaseCount = 1;
+        MxVector<float> Weights;
+    };
+
+    /*!
+    pointers to kernels of one instruction set. Kernels which have no specialized version for instruction set point to version of lower one
+    */
+    struct AudioKernelTable
+    {
+        void (*Downmix)(const int16_t* source, int16_t* destination, size_t frameCount, size_t channelCount);
+        void (*ConvertToFloat)(const int16_t* source, float* destination, size_t count);
+        void (*ConvertFromFloat)(const float* source, int16_t* destination, size_t count);
+        void (*Resample)(const float* source, float* destination, size_t begin, size_t end, const ResamplingFilter& filter);
+    };
+
+    static uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static const float* GetFilterTaps(const ResamplingFilter& filter, const float* source, size_t index, const float*& weights)
+    {
+        size_t position = index * filter.Decimation;
+        size_t phase = (position % filter.Interpolation) * filter.PhaseCount / filter.Interpolation;
+        weights = filter.Weights.data() + phase * TapCount;
+        return source + position / filter.Interpolation;
+    }
+
+    static void DownmixScalar(const int16_t* source, int16_t* destination, size_t frameCount, size_t channelCount)
+    {
+        if (channelCount == 1)
+        {
+            if (source != destination) std::memmove(destination, source, frameCount * sizeof(int16_t));
+            return;
+        }
+        // each frame is written before or at position of its first source sample, so data can be overwritten in place
+        for (size_t i = 0; i < frameCount; i++)
+        {
+            int sum = 0;
+            for (size_t channel = 0; channel < channelCount; channel++)
+                sum += source[i * channelCount + channel];
+            destination[i] = int16_t(sum / (int)channelCount);
+        }
+    }
+
+    static void ConvertToFloatScalar(const int16_t* source, float* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            destination[i] = float(source[i]) * (1.0f / 32768.0f);
+    }
+
+    static int16_t FloatToSample(float value)
+    {
+        float scaled = value * 32768.0f;
+        if (scaled != scaled) return 0;
+        scaled = std::min(std::max(scaled, -32768.0f), 32767.0f);
+        return (int16_t)std::nearbyint(scaled);
+    }
+
+    static void ConvertFromFloatScalar(const float* source, int16_t* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            destination[i] = FloatToSample(source[i]);
+    }
+
+    static void ResampleScalar(const float* source, float* destination, size_t begin, size_t end, const ResamplingFilter& filter)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const float* weights = nullptr;
+            const float* samples = GetFilterTaps(filter, source, i, weights);
+            float sum = 0.0f;
+            for (size_t k = 0; k < TapCount; k++)
+                sum += samples[k] * weights[k];
+            destination[i - begin] = sum;
+        }
+    }
+
+    constexpr AudioKernelTable ScalarKernels =
+    {
+        DownmixScalar,
+        ConvertToFloatScalar,
+        ConvertFromFloatScalar,
+        ResampleScalar,
+    };
+
+#if defined(MXENGINE_AUDIO_KERNELS_SSE2)
+    template<int Shift>
+    static __m128i DivideSumsSSE2(__m128i sums)
+    {
+        // negative sums are biased before shift, so result is rounded towards zero as in integer division
+        __m128i bias = _mm_srli_epi32(_mm_srai_epi32(sums, 31), 32 - Shift);
+        return _mm_srai_epi32(_mm_add_epi32(sums, bias), Shift);
+    }
+
+    static __m128i SumPairsSSE2(const int16_t* samples)
+    {
+        return _mm_madd_epi16(_mm_loadu_si128((const __m128i*)samples), _mm_set1_epi16(1));
+    }
+
+    static __m128i SumQuadsSSE2(const int16_t* samples)
+    {
+        // each frame produces two adjacent pair sums, which are separated into even and odd lanes and added
+        __m128 a = _mm_castsi128_ps(SumPairsSSE2(samples));
+        __m128 b = _mm_castsi128_ps(SumPairsSSE2(samples + 8));
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        return _mm_add_epi32(even, odd);
+    }
+
+    static __m128i SumOctetsSSE2(const int16_t* samples)
+    {
+        // each load contains one frame, its four pair sums are transposed with other frames and added
+        __m128i a = SumPairsSSE2(samples);
+        __m128i b = SumPairsSSE2(samples + 8);
+        __m128i c = SumPairsSSE2(samples + 16);
+        __m128i d = SumPairsSSE2(samples + 24);
+        __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+        __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+        return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+    }
+
+    static void DownmixSSE2(const int16_t* source, int16_t* destination, size_t frameCount, size_t channelCount)
+    {
+        // all frames of iteration are loaded before result is stored, so downmix can still be done in place
+        size_t i = 0;
+        if (channelCount == 2)
+        {
+            for (; i + 8 <= frameCount; i += 8)
+            {
+                __m128i low = DivideSumsSSE2<1>(SumPairsSSE2(source + i * 2));
+                __m128i high = DivideSumsSSE2<1>(SumPairsSSE2(source + i * 2 + 8));
+                _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+            }
+        }
+        else if (channelCount == 4)
+        {
+            for (; i + 8 <= frameCount; i += 8)
+            {
+                __m128i low = DivideSumsSSE2<2>(SumQuadsSSE2(source + i * 4));
+                __m128i high = DivideSumsSSE2<2>(SumQuadsSSE2(source + i * 4 + 16));
+                _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+            }
+        }
+        else if (channelCount == 8)
+        {
+            for (; i + 8 <= frameCount; i += 8)
+            {
+                __m128i low = DivideSumsSSE2<3>(SumOctetsSSE2(source + i * 8));
+                __m128i high = DivideSumsSSE2<3>(SumOctetsSSE2(source + i * 8 + 32));
+                _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+            }
+        }
+        DownmixScalar(source + i * channelCount, destination + i, frameCount - i, channelCount);
+    }
+
+    static void ConvertToFloatSSE2(const int16_t* source, float* destination, size_t count)
+    {
+        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i samples = _mm_loadu_si128((const __m128i*)(source + i));
+            // samples are moved to upper halves of 32-bit lanes, so arithmetic shift extends their sign
+            __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+            __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+            _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+            _mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+        }
+        ConvertToFloatScalar(source + i, destination + i, count - i);
+    }
+
+    static __m128i FloatToSamplesSSE2(__m128 values)
+    {
+        __m128 scaled = _mm_mul_ps(values, _mm_set1_ps(32768.0f));
+        scaled = _mm_and_ps(scaled, _mm_cmpeq_ps(scaled, scaled));
+        scaled = _mm_min_ps(_mm_max_ps(scaled, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f));
+        return _mm_cvtps_epi32(scaled);
+    }
+
+    static void ConvertFromFloatSSE2(const float* source, int16_t* destination, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i low = FloatToSamplesSSE2(_mm_loadu_ps(source + i));
+            __m128i high = FloatToSamplesSSE2(_mm_loadu_ps(source + i + 4));
+            _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+        }
+        ConvertFromFloatScalar(source + i, destination + i, count - i);
+    }
+
+    static float HorizontalSumSSE2(__m128 values)
+    {
+        values = _mm_add_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+        values = _mm_add_ps(values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(values);
+    }
+
+    static void ResampleSSE2(const float* source, float* destination, size_t begin, size_t end, const ResamplingFilter& filter)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const float* weights = nullptr;
+            const float* samples = GetFilterTaps(filter, source, i, weights);
+            __m128 sum0 = _mm_setzero_ps();
+            __m128 sum1 = _mm_setzero_ps();
+            for (size_t k = 0; k < TapCount; k += 8)
+            {
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(samples + k), _mm_loadu_ps(weights + k)));
+                sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(samples + k + 4), _mm_loadu_ps(weights + k + 4)));
+            }
+            destination[i - begin] = HorizontalSumSSE2(_mm_add_ps(sum0, sum1));
+        }
+    }
+
+    constexpr AudioKernelTable SSE2Kernels =
+    {
+        DownmixSSE2,
+        ConvertToFloatSSE2,
+        ConvertFromFloatSSE2,
+        ResampleSSE2,
+    };
+#endif
+
+#if defined(MXENGINE_AUDIO_KERNELS_AVX2)
+    MXENGINE_TARGET_AVX2 static __m256i DivideStereoSumsAVX2(__m256i sums)
+    {
+        __m256i bias = _mm256_srli_epi32(sums, 31);
+        return _mm256_srai_epi32(_mm256_add_epi32(sums, bias), 1);
+    }
+
+    MXENGINE_TARGET_AVX2 static void DownmixAVX2(const int16_t* source, int16_t* destination, size_t frameCount, size_t channelCount)
+    {
+        // only stereo layout benefits from wider registers, other layouts are processed by SSE2 kernel
+        if (channelCount != 2)
+        {
+            DownmixSSE2(source, destination, frameCount, channelCount);
+            return;
+        }
+
+        const __m256i ones = _mm256_set1_epi16(1);
+        size_t i = 0;
+        for (; i + 16 <= frameCount; i += 16)
+        {
+            __m256i low = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(source + i * 2)), ones);
+            __m256i high = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(source + i * 2 + 16)), ones);
+            // packing works inside 128-bit lanes, so frames are reordered back afterwards
+            __m256i packed = _mm256_packs_epi32(DivideStereoSumsAVX2(low), DivideStereoSumsAVX2(high));
+            _mm256_storeu_si256((__m256i*)(destination + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        DownmixSSE2(source + i * 2, destination + i, frameCount - i, channelCount);
+    }
+
+    MXENGINE_TARGET_AVX2 static void ConvertToFloatAVX2(const int16_t* source, float* destination, size_t count)
+    {
+        const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i low = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(source + i)));
+            __m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(source + i + 8)));
+            _mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale));
+            _mm256_storeu_ps(destination + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale));
+        }
+        ConvertToFloatSSE2(source + i, destination + i, count - i);
+    }
+
+    MXENGINE_TARGET_AVX2 static __m256i FloatToSamplesAVX2(__m256 values)
+    {
+        __m256 scaled = _mm256_mul_ps(values, _mm256_set1_ps(32768.0f));
+        scaled = _mm256_and_ps(scaled, _mm256_cmp_ps(scaled, scaled, _CMP_EQ_OQ));
+        scaled = _mm256_min_ps(_mm256_max_ps(scaled, _mm256_set1_ps(-32768.0f)), _mm256_set1_ps(32767.0f));
+        return _mm256_cvtps_epi32(scaled);
+    }
+
+    MXENGINE_TARGET_AVX2 static void ConvertFromFloatAVX2(const float* source, int16_t* destination, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i low = FloatToSamplesAVX2(_mm256_loadu_ps(source + i));
+            __m256i high = FloatToSamplesAVX2(_mm256_loadu_ps(source + i + 8));
+            __m256i packed = _mm256_packs_epi32(low, high);
+            _mm256_storeu_si256((__m256i*)(destination + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        ConvertFromFloatSSE2(source + i, destination + i, count - i);
+    }
+
+    MXENGINE_TARGET_AVX2 static void ResampleAVX2(const float* source, float* destination, size_t begin, size_t end, const ResamplingFilter& filter)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const float* weights = nullptr;
+            const float* samples = GetFilterTaps(filter, source, i, weights);
+            __m256 sum0 = _mm256_setzero_ps();
+            __m256 sum1 = _mm256_setzero_ps();
+            for (size_t k = 0; k < TapCount; k += 16)
+            {
+                sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(samples + k), _mm256_loadu_ps(weights + k)));
+                sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(samples + k + 8), _mm256_loadu_ps(weights + k + 8)));
+            }
+            __m256 sum = _mm256_add_ps(sum0, sum1);
+            destination[i - begin] = HorizontalSumSSE2(_mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1)));
+        }
+    }
+
+    constexpr AudioKernelTable AVX2Kernels =
+    {
+        DownmixAVX2,
+        ConvertToFloatAVX2,
+        ConvertFromFloatAVX2,
+        ResampleAVX2,
+    };
+
+    static bool IsAVX2Available()
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+        bool hasAVX = (info[2] & (1 << 28)) != 0;
+        if (!hasOSXSave || !hasAVX) return false;
+        // operating system must save upper halves of ymm registers on context switch
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2");
+    #endif
+    }
+#endif
+
+    static AudioInstructionSet DetectInstructionSet()
+    {
+    #if defined(MXENGINE_AUDIO_KERNELS_AVX2)
+        if (IsAVX2Available()) return AudioInstructionSet::AVX2;
+    #endif
+    #if defined(MXENGINE_AUDIO_KERNELS_SSE2)
+        return AudioInstructionSet::SSE2;
+    #else
+        return AudioInstructionSet::SCALAR;
+    #endif
+    }
+
+    static const AudioKernelTable& GetKernelTable(AudioInstructionSet set)
+    {
+        switch (set)
+        {
+        #if defined(MXENGINE_AUDIO_KERNELS_AVX2)
+        case AudioInstructionSet::AVX2:
+            return AVX2Kernels;
+        #endif
+        #if defined(MXENGINE_AUDIO_KERNELS_SSE2)
+        case AudioInstructionSet::SSE2:
+            return SSE2Kernels;
+        #endif
+        default:
+            return ScalarKernels;
+        }
+    }
+
+    static const AudioKernelTable& GetKernelTable()
+    {
+        static const AudioKernelTable& table = GetKernelTable(AudioKernels::GetInstructionSet());
+        return table;
+    }
+
+    AudioInstructionSet AudioKernels::GetInstructionSet()
+    {
+        static AudioInstructionSet set = DetectInstructionSet();
+        return set;
+    }
+
+    bool AudioKernels::IsSupported(AudioInstructionSet set)
+    {
+        return (uint8_t)set <= (uint8_t)AudioKernels::GetInstructionSet();
+    }
+
+    void AudioKernels::Downmix(const int16_t* source, int16_t* destination, size_t frameCount, size_t channelCount)
+    {
+        MX_ASSERT(channelCount > 0);
+        GetKernelTable().Downmix(source, destination, frameCount, channelCount);
+    }
+
+    void AudioKernels::ConvertToFloat(const int16_t* source, float* destination, size_t count)
+    {
+        GetKernelTable().ConvertToFloat(source, destination, count);
+    }
+
+    void AudioKernels::ConvertFromFloat(const float* source, int16_t* destination, size_t count)
+    {
+        GetKernelTable().ConvertFromFloat(source, destination, count);
+    }
+
+    size_t AudioKernels::GetResampledCount(size_t sampleCount, size_t sourceFrequency, size_t destinationFrequency)
+    {
+        if (sourceFrequency == 0 || destinationFrequency == 0 || sourceFrequency == destinationFrequency)
+            return sampleCount;
+        size_t divisor = std::gcd(sourceFrequency, destinationFrequency);
+        size_t interpolation = destinationFrequency / divisor, decimation = sourceFrequency / divisor;
+        return (sampleCount * interpolation + decimation - 1) / decimation;
+    }
+
+    static float BesselI0(float x)
+    {
+        // power series converges quickly for window parameters used in practice
+        float sum = 1.0f, term = 1.0f;
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (x / (2.0f * k)) * (x / (2.0f * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static ResamplingFilter CreateResamplingFilter(size_t sourceFrequency, size_t destinationFrequency)
+    {
+        ResamplingFilter filter;
+        size_t divisor = std::gcd(sourceFrequency, destinationFrequency);
+        filter.Interpolation = destinationFrequency / divisor;
+        filter.Decimation = sourceFrequency / divisor;
+        filter.PhaseCount = std::min(filter.Interpolation, AudioKernels::MaxResamplerPhaseCount);
+        filter.Weights.resize(filter.PhaseCount * TapCount);
+
+        // cutoff is measured in source sampling rate and is lowered when downsampling, so no frequencies above new Nyquist frequency remain
+        float cutoff = ResamplerCutoff * std::min(1.0f, float(destinationFrequency) / float(sourceFrequency));
+        constexpr float Radius = TapCount / 2.0f;
+        float windowScale = 1.0f / BesselI0(ResamplerKaiserAlpha);
+        for (size_t phase = 0; phase < filter.PhaseCount; phase++)
+        {
+            float* weights = filter.Weights.data() + phase * TapCount;
+            float fraction = float(phase) / float(filter.PhaseCount);
+            float total = 0.0f;
+            for (size_t k = 0; k < TapCount; k++)
+            {
+                // distance from resampled sample to source sample of k-th tap
+                float offset = float(k) - float(TapPadding) - fraction;
+                float t = offset / Radius;
+                float x = Pi<float>() * offset * cutoff;
+                float sinc = x == 0.0f ? 1.0f : std::sin(x) / x;
+                float window = BesselI0(ResamplerKaiserAlpha * std::sqrt(std::max(1.0f - t * t, 0.0f))) * windowScale;
+                weights[k] = sinc * window;
+                total += weights[k];
+            }
+            // each phase is normalized separately, so constant signal keeps its level
+            for (size_t k = 0; k < TapCount; k++)
+                weights[k] /= total;
+        }
+        return filter;
+    }
+
+    static void Resample(const int16_t* source, size_t sampleCount, size_t sourceFrequency, int16_t* destination, size_t destinationFrequency, const AudioKernelTable& kernels)
+    {
+        size_t resampledCount = AudioKernels::GetResampledCount(sampleCount, sourceFrequency, destinationFrequency);
+        if (sourceFrequency == destinationFrequency)
+        {
+            std::copy(source, source + sampleCount, destination);
+            return;
+        }
+        if (resampledCount == 0) return;
+
+        auto filter = CreateResamplingFilter(sourceFrequency, destinationFrequency);
+        // source is surrounded by silence, so filter taps never read outside of samples
+        MxVector<float> samples(sampleCount + TapCount, 0.0f);
+        kernels.ConvertToFloat(source, samples.data() + TapPadding, sampleCount);
+
+        ThreadPool::ParallelFor(resampledCount, AudioKernels::ParallelSampleGranularity, [&](size_t begin, size_t end)
+        {
+            // filtered samples are converted back in small chunks, so no second float copy of whole audio is needed
+            std::array<float, ResampleChunkSize> filtered;
+            for (size_t chunk = begin; chunk < end; chunk += ResampleChunkSize)
+            {
+                size_t chunkEnd = std::min(chunk + ResampleChunkSize, end);
+                kernels.Resample(samples.data(), filtered.data(), chunk, chunkEnd, filter);
+                kernels.ConvertFromFloat(filtered.data(), destination + chunk, chunkEnd - chunk);
+            }
+        });
+    }
+
+    void AudioKernels::Resample(const int16_t* source, size_t sampleCount, size_t sourceFrequency, int16_t* destination, size_t destinationFrequency)
+    {
+        MAKE_SCOPE_PROFILER("AudioKernels::Resample()");
+        MX_ASSERT(sourceFrequency > 0 && destinationFrequency > 0);
+        MxEngine::Resample(source, sampleCount, sourceFrequency, destination, destinationFrequency, GetKernelTable());
+    }
+
+    AudioKernelsBenchmark AudioKernels::RunBenchmark(size_t sampleCount)
+    {
+        AudioKernelsBenchmark result;
+        sampleCount = std::max(sampleCount - sampleCount % 8, (size_t)8);
+        result.SampleCount = sampleCount;
+        result.InstructionSet = AudioKernels::GetInstructionSet();
+
+        // several tones with noise, clipped near full scale, so rounding and saturation paths are exercised
+        MxVector<int16_t> samples(sampleCount);
+        uint32_t seed = 0x12345678u;
+        for (size_t i = 0; i < sampleCount; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            float t = float(i) / 44100.0f;
+            float value = 0.6f * std::sin(2.0f * Pi<float>() * 440.0f * t) + 0.3f * std::sin(2.0f * Pi<float>() * 7919.0f * t);
+            value += (float(seed >> 16) / 65535.0f - 0.5f) * 0.3f;
+            samples[i] = (int16_t)Clamp(value * 32768.0f, -32768.0f, 32767.0f);
+        }
+        samples[0] = std::numeric_limits<int16_t>::min();
+        samples[1] = std::numeric_limits<int16_t>::max();
+
+        // float input covers out-of-range, special values and exact halves between samples
+        MxVector<float> floats(sampleCount);
+        for (size_t i = 0; i < sampleCount; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            floats[i] = float(int32_t(seed >> 14) - (1 << 17)) * (0.5f / 32768.0f);
+        }
+        floats[0] = std::numeric_limits<float>::infinity();
+        floats[1] = -std::numeric_limits<float>::infinity();
+        floats[2] = std::numeric_limits<float>::quiet_NaN();
+
+        // each vectorized output is compared to scalar reference, see KernelBenchmark::Measure()
+        KernelBenchmark<AudioKernelTable, AudioInstructionSet, AudioKernelTiming> benchmark(ScalarKernels, result.InstructionSet);
+        for (auto set : { AudioInstructionSet::SSE2, AudioInstructionSet::AVX2 })
+        {
+            if (AudioKernels::IsSupported(set)) benchmark.AddTable(set, GetKernelTable(set));
+        }
+
+        MxVector<int16_t> output[2];
+        MxVector<float> floatOutput[2];
+        auto compareSamples = [&]() { return ComputeKernelMaxError(output[1].data(), output[0].data(), output[0].size()); };
+
+        const std::pair<size_t, const char*> layouts[] = { { 2, "stereo downmix" }, { 4, "quad downmix" }, { 6, "5.1 downmix" }, { 8, "7.1 downmix" } };
+        for (const auto& [channels, name] : layouts)
+        {
+            benchmark.Measure(name, [&, channels = channels](const AudioKernelTable& kernels, bool isReference)
+            {
+                output[isReference].resize(sampleCount / channels);
+                kernels.Downmix(samples.data(), output[isReference].data(), sampleCount / channels, channels);
+            }, compareSamples);
+        }
+
+        benchmark.Measure("int16 to float", [&](const AudioKernelTable& kernels, bool isReference)
+        {
+            floatOutput[isReference].resize(sampleCount);
+            kernels.ConvertToFloat(samples.data(), floatOutput[isReference].data(), sampleCount);
+        }, [&]() { return ComputeKernelMaxError(floatOutput[1].data(), floatOutput[0].data(), floatOutput[0].size()); });
+
+        benchmark.Measure("float to int16", [&](const AudioKernelTable& kernels, bool isReference)
+        {
+            output[isReference].resize(sampleCount);
+            kernels.ConvertFromFloat(floats.data(), output[isReference].data(), sampleCount);
+        }, compareSamples);
+
+        benchmark.Measure("resample 44100 -> 48000", [&](const AudioKernelTable& kernels, bool isReference)
+        {
+            output[isReference].resize(AudioKernels::GetResampledCount(sampleCount, 44100, 48000));
+            MxEngine::Resample(samples.data(), sampleCount, 44100, output[isReference].data(), 48000, kernels);
+        }, compareSamples);
+
+        benchmark.Measure("resample 48000 -> 22050", [&](const AudioKernelTable& kernels, bool isReference)
+        {
+            output[isReference].resize(AudioKernels::GetResampledCount(sampleCount, 48000, 22050));
+            MxEngine::Resample(samples.data(), sampleCount, 48000, output[isReference].data(), 22050, kernels);
+        }, compareSamples);
+
+        result.FailedKernels = benchmark.Report("MxEngine::AudioKernels", [](const AudioKernelTiming& kernel) -> size_t
+        {
+            // resampler accumulates taps in different order on each instruction set
+            return std::strncmp(kernel.Name, "resample", 8) == 0 ? 1 : 0;
+        });
+        result.Kernels = std::move(benchmark.Timings);
+
+        MXLOG_INFO("MxEngine::AudioKernels", MxFormat("benchmark on {0} samples using {1} kernels, {2} threads",
+            sampleCount, EnumToString(result.InstructionSet), ThreadPool::GetWorkerCount() + 1));
+        if (result.FailedKernels > 0)
+            MXLOG_WARNING("MxEngine::AudioKernels", MxFormat("{0} kernels produced results different from scalar reference", result.FailedKernels));
+        return result;
+    }
+}
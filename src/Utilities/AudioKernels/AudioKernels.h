@@ -0,0 +1,132 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+#include <cstdint>
+
+namespace MxEngine
+{
+    enum class AudioInstructionSet : uint8_t
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+    };
+
+    const char* EnumToString(AudioInstructionSet set);
+
+    /*!
+    timings of one audio kernel, measured in seconds. Error is the maximal difference from scalar kernel output in units in the last place of output type
+    */
+    struct AudioKernelTiming
+    {
+        const char* Name = "";
+        TimeStep Reference = 0.0f;
+        TimeStep Optimized = 0.0f;
+        size_t MaxError = 0;
+    };
+
+    /*!
+    results of audio kernels benchmark. Each kernel of each supported instruction set is validated against scalar kernel
+    */
+    struct AudioKernelsBenchmark
+    {
+        size_t SampleCount = 0;
+        AudioInstructionSet InstructionSet = AudioInstructionSet::SCALAR;
+        MxVector<AudioKernelTiming> Kernels;
+        size_t FailedKernels = 0;
+    };
+
+    /*!
+    AudioKernels contains vectorized implementations of sample conversions used when audio is loaded.
+    Each kernel has scalar, SSE2 and AVX2 version. Best instruction set is selected once at runtime, scalar kernels are used as reference.
+    Integer kernels produce exactly the same output on all instruction sets, resampler may differ by one in last bit of 16-bit result
+    */
+    class AudioKernels
+    {
+    public:
+        /*!
+        number of source samples which contribute to each resampled sample
+        */
+        constexpr static size_t ResamplerTapCount = 32;
+        /*!
+        maximal number of filter phases. Resampling ratios which require more phases use nearest precomputed one
+        */
+        constexpr static size_t MaxResamplerPhaseCount = 1024;
+        /*!
+        minimal number of resampled samples processed by one thread. Shorter audio is resampled by the calling thread only
+        */
+        constexpr static size_t ParallelSampleGranularity = 1 << 16;
+
+        /*!
+        gets instruction set which is used by kernels. It is the best instruction set supported both by compiler and current CPU
+        */
+        static AudioInstructionSet GetInstructionSet();
+        /*!
+        checks if kernels of the instruction set can be executed on current CPU
+        */
+        static bool IsSupported(AudioInstructionSet set);
+
+        /*!
+        averages channels of interleaved 16-bit frames, rounding towards zero. Destination may point to source, so audio can be downmixed in place.
+        Stereo, quad and 7.1 layouts are vectorized, other layouts use scalar kernel
+        \param channelCount number of interleaved channels in source frames
+        */
+        static void Downmix(const int16_t* source, int16_t* destination, size_t frameCount, size_t channelCount);
+        /*!
+        converts 16-bit samples to floating point in [-1, 1) range. Conversion is exact
+        */
+        static void ConvertToFloat(const int16_t* source, float* destination, size_t count);
+        /*!
+        converts floating point samples to 16-bit with round-to-nearest-even. Values are clamped to [-1, 1) range, NaNs are converted to zero
+        */
+        static void ConvertFromFloat(const float* source, int16_t* destination, size_t count);
+        /*!
+        computes number of samples which mono audio has after resampling
+        \returns sampleCount * destinationFrequency / sourceFrequency, rounded up
+        */
+        static size_t GetResampledCount(size_t sampleCount, size_t sourceFrequency, size_t destinationFrequency);
+        /*!
+        resamples mono 16-bit audio using polyphase Kaiser-windowed sinc filter. Cutoff is placed below Nyquist frequency of lower sampling rate,
+        so downsampling does not produce aliasing. Audio outside of source samples is considered silent
+        \param destination buffer of at least GetResampledCount(sampleCount, sourceFrequency, destinationFrequency) samples
+        */
+        static void Resample(const int16_t* source, size_t sampleCount, size_t sourceFrequency, int16_t* destination, size_t destinationFrequency);
+        /*!
+        runs each kernel on generated audio through scalar and all supported vectorized versions, validating their results and logging timings
+        \param sampleCount number of generated samples
+        \returns benchmark timings and validation results
+        */
+        static AudioKernelsBenchmark RunBenchmark(size_t sampleCount = 1 << 22);
+    };
+}
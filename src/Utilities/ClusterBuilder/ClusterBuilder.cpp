@@ -0,0 +1,254 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ClusterBuilder.h"
+#include "Utilities/Profiler/Profiler.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    constexpr uint32_t InvalidTriangle = std::numeric_limits<uint32_t>::max();
+
+    static MeshCluster ComputeClusterBounds(const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies,
+        const MxVector<Vector3>& triangleNormals, const MxVector<uint32_t>& triangles)
+    {
+        MeshCluster cluster;
+
+        const Vector3& first = vertecies[indicies[triangles.front() * 3]].Position;
+        AABB box{ first, first };
+        for (uint32_t t : triangles)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                const Vector3& position = vertecies[indicies[t * 3 + k]].Position;
+                box.Min = VectorMin(box.Min, position);
+                box.Max = VectorMax(box.Max, position);
+            }
+        }
+
+        cluster.Bounds.Center = box.GetCenter();
+        float radius2 = 0.0f;
+        for (uint32_t t : triangles)
+        {
+            for (size_t k = 0; k < 3; k++)
+                radius2 = Max(radius2, Length2(vertecies[indicies[t * 3 + k]].Position - cluster.Bounds.Center));
+        }
+        cluster.Bounds.Radius = std::sqrt(radius2);
+
+        Vector3 axis = MakeVector3(0.0f);
+        for (uint32_t t : triangles)
+            axis += triangleNormals[t];
+
+        float axisLength = Length(axis);
+        if (axisLength == 0.0f) return cluster; //-V550
+        axis /= axisLength;
+
+        float minDot = 1.0f;
+        for (uint32_t t : triangles)
+        {
+            if (triangleNormals[t] != MakeVector3(0.0f)) // skip degenerate triangles
+                minDot = Min(minDot, Dot(axis, triangleNormals[t]));
+        }
+
+        cluster.ConeAxis = axis;
+        // wide cones (> ~84 degrees) are almost never rejected, so culling is disabled for them
+        cluster.ConeCutoff = minDot <= 0.1f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+        return cluster;
+    }
+
+    MxVector<MeshCluster> ClusterBuilder::Build(const MxVector<Vertex>& vertecies, MxVector<uint32_t>& indicies, size_t maxTriangles)
+    {
+        MAKE_SCOPE_PROFILER("ClusterBuilder::Build()");
+        MxVector<MeshCluster> clusters;
+
+        size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0 || vertecies.empty()) return clusters;
+        maxTriangles = Clamp(maxTriangles, MinClusterSize, MaxClusterSize);
+
+        MxVector<Vector3> triangleNormals(triangleCount);
+        MxVector<Vector3> triangleCenters(triangleCount);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            const Vector3& p0 = vertecies[indicies[t * 3 + 0]].Position;
+            const Vector3& p1 = vertecies[indicies[t * 3 + 1]].Position;
+            const Vector3& p2 = vertecies[indicies[t * 3 + 2]].Position;
+            Vector3 normal = Cross(p1 - p0, p2 - p0);
+            float length = Length(normal);
+            triangleNormals[t] = length > 0.0f ? normal / length : MakeVector3(0.0f);
+            triangleCenters[t] = (p0 + p1 + p2) / 3.0f;
+        }
+
+        // vertex -> triangles adjacency in compressed form
+        MxVector<uint32_t> adjacencyOffsets(vertecies.size() + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; i++)
+            adjacencyOffsets[indicies[i] + 1]++;
+        for (size_t v = 0; v < vertecies.size(); v++)
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+        MxVector<uint32_t> adjacency(triangleCount * 3);
+        {
+            MxVector<uint32_t> filled(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < triangleCount * 3; i++)
+                adjacency[filled[indicies[i]]++] = uint32_t(i / 3);
+        }
+
+        MxVector<bool> isAssigned(triangleCount, false);
+        MxVector<uint32_t> frontierStamp(triangleCount, InvalidTriangle);
+        MxVector<uint32_t> frontier;
+        MxVector<uint32_t> clusterTriangles;
+        MxVector<uint32_t> result;
+        result.reserve(triangleCount * 3);
+
+        auto expandFrontier = [&](uint32_t t, uint32_t stamp)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = indicies[t * 3 + k];
+                for (uint32_t i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1]; i++)
+                {
+                    uint32_t neighbour = adjacency[i];
+                    if (!isAssigned[neighbour] && frontierStamp[neighbour] != stamp)
+                    {
+                        frontierStamp[neighbour] = stamp;
+                        frontier.push_back(neighbour);
+                    }
+                }
+            }
+        };
+
+        for (uint32_t seed = 0; seed < (uint32_t)triangleCount; seed++)
+        {
+            if (isAssigned[seed]) continue;
+
+            uint32_t stamp = (uint32_t)clusters.size();
+            clusterTriangles.clear();
+            frontier.clear();
+
+            clusterTriangles.push_back(seed);
+            isAssigned[seed] = true;
+            Vector3 clusterCenter = triangleCenters[seed];
+            Vector3 clusterNormal = triangleNormals[seed];
+            expandFrontier(seed, stamp);
+
+            while (clusterTriangles.size() < maxTriangles)
+            {
+                // select triangle which is closest to cluster center and faces the same direction
+                size_t bestIndex = frontier.size();
+                float bestScore = std::numeric_limits<float>::max();
+                float normalLength = Length(clusterNormal);
+                Vector3 direction = normalLength > 0.0f ? clusterNormal / normalLength : MakeVector3(0.0f);
+
+                for (size_t i = 0; i < frontier.size();)
+                {
+                    uint32_t t = frontier[i];
+                    if (isAssigned[t]) // triangle was taken by this cluster from other adjacent vertex
+                    {
+                        frontier[i] = frontier.back();
+                        frontier.pop_back();
+                        continue;
+                    }
+                    float distance = Length(triangleCenters[t] - clusterCenter);
+                    float score = distance * (2.0f - Dot(direction, triangleNormals[t]));
+                    if (score < bestScore)
+                    {
+                        bestScore = score;
+                        bestIndex = i;
+                    }
+                    i++;
+                }
+                if (bestIndex == frontier.size()) break; // cluster can not grow anymore
+
+                uint32_t best = frontier[bestIndex];
+                frontier[bestIndex] = frontier.back();
+                frontier.pop_back();
+
+                isAssigned[best] = true;
+                clusterTriangles.push_back(best);
+                clusterCenter += (triangleCenters[best] - clusterCenter) / (float)clusterTriangles.size();
+                clusterNormal += triangleNormals[best];
+                expandFrontier(best, stamp);
+            }
+
+            // keep original triangle order inside cluster to preserve vertex cache locality
+            std::sort(clusterTriangles.begin(), clusterTriangles.end());
+
+            auto& cluster = clusters.emplace_back(ComputeClusterBounds(vertecies, indicies, triangleNormals, clusterTriangles));
+            cluster.IndexOffset = (uint32_t)result.size();
+            cluster.IndexCount = uint32_t(clusterTriangles.size() * 3);
+            for (uint32_t t : clusterTriangles)
+            {
+                result.push_back(indicies[t * 3 + 0]);
+                result.push_back(indicies[t * 3 + 1]);
+                result.push_back(indicies[t * 3 + 2]);
+            }
+        }
+
+        std::copy(result.begin(), result.end(), indicies.begin());
+        return clusters;
+    }
+
+    void ClusterBuilder::Cull(const MxVector<MeshCluster>& clusters, const FrustrumCuller& culler, const Matrix4x4& modelMatrix,
+        const Vector3& viewPosition, bool cullBackfaces, MxVector<IndexRange>& ranges, ClusterCullingStatistics& statistics)
+    {
+        // backface test is invariant to affine transformations, so it is performed in object space
+        Vector3 objectViewPosition = Inverse(modelMatrix) * Vector4(viewPosition, 1.0f);
+        float radiusScale = Max(Length(Vector3(modelMatrix[0])), Length(Vector3(modelMatrix[1])), Length(Vector3(modelMatrix[2])));
+
+        for (const auto& cluster : clusters)
+        {
+            statistics.SubmittedClusters++;
+            statistics.SubmittedTriangles += cluster.IndexCount / 3;
+
+            Vector3 center = modelMatrix * Vector4(cluster.Bounds.Center, 1.0f);
+            Vector3 radius = MakeVector3(cluster.Bounds.Radius * radiusScale);
+            if (!culler.IsAABBVisible(center - radius, center + radius))
+            {
+                statistics.FrustrumCulledClusters++;
+                continue;
+            }
+
+            if (cullBackfaces)
+            {
+                Vector3 direction = cluster.Bounds.Center - objectViewPosition;
+                if (Dot(direction, cluster.ConeAxis) >= cluster.ConeCutoff * Length(direction) + cluster.Bounds.Radius)
+                {
+                    statistics.BackfaceCulledClusters++;
+                    continue;
+                }
+            }
+
+            statistics.DrawnTriangles += cluster.IndexCount / 3;
+            if (!ranges.empty() && ranges.back().Offset + ranges.back().Count == cluster.IndexOffset)
+                ranges.back().Count += cluster.IndexCount;
+            else
+                ranges.push_back(IndexRange{ cluster.IndexOffset, cluster.IndexCount });
+        }
+    }
+}
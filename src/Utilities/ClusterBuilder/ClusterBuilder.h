@@ -0,0 +1,112 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/BoundingObjects/BoundingSphere.h"
+#include "Core/BoundingObjects/FrustrumCuller.h"
+#include "Core/Resources/Vertex.h"
+#include "Platform/OpenGL/IndexBuffer.h"
+#include "Utilities/STL/MxVector.h"
+
+namespace MxEngine
+{
+    /*!
+    mesh cluster (meshlet) is a small group of spatially close triangles stored as contiguous range in mesh index buffer
+    each cluster has its own bounding sphere and normal cone, so it can be culled independently of other parts of mesh
+    */
+    struct MeshCluster
+    {
+        /*!
+        bounding sphere of cluster vertecies in object space
+        */
+        BoundingSphere Bounds;
+        /*!
+        average direction of cluster triangle normals in object space
+        */
+        Vector3 ConeAxis = MakeVector3(0.0f);
+        /*!
+        sine of normal cone half-angle. Value of 1 means cluster can not be rejected by its normal cone
+        */
+        float ConeCutoff = 1.0f;
+        /*!
+        offset of first cluster index in mesh index buffer
+        */
+        uint32_t IndexOffset = 0;
+        /*!
+        number of cluster indicies (three per triangle)
+        */
+        uint32_t IndexCount = 0;
+    };
+
+    /*!
+    statistics of cluster culling, accumulated over all culled meshes
+    */
+    struct ClusterCullingStatistics
+    {
+        size_t SubmittedTriangles = 0;
+        size_t DrawnTriangles = 0;
+        size_t SubmittedClusters = 0;
+        size_t FrustrumCulledClusters = 0;
+        size_t BackfaceCulledClusters = 0;
+    };
+
+    /*!
+    ClusterBuilder splits mesh into clusters of triangles and culls them per view
+    clusters are grown greedily over triangle adjacency, preferring triangles which are close to cluster center and face the same direction
+    */
+    class ClusterBuilder
+    {
+    public:
+        constexpr static size_t MinClusterSize = 64;
+        constexpr static size_t MaxClusterSize = 128;
+        constexpr static size_t DefaultClusterSize = 64;
+
+        /*!
+        splits mesh into clusters, reordering its indicies so each cluster occupies contiguous index range
+        \param vertecies mesh vertex buffer
+        \param indicies triangle list indicies which will be reordered
+        \param maxTriangles maximum number of triangles in one cluster, clamped to range [MinClusterSize, MaxClusterSize]
+        \returns list of clusters in order of their index ranges
+        */
+        static MxVector<MeshCluster> Build(const MxVector<Vertex>& vertecies, MxVector<uint32_t>& indicies, size_t maxTriangles = DefaultClusterSize);
+        /*!
+        culls clusters against view frustrum and (optionally) by their normal cones. Visible clusters are emitted as compacted index ranges
+        \param clusters mesh clusters to cull
+        \param culler frustrum culler of view
+        \param modelMatrix object transformation matrix
+        \param viewPosition position of view in world space
+        \param cullBackfaces if true, clusters which are entirely back-facing are rejected
+        \param ranges output index ranges. Adjacent visible clusters are merged into one range. Previous content is not cleared
+        \param statistics culling statistics to accumulate into
+        */
+        static void Cull(const MxVector<MeshCluster>& clusters, const FrustrumCuller& culler, const Matrix4x4& modelMatrix, 
+            const Vector3& viewPosition, bool cullBackfaces, MxVector<IndexRange>& ranges, ClusterCullingStatistics& statistics);
+    };
+}
@@ -0,0 +1,149 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "CacheFile.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Math/Math.h"
+
+#include <atomic>
+#include <thread>
+#include <string>
+
+namespace MxEngine
+{
+    CacheWriter::CacheWriter(File& file)
+        : file(file)
+    {
+
+    }
+
+    void CacheWriter::WriteAt(uint64_t position, const void* data, size_t size)
+    {
+        const uint8_t padding[64] = { };
+        while (this->written < position)
+        {
+            auto count = (size_t)Min(position - this->written, (uint64_t)sizeof(padding));
+            this->file.WriteBytes(padding, count);
+            this->written += count;
+        }
+        this->file.WriteBytes((const uint8_t*)data, size);
+        this->written += size;
+    }
+
+    bool CacheFile::GetSourceStamp(const FilePath& path, SourceStamp& stamp, bool computeHash)
+    {
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        if (error) return false;
+        auto time = std::filesystem::last_write_time(path, error);
+        if (error) return false;
+
+        stamp.Size = (uint64_t)size;
+        stamp.ModifiedTime = (int64_t)time.time_since_epoch().count();
+        stamp.Hash = 0;
+        if (computeHash)
+        {
+            MAKE_SCOPE_PROFILER("CacheFile::ComputeSourceHash()");
+            MappedFile source(path);
+            stamp.Hash = source.ComputeHash();
+        }
+        return true;
+    }
+
+    SourceState CacheFile::ValidateSource(const FilePath& path, const SourceStamp& stored, SourceStamp& current)
+    {
+        current = stored;
+        SourceStamp source;
+        if (!CacheFile::GetSourceStamp(path, source, false)) return SourceState::UP_TO_DATE;
+        if (source.ModifiedTime == stored.ModifiedTime && source.Size == stored.Size) return SourceState::UP_TO_DATE;
+        if (source.Size != stored.Size) return SourceState::MODIFIED;
+
+        CacheFile::GetSourceStamp(path, source, true);
+        if (source.Hash != stored.Hash) return SourceState::MODIFIED;
+
+        current = source;
+        return SourceState::TOUCHED;
+    }
+
+    void CacheFile::UpdateSourceStamp(const FilePath& path, uint64_t offset, const SourceStamp& stamp)
+    {
+        File file(path, File::READ | File::WRITE | File::BINARY);
+        if (file.IsOpen())
+        {
+            file.GetStream().seekp((std::streamoff)offset);
+            file.WriteBytes((const uint8_t*)&stamp, sizeof(stamp));
+        }
+    }
+
+    bool CacheFile::Write(const FilePath& path, const std::function<void(CacheWriter&)>& write)
+    {
+        // several threads or engine instances may rebuild same cache at once, so each writer needs its own temporary file
+        static std::atomic<uint64_t> writeCounter{ 0 };
+        auto threadHash = std::hash<std::thread::id>{ }(std::this_thread::get_id());
+        auto temporaryPath = path;
+        temporaryPath += "." + std::to_string(threadHash) + "-" + std::to_string(writeCounter.fetch_add(1)) + ".tmp";
+        {
+            File file(temporaryPath, File::WRITE | File::BINARY);
+            if (!file.IsOpen())
+            {
+                MXLOG_WARNING("MxEngine::CacheFile", "cannot create cache file: " + ToMxString(temporaryPath));
+                return false;
+            }
+
+            CacheWriter writer(file);
+            write(writer);
+
+            if (!file.GetStream().good())
+            {
+                MXLOG_WARNING("MxEngine::CacheFile", "failed to write cache file: " + ToMxString(temporaryPath));
+                file.Close();
+                std::error_code error;
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            MXLOG_WARNING("MxEngine::CacheFile", "cannot replace cache file: " + ToMxString(path));
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t CacheFile::AlignOffset(uint64_t offset, uint64_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+}
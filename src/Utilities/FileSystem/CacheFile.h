@@ -0,0 +1,125 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/FileSystem/File.h"
+
+#include <functional>
+
+namespace MxEngine
+{
+    /*!
+    source stamp identifies version of file from which cache was built. It is stored in cache headers as is,
+    so its layout must not be changed without increasing version of all cache formats
+    */
+    struct SourceStamp
+    {
+        int64_t ModifiedTime = 0;
+        uint64_t Size = 0;
+        uint64_t Hash = 0;
+    };
+
+    /*!
+    result of comparing source file with stamp stored in cache
+    */
+    enum class SourceState : uint8_t
+    {
+        UP_TO_DATE,
+        TOUCHED,
+        MODIFIED,
+    };
+
+    /*!
+    cache writer writes cache blobs at fixed offsets, filling gaps between them with zero padding
+    */
+    class CacheWriter
+    {
+        File& file;
+        uint64_t written = 0;
+    public:
+        CacheWriter(File& file);
+
+        /*!
+        writes bytes at position in file. Positions of subsequent writes must not decrease
+        \param position offset from file start, at which data is written
+        \param data pointer to bytes to write
+        \param size how many bytes to write
+        */
+        void WriteAt(uint64_t position, const void* data, size_t size);
+    };
+
+    /*!
+    cache file contains helper functions shared by all engine-native binary caches (meshes, textures, audio).
+    Caches are stored next to their source files and checked against them by modification time and size, content hash is used as fallback
+    */
+    class CacheFile
+    {
+    public:
+        /*!
+        computes stamp of source file
+        \param path path to source file
+        \param stamp stamp to fill. Content hash is computed only if computeHash is true
+        \param computeHash if content hash should be computed (requires reading whole file)
+        \returns true if file exists, false either
+        */
+        static bool GetSourceStamp(const FilePath& path, SourceStamp& stamp, bool computeHash = true);
+        /*!
+        compares source file with stamp stored in cache. Modification time and size are checked first, content hash is only computed when file was touched.
+        Missing source is treated as up-to-date, so caches may be shipped without their sources
+        \param path path to source file
+        \param stored stamp stored in cache header
+        \param current stamp of source file. Contains new modification time if source was touched
+        \returns state of source file relative to stored stamp
+        */
+        static SourceState ValidateSource(const FilePath& path, const SourceStamp& stored, SourceStamp& current);
+        /*!
+        rewrites source stamp inside existing cache file, so touched but not modified source takes fast path next time
+        \param path path to cache file
+        \param offset offset of stamp from file start
+        \param stamp new source stamp
+        */
+        static void UpdateSourceStamp(const FilePath& path, uint64_t offset, const SourceStamp& stamp);
+        /*!
+        writes cache file atomically: data is written to temporary file first and then replaces old cache,
+        so other engine instances never observe partially written cache
+        \param path path to cache file
+        \param write functor which writes cache contents
+        \returns true if cache was written successfully, false either
+        */
+        static bool Write(const FilePath& path, const std::function<void(CacheWriter&)>& write);
+        /*!
+        rounds offset up to alignment
+        \param offset offset inside cache file
+        \param alignment required alignment in bytes
+        \returns smallest aligned offset which is not less than offset
+        */
+        static uint64_t AlignOffset(uint64_t offset, uint64_t alignment);
+    };
+}
@@ -0,0 +1,195 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "MappedFile.h"
+#include "Utilities/Logging/Logger.h"
+#include "Core/Macro/Macro.h"
+
+#if defined(MXENGINE_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace MxEngine
+{
+    MappedFile::MappedFile(const FilePath& path)
+    {
+        this->Open(path);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->Close();
+            this->data = std::exchange(other.data, nullptr);
+            this->size = std::exchange(other.size, 0);
+            this->fileHandle = std::exchange(other.fileHandle, -1);
+            this->mappingHandle = std::exchange(other.mappingHandle, -1);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        this->Close();
+    }
+
+    bool MappedFile::Open(const FilePath& path)
+    {
+        this->Close();
+        if (!File::IsFile(path))
+        {
+            MXLOG_WARNING("MxEngine::MappedFile", "file was not found: " + ToMxString(path));
+            return false;
+        }
+
+        #if defined(MXENGINE_WINDOWS)
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            MXLOG_WARNING("MxEngine::MappedFile", "cannot open file: " + ToMxString(path));
+            return false;
+        }
+        this->fileHandle = (intptr_t)file;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            this->Close();
+            return false;
+        }
+        this->size = (size_t)fileSize.QuadPart;
+        if (this->size == 0) return true; // empty files cannot be mapped, but they are still valid
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            MXLOG_WARNING("MxEngine::MappedFile", "cannot create file mapping: " + ToMxString(path));
+            this->Close();
+            return false;
+        }
+        this->mappingHandle = (intptr_t)mapping;
+
+        this->data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        #else
+        int file = open(path.c_str(), O_RDONLY);
+        if (file == -1)
+        {
+            MXLOG_WARNING("MxEngine::MappedFile", "cannot open file: " + ToMxString(path));
+            return false;
+        }
+        this->fileHandle = (intptr_t)file;
+
+        struct stat fileInfo;
+        if (fstat(file, &fileInfo) != 0)
+        {
+            this->Close();
+            return false;
+        }
+        this->size = (size_t)fileInfo.st_size;
+        if (this->size == 0) return true; // empty files cannot be mapped, but they are still valid
+
+        void* view = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file, 0);
+        this->data = view != MAP_FAILED ? (const uint8_t*)view : nullptr;
+        #endif
+
+        if (this->data == nullptr)
+        {
+            MXLOG_WARNING("MxEngine::MappedFile", "cannot map file into memory: " + ToMxString(path));
+            this->Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        #if defined(MXENGINE_WINDOWS)
+        if (this->data != nullptr) UnmapViewOfFile(this->data);
+        if (this->mappingHandle != -1) CloseHandle((HANDLE)this->mappingHandle);
+        if (this->fileHandle != -1) CloseHandle((HANDLE)this->fileHandle);
+        #else
+        if (this->data != nullptr) munmap((void*)this->data, this->size);
+        if (this->fileHandle != -1) close((int)this->fileHandle);
+        #endif
+        this->data = nullptr;
+        this->size = 0;
+        this->fileHandle = -1;
+        this->mappingHandle = -1;
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return this->fileHandle != -1;
+    }
+
+    const uint8_t* MappedFile::GetData() const
+    {
+        return this->data;
+    }
+
+    size_t MappedFile::GetSize() const
+    {
+        return this->size;
+    }
+
+    uint64_t MappedFile::ComputeHash() const
+    {
+        if (!this->IsOpen()) return 0;
+        return MappedFile::ComputeHash(this->data, this->size);
+    }
+
+    uint64_t MappedFile::ComputeHash(const uint8_t* bytes, size_t size)
+    {
+        constexpr uint64_t FnvOffsetBasis = 14695981039346656037ull;
+        constexpr uint64_t FnvPrime = 1099511628211ull;
+
+        uint64_t hash = FnvOffsetBasis;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= (uint64_t)bytes[i];
+            hash *= FnvPrime;
+        }
+        return hash;
+    }
+}
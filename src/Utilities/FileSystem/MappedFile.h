@@ -0,0 +1,111 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/FileSystem/File.h"
+
+namespace MxEngine
+{
+    /*!
+    mapped file is a read-only view of a file on disk, mapped into process address space.
+    It is used for large binary caches which should be consumed without copying them into stream buffers first
+    */
+    class MappedFile
+    {
+        /*!
+        pointer to the first byte of mapped file or nullptr if file is not mapped
+        */
+        const uint8_t* data = nullptr;
+        /*!
+        size of mapped view in bytes
+        */
+        size_t size = 0;
+        /*!
+        platform-dependent file handle (file descriptor on posix systems)
+        */
+        intptr_t fileHandle = -1;
+        /*!
+        platform-dependent mapping handle (unused on posix systems)
+        */
+        intptr_t mappingHandle = -1;
+    public:
+        /*!
+        creates empty (unmapped) file object
+        */
+        MappedFile() = default;
+        /*!
+        maps file into memory
+        \param path path to a file to map
+        */
+        MappedFile(const FilePath& path);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        /*!
+        maps new file, old file view is unmapped automatically
+        \param path path to a file to map
+        \returns true if file was mapped successfully, false either
+        */
+        bool Open(const FilePath& path);
+        /*!
+        unmaps current file view and closes all associated handles
+        */
+        void Close();
+        /*!
+        checks if file is currently mapped
+        */
+        bool IsOpen() const;
+        /*!
+        gets pointer to mapped file contents
+        \returns pointer to the first byte of file or nullptr if file is not mapped
+        */
+        const uint8_t* GetData() const;
+        /*!
+        gets size of mapped file
+        \returns size of file in bytes
+        */
+        size_t GetSize() const;
+        /*!
+        computes 64-bit FNV-1a hash of mapped file contents
+        \returns hash of file bytes or zero if file is not mapped
+        */
+        uint64_t ComputeHash() const;
+        /*!
+        computes 64-bit FNV-1a hash of byte range
+        \param bytes pointer to the first byte to hash
+        \param size how many bytes to hash
+        \returns hash of the byte range
+        */
+        static uint64_t ComputeHash(const uint8_t* bytes, size_t size);
+    };
+}
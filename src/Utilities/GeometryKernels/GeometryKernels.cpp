@@ -0,0 +1,470 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "GeometryKernels.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+#include <array>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_GEOMETRY_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace MxEngine
+{
+    /*!
+    accumulated tangent frame of vertex. Normal is area-weighted as it is not normalized before accumulation
+    */
+    struct FrameAccumulator
+    {
+        Vector3 Normal = MakeVector3(0.0f);
+        Vector3 Tangent = MakeVector3(0.0f);
+        Vector3 Bitangent = MakeVector3(0.0f);
+    };
+
+    static size_t GetChunkSize(size_t count)
+    {
+        size_t threadCount = ThreadPool::GetWorkerCount() + 1;
+        return Max(GeometryKernels::ParallelGranularity, (count + threadCount - 1) / threadCount);
+    }
+
+    static Vector3 SafeNormalize(const Vector3& v)
+    {
+        float length = Length(v);
+        return length > 0.0f ? v / length : MakeVector3(0.0f);
+    }
+
+    /*!
+    computes tangent frame of each triangle in range [begin, end) and passes it to accumulate functor with (uint32_t triangle, const FrameAccumulator&) signature
+    with SSE2 four triangles are processed at once: vertex data is transposed to SoA registers, results are transposed back for scatter
+    */
+    template<typename F>
+    static void ForEachTriangleFrame(const MxVector<Vertex>& vertecies, const uint32_t* indicies, size_t begin, size_t end, F&& accumulate)
+    {
+    #if defined(MXENGINE_GEOMETRY_KERNELS_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        alignas(16) float frames[9][4];
+
+        for (; begin + 4 <= end; begin += 4)
+        {
+            const uint32_t* triangles = indicies + 3 * begin;
+            const Vertex* v[3][4];
+            for (size_t k = 0; k < 3; k++)
+                for (size_t lane = 0; lane < 4; lane++)
+                    v[k][lane] = &vertecies[triangles[3 * lane + k]];
+
+            #define MX_LOAD_LANES(k, field) _mm_setr_ps(v[k][0]->field, v[k][1]->field, v[k][2]->field, v[k][3]->field)
+            __m128 p0x = MX_LOAD_LANES(0, Position.x), p0y = MX_LOAD_LANES(0, Position.y), p0z = MX_LOAD_LANES(0, Position.z);
+            __m128 e1x = _mm_sub_ps(MX_LOAD_LANES(1, Position.x), p0x);
+            __m128 e1y = _mm_sub_ps(MX_LOAD_LANES(1, Position.y), p0y);
+            __m128 e1z = _mm_sub_ps(MX_LOAD_LANES(1, Position.z), p0z);
+            __m128 e2x = _mm_sub_ps(MX_LOAD_LANES(2, Position.x), p0x);
+            __m128 e2y = _mm_sub_ps(MX_LOAD_LANES(2, Position.y), p0y);
+            __m128 e2z = _mm_sub_ps(MX_LOAD_LANES(2, Position.z), p0z);
+
+            __m128 t0u = MX_LOAD_LANES(0, TexCoord.x), t0v = MX_LOAD_LANES(0, TexCoord.y);
+            __m128 du1 = _mm_sub_ps(MX_LOAD_LANES(1, TexCoord.x), t0u);
+            __m128 dv1 = _mm_sub_ps(MX_LOAD_LANES(1, TexCoord.y), t0v);
+            __m128 du2 = _mm_sub_ps(MX_LOAD_LANES(2, TexCoord.x), t0u);
+            __m128 dv2 = _mm_sub_ps(MX_LOAD_LANES(2, TexCoord.y), t0v);
+            #undef MX_LOAD_LANES
+
+            _mm_store_ps(frames[0], _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y)));
+            _mm_store_ps(frames[1], _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z)));
+            _mm_store_ps(frames[2], _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x)));
+
+            // degenerate texture coordinates produce zero tangent frame instead of infinities
+            __m128 determinant = _mm_sub_ps(_mm_mul_ps(du1, dv2), _mm_mul_ps(dv1, du2));
+            __m128 r = _mm_and_ps(_mm_div_ps(one, determinant), _mm_cmpneq_ps(determinant, zero));
+
+            _mm_store_ps(frames[3], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e1x, dv2), _mm_mul_ps(e2x, dv1)), r));
+            _mm_store_ps(frames[4], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e1y, dv2), _mm_mul_ps(e2y, dv1)), r));
+            _mm_store_ps(frames[5], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e1z, dv2), _mm_mul_ps(e2z, dv1)), r));
+            _mm_store_ps(frames[6], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e2x, du1), _mm_mul_ps(e1x, du2)), r));
+            _mm_store_ps(frames[7], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e2y, du1), _mm_mul_ps(e1y, du2)), r));
+            _mm_store_ps(frames[8], _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(e2z, du1), _mm_mul_ps(e1z, du2)), r));
+
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                FrameAccumulator frame;
+                frame.Normal    = Vector3(frames[0][lane], frames[1][lane], frames[2][lane]);
+                frame.Tangent   = Vector3(frames[3][lane], frames[4][lane], frames[5][lane]);
+                frame.Bitangent = Vector3(frames[6][lane], frames[7][lane], frames[8][lane]);
+                accumulate(triangles + 3 * lane, frame);
+            }
+        }
+    #endif
+        for (; begin < end; begin++)
+        {
+            const uint32_t* triangle = indicies + 3 * begin;
+            const Vertex& v0 = vertecies[triangle[0]];
+            const Vertex& v1 = vertecies[triangle[1]];
+            const Vertex& v2 = vertecies[triangle[2]];
+
+            Vector3 edge1 = v1.Position - v0.Position;
+            Vector3 edge2 = v2.Position - v0.Position;
+            Vector2 deltaT1 = v1.TexCoord - v0.TexCoord;
+            Vector2 deltaT2 = v2.TexCoord - v0.TexCoord;
+
+            float determinant = deltaT1.x * deltaT2.y - deltaT1.y * deltaT2.x;
+            float r = determinant != 0.0f ? 1.0f / determinant : 0.0f; //-V550
+
+            FrameAccumulator frame;
+            frame.Normal = Cross(edge1, edge2); // cross product length is twice triangle area
+            frame.Tangent = (edge1 * deltaT2.y - edge2 * deltaT1.y) * r;
+            frame.Bitangent = (edge2 * deltaT1.x - edge1 * deltaT2.x) * r;
+            accumulate(triangle, frame);
+        }
+    }
+
+    static void AddFrame(FrameAccumulator& accumulator, const FrameAccumulator& frame)
+    {
+        accumulator.Normal += frame.Normal;
+        accumulator.Tangent += frame.Tangent;
+        accumulator.Bitangent += frame.Bitangent;
+    }
+
+    static void StoreFrame(Vertex& vertex, const FrameAccumulator& frame, bool computeNormals)
+    {
+        if (computeNormals) vertex.Normal = SafeNormalize(frame.Normal);
+        vertex.Tangent = SafeNormalize(frame.Tangent);
+        vertex.Bitangent = SafeNormalize(frame.Bitangent);
+    }
+
+    static void ComputeTangentSpaceSerial(MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies, bool computeNormals)
+    {
+        // accumulate directly into vertecies without any intermediate storage
+        for (auto& vertex : vertecies)
+        {
+            if (computeNormals) vertex.Normal = MakeVector3(0.0f);
+            vertex.Tangent = MakeVector3(0.0f);
+            vertex.Bitangent = MakeVector3(0.0f);
+        }
+        ForEachTriangleFrame(vertecies, indicies.data(), 0, indicies.size() / 3, [&vertecies, computeNormals](const uint32_t* triangle, const FrameAccumulator& frame)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                auto& vertex = vertecies[triangle[k]];
+                if (computeNormals) vertex.Normal += frame.Normal;
+                vertex.Tangent += frame.Tangent;
+                vertex.Bitangent += frame.Bitangent;
+            }
+        });
+        for (auto& vertex : vertecies)
+        {
+            if (computeNormals) vertex.Normal = SafeNormalize(vertex.Normal);
+            vertex.Tangent = SafeNormalize(vertex.Tangent);
+            vertex.Bitangent = SafeNormalize(vertex.Bitangent);
+        }
+    }
+
+    void GeometryKernels::ComputeTangentSpace(MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies, bool computeNormals)
+    {
+        MAKE_SCOPE_PROFILER("GeometryKernels::ComputeTangentSpace()");
+        size_t triangleCount = indicies.size() / 3;
+        size_t chunkSize = GetChunkSize(triangleCount);
+        size_t chunkCount = (triangleCount + chunkSize - 1) / chunkSize;
+
+        if (chunkCount <= 1)
+        {
+            ComputeTangentSpaceSerial(vertecies, indicies, computeNormals);
+            return;
+        }
+
+        // each chunk scatters into its own partial accumulator, which covers only vertex index range referenced by chunk
+        // for meshes with good index locality ranges barely overlap, so total memory stays close to one accumulator per vertex
+        struct PartialFrames
+        {
+            uint32_t FirstVertex = 0;
+            uint32_t LastVertex = 0;
+            MxVector<FrameAccumulator> Frames;
+        };
+        MxVector<PartialFrames> partials(chunkCount);
+
+        ThreadPool::ParallelFor(triangleCount, chunkSize, [&](size_t begin, size_t end)
+        {
+            auto& partial = partials[begin / chunkSize];
+            auto minmax = std::minmax_element(indicies.begin() + 3 * begin, indicies.begin() + 3 * end);
+            partial.FirstVertex = *minmax.first;
+            partial.LastVertex = *minmax.second;
+        });
+
+        // poorly ordered indicies make every chunk span almost whole mesh, so accumulators would take chunkCount times more memory
+        size_t totalFrames = 0;
+        for (const auto& partial : partials)
+            totalFrames += size_t(partial.LastVertex - partial.FirstVertex) + 1;
+        if (totalFrames > GeometryKernels::MaxTangentAccumulatorRatio * vertecies.size())
+        {
+            ComputeTangentSpaceSerial(vertecies, indicies, computeNormals);
+            return;
+        }
+
+        ThreadPool::ParallelFor(triangleCount, chunkSize, [&](size_t begin, size_t end)
+        {
+            auto& partial = partials[begin / chunkSize];
+            partial.Frames.resize(size_t(partial.LastVertex - partial.FirstVertex) + 1);
+
+            FrameAccumulator* frames = partial.Frames.data() - partial.FirstVertex;
+            ForEachTriangleFrame(vertecies, indicies.data(), begin, end, [frames](const uint32_t* triangle, const FrameAccumulator& frame)
+            {
+                AddFrame(frames[triangle[0]], frame);
+                AddFrame(frames[triangle[1]], frame);
+                AddFrame(frames[triangle[2]], frame);
+            });
+        });
+
+        // reduce partial results over independent vertex ranges
+        ThreadPool::ParallelFor(vertecies.size(), GetChunkSize(vertecies.size()), [&](size_t begin, size_t end)
+        {
+            MxVector<const PartialFrames*> overlapping;
+            for (const auto& partial : partials)
+            {
+                if (partial.FirstVertex < end && partial.FirstVertex + partial.Frames.size() > begin)
+                    overlapping.push_back(&partial);
+            }
+
+            for (size_t v = begin; v < end; v++)
+            {
+                FrameAccumulator accumulator;
+                for (const auto* partial : overlapping)
+                {
+                    size_t offset = v - partial->FirstVertex;
+                    if (v >= partial->FirstVertex && offset < partial->Frames.size())
+                        AddFrame(accumulator, partial->Frames[offset]);
+                }
+                StoreFrame(vertecies[v], accumulator, computeNormals);
+            }
+        });
+    }
+
+    void GeometryKernels::ComputeBounds(const MxVector<Vertex>& vertecies, AABB& box, BoundingSphere& sphere)
+    {
+        MAKE_SCOPE_PROFILER("GeometryKernels::ComputeBounds()");
+        if (vertecies.empty())
+        {
+            box = AABB{ MakeVector3(0.0f), MakeVector3(0.0f) };
+            sphere = BoundingSphere(MakeVector3(0.0f), 0.0f);
+            return;
+        }
+
+        size_t chunkSize = GetChunkSize(vertecies.size());
+        size_t chunkCount = (vertecies.size() + chunkSize - 1) / chunkSize;
+
+        // each chunk writes only its own partial result, which are reduced afterwards
+        MxVector<AABB> partialBoxes(chunkCount);
+        ThreadPool::ParallelFor(vertecies.size(), chunkSize, [&](size_t begin, size_t end)
+        {
+            AABB& partial = partialBoxes[begin / chunkSize];
+            partial = AABB{ vertecies[begin].Position, vertecies[begin].Position };
+        #if defined(MXENGINE_GEOMETRY_KERNELS_SSE2)
+            // position is followed by texture coordinates in vertex, so 4-float load does not leave vertex memory
+            __m128 minp = _mm_loadu_ps(&vertecies[begin].Position.x);
+            __m128 maxp = minp;
+            for (size_t i = begin; i < end; i++)
+            {
+                __m128 position = _mm_loadu_ps(&vertecies[i].Position.x);
+                minp = _mm_min_ps(minp, position);
+                maxp = _mm_max_ps(maxp, position);
+            }
+            alignas(16) float minValues[4], maxValues[4];
+            _mm_store_ps(minValues, minp);
+            _mm_store_ps(maxValues, maxp);
+            partial.Min = Vector3(minValues[0], minValues[1], minValues[2]);
+            partial.Max = Vector3(maxValues[0], maxValues[1], maxValues[2]);
+        #else
+            for (size_t i = begin; i < end; i++)
+            {
+                partial.Min = VectorMin(partial.Min, vertecies[i].Position);
+                partial.Max = VectorMax(partial.Max, vertecies[i].Position);
+            }
+        #endif
+        });
+
+        box = partialBoxes.front();
+        for (const auto& partial : partialBoxes)
+        {
+            box.Min = VectorMin(box.Min, partial.Min);
+            box.Max = VectorMax(box.Max, partial.Max);
+        }
+
+        Vector3 center = box.GetCenter();
+        MxVector<float> partialRadius(chunkCount, 0.0f);
+        ThreadPool::ParallelFor(vertecies.size(), chunkSize, [&](size_t begin, size_t end)
+        {
+            float maxRadius = 0.0f;
+        #if defined(MXENGINE_GEOMETRY_KERNELS_SSE2)
+            const __m128 centerp = _mm_setr_ps(center.x, center.y, center.z, 0.0f);
+            const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+            __m128 radius = _mm_setzero_ps();
+            for (size_t i = begin; i < end; i++)
+            {
+                __m128 distance = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&vertecies[i].Position.x), centerp), mask);
+                __m128 squared = _mm_mul_ps(distance, distance);
+                squared = _mm_add_ps(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 3, 0, 1)));
+                squared = _mm_add_ps(squared, _mm_movehl_ps(squared, squared));
+                radius = _mm_max_ss(radius, squared);
+            }
+            maxRadius = _mm_cvtss_f32(radius);
+        #else
+            for (size_t i = begin; i < end; i++)
+                maxRadius = Max(maxRadius, Length2(vertecies[i].Position - center));
+        #endif
+            partialRadius[begin / chunkSize] = maxRadius;
+        });
+
+        float maxRadius = 0.0f;
+        for (float radius : partialRadius)
+            maxRadius = Max(maxRadius, radius);
+        sphere = BoundingSphere(center, std::sqrt(maxRadius));
+    }
+
+    /*!
+    scalar single-threaded implementation which was used by MeshData before, kept as benchmark baseline
+    */
+    static void ReferenceTangentSpace(MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies)
+    {
+        for (auto& vertex : vertecies)
+        {
+            vertex.Normal = MakeVector3(0.0f);
+            vertex.Tangent = MakeVector3(0.0f);
+            vertex.Bitangent = MakeVector3(0.0f);
+        }
+
+        for (size_t i = 0; i < indicies.size() / 3; i++)
+        {
+            std::array triangle = {
+                vertecies[indicies[3 * i + 0]],
+                vertecies[indicies[3 * i + 1]],
+                vertecies[indicies[3 * i + 2]],
+            };
+
+            auto normal = ComputeNormal(triangle[0].Position, triangle[1].Position, triangle[2].Position);
+            auto tanbitan = ComputeTangentSpace(
+                triangle[0].Position, triangle[1].Position, triangle[2].Position,
+                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
+            );
+
+            for (auto& vertex : triangle)
+            {
+                vertex.Normal += normal;
+                vertex.Tangent += tanbitan[0];
+                vertex.Bitangent += tanbitan[1];
+            }
+
+            for (size_t j = 0; j < triangle.size(); j++)
+                vertecies[indicies[3 * i + j]] = triangle[j];
+        }
+
+        for (auto& vertex : vertecies)
+        {
+            vertex.Normal = Normalize(vertex.Normal);
+            vertex.Tangent = Normalize(vertex.Tangent);
+            vertex.Bitangent = Normalize(vertex.Bitangent);
+        }
+    }
+
+    static void ReferenceBounds(const MxVector<Vertex>& vertecies, AABB& box, BoundingSphere& sphere)
+    {
+        box = { vertecies[0].Position, vertecies[0].Position };
+        for (const auto& vertex : vertecies)
+        {
+            box.Min = VectorMin(box.Min, vertex.Position);
+            box.Max = VectorMax(box.Max, vertex.Position);
+        }
+
+        auto center = box.GetCenter();
+        float maxRadius = 0.0f;
+        for (const auto& vertex : vertecies)
+            maxRadius = Max(maxRadius, Length2(vertex.Position - center));
+        sphere = BoundingSphere(center, std::sqrt(maxRadius));
+    }
+
+    GeometryKernelsBenchmark GeometryKernels::RunBenchmark(size_t triangleCount)
+    {
+        GeometryKernelsBenchmark result;
+
+        // regular grid with slightly displaced heights, two triangles per cell
+        size_t gridSize = Max((size_t)1, (size_t)std::sqrt((float)triangleCount / 2.0f));
+        MxVector<Vertex> vertecies((gridSize + 1) * (gridSize + 1));
+        MxVector<uint32_t> indicies;
+        indicies.reserve(gridSize * gridSize * 6);
+
+        for (size_t y = 0; y <= gridSize; y++)
+        {
+            for (size_t x = 0; x <= gridSize; x++)
+            {
+                auto& vertex = vertecies[y * (gridSize + 1) + x];
+                vertex.Position = Vector3((float)x, std::sin(0.1f * float(x + y)), (float)y);
+                vertex.TexCoord = Vector2((float)x, (float)y) / (float)gridSize;
+            }
+        }
+        for (size_t y = 0; y < gridSize; y++)
+        {
+            for (size_t x = 0; x < gridSize; x++)
+            {
+                uint32_t i0 = uint32_t(y * (gridSize + 1) + x), i1 = i0 + 1;
+                uint32_t i2 = i0 + uint32_t(gridSize + 1), i3 = i2 + 1;
+                indicies.insert(indicies.end(), { i0, i2, i1, i1, i2, i3 });
+            }
+        }
+
+        result.TriangleCount = indicies.size() / 3;
+        result.VertexCount = vertecies.size();
+        result.ThreadCount = ThreadPool::GetWorkerCount() + 1;
+
+        AABB box;
+        BoundingSphere sphere;
+        TimeStep start = Time::Current();
+        ReferenceTangentSpace(vertecies, indicies);
+        result.ReferenceTangentSpace = Time::Current() - start;
+
+        start = Time::Current();
+        GeometryKernels::ComputeTangentSpace(vertecies, indicies);
+        result.TangentSpace = Time::Current() - start;
+
+        start = Time::Current();
+        ReferenceBounds(vertecies, box, sphere);
+        result.ReferenceBounds = Time::Current() - start;
+
+        start = Time::Current();
+        GeometryKernels::ComputeBounds(vertecies, box, sphere);
+        result.Bounds = Time::Current() - start;
+
+        MXLOG_INFO("MxEngine::GeometryKernels", MxFormat("benchmark on {0} triangles, {1} threads: tangent space {2}ms -> {3}ms, bounds {4}ms -> {5}ms",
+            result.TriangleCount, result.ThreadCount, result.ReferenceTangentSpace * 1000.0f, result.TangentSpace * 1000.0f,
+            result.ReferenceBounds * 1000.0f, result.Bounds * 1000.0f));
+        return result;
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/BoundingObjects/BoundingSphere.h"
+#include "Core/Resources/Vertex.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+namespace MxEngine
+{
+    /*!
+    timings of geometry kernels benchmark, measured in seconds
+    */
+    struct GeometryKernelsBenchmark
+    {
+        size_t TriangleCount = 0;
+        size_t VertexCount = 0;
+        size_t ThreadCount = 0;
+        TimeStep ReferenceTangentSpace = 0.0f;
+        TimeStep TangentSpace = 0.0f;
+        TimeStep ReferenceBounds = 0.0f;
+        TimeStep Bounds = 0.0f;
+    };
+
+    /*!
+    GeometryKernels contains data-parallel implementations of common mesh processing algorithms
+    triangle frames are computed four at once in SoA registers (if SSE2 is available) over parallel triangle ranges.
+    each range scatters into its own partial accumulator, which are then reduced over independent vertex ranges, so no atomics are needed.
+    if indicies have poor locality, partial accumulators would grow up to thread count times vertex count, so tangents are accumulated serially instead
+    */
+    class GeometryKernels
+    {
+    public:
+        /*!
+        minimal number of elements processed by one thread. Smaller meshes are processed by the calling thread only
+        */
+        constexpr static size_t ParallelGranularity = 16384;
+        /*!
+        maximal total size of per-thread tangent accumulators relative to vertex count. If index ranges of triangle chunks overlap more, serial path is used
+        */
+        constexpr static size_t MaxTangentAccumulatorRatio = 2;
+
+        /*!
+        recomputes vertex normal, tangent and bitangent vectors as area-weighted average of adjacent triangle frames
+        \param vertecies mesh vertecies to update
+        \param indicies triangle list indicies
+        \param computeNormals if false, only tangents and bitangents are recomputed
+        */
+        static void ComputeTangentSpace(MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies, bool computeNormals = true);
+        /*!
+        computes axis-aligned bounding box and bounding sphere (centered in box center) of vertecies
+        \param vertecies mesh vertecies
+        \param box resulting bounding box. If vertecies are empty, box is set to zero
+        \param sphere resulting bounding sphere
+        */
+        static void ComputeBounds(const MxVector<Vertex>& vertecies, AABB& box, BoundingSphere& sphere);
+        /*!
+        runs generated grid mesh through reference (scalar single-threaded) and optimized kernels, logging timings
+        \param triangleCount number of triangles in generated mesh
+        \returns benchmark timings
+        */
+        static GeometryKernelsBenchmark RunBenchmark(size_t triangleCount = 2'000'000);
+    };
+}
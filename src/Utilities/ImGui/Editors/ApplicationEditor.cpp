@@ -31,6 +31,15 @@
 #include "Core/Config/GlobalConfig.h"
 #include "Utilities/FileSystem/FileManager.h"
 #include "Core/Serialization/SceneSerializer.h"
+#include "Utilities/GeometryKernels/GeometryKernels.h"
+#include "Utilities/TextureCompressor/TextureCompressor.h"
+#include "Utilities/ImageKernels/ImageKernels.h"
+#include "Utilities/ImageEncoder/ImageEncoder.h"
+#include "Utilities/AudioKernels/AudioKernels.h"
+#include "Core/Resources/AssetManager.h"
+#include "Core/Application/Physics.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Core/Application/CollisionPairSet.h"
 
 namespace MxEngine::GUI
 {
@@ -59,6 +68,78 @@ namespace MxEngine::GUI
             }
         }
 
+        if (ImGui::TreeNode("asset cache"))
+        {
+            auto report = AssetManager::GetCacheReport();
+            constexpr float MB = 1024.0f * 1024.0f;
+            ImGui::Text("cache hits: %d | cache misses: %d", (int)report.CacheHits, (int)report.CacheMisses);
+            ImGui::Text("textures: %.2f MB | cubemaps: %.2f MB", report.TextureBytes / MB, report.CubeMapBytes / MB);
+            ImGui::Text("meshes: %.2f MB | audio: %.2f MB", report.MeshBytes / MB, report.AudioBytes / MB);
+            ImGui::Text("total: %.2f MB | expired entries: %d", report.TotalBytes / MB, (int)report.ExpiredEntries);
+
+            if (ImGui::Button("evict expired entries"))
+                AssetManager::EvictExpiredCache();
+            ImGui::SameLine();
+            if (ImGui::Button("clear cache"))
+                AssetManager::ClearCache();
+
+            for (const auto& record : report.Records)
+            {
+                ImGui::Text("[%s] %s: %.2f MB, %d refs", EnumToString(record.Type), record.Path.c_str(), record.ByteSize / MB, (int)record.ReferenceCount);
+            }
+
+            ImGui::TreePop();
+        }
+
+        if (ImGui::TreeNode("physics"))
+        {
+            bool isMultithreaded = Physics::IsMultithreaded();
+            int threadCount = (int)Physics::GetThreadCount();
+            bool isChanged = ImGui::Checkbox("multithreaded world", &isMultithreaded);
+            isChanged |= isMultithreaded && ImGui::DragInt("thread count", &threadCount, 0.1f, 1, 64);
+            if (isChanged)
+                Physics::SetMultithreading(isMultithreaded, (size_t)Max(threadCount, 1));
+
+            bool isThreaded = Physics::IsThreadedSimulation();
+            if (ImGui::Checkbox("dedicated physics thread", &isThreaded))
+                Physics::SetThreadedSimulation(isThreaded);
+
+            auto shapeStats = ShapeCache::GetStats();
+            ImGui::Text("shared shapes: %d (%d references)", (int)shapeStats.SharedShapeCount, (int)shapeStats.SharedReferenceCount);
+            ImGui::Text("unique shapes: %d", (int)shapeStats.UniqueShapeCount);
+            ImGui::Text("shapes created: %d, cache hits: %d", (int)shapeStats.CreatedShapeCount, (int)shapeStats.CacheHitCount);
+            ImGui::Text("shape memory: %.1f KB", float(shapeStats.ShapeMemory) / 1024.0f);
+
+            ImGui::TreePop();
+        }
+
+        if (ImGui::TreeNode("benchmarks"))
+        {
+            // results are written to log
+            if (ImGui::Button("geometry kernels (2M triangles)"))
+                GeometryKernels::RunBenchmark();
+            if (ImGui::Button("texture compressor (2048x2048)"))
+                TextureCompressor::RunBenchmark();
+            if (ImGui::Button("image kernels (2048x2048)"))
+                ImageKernels::RunBenchmark();
+            if (ImGui::Button("image encoder (7680x4320)"))
+                ImageEncoder::RunBenchmark(7680, 4320);
+            if (ImGui::Button("image encoder (30720x17280)"))
+                ImageEncoder::RunBenchmark(30720, 17280);
+            if (ImGui::Button("audio kernels (4M samples)"))
+                AudioKernels::RunBenchmark();
+            if (ImGui::Button("physics (10k bodies)"))
+                PhysicsModule::RunBenchmark(10000);
+            if (ImGui::Button("physics (50k bodies)"))
+                PhysicsModule::RunBenchmark(50000);
+            if (ImGui::Button("collision pairs (100k manifolds)"))
+                CollisionPairSet::RunBenchmark(100000);
+            if (ImGui::Button("physics queries (100k per type)"))
+                Physics::RunQueryBenchmark(10000, 100000);
+
+            ImGui::TreePop();
+        }
+
         ImGui::End();
     }
 }
\ No newline at end of file
@@ -54,14 +54,34 @@ namespace MxEngine::GUI
 					audioSource.Load(AssetManager::LoadAudio(path));
 				}
 			}
+			ImGui::SameLine();
+			if (ImGui::Button("stream from file"))
+			{
+				MxString path = FileManager::OpenFileDialog("*.flac *.ogg *.wav *.mp3", "Image Files");
+				if (!path.empty() && File::Exists(path))
+				{
+					audioSource.LoadStream(path);
+				}
+			}
 
-			if (!source.IsValid())
+			if (audioSource.IsStreaming())
+			{
+				auto stream = audioSource.GetLoadedStream();
+				ImGui::Text("streaming: yes");
+				ImGui::Text("audio format: %s", EnumToString(stream->GetAudioType())); //-V111
+				ImGui::Text("channel count: %d", (int)stream->GetChannelCount());
+				ImGui::Text("length (in seconds): %d", int(stream->GetFrameCount() / Max(stream->GetFrequency(), 1)));
+				ImGui::Text("sampling frequency: %d", (int)stream->GetFrequency());
+				ImGui::Text("path to file: %s", stream->GetFilePath().c_str());
+			}
+			else if (!source.IsValid())
 			{
 				ImGui::Text("no audio source loaded");
 			}
 			else
 			{
 				ImGui::Text("native handle: %d", (int)source->GetNativeHandle());
+				ImGui::Text("status: %s", EnumToString(source->GetStatus())); //-V111
 				ImGui::Text("native format: %d", (int)source->GetNativeFormat());
 				ImGui::Text("audio format: %s", EnumToString(source->GetAudioType())); //-V111
 				ImGui::Text("channel count: %d", (int)source->GetChannelCount());
@@ -130,6 +130,7 @@ namespace MxEngine::GUI
 
 		ImGui::SameLine();
 		ImGui::Checkbox("auto LOD selection", &meshLOD.AutoLODSelection);
+		ImGui::Text("status: %s", EnumToString(meshLOD.GetStatus()));
 
 		int currentLOD = (int)meshLOD.CurrentLOD;
 		if (ImGui::DragInt("current LOD", &currentLOD, 0.1f, 0, (int)meshLOD.LODs.size()))
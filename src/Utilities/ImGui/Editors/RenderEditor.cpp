@@ -30,6 +30,8 @@
 #include "ComponentEditor.h"
 #include "Utilities/ImGui/ImGuiUtils.h"
 #include "Core/Application/Rendering.h"
+#include "Core/Resources/TextureStreamer.h"
+#include "Core/Resources/TextureReadback.h"
 #include "Platform/Window/WindowManager.h"
 
 namespace MxEngine
@@ -51,6 +53,55 @@ namespace MxEngine
             ImGui::TreePop();
         }
 
+        if (ImGui::TreeNode("cluster culling"))
+        {
+            auto clusterCulling = Rendering::IsClusterCullingEnabled();
+            if (ImGui::Checkbox("enable cluster culling", &clusterCulling))
+                Rendering::SetClusterCulling(clusterCulling);
+
+            const auto& statistics = Rendering::GetClusterStatistics();
+            ImGui::Text("triangles submitted: %d", (int)statistics.SubmittedTriangles);
+            ImGui::Text("triangles drawn: %d", (int)statistics.DrawnTriangles);
+            ImGui::Text("clusters submitted: %d", (int)statistics.SubmittedClusters);
+            ImGui::Text("clusters culled by frustrum: %d", (int)statistics.FrustrumCulledClusters);
+            ImGui::Text("clusters culled by normal cone: %d", (int)statistics.BackfaceCulledClusters);
+
+            ImGui::TreePop();
+        }
+
+        if (ImGui::TreeNode("texture streaming"))
+        {
+            int uploadBudget = int(TextureStreamer::GetUploadBudget() / 1024);
+            if (ImGui::DragInt("upload budget (KB per frame)", &uploadBudget, 16.0f))
+                TextureStreamer::SetUploadBudget((size_t)Max(0, uploadBudget) * 1024);
+
+            auto statistics = TextureStreamer::GetStatistics();
+            ImGui::ProgressBar(TextureStreamer::GetProgress());
+            ImGui::Text("pending decodes: %d", (int)statistics.PendingDecodes);
+            ImGui::Text("pending uploads: %d", (int)statistics.PendingUploads);
+            ImGui::Text("textures requested: %d", (int)statistics.RequestedTextures);
+            ImGui::Text("textures completed: %d", (int)statistics.CompletedTextures);
+            ImGui::Text("textures failed: %d", (int)statistics.FailedTextures);
+            ImGui::Text("uploaded last frame: %d KB", int(statistics.UploadedBytesLastFrame / 1024));
+            ImGui::Text("uploaded total: %d MB", int(statistics.UploadedBytes / (1024 * 1024)));
+            ImGui::Text("pixel buffers: %d", (int)statistics.PixelBufferCount);
+
+            ImGui::TreePop();
+        }
+
+        if (ImGui::TreeNode("texture readback"))
+        {
+            auto statistics = TextureReadback::GetStatistics();
+            ImGui::Text("pending readbacks: %d", (int)statistics.PendingReadbacks);
+            ImGui::Text("readbacks requested: %d", (int)statistics.RequestedReadbacks);
+            ImGui::Text("readbacks completed: %d", (int)statistics.CompletedReadbacks);
+            ImGui::Text("readbacks failed: %d", (int)statistics.FailedReadbacks);
+            ImGui::Text("read total: %d MB", int(statistics.ReadBytes / (1024 * 1024)));
+            ImGui::Text("pixel buffers: %d", (int)statistics.PixelBufferCount);
+
+            ImGui::TreePop();
+        }
+
         if (ImGui::TreeNode("window settings"))
         {
             static MxString title = WindowManager::GetTitle();;
@@ -36,6 +36,9 @@
 #include "Library/Primitives/Colors.h"
 #include "Library/Primitives/Primitives.h"
 #include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/MeshOptimizer/MeshOptimizer.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
 
 namespace MxEngine::GUI
 {
@@ -434,6 +437,7 @@ namespace MxEngine::GUI
         SCOPE_TREE_NODE(name);
         ImGui::PushID((int)mesh.GetHandle());
 
+        ImGui::Text("status: %s", EnumToString(mesh->GetStatus()));
         DrawAABBEditor("bounding box", mesh->BoxBounding);
         DrawSphereEditor("bounding sphere", mesh->SphereBounding);
 
@@ -443,10 +447,23 @@ namespace MxEngine::GUI
             if (!path.empty() && File::Exists(path))
                 mesh = AssetManager::LoadMesh(path);
         }
+        ImGui::SameLine();
+        if (ImGui::Button("load from file async"))
+        {
+            MxString path = FileManager::OpenFileDialog();
+            if (!path.empty() && File::Exists(path))
+                mesh = AssetManager::LoadMeshAsync(path);
+        }
 
         ImGui::SameLine();
         if (ImGui::Button("update mesh boundings"))
             mesh->UpdateBoundingGeometry();
+
+        if (ImGui::Button("use packed vertecies"))
+            mesh->SetVertexFormat(VertexFormat::PACKED);
+        ImGui::SameLine();
+        if (ImGui::Button("use full vertecies"))
+            mesh->SetVertexFormat(VertexFormat::FULL);
         
         ImGui::Indent(9.0f);
         LoadFromPrimitive(mesh);
@@ -472,6 +489,28 @@ namespace MxEngine::GUI
             ImGui::Text("vertex count: %d", (int)submesh.Data.GetVertecies().size());
             ImGui::Text("index count: %d", (int)submesh.Data.GetIndicies().size());
             ImGui::Text("material id: %d", (int)submesh.GetMaterialId());
+            ImGui::Text("vertex format: %s", EnumToString(submesh.Data.GetVertexFormat()));
+
+            if (ImGui::CollapsingHeader("quantization report"))
+            {
+                GUI::Indent _(5.0f);
+                // report is computed when packed vertecies are buffered, as quantizing whole mesh every frame is too expensive
+                const auto& report = submesh.Data.GetQuantizationReport();
+                if (report.VertexCount > 0)
+                {
+                    ImGui::Text("memory: %d bytes -> %d bytes", (int)report.FullSizeInBytes, (int)report.PackedSizeInBytes);
+                    ImGui::Text("max position error: %f", report.MaxPositionError);
+                    ImGui::Text("average position error: %f", report.AveragePositionError);
+                    ImGui::Text("max texcoord error: %f", report.MaxTexCoordError);
+                    ImGui::Text("max normal error: %f deg", report.MaxNormalError);
+                    ImGui::Text("max tangent error: %f deg", report.MaxTangentError);
+                    ImGui::Text("bitangent sign mismatches: %d", (int)report.BitangentSignMismatches);
+                }
+                else
+                {
+                    ImGui::Text("vertex format is not packed");
+                }
+            }
 
             TransformEditor(*submesh.GetTransform());
 
@@ -494,6 +533,32 @@ namespace MxEngine::GUI
             ImGui::SameLine();
             if (ImGui::Button("regenerate tangents"))
                 submesh.Data.RegenerateTangentSpace();
+            ImGui::SameLine();
+            if (ImGui::Button("optimize"))
+            {
+                submesh.Optimization = MeshOptimizer::Optimize(submesh.Data);
+                const auto& report = submesh.Optimization;
+                MXLOG_INFO("MxEngine::MeshOptimizer", MxFormat("optimized submesh {0}: ACMR {1} -> {2}, ATVR {3} -> {4}", submesh.Name.c_str(),
+                    report.Before.ACMR, report.After.ACMR, report.Before.ATVR, report.After.ATVR));
+            }
+            // statistics are measured once during optimization, as simulating vertex cache every frame is too expensive for big meshes
+            if (submesh.Optimization.After.TriangleCount > 0)
+            {
+                const auto& report = submesh.Optimization;
+                ImGui::Text("ACMR: %f -> %f, ATVR: %f -> %f", report.Before.ACMR, report.After.ACMR, report.Before.ATVR, report.After.ATVR);
+            }
+            else
+            {
+                ImGui::Text("ACMR / ATVR: not optimized");
+            }
+
+            ImGui::Text("clusters: %d", (int)submesh.Data.GetClusters().size());
+            ImGui::SameLine();
+            if (ImGui::Button("build clusters"))
+                submesh.Data.BuildClusters();
+            ImGui::SameLine();
+            if (ImGui::Button("clear clusters"))
+                submesh.Data.ClearClusters();
 
             // TODO: maybe add indicies editor?
             {
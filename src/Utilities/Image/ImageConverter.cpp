@@ -56,6 +56,12 @@ namespace MxEngine
         return data;
     }
 
+    ImageConverter::RawImageData ImageConverter::ConvertImagePNG(const uint8_t* imagedata, int width, int height, int channels, PngCompression compression, bool flipOnConvert)
+    {
+        MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImagePNG()");
+        return ImageEncoder::EncodePNG(imagedata, (size_t)width, (size_t)height, (size_t)channels, compression, flipOnConvert);
+    }
+
     ImageConverter::RawImageData ImageConverter::ConvertImageBMP(const uint8_t* imagedata, int width, int height, int channels, bool flipOnConvert)
     {
         ImageConverter::RawImageData data;
@@ -110,6 +116,12 @@ namespace MxEngine
         return ImageConverter::ConvertImagePNG(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), flipOnSave);
     }
 
+    ImageConverter::RawImageData ImageConverter::ConvertImagePNG(const Image& image, PngCompression compression, bool flipOnSave)
+    {
+        if (image.IsFloatingPoint()) return { };
+        return ImageConverter::ConvertImagePNG(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), compression, flipOnSave);
+    }
+
     ImageConverter::RawImageData ImageConverter::ConvertImageBMP(const Image& image, bool flipOnSave)
     {
         if (image.IsFloatingPoint()) return { };
@@ -128,6 +140,13 @@ namespace MxEngine
         return ImageConverter::ConvertImageJPG(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), quality, flipOnSave);
     }
 
+    ImageConverter::RawImageData ImageConverter::ConvertImageJPGParallel(const Image& image, int quality, bool flipOnSave)
+    {
+        if (image.IsFloatingPoint()) return { };
+        MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImageJPG()");
+        return ImageEncoder::EncodeJPG(image.GetRawData(), image.GetWidth(), image.GetHeight(), image.GetChannelCount(), quality, flipOnSave);
+    }
+
     ImageConverter::RawImageData ImageConverter::ConvertImageHDR(const Image& image, bool flipOnSave)
     {
         if (!image.IsFloatingPoint()) return { };
@@ -31,6 +31,7 @@
 #include "Utilities/STL/MxString.h"
 #include "Utilities/STL/MxVector.h"
 #include "Image.h"
+#include "Utilities/ImageEncoder/ImageEncoder.h"
 
 namespace MxEngine
 {
@@ -40,15 +41,18 @@ namespace MxEngine
 		using RawImageData = MxVector<uint8_t>;
 
 		static RawImageData ConvertImagePNG(const uint8_t* imagedata, int width, int height, int channels, bool flipOnSave = true);
+		static RawImageData ConvertImagePNG(const uint8_t* imagedata, int width, int height, int channels, PngCompression compression, bool flipOnSave = true);
 		static RawImageData ConvertImageBMP(const uint8_t* imagedata, int width, int height, int channels, bool flipOnSave = true);
 		static RawImageData ConvertImageTGA(const uint8_t* imagedata, int width, int height, int channels, bool flipOnSave = true);
 		static RawImageData ConvertImageJPG(const uint8_t* imagedata, int width, int height, int channels, int  quality = 90, bool flipOnSave = true);
 		static RawImageData ConvertImageHDR(const float* imagedata, int width, int height, int channels, bool flipOnSave = true);
 
 		static RawImageData ConvertImagePNG(const Image& image, bool flipOnSave = true);
+		static RawImageData ConvertImagePNG(const Image& image, PngCompression compression, bool flipOnSave = true);
 		static RawImageData ConvertImageBMP(const Image& image, bool flipOnSave = true);
 		static RawImageData ConvertImageTGA(const Image& image, bool flipOnSave = true);
 		static RawImageData ConvertImageJPG(const Image& image, int  quality = 90, bool flipOnSave = true);
+		static RawImageData ConvertImageJPGParallel(const Image& image, int quality = 90, bool flipOnSave = true);
 		static RawImageData ConvertImageHDR(const Image& image, bool flipOnSave = true);
 	};
 }
\ No newline at end of file
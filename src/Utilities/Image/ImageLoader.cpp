@@ -30,6 +30,7 @@
 #include "Core/Macro/Macro.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/Math/Math.h"
+#include "Utilities/ImageKernels/ImageKernels.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -42,10 +43,11 @@ namespace MxEngine
 		MAKE_SCOPE_TIMER("MxEngine::ImageLoader", "ImageLoader::LoadImage()");
 		MXLOG_INFO("MxEngine::ImageLoader", "loading image from file: " + filepath);
 
-		stbi_set_flip_vertically_on_load(flipImage);
 		int width, height, channels;
 		uint8_t* data = stbi_load(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
 		channels = 4;
+		// stb flip flag is global for all threads, so images are always decoded as-is and flipped here
+		if (flipImage) ImageKernels::FlipVertically(data, (size_t)width * channels, (size_t)height);
 		return Image(data, (size_t)width, (size_t)height, (size_t)channels, false);
 	}
 
@@ -55,10 +57,11 @@ namespace MxEngine
 		MAKE_SCOPE_TIMER("MxEngine::ImageLoader", "ImageLoader::LoadImage()");
 		MXLOG_INFO("MxEngine::ImageLoader", "loading image from memory");
 
-		stbi_set_flip_vertically_on_load(flipImage);
 		int width, height, channels;
 		uint8_t* data = stbi_load_from_memory(memory, (int)byteSize, &width, &height, &channels, STBI_rgb_alpha);
 		channels = 4;
+		// stb flip flag is global for all threads, so images are always decoded as-is and flipped here
+		if (flipImage) ImageKernels::FlipVertically(data, (size_t)width * channels, (size_t)height);
 		return Image(data, (size_t)width, (size_t)height, (size_t)channels, false);
 	}
 
@@ -94,14 +97,12 @@ namespace MxEngine
 
 		auto copySide = [&image, &width, &height, &channels](Array2D<unsigned char>& dst, size_t sliceX, size_t sliceY)
 		{
-			for (size_t i = 0; i < height; i++)
-			{
-				size_t y = i + sliceY * height;
-				size_t x = sliceX * width;
-				size_t bytesInRow = width * channels;
+			size_t y = sliceY * height;
+			size_t x = sliceX * width;
+			size_t bytesInRow = width * channels;
+			auto source = &image.GetRawData()[(y * image.GetWidth() + x) * channels];
 
-				std::memcpy(dst[i].data(), &image.GetRawData()[(y * image.GetWidth() + x) * channels], bytesInRow);
-			}
+			ImageKernels::Blit(source, image.GetWidth() * channels, dst.data(), bytesInRow, bytesInRow, height);
 		};
 
 		copySide(result[0], 2, 1);
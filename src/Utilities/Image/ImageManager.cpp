@@ -30,7 +30,14 @@
 #include "Utilities/FileSystem/FileManager.h"
 #include "Utilities/Image/ImageConverter.h"
 #include "Core/Application/Rendering.h"
+#include "Core/Resources/TextureReadback.h"
 #include "Utilities/Logging/Logger.h"
+#include "Utilities/ImageKernels/ImageKernels.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
 
 namespace MxEngine
 {
@@ -51,7 +58,7 @@ namespace MxEngine
         switch (type)
         {
         case ImageType::PNG:
-            imageByteData = ImageConverter::ConvertImagePNG(image);
+            imageByteData = ImageConverter::ConvertImagePNG(image, PngCompression::DEFAULT);
             break;
         case ImageType::BMP:
             imageByteData = ImageConverter::ConvertImageBMP(image);
@@ -60,7 +67,7 @@ namespace MxEngine
             imageByteData = ImageConverter::ConvertImageTGA(image);
             break;
         case ImageType::JPG:
-            imageByteData = ImageConverter::ConvertImageJPG(image);
+            imageByteData = ImageConverter::ConvertImageJPGParallel(image);
             break;
         case ImageType::HDR:
             // TODO: support HDR images
@@ -136,7 +143,79 @@ namespace MxEngine
 
     void ImageManager::SaveTexture(const char* filePath, const TextureHandle& texture)
     {
-        ImageManager::SaveTexture(MxString(filePath), texture);
+        ImageManager::SaveTexture(FilePath(filePath), texture);
+    }
+
+    void ImageManager::SaveTextureAsync(StringId fileHash, const TextureHandle& texture, ImageType type)
+    {
+        ImageManager::SaveTextureAsync(FileManager::GetFilePath(fileHash), texture, type);
+    }
+
+    void ImageManager::SaveTextureAsync(const FilePath& filePath, const TextureHandle& texture, ImageType type)
+    {
+        ImageManager::SaveTextureAsync(ToMxString(filePath), texture, type);
+    }
+
+    void ImageManager::SaveTextureAsync(const MxString& filePath, const TextureHandle& texture, ImageType type)
+    {
+        TextureReadback::Read(texture, [filePath, type](Image image)
+        {
+            if (image.GetRawData() == nullptr)
+            {
+                MXLOG_ERROR("MxEngine::ImageManager", "image was not saved because texture readback failed: " + filePath);
+                return;
+            }
+            ImageManager::SaveImage(filePath, image, type);
+        });
+    }
+
+    void ImageManager::SaveTextureAsync(const char* filePath, const TextureHandle& texture, ImageType type)
+    {
+        ImageManager::SaveTextureAsync((MxString)filePath, texture, type);
+    }
+
+    void ImageManager::SaveTextureAsync(StringId fileHash, const TextureHandle& texture)
+    {
+        ImageManager::SaveTextureAsync(FileManager::GetFilePath(fileHash), texture);
+    }
+
+    void ImageManager::SaveTextureAsync(const FilePath& filepath, const TextureHandle& texture)
+    {
+        auto ext = filepath.extension();
+        if (ext == ".png")
+        {
+            ImageManager::SaveTextureAsync(filepath, texture, ImageType::PNG);
+        }
+        else if (ext == ".jpg" || ext == ".jpeg")
+        {
+            ImageManager::SaveTextureAsync(filepath, texture, ImageType::JPG);
+        }
+        else if (ext == ".bmp")
+        {
+            ImageManager::SaveTextureAsync(filepath, texture, ImageType::BMP);
+        }
+        else if (ext == ".tga")
+        {
+            ImageManager::SaveTextureAsync(filepath, texture, ImageType::TGA);
+        }
+        else if (ext == ".hdr")
+        {
+            ImageManager::SaveTextureAsync(filepath, texture, ImageType::HDR);
+        }
+        else
+        {
+            MXLOG_WARNING("MxEngine::ImageManager", "image was not saved because extenstion was invalid: " + ToMxString(ext));
+        }
+    }
+
+    void ImageManager::SaveTextureAsync(const MxString& filePath, const TextureHandle& texture)
+    {
+        ImageManager::SaveTextureAsync(ToFilePath(filePath), texture);
+    }
+
+    void ImageManager::SaveTextureAsync(const char* filePath, const TextureHandle& texture)
+    {
+        ImageManager::SaveTextureAsync(FilePath(filePath), texture);
     }
 
     void ImageManager::TakeScreenShot(StringId fileHash, ImageType type)
@@ -157,7 +236,7 @@ namespace MxEngine
             MXLOG_WARNING("MxEngine::ImageManager", "cannot take screenshot at there is no viewport attached");
             return;
         }
-        ImageManager::SaveTexture(filePath, screenshot, type);
+        ImageManager::SaveTextureAsync(filePath, screenshot, type);
     }
 
     void ImageManager::TakeScreenShot(const char* filePath, ImageType type)
@@ -211,25 +290,7 @@ namespace MxEngine
 
     void ImageManager::FlipImage(Image& image)
     {
-        auto imageByteRow = image.GetRawData();
-        auto rowByteSize = image.GetWidth() * image.GetPixelSize();
-        uint8_t* swapRow = (uint8_t*)std::malloc(rowByteSize);
-
-        for (size_t i = 0; i < image.GetHeight() * rowByteSize / 2; i += rowByteSize)
-        {
-            auto currentRow = imageByteRow + i;
-            auto symmetricRow = imageByteRow + (rowByteSize * (image.GetHeight() - 1) - i);
-
-            // Copying current row to the swap memory allocated for it
-            std::memcpy(swapRow, currentRow, rowByteSize);
-
-            // Copying destination to source
-            std::memcpy(currentRow, symmetricRow, rowByteSize);
-
-            // Putting content of the swap (previously current row) to the symmetric row
-            std::memcpy(symmetricRow, swapRow, rowByteSize);
-        }
-        std::free((void*)rowByteSize);
+        ImageKernels::FlipVertically(image);
     }
 
     Image ImageManager::CombineImages(ArrayView<Image> images, size_t imagesPerRaw)
@@ -255,20 +316,21 @@ namespace MxEngine
 
         const size_t imagesPerColumn = images.size() / imagesPerRaw;
         const size_t rawWidth = width * pixelSize;
-        size_t offset = 0;
+        const size_t resultRawWidth = rawWidth * imagesPerRaw;
+        const size_t rowGranularity = std::max(ImageKernels::ParallelRowGranularity / imagesPerRaw, (size_t)1);
 
+        // each task copies band of rows of all images in one row of tiles
         for (size_t t1 = 0; t1 < imagesPerColumn; t1++)
         {
-            for (size_t i = 0; i < height; i++)
+            ThreadPool::ParallelFor(height, rowGranularity, [&](size_t begin, size_t end)
             {
                 for (size_t t2 = 0; t2 < imagesPerRaw; t2++)
                 {
                     auto& tex = images[t1 * imagesPerRaw + t2];
-                    auto currentRaw = tex.GetRawData() + i * rawWidth;
-                    std::copy(currentRaw, currentRaw + rawWidth, result + offset); //-V769
-                    offset += rawWidth;
+                    auto destination = result + (t1 * height + begin) * resultRawWidth + t2 * rawWidth;
+                    ImageKernels::Blit(tex.GetRawData() + begin * rawWidth, rawWidth, destination, resultRawWidth, rawWidth, end - begin); //-V769
                 }
-            }
+            });
         }
         return Image(result, width * imagesPerRaw, height * imagesPerColumn, pixelSize, isFloatingPoint);
     }
@@ -277,4 +339,66 @@ namespace MxEngine
     {
         return ImageManager::CombineImages(ArrayView<Image>(images.data(), images.size()), images.width());
     }
-}
\ No newline at end of file
+
+    ImageTileWriter::ImageTileWriter(const MxString& filePath, size_t tileWidth, size_t tileHeight, size_t tilesPerRow, size_t tileRowCount, 
+        size_t channels, PngCompression compression)
+        : file(filePath, File::WRITE | File::BINARY), receivedTiles(tilesPerRow, 0), tileWidth(tileWidth), tileHeight(tileHeight), 
+          tilesPerRow(tilesPerRow), tileRowCount(tileRowCount), channels(channels),
+          encoder(tileWidth * tilesPerRow, tileHeight * tileRowCount, channels, compression,
+            [this](const uint8_t* data, size_t size) { this->file.WriteBytes(data, size); })
+    {
+        if (!this->file.IsOpen())
+            MXLOG_ERROR("MxEngine::ImageTileWriter", "cannot open file for writing: " + filePath);
+        this->strip.resize(tileWidth * tilesPerRow * tileHeight * channels);
+    }
+
+    bool ImageTileWriter::WriteTile(size_t column, size_t row, const Image& tile)
+    {
+        MAKE_SCOPE_PROFILER("ImageTileWriter::WriteTile()");
+        if (row != this->currentTileRow || column >= this->tilesPerRow || this->receivedTiles[column] != 0)
+        {
+            MXLOG_ERROR("MxEngine::ImageTileWriter", MxFormat("tile ({0}, {1}) was rejected, as tile row {2} is being written", column, row, this->currentTileRow));
+            return false;
+        }
+        if (tile.GetWidth() != this->tileWidth || tile.GetHeight() != this->tileHeight || tile.GetChannelCount() != this->channels || tile.IsFloatingPoint())
+        {
+            MXLOG_ERROR("MxEngine::ImageTileWriter", MxFormat("tile ({0}, {1}) was rejected, as its size or format does not match other tiles", column, row));
+            return false;
+        }
+
+        // strip is stored from the last row to the first one, same as tiles, so it is flipped by encoder
+        const size_t rawWidth = this->tileWidth * this->channels;
+        const size_t stripRawWidth = rawWidth * this->tilesPerRow;
+        uint8_t* destination = this->strip.data() + column * rawWidth;
+        ThreadPool::ParallelFor(this->tileHeight, ImageKernels::ParallelRowGranularity, [&](size_t begin, size_t end)
+        {
+            ImageKernels::Blit(tile.GetRawData() + begin * rawWidth, rawWidth, destination + begin * stripRawWidth, stripRawWidth, rawWidth, end - begin);
+        });
+
+        this->receivedTiles[column] = 1;
+        this->receivedTileCount++;
+        if (this->receivedTileCount == this->tilesPerRow)
+        {
+            this->encoder.WriteRows(this->strip.data(), this->tileHeight, true);
+            std::fill(this->receivedTiles.begin(), this->receivedTiles.end(), 0);
+            this->receivedTileCount = 0;
+            this->currentTileRow++;
+            if (this->IsFinished())
+            {
+                MxVector<uint8_t>().swap(this->strip);
+                this->file.GetStream().flush();
+            }
+        }
+        return true;
+    }
+
+    size_t ImageTileWriter::GetCurrentTileRow() const
+    {
+        return this->currentTileRow;
+    }
+
+    bool ImageTileWriter::IsFinished() const
+    {
+        return this->currentTileRow == this->tileRowCount;
+    }
+}
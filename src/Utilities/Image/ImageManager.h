@@ -32,6 +32,7 @@
 #include "Utilities/FileSystem/File.h"
 #include "Utilities/String/String.h"
 #include "Utilities/Array/Array2D.h"
+#include "Utilities/ImageEncoder/ImageEncoder.h"
 
 namespace MxEngine
 {
@@ -62,6 +63,19 @@ namespace MxEngine
 		static void SaveTexture(const MxString& filePath, const TextureHandle& texture);
 		static void SaveTexture(const char* filePath,     const TextureHandle& texture);
 
+		// texture is read back without GPU stall and saved on worker thread a few frames later (see TextureReadback)
+		static void SaveTextureAsync(StringId        fileHash, const TextureHandle& texture, ImageType type);
+		static void SaveTextureAsync(const FilePath& filePath, const TextureHandle& texture, ImageType type);
+		static void SaveTextureAsync(const MxString& filePath, const TextureHandle& texture, ImageType type);
+		static void SaveTextureAsync(const char*     filePath, const TextureHandle& texture, ImageType type);
+
+		static void SaveTextureAsync(StringId        fileHash, const TextureHandle& texture);
+		static void SaveTextureAsync(const FilePath& filePath, const TextureHandle& texture);
+		static void SaveTextureAsync(const MxString& filePath, const TextureHandle& texture);
+		static void SaveTextureAsync(const char*     filePath, const TextureHandle& texture);
+
+		// screenshots are saved asynchronously, so they can be taken every frame
+
 		static void TakeScreenShot(StringId        fileHash, ImageType type);
 		static void TakeScreenShot(const FilePath& filePath, ImageType type);
 		static void TakeScreenShot(const MxString& filePath, ImageType type);
@@ -81,4 +95,45 @@ namespace MxEngine
 		static Image CombineImages(ArrayView<Image> images, size_t imagesPerRaw);
 		static Image CombineImages(Array2D<Image>& images);
 	};
+
+	/*!
+	tile writer saves huge image to PNG file without allocating it as a whole. Tiles are copied into strip of one tile row,
+	which is encoded and written to file as soon as all its tiles are received, so memory usage does not depend on number of tile rows.
+	Tile rows must be written from the top one to the bottom one, tiles inside a row can be written in any order
+	*/
+	class ImageTileWriter
+	{
+		File file;
+		MxVector<uint8_t> strip;
+		MxVector<uint8_t> receivedTiles;
+		size_t tileWidth = 0;
+		size_t tileHeight = 0;
+		size_t tilesPerRow = 0;
+		size_t tileRowCount = 0;
+		size_t channels = 0;
+		size_t currentTileRow = 0;
+		size_t receivedTileCount = 0;
+		PngStreamEncoder encoder;
+	public:
+		/*!
+		opens file and writes PNG header. Resulting image size is (tileWidth * tilesPerRow, tileHeight * tileRowCount)
+		\param channels channel count of 8-bit tiles
+		\param compression PNG compression level
+		*/
+		ImageTileWriter(const MxString& filePath, size_t tileWidth, size_t tileHeight, size_t tilesPerRow, size_t tileRowCount, 
+			size_t channels, PngCompression compression = PngCompression::DEFAULT);
+		ImageTileWriter(const ImageTileWriter&) = delete;
+		ImageTileWriter& operator=(const ImageTileWriter&) = delete;
+
+		/*!
+		copies tile into current strip. If strip is complete, it is encoded and written to file
+		\param column tile column, counted from the left
+		\param row tile row, counted from the top. Must be equal to current tile row
+		\param tile tile image stored from the last row to the first one, as all images read from textures
+		\returns false if tile was rejected because of its size, format or position
+		*/
+		bool WriteTile(size_t column, size_t row, const Image& tile);
+		size_t GetCurrentTileRow() const;
+		bool IsFinished() const;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,1458 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ImageEncoder.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+#include "Core/Macro/Macro.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace MxEngine
+{
+    const char* EnumToString(PngCompression compression)
+    {
+        switch (compression)
+        {
+        case PngCompression::FAST:
+            return "FAST";
+        case PngCompression::DEFAULT:
+            return "DEFAULT";
+        case PngCompression::BEST:
+            return "BEST";
+        default:
+            return "DEFAULT";
+        }
+    }
+
+    constexpr size_t DeflateWindowSize = 1 << 15;
+    constexpr size_t DeflateMinMatch = 3;
+    constexpr size_t DeflateMaxMatch = 258;
+    constexpr size_t DeflateHashBits = 15;
+    constexpr size_t DeflateBlockSymbols = 1 << 16;
+    constexpr size_t DeflateLiteralCodeCount = 286;
+    constexpr size_t DeflateDistanceCodeCount = 30;
+    constexpr size_t DeflateMaxCodeLength = 15;
+    constexpr size_t DeflateMaxCodeLengthLength = 7;
+
+    struct DeflateSettings
+    {
+        size_t ChainDepth;
+        bool InsertAllPositions;
+        bool LazyMatching;
+        bool AdaptiveFilter;
+        uint8_t HeaderLevel;
+    };
+
+    static DeflateSettings GetDeflateSettings(PngCompression compression)
+    {
+        switch (compression)
+        {
+        case PngCompression::FAST:
+            return DeflateSettings{ 1, false, false, false, 0x5E };
+        case PngCompression::BEST:
+            return DeflateSettings{ 64, true, true, true, 0xDA };
+        default:
+            return DeflateSettings{ 16, true, false, true, 0x9C };
+        }
+    }
+
+    /*!
+    single literal or match of LZ77 stream. Literals have zero distance
+    */
+    struct DeflateSymbol
+    {
+        uint16_t LengthOrLiteral;
+        uint16_t Distance;
+    };
+
+    struct HuffmanCode
+    {
+        uint16_t Code = 0;
+        uint8_t Length = 0;
+    };
+
+    /*!
+    maps match lengths and distances to deflate codes. Distances above 256 are mapped by their highest bits, as in zlib
+    */
+    struct DeflateTables
+    {
+        uint16_t LengthCode[DeflateMaxMatch + 1];
+        uint8_t LengthExtraBits[DeflateMaxMatch + 1];
+        uint16_t LengthBase[DeflateMaxMatch + 1];
+        uint8_t DistanceCode[512];
+        uint8_t DistanceExtraBits[DeflateDistanceCodeCount];
+        uint16_t DistanceBase[DeflateDistanceCodeCount];
+
+        static uint32_t GetHighestBit(uint32_t value)
+        {
+            uint32_t bit = 0;
+            while (value >>= 1) bit++;
+            return bit;
+        }
+
+        DeflateTables()
+        {
+            for (size_t length = DeflateMinMatch; length <= DeflateMaxMatch; length++)
+            {
+                uint32_t value = uint32_t(length - DeflateMinMatch);
+                if (length == DeflateMaxMatch)
+                {
+                    this->LengthCode[length] = 285;
+                    this->LengthExtraBits[length] = 0;
+                    this->LengthBase[length] = (uint16_t)length;
+                }
+                else if (value < 8)
+                {
+                    this->LengthCode[length] = uint16_t(257 + value);
+                    this->LengthExtraBits[length] = 0;
+                    this->LengthBase[length] = (uint16_t)length;
+                }
+                else
+                {
+                    uint32_t bit = GetHighestBit(value);
+                    this->LengthCode[length] = uint16_t(257 + 4 * (bit - 1) + ((value >> (bit - 2)) & 3));
+                    this->LengthExtraBits[length] = uint8_t(bit - 2);
+                    this->LengthBase[length] = uint16_t(length - (value & ((1u << (bit - 2)) - 1)));
+                }
+            }
+            for (uint32_t code = 0; code < DeflateDistanceCodeCount; code++)
+            {
+                this->DistanceExtraBits[code] = uint8_t(code < 4 ? 0 : code / 2 - 1);
+                this->DistanceBase[code] = uint16_t(code < 4 ? code + 1 : ((2u | (code & 1)) << (code / 2 - 1)) + 1);
+            }
+            for (uint32_t value = 0; value < 512; value++)
+            {
+                // second half of table is indexed by (distance - 1) >> 7 for distances above 256
+                uint32_t distance = value < 256 ? value : (value - 256) << 7;
+                if (value >= 256 && distance < 256) { this->DistanceCode[value] = 0; continue; }
+                uint32_t bit = GetHighestBit(distance);
+                this->DistanceCode[value] = uint8_t(distance < 4 ? distance : 2 * bit + ((distance >> (bit - 1)) & 1));
+            }
+        }
+
+        uint32_t GetDistanceCode(uint32_t distance) const
+        {
+            uint32_t value = distance - 1;
+            return value < 256 ? this->DistanceCode[value] : this->DistanceCode[256 + (value >> 7)];
+        }
+    };
+
+    static const DeflateTables& GetDeflateTables()
+    {
+        static DeflateTables tables;
+        return tables;
+    }
+
+    /*!
+    writes bits in deflate order (least significant bit first)
+    */
+    class DeflateBitWriter
+    {
+        MxVector<uint8_t>& output;
+        uint64_t bits = 0;
+        size_t bitCount = 0;
+    public:
+        DeflateBitWriter(MxVector<uint8_t>& output) : output(output) { }
+
+        void Write(uint32_t value, size_t length)
+        {
+            this->bits |= (uint64_t)value << this->bitCount;
+            this->bitCount += length;
+            if (this->bitCount >= 32)
+            {
+                uint8_t bytes[4] = { uint8_t(this->bits), uint8_t(this->bits >> 8), uint8_t(this->bits >> 16), uint8_t(this->bits >> 24) };
+                this->output.insert(this->output.end(), bytes, bytes + 4);
+                this->bits >>= 32;
+                this->bitCount -= 32;
+            }
+        }
+
+        void Write(HuffmanCode code)
+        {
+            this->Write(code.Code, code.Length);
+        }
+
+        void AlignToByte()
+        {
+            if (this->bitCount % 8 != 0) this->Write(0, 8 - this->bitCount % 8);
+        }
+
+        void Flush()
+        {
+            this->AlignToByte();
+            for (; this->bitCount > 0; this->bitCount -= 8, this->bits >>= 8)
+                this->output.push_back(uint8_t(this->bits));
+        }
+    };
+
+    /*!
+    computes code lengths of length-limited huffman code. Lengths which exceed limit are redistributed keeping code complete, as done in miniz
+    \param frequencies frequency of each symbol
+    \param lengths resulting length of each symbol (zero for unused symbols)
+    */
+    static void BuildHuffmanLengths(const uint32_t* frequencies, size_t symbolCount, size_t maxLength, uint8_t* lengths)
+    {
+        std::fill(lengths, lengths + symbolCount, 0);
+        MxVector<std::pair<uint32_t, uint16_t>> symbols;
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            if (frequencies[i] > 0) symbols.emplace_back(frequencies[i], (uint16_t)i);
+        }
+
+        // decoders require at least two codes to build complete code, so unused symbols are added if needed
+        if (symbols.size() < 2)
+        {
+            uint16_t used = symbols.empty() ? 0 : symbols[0].second;
+            lengths[used] = 1;
+            lengths[used == 0 ? 1 : 0] = 1;
+            return;
+        }
+        std::sort(symbols.begin(), symbols.end());
+
+        // two-queue construction: leaves are sorted, internal nodes are created in non-decreasing weight order
+        size_t leafCount = symbols.size();
+        MxVector<uint64_t> weights(2 * leafCount - 1);
+        MxVector<uint32_t> parents(2 * leafCount - 1);
+        for (size_t i = 0; i < leafCount; i++)
+            weights[i] = symbols[i].first;
+
+        size_t leaf = 0, node = leafCount;
+        auto takeSmallest = [&](size_t current)
+        {
+            if (leaf < leafCount && (node >= current || weights[leaf] <= weights[node])) return leaf++;
+            return node++;
+        };
+        for (size_t current = leafCount; current < 2 * leafCount - 1; current++)
+        {
+            size_t a = takeSmallest(current);
+            size_t b = takeSmallest(current);
+            weights[current] = weights[a] + weights[b];
+            parents[a] = parents[b] = (uint32_t)current;
+        }
+
+        std::array<uint32_t, 33> lengthCounts{ };
+        MxVector<uint32_t> depths(2 * leafCount - 1);
+        depths[2 * leafCount - 2] = 0;
+        for (size_t i = 2 * leafCount - 2; i-- > 0;)
+        {
+            depths[i] = depths[parents[i]] + 1;
+            if (i < leafCount) lengthCounts[std::min(depths[i], 32u)]++;
+        }
+
+        for (size_t i = maxLength + 1; i < lengthCounts.size(); i++)
+        {
+            lengthCounts[maxLength] += lengthCounts[i];
+            lengthCounts[i] = 0;
+        }
+        uint32_t total = 0;
+        for (size_t i = maxLength; i > 0; i--)
+            total += lengthCounts[i] << (maxLength - i);
+        while (total != (1u << maxLength))
+        {
+            lengthCounts[maxLength]--;
+            for (size_t i = maxLength - 1; i > 0; i--)
+            {
+                if (lengthCounts[i] != 0)
+                {
+                    lengthCounts[i]--;
+                    lengthCounts[i + 1] += 2;
+                    break;
+                }
+            }
+            total--;
+        }
+
+        // least frequent symbols get longest codes
+        size_t index = 0;
+        for (size_t length = maxLength; length > 0; length--)
+        {
+            for (uint32_t i = 0; i < lengthCounts[length]; i++)
+                lengths[symbols[index++].second] = (uint8_t)length;
+        }
+    }
+
+    /*!
+    builds canonical huffman codes from lengths. Codes are bit-reversed, as deflate writes them starting from most significant bit
+    */
+    static void BuildHuffmanCodes(const uint8_t* lengths, size_t symbolCount, HuffmanCode* codes)
+    {
+        std::array<uint32_t, DeflateMaxCodeLength + 2> nextCode{ };
+        for (size_t i = 0; i < symbolCount; i++)
+            nextCode[lengths[i] + 1]++;
+        nextCode[1] = 0;
+        for (size_t length = 2; length < nextCode.size(); length++)
+            nextCode[length] = (nextCode[length - 1] + nextCode[length]) << 1;
+
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            codes[i].Length = lengths[i];
+            if (lengths[i] == 0) continue;
+            uint32_t code = nextCode[lengths[i]]++;
+            uint32_t reversed = 0;
+            for (size_t bit = 0; bit < lengths[i]; bit++)
+                reversed |= ((code >> bit) & 1) << (lengths[i] - 1 - bit);
+            codes[i].Code = (uint16_t)reversed;
+        }
+    }
+
+    static void WriteDynamicBlock(DeflateBitWriter& writer, const DeflateSymbol* symbols, size_t symbolCount, bool isFinal)
+    {
+        const auto& tables = GetDeflateTables();
+        std::array<uint32_t, DeflateLiteralCodeCount> literalFrequencies{ };
+        std::array<uint32_t, DeflateDistanceCodeCount> distanceFrequencies{ };
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            const auto& symbol = symbols[i];
+            if (symbol.Distance == 0)
+            {
+                literalFrequencies[symbol.LengthOrLiteral]++;
+            }
+            else
+            {
+                literalFrequencies[tables.LengthCode[symbol.LengthOrLiteral]]++;
+                distanceFrequencies[tables.GetDistanceCode(symbol.Distance)]++;
+            }
+        }
+        literalFrequencies[256] = 1;
+
+        uint8_t lengths[DeflateLiteralCodeCount + DeflateDistanceCodeCount];
+        uint8_t* literalLengths = lengths;
+        uint8_t distanceLengths[DeflateDistanceCodeCount];
+        BuildHuffmanLengths(literalFrequencies.data(), DeflateLiteralCodeCount, DeflateMaxCodeLength, literalLengths);
+        BuildHuffmanLengths(distanceFrequencies.data(), DeflateDistanceCodeCount, DeflateMaxCodeLength, distanceLengths);
+
+        size_t literalCount = DeflateLiteralCodeCount;
+        while (literalCount > 257 && literalLengths[literalCount - 1] == 0) literalCount--;
+        size_t distanceCount = DeflateDistanceCodeCount;
+        while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) distanceCount--;
+        // code lengths of both alphabets are sent as one sequence, so runs may cross from literals to distances
+        std::memcpy(lengths + literalCount, distanceLengths, distanceCount);
+        size_t lengthCount = literalCount + distanceCount;
+
+        MxVector<std::pair<uint8_t, uint8_t>> lengthSymbols; // code length symbol and its extra bits value
+        std::array<uint32_t, 19> lengthFrequencies{ };
+        auto emit = [&lengthSymbols, &lengthFrequencies](uint8_t symbol, uint8_t extra)
+        {
+            lengthSymbols.emplace_back(symbol, extra);
+            lengthFrequencies[symbol]++;
+        };
+        for (size_t i = 0; i < lengthCount;)
+        {
+            uint8_t current = lengths[i];
+            size_t run = 1;
+            while (i + run < lengthCount && lengths[i + run] == current) run++;
+            i += run;
+
+            if (current == 0)
+            {
+                for (; run >= 11; run -= std::min(run, (size_t)138))
+                    emit(18, uint8_t(std::min(run, (size_t)138) - 11));
+                if (run >= 3)
+                {
+                    emit(17, uint8_t(run - 3));
+                    run = 0;
+                }
+            }
+            else
+            {
+                emit(current, 0);
+                run--;
+                for (; run >= 3; run -= std::min(run, (size_t)6))
+                    emit(16, uint8_t(std::min(run, (size_t)6) - 3));
+            }
+            for (; run > 0; run--)
+                emit(current, 0);
+        }
+
+        constexpr uint8_t LengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+        uint8_t lengthLengths[19];
+        BuildHuffmanLengths(lengthFrequencies.data(), 19, DeflateMaxCodeLengthLength, lengthLengths);
+        size_t lengthLengthCount = 19;
+        while (lengthLengthCount > 4 && lengthLengths[LengthOrder[lengthLengthCount - 1]] == 0) lengthLengthCount--;
+
+        HuffmanCode literalCodes[DeflateLiteralCodeCount], distanceCodes[DeflateDistanceCodeCount], lengthCodes[19];
+        BuildHuffmanCodes(literalLengths, literalCount, literalCodes);
+        BuildHuffmanCodes(distanceLengths, distanceCount, distanceCodes);
+        BuildHuffmanCodes(lengthLengths, 19, lengthCodes);
+
+        writer.Write(isFinal ? 1 : 0, 1);
+        writer.Write(2, 2);
+        writer.Write(uint32_t(literalCount - 257), 5);
+        writer.Write(uint32_t(distanceCount - 1), 5);
+        writer.Write(uint32_t(lengthLengthCount - 4), 4);
+        for (size_t i = 0; i < lengthLengthCount; i++)
+            writer.Write(lengthLengths[LengthOrder[i]], 3);
+
+        constexpr uint8_t RepeatExtraBits[3] = { 2, 3, 7 };
+        for (auto [symbol, extra] : lengthSymbols)
+        {
+            writer.Write(lengthCodes[symbol]);
+            if (symbol >= 16) writer.Write(extra, RepeatExtraBits[symbol - 16]);
+        }
+
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            const auto& symbol = symbols[i];
+            if (symbol.Distance == 0)
+            {
+                writer.Write(literalCodes[symbol.LengthOrLiteral]);
+            }
+            else
+            {
+                size_t length = symbol.LengthOrLiteral;
+                writer.Write(literalCodes[tables.LengthCode[length]]);
+                writer.Write(uint32_t(length - tables.LengthBase[length]), tables.LengthExtraBits[length]);
+
+                uint32_t distanceCode = tables.GetDistanceCode(symbol.Distance);
+                writer.Write(distanceCodes[distanceCode]);
+                writer.Write(symbol.Distance - tables.DistanceBase[distanceCode], tables.DistanceExtraBits[distanceCode]);
+            }
+        }
+        writer.Write(literalCodes[256]);
+    }
+
+    static size_t CountMatchingBytes(const uint8_t* a, const uint8_t* b, size_t maxLength)
+    {
+        size_t length = 0;
+        for (; length + 8 <= maxLength; length += 8)
+        {
+            uint64_t x, y;
+            std::memcpy(&x, a + length, sizeof(x));
+            std::memcpy(&y, b + length, sizeof(y));
+            uint64_t difference = x ^ y;
+            if (difference != 0)
+            {
+                // first different byte is the lowest one on little-endian platforms
+            #if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long index;
+                _BitScanForward64(&index, difference);
+                return length + index / 8;
+            #else
+                return length + (size_t)__builtin_ctzll(difference) / 8;
+            #endif
+            }
+        }
+        while (length < maxLength && a[length] == b[length]) length++;
+        return length;
+    }
+
+    /*!
+    LZ77 matcher with hash chains over 32KB window. Positions are stored as band offsets, chain links are kept in ring buffer
+    */
+    class DeflateMatcher
+    {
+        const uint8_t* data;
+        size_t size;
+        const DeflateSettings& settings;
+        MxVector<int32_t> head;
+        MxVector<int32_t> previous;
+
+        uint32_t Hash(size_t position) const
+        {
+            uint32_t value = data[position] | (data[position + 1] << 8) | (data[position + 2] << 16);
+            return (value * 2654435761u) >> (32 - DeflateHashBits);
+        }
+    public:
+        DeflateMatcher(const uint8_t* data, size_t size, const DeflateSettings& settings)
+            : data(data), size(size), settings(settings), head(1 << DeflateHashBits, -1), previous(DeflateWindowSize) { }
+
+        void Insert(size_t position)
+        {
+            uint32_t hash = this->Hash(position);
+            this->previous[position & (DeflateWindowSize - 1)] = this->head[hash];
+            this->head[hash] = (int32_t)position;
+        }
+
+        std::pair<size_t, size_t> FindMatch(size_t position) const
+        {
+            size_t bestLength = 0, bestDistance = 0;
+            size_t maxLength = std::min(DeflateMaxMatch, this->size - position);
+            int32_t candidate = this->head[this->Hash(position)];
+            for (size_t depth = this->settings.ChainDepth; candidate >= 0 && depth > 0; depth--)
+            {
+                size_t distance = position - (size_t)candidate;
+                if (distance > DeflateWindowSize) break;
+
+                const uint8_t* match = this->data + candidate;
+                // candidate can only be better if it matches byte at current best length
+                if (match[bestLength] == this->data[position + bestLength])
+                {
+                    size_t length = CountMatchingBytes(match, this->data + position, maxLength);
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length == maxLength) break;
+                    }
+                }
+
+                int32_t next = this->previous[(size_t)candidate & (DeflateWindowSize - 1)];
+                if (next >= candidate) break;
+                candidate = next;
+            }
+            return { bestLength, bestDistance };
+        }
+    };
+
+    /*!
+    compresses band of filtered rows into independent sequence of deflate blocks. Non-final band ends with empty stored block,
+    so next band starts at byte boundary and can be simply appended to it
+    */
+    static void DeflateBand(const uint8_t* data, size_t size, const DeflateSettings& settings, bool isFinal, MxVector<uint8_t>& output)
+    {
+        DeflateMatcher matcher(data, size, settings);
+        DeflateBitWriter writer(output);
+        MxVector<DeflateSymbol> symbols;
+        symbols.reserve(DeflateBlockSymbols);
+
+        auto push = [&](DeflateSymbol symbol)
+        {
+            symbols.push_back(symbol);
+            if (symbols.size() == DeflateBlockSymbols)
+            {
+                WriteDynamicBlock(writer, symbols.data(), symbols.size(), false);
+                symbols.clear();
+            }
+        };
+
+        constexpr size_t MaxLazyLength = 32;
+        for (size_t position = 0; position < size;)
+        {
+            std::pair<size_t, size_t> match{ 0, 0 };
+            if (position + DeflateMinMatch <= size)
+            {
+                match = matcher.FindMatch(position);
+                matcher.Insert(position);
+            }
+
+            if (match.first >= DeflateMinMatch && settings.LazyMatching && match.first < MaxLazyLength && position + 1 + DeflateMinMatch <= size)
+            {
+                // if next position has longer match, current byte is emitted as literal
+                if (matcher.FindMatch(position + 1).first > match.first)
+                    match.first = 0;
+            }
+
+            if (match.first >= DeflateMinMatch)
+            {
+                push(DeflateSymbol{ (uint16_t)match.first, (uint16_t)match.second });
+                if (settings.InsertAllPositions)
+                {
+                    size_t end = std::min(position + match.first, size - DeflateMinMatch + 1);
+                    for (size_t i = position + 1; i < end; i++)
+                        matcher.Insert(i);
+                }
+                position += match.first;
+            }
+            else
+            {
+                push(DeflateSymbol{ data[position], 0 });
+                position++;
+            }
+        }
+
+        if (!symbols.empty() || isFinal)
+            WriteDynamicBlock(writer, symbols.data(), symbols.size(), isFinal);
+        if (!isFinal)
+        {
+            writer.Write(0, 3);
+            writer.AlignToByte();
+            writer.Write(0xFFFF0000u, 32);
+        }
+        writer.Flush();
+    }
+
+    static uint32_t ComputeAdler32(const uint8_t* data, size_t size)
+    {
+        constexpr uint32_t Base = 65521;
+        constexpr size_t MaxChunk = 5552; // largest chunk for which sums do not overflow 32 bits
+        uint32_t a = 1, b = 0;
+        while (size > 0)
+        {
+            size_t chunk = std::min(size, MaxChunk);
+            for (size_t i = 0; i < chunk; i++)
+            {
+                a += data[i];
+                b += a;
+            }
+            a %= Base;
+            b %= Base;
+            data += chunk;
+            size -= chunk;
+        }
+        return (b << 16) | a;
+    }
+
+    /*!
+    computes Adler-32 of concatenated data from checksums of its parts (zlib adler32_combine)
+    */
+    static uint32_t CombineAdler32(uint32_t first, uint32_t second, size_t secondSize)
+    {
+        constexpr uint32_t Base = 65521;
+        uint32_t remainder = uint32_t(secondSize % Base);
+        uint32_t sum1 = first & 0xFFFF;
+        uint32_t sum2 = uint32_t((uint64_t)remainder * sum1 % Base);
+        sum1 += (second & 0xFFFF) + Base - 1;
+        sum2 += (first >> 16) + (second >> 16) + Base - remainder;
+        if (sum1 >= Base) sum1 -= Base;
+        if (sum1 >= Base) sum1 -= Base;
+        if (sum2 >= 2 * Base) sum2 -= 2 * Base;
+        if (sum2 >= Base) sum2 -= Base;
+        return (sum2 << 16) | sum1;
+    }
+
+    struct Crc32Table
+    {
+        uint32_t Values[8][256];
+
+        Crc32Table()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t value = i;
+                for (size_t bit = 0; bit < 8; bit++)
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                this->Values[0][i] = value;
+            }
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                for (size_t slice = 1; slice < 8; slice++)
+                    this->Values[slice][i] = (this->Values[slice - 1][i] >> 8) ^ this->Values[0][this->Values[slice - 1][i] & 0xFF];
+            }
+        }
+    };
+
+    /*!
+    updates CRC-32 of PNG chunk. Data is processed by 8 bytes using slicing tables
+    */
+    static uint32_t UpdateCrc32(uint32_t crc, const uint8_t* data, size_t size)
+    {
+        static Crc32Table table;
+        const auto& values = table.Values;
+        crc = ~crc;
+        for (; size >= 8; size -= 8, data += 8)
+        {
+            uint32_t low = (data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24)) ^ crc;
+            uint32_t high = data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t)data[7] << 24);
+            crc = values[7][low & 0xFF] ^ values[6][(low >> 8) & 0xFF] ^ values[5][(low >> 16) & 0xFF] ^ values[4][low >> 24] ^
+                  values[3][high & 0xFF] ^ values[2][(high >> 8) & 0xFF] ^ values[1][(high >> 16) & 0xFF] ^ values[0][high >> 24];
+        }
+        for (; size > 0; size--, data++)
+            crc = values[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static uint8_t PaethPredictor(int a, int b, int c)
+    {
+        int p = a + b - c;
+        int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return (uint8_t)a;
+        return pb <= pc ? (uint8_t)b : (uint8_t)c;
+    }
+
+    /*!
+    applies PNG filter to one row
+    \param previous previous row or nullptr for the first row of image
+    \param destination filter type byte followed by filtered row
+    */
+    static void FilterRow(const uint8_t* row, const uint8_t* previous, size_t rowByteSize, size_t pixelSize, uint8_t filter, uint8_t* destination)
+    {
+        destination[0] = filter;
+        uint8_t* out = destination + 1;
+        switch (filter)
+        {
+        case 0:
+            std::memcpy(out, row, rowByteSize);
+            break;
+        case 1:
+            for (size_t i = 0; i < pixelSize; i++) out[i] = row[i];
+            for (size_t i = pixelSize; i < rowByteSize; i++) out[i] = uint8_t(row[i] - row[i - pixelSize]);
+            break;
+        case 2:
+            for (size_t i = 0; i < rowByteSize; i++) out[i] = uint8_t(row[i] - (previous != nullptr ? previous[i] : 0));
+            break;
+        case 3:
+            for (size_t i = 0; i < rowByteSize; i++)
+            {
+                int left = i >= pixelSize ? row[i - pixelSize] : 0;
+                int up = previous != nullptr ? previous[i] : 0;
+                out[i] = uint8_t(row[i] - ((left + up) >> 1));
+            }
+            break;
+        default:
+            for (size_t i = 0; i < rowByteSize; i++)
+            {
+                int left = i >= pixelSize ? row[i - pixelSize] : 0;
+                int up = previous != nullptr ? previous[i] : 0;
+                int upLeft = previous != nullptr && i >= pixelSize ? previous[i - pixelSize] : 0;
+                out[i] = uint8_t(row[i] - PaethPredictor(left, up, upLeft));
+            }
+            break;
+        }
+    }
+
+    /*!
+    selects filter with minimal sum of absolute values of filtered bytes, which is standard heuristic of libpng
+    */
+    static void FilterRowAdaptive(const uint8_t* row, const uint8_t* previous, size_t rowByteSize, size_t pixelSize, uint8_t* destination, MxVector<uint8_t>& buffer)
+    {
+        buffer.resize(rowByteSize + 1);
+        uint64_t bestScore = std::numeric_limits<uint64_t>::max();
+        for (uint8_t filter = 0; filter < 5; filter++)
+        {
+            uint8_t* candidate = filter == 0 ? destination : buffer.data();
+            FilterRow(row, previous, rowByteSize, pixelSize, filter, candidate);
+
+            uint64_t score = 0;
+            for (size_t i = 1; i <= rowByteSize; i++)
+                score += (uint64_t)std::abs((int)(int8_t)candidate[i]);
+            if (score < bestScore)
+            {
+                bestScore = score;
+                if (candidate != destination) std::memcpy(destination, candidate, rowByteSize + 1);
+            }
+        }
+    }
+
+    static void WriteBigEndian(uint8_t* destination, uint32_t value)
+    {
+        destination[0] = uint8_t(value >> 24);
+        destination[1] = uint8_t(value >> 16);
+        destination[2] = uint8_t(value >> 8);
+        destination[3] = uint8_t(value);
+    }
+
+    static void AppendPngChunk(MxVector<uint8_t>& output, const char* type, const uint8_t* data, size_t size)
+    {
+        size_t offset = output.size();
+        output.resize(offset + size + 12);
+        uint8_t* chunk = output.data() + offset;
+        WriteBigEndian(chunk, (uint32_t)size);
+        std::memcpy(chunk + 4, type, 4);
+        if (size > 0) std::memcpy(chunk + 8, data, size);
+        WriteBigEndian(chunk + 8 + size, UpdateCrc32(0, chunk + 4, size + 4));
+    }
+
+    struct PngBand
+    {
+        MxVector<uint8_t> Data;
+        uint32_t Checksum = 1;
+        size_t FilteredSize = 0;
+    };
+
+    /*!
+    filters and compresses rows [firstRow, firstRow + rowCount) in parallel bands. Previous row of each band is taken from getRow(),
+    so filters are the same as in sequential encoder. Row before firstRow must be accessible if firstRow is not zero
+    \param isLastStrip if last band should end zlib stream with final deflate block
+    */
+    template<typename GetRow>
+    static MxVector<PngBand> CompressPngRows(const GetRow& getRow, size_t firstRow, size_t rowCount, size_t rowByteSize, size_t channels,
+        const DeflateSettings& settings, bool isLastStrip)
+    {
+        size_t rowsPerBand = std::max(ImageEncoder::BandByteSize / (rowByteSize + 1), (size_t)1);
+        size_t bandCount = (rowCount + rowsPerBand - 1) / rowsPerBand;
+
+        MxVector<PngBand> bands(bandCount);
+        ThreadPool::ParallelFor(bandCount, 1, [&](size_t begin, size_t end)
+        {
+            MxVector<uint8_t> filtered, buffer;
+            for (size_t band = begin; band < end; band++)
+            {
+                size_t bandFirstRow = firstRow + band * rowsPerBand;
+                size_t bandRowCount = std::min(rowsPerBand, firstRow + rowCount - bandFirstRow);
+                filtered.resize(bandRowCount * (rowByteSize + 1));
+                for (size_t i = 0; i < bandRowCount; i++)
+                {
+                    size_t y = bandFirstRow + i;
+                    const uint8_t* previous = y > 0 ? getRow(y - 1) : nullptr;
+                    uint8_t* destination = filtered.data() + i * (rowByteSize + 1);
+                    if (settings.AdaptiveFilter)
+                        FilterRowAdaptive(getRow(y), previous, rowByteSize, channels, destination, buffer);
+                    else
+                        FilterRow(getRow(y), previous, rowByteSize, channels, y > 0 ? 2 : 1, destination);
+                }
+
+                auto& result = bands[band];
+                result.Checksum = ComputeAdler32(filtered.data(), filtered.size());
+                result.FilteredSize = filtered.size();
+                result.Data.reserve(filtered.size() / 2);
+                DeflateBand(filtered.data(), filtered.size(), settings, isLastStrip && band + 1 == bandCount, result.Data);
+            }
+        });
+        return bands;
+    }
+
+    static void AppendPngHeader(MxVector<uint8_t>& output, size_t width, size_t height, size_t channels)
+    {
+        const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        output.insert(output.end(), signature, signature + 8);
+
+        constexpr uint8_t ColorTypes[4] = { 0, 4, 2, 6 }; // grey, grey alpha, RGB, RGBA
+        uint8_t header[13];
+        WriteBigEndian(header + 0, (uint32_t)width);
+        WriteBigEndian(header + 4, (uint32_t)height);
+        header[8] = 8;
+        header[9] = ColorTypes[channels - 1];
+        header[10] = header[11] = header[12] = 0;
+        AppendPngChunk(output, "IHDR", header, sizeof(header));
+    }
+
+    ImageEncoder::RawImageData ImageEncoder::EncodePNG(const uint8_t* data, size_t width, size_t height, size_t channels, PngCompression compression, bool flipOnSave)
+    {
+        MAKE_SCOPE_PROFILER("ImageEncoder::EncodePNG()");
+        MX_ASSERT(channels >= 1 && channels <= 4);
+        if (data == nullptr || width == 0 || height == 0) return { };
+
+        auto settings = GetDeflateSettings(compression);
+        size_t rowByteSize = width * channels;
+        auto getRow = [=](size_t y) { return data + (flipOnSave ? height - 1 - y : y) * rowByteSize; };
+        auto bands = CompressPngRows(getRow, 0, height, rowByteSize, channels, settings, true);
+        size_t bandCount = bands.size();
+
+        uint32_t checksum = bands[0].Checksum;
+        for (size_t band = 1; band < bandCount; band++)
+            checksum = CombineAdler32(checksum, bands[band].Checksum, bands[band].FilteredSize);
+
+        // each band is stored as separate IDAT chunk. Zlib header is added to the first one, checksum to the last one
+        const uint8_t zlibHeader[2] = { 0x78, settings.HeaderLevel };
+        uint8_t zlibChecksum[4];
+        WriteBigEndian(zlibChecksum, checksum);
+        bands.front().Data.insert(bands.front().Data.begin(), zlibHeader, zlibHeader + 2);
+        bands.back().Data.insert(bands.back().Data.end(), zlibChecksum, zlibChecksum + 4);
+
+        RawImageData result;
+        AppendPngHeader(result, width, height, channels);
+
+        MxVector<size_t> offsets(bandCount + 1, result.size());
+        for (size_t band = 0; band < bandCount; band++)
+            offsets[band + 1] = offsets[band] + bands[band].Data.size() + 12;
+        result.resize(offsets.back());
+
+        ThreadPool::ParallelFor(bandCount, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t band = begin; band < end; band++)
+            {
+                uint8_t* chunk = result.data() + offsets[band];
+                auto& bandData = bands[band].Data;
+                size_t size = bandData.size();
+                WriteBigEndian(chunk, (uint32_t)size);
+                std::memcpy(chunk + 4, "IDAT", 4);
+                std::memcpy(chunk + 8, bandData.data(), size);
+                WriteBigEndian(chunk + 8 + size, UpdateCrc32(0, chunk + 4, size + 4));
+                MxVector<uint8_t>().swap(bandData);
+            }
+        });
+        AppendPngChunk(result, "IEND", nullptr, 0);
+        return result;
+    }
+
+    PngStreamEncoder::PngStreamEncoder(size_t width, size_t height, size_t channels, PngCompression compression, OutputCallback output)
+        : output(std::move(output)), width(width), height(height), channels(channels), compression(compression)
+    {
+        MX_ASSERT(channels >= 1 && channels <= 4);
+        MX_ASSERT(width > 0 && height > 0);
+
+        MxVector<uint8_t> header;
+        AppendPngHeader(header, width, height, channels);
+        this->output(header.data(), header.size());
+    }
+
+    void PngStreamEncoder::WriteRows(const uint8_t* data, size_t rowCount, bool flipRows)
+    {
+        MAKE_SCOPE_PROFILER("PngStreamEncoder::WriteRows()");
+        rowCount = std::min(rowCount, this->height - this->writtenRows);
+        if (data == nullptr || rowCount == 0) return;
+
+        auto settings = GetDeflateSettings(this->compression);
+        size_t rowByteSize = this->width * this->channels;
+        size_t firstRow = this->writtenRows;
+        bool isLastStrip = firstRow + rowCount == this->height;
+        // rows of previous strips are already encoded, so only the last one is kept for filtering
+        const uint8_t* previousRow = this->previousRow.data();
+        auto getRow = [=](size_t y)
+        {
+            if (y < firstRow) return previousRow;
+            size_t row = y - firstRow;
+            return data + (flipRows ? rowCount - 1 - row : row) * rowByteSize;
+        };
+        auto bands = CompressPngRows(getRow, firstRow, rowCount, rowByteSize, this->channels, settings, isLastStrip);
+
+        MxVector<uint8_t> chunk;
+        for (size_t band = 0; band < bands.size(); band++)
+        {
+            auto& bandData = bands[band].Data;
+            this->checksum = firstRow == 0 && band == 0 ?
+                bands[band].Checksum : CombineAdler32(this->checksum, bands[band].Checksum, bands[band].FilteredSize);
+
+            if (firstRow == 0 && band == 0)
+            {
+                const uint8_t zlibHeader[2] = { 0x78, settings.HeaderLevel };
+                bandData.insert(bandData.begin(), zlibHeader, zlibHeader + 2);
+            }
+            if (isLastStrip && band + 1 == bands.size())
+            {
+                uint8_t zlibChecksum[4];
+                WriteBigEndian(zlibChecksum, this->checksum);
+                bandData.insert(bandData.end(), zlibChecksum, zlibChecksum + 4);
+            }
+
+            chunk.clear();
+            AppendPngChunk(chunk, "IDAT", bandData.data(), bandData.size());
+            if (isLastStrip && band + 1 == bands.size())
+                AppendPngChunk(chunk, "IEND", nullptr, 0);
+            this->output(chunk.data(), chunk.size());
+            MxVector<uint8_t>().swap(bandData);
+        }
+
+        const uint8_t* lastRow = getRow(firstRow + rowCount - 1);
+        this->previousRow.assign(lastRow, lastRow + rowByteSize);
+        this->writtenRows += rowCount;
+    }
+
+    size_t PngStreamEncoder::GetWrittenRows() const
+    {
+        return this->writtenRows;
+    }
+
+    bool PngStreamEncoder::IsFinished() const
+    {
+        return this->writtenRows == this->height;
+    }
+
+    constexpr uint8_t JpegZigZag[64] =
+    {
+         0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    };
+
+    constexpr uint8_t JpegLuminanceQuantization[64] =
+    {
+        16, 11, 10, 16,  24,  40,  51,  61,
+        12, 12, 14, 19,  26,  58,  60,  55,
+        14, 13, 16, 24,  40,  57,  69,  56,
+        14, 17, 22, 29,  51,  87,  80,  62,
+        18, 22, 37, 56,  68, 109, 103,  77,
+        24, 35, 55, 64,  81, 104, 113,  92,
+        49, 64, 78, 87, 103, 121, 120, 101,
+        72, 92, 95, 98, 112, 100, 103,  99,
+    };
+
+    constexpr uint8_t JpegChrominanceQuantization[64] =
+    {
+        17, 18, 24, 47, 99, 99, 99, 99,
+        18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99,
+        47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+    };
+
+    // standard huffman tables from JPEG specification (annex K.3): number of codes of each length followed by symbols
+    constexpr uint8_t JpegLuminanceDCBits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+    constexpr uint8_t JpegChrominanceDCBits[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+    constexpr uint8_t JpegDCValues[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+    constexpr uint8_t JpegLuminanceACBits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D };
+    constexpr uint8_t JpegLuminanceACValues[162] =
+    {
+        0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+        0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+        0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+        0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+        0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+        0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+        0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+        0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+        0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+        0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+        0xF9, 0xFA,
+    };
+
+    constexpr uint8_t JpegChrominanceACBits[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+    constexpr uint8_t JpegChrominanceACValues[162] =
+    {
+        0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+        0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+        0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+        0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+        0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+        0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+        0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+        0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+        0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+        0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+        0xF9, 0xFA,
+    };
+
+    /*!
+    huffman codes of one JPEG table, indexed by symbol
+    */
+    struct JpegHuffmanTable
+    {
+        HuffmanCode Codes[256];
+
+        JpegHuffmanTable(const uint8_t* bits, const uint8_t* values)
+        {
+            uint16_t code = 0;
+            size_t index = 0;
+            for (size_t length = 1; length <= 16; length++, code <<= 1)
+            {
+                for (size_t i = 0; i < bits[length - 1]; i++, code++)
+                {
+                    this->Codes[values[index]].Code = code;
+                    this->Codes[values[index]].Length = (uint8_t)length;
+                    index++;
+                }
+            }
+        }
+    };
+
+    struct JpegTables
+    {
+        JpegHuffmanTable LuminanceDC{ JpegLuminanceDCBits, JpegDCValues };
+        JpegHuffmanTable LuminanceAC{ JpegLuminanceACBits, JpegLuminanceACValues };
+        JpegHuffmanTable ChrominanceDC{ JpegChrominanceDCBits, JpegDCValues };
+        JpegHuffmanTable ChrominanceAC{ JpegChrominanceACBits, JpegChrominanceACValues };
+    };
+
+    static const JpegTables& GetJpegTables()
+    {
+        static JpegTables tables;
+        return tables;
+    }
+
+    /*!
+    writes bits in JPEG order (most significant bit first). Each 0xFF byte of entropy-coded data is followed by zero byte
+    */
+    class JpegBitWriter
+    {
+        MxVector<uint8_t>& output;
+        uint32_t bits = 0;
+        size_t bitCount = 0;
+    public:
+        JpegBitWriter(MxVector<uint8_t>& output) : output(output) { }
+
+        void Write(uint32_t value, size_t length)
+        {
+            this->bitCount += length;
+            this->bits |= value << (24 - this->bitCount);
+            while (this->bitCount >= 8)
+            {
+                uint8_t byte = uint8_t(this->bits >> 16);
+                this->output.push_back(byte);
+                if (byte == 0xFF) this->output.push_back(0);
+                this->bits <<= 8;
+                this->bitCount -= 8;
+            }
+        }
+
+        void Write(HuffmanCode code)
+        {
+            this->Write(code.Code, code.Length);
+        }
+
+        void Flush()
+        {
+            // remaining bits of last byte are filled with ones
+            this->Write(0x7F, 7);
+            this->bits = 0;
+            this->bitCount = 0;
+        }
+    };
+
+    /*!
+    in-place 8-point forward DCT (AAN algorithm, as in libjpeg jfdctflt). Outputs are scaled by AAN factors, which are compensated during quantization
+    */
+    static void ForwardDCT(float* data, size_t stride)
+    {
+        float* d0 = data;
+        float* d1 = data + 1 * stride;
+        float* d2 = data + 2 * stride;
+        float* d3 = data + 3 * stride;
+        float* d4 = data + 4 * stride;
+        float* d5 = data + 5 * stride;
+        float* d6 = data + 6 * stride;
+        float* d7 = data + 7 * stride;
+
+        float tmp0 = *d0 + *d7, tmp7 = *d0 - *d7;
+        float tmp1 = *d1 + *d6, tmp6 = *d1 - *d6;
+        float tmp2 = *d2 + *d5, tmp5 = *d2 - *d5;
+        float tmp3 = *d3 + *d4, tmp4 = *d3 - *d4;
+
+        float tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3;
+        float tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+        *d0 = tmp10 + tmp11;
+        *d4 = tmp10 - tmp11;
+        float z1 = (tmp12 + tmp13) * 0.707106781f;
+        *d2 = tmp13 + z1;
+        *d6 = tmp13 - z1;
+
+        tmp10 = tmp4 + tmp5;
+        tmp11 = tmp5 + tmp6;
+        tmp12 = tmp6 + tmp7;
+        float z5 = (tmp10 - tmp12) * 0.382683433f;
+        float z2 = tmp10 * 0.541196100f + z5;
+        float z4 = tmp12 * 1.306562965f + z5;
+        float z3 = tmp11 * 0.707106781f;
+        float z11 = tmp7 + z3, z13 = tmp7 - z3;
+        *d5 = z13 + z2;
+        *d3 = z13 - z2;
+        *d1 = z11 + z4;
+        *d7 = z11 - z4;
+    }
+
+    /*!
+    quantization tables of JPEG file, scaled by quality. Divisors include AAN scale factors of DCT
+    */
+    struct JpegQuantization
+    {
+        uint8_t Luminance[64];
+        uint8_t Chrominance[64];
+        float LuminanceDivisors[64];
+        float ChrominanceDivisors[64];
+
+        JpegQuantization(int quality)
+        {
+            constexpr float AANScale[8] = { 1.0f, 1.387039845f, 1.306562965f, 1.175875602f, 1.0f, 0.785694958f, 0.541196100f, 0.275899379f };
+            int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+            for (size_t i = 0; i < 64; i++)
+            {
+                this->Luminance[i] = (uint8_t)Clamp((JpegLuminanceQuantization[i] * scale + 50) / 100, 1, 255);
+                this->Chrominance[i] = (uint8_t)Clamp((JpegChrominanceQuantization[i] * scale + 50) / 100, 1, 255);
+                float factor = AANScale[i / 8] * AANScale[i % 8] * 8.0f;
+                this->LuminanceDivisors[i] = 1.0f / (this->Luminance[i] * factor);
+                this->ChrominanceDivisors[i] = 1.0f / (this->Chrominance[i] * factor);
+            }
+        }
+    };
+
+    static int EncodeJpegBlock(JpegBitWriter& writer, float* block, const float* divisors, int previousDC, const JpegHuffmanTable& dcTable, const JpegHuffmanTable& acTable)
+    {
+        for (size_t row = 0; row < 8; row++)
+            ForwardDCT(block + row * 8, 1);
+        for (size_t column = 0; column < 8; column++)
+            ForwardDCT(block + column, 8);
+
+        int coefficients[64];
+        for (size_t i = 0; i < 64; i++)
+        {
+            float value = block[JpegZigZag[i]] * divisors[JpegZigZag[i]];
+            coefficients[i] = (int)(value < 0.0f ? value - 0.5f : value + 0.5f);
+        }
+
+        // values are written as category (number of bits) followed by bits, negative values are stored as value - 1
+        auto getCategory = [](int value)
+        {
+            uint32_t magnitude = (uint32_t)std::abs(value), category = 0;
+            for (; magnitude != 0; magnitude >>= 1) category++;
+            return category;
+        };
+        auto getBits = [](int value, uint32_t category)
+        {
+            return uint32_t(value < 0 ? value - 1 : value) & ((1u << category) - 1);
+        };
+
+        int difference = coefficients[0] - previousDC;
+        uint32_t category = getCategory(difference);
+        writer.Write(dcTable.Codes[category]);
+        if (category > 0) writer.Write(getBits(difference, category), category);
+
+        size_t last = 63;
+        while (last > 0 && coefficients[last] == 0) last--;
+        size_t zeros = 0;
+        for (size_t i = 1; i <= last; i++)
+        {
+            if (coefficients[i] == 0)
+            {
+                zeros++;
+                continue;
+            }
+            // runs longer than 15 zeros are split by special symbol
+            for (; zeros >= 16; zeros -= 16)
+                writer.Write(acTable.Codes[0xF0]);
+
+            category = getCategory(coefficients[i]);
+            writer.Write(acTable.Codes[(zeros << 4) | category]);
+            writer.Write(getBits(coefficients[i], category), category);
+            zeros = 0;
+        }
+        if (last < 63) writer.Write(acTable.Codes[0x00]);
+        return coefficients[0];
+    }
+
+    static void AppendJpegMarker(MxVector<uint8_t>& output, uint8_t marker, const MxVector<uint8_t>& data)
+    {
+        size_t length = data.size() + 2;
+        const uint8_t header[4] = { 0xFF, marker, uint8_t(length >> 8), uint8_t(length) };
+        output.insert(output.end(), header, header + 4);
+        output.insert(output.end(), data.begin(), data.end());
+    }
+
+    ImageEncoder::RawImageData ImageEncoder::EncodeJPG(const uint8_t* data, size_t width, size_t height, size_t channels, int quality, bool flipOnSave)
+    {
+        MAKE_SCOPE_PROFILER("ImageEncoder::EncodeJPG()");
+        MX_ASSERT(channels >= 1 && channels <= 4);
+        if (data == nullptr || width == 0 || height == 0) return { };
+        if (width > 0xFFFF || height > 0xFFFF)
+        {
+            MXLOG_ERROR("MxEngine::ImageEncoder", MxFormat("cannot encode {0}x{1} image as JPEG, maximal size is 65535x65535", width, height));
+            return { };
+        }
+
+        quality = Clamp(quality, 1, 100);
+        JpegQuantization quantization(quality);
+        const auto& tables = GetJpegTables();
+        bool subsample = quality <= 90;
+        size_t mcuSize = subsample ? 16 : 8;
+        size_t mcuCountX = (width + mcuSize - 1) / mcuSize;
+        size_t mcuCountY = (height + mcuSize - 1) / mcuSize;
+
+        // restart interval is 16-bit number of MCUs, so band is also limited by that
+        size_t mcuRowsPerBand = std::max(ImageEncoder::BandByteSize / (mcuCountX * mcuSize * mcuSize * channels), (size_t)1);
+        mcuRowsPerBand = std::max(std::min(mcuRowsPerBand, (size_t)0xFFFF / mcuCountX), (size_t)1);
+        size_t bandCount = (mcuCountY + mcuRowsPerBand - 1) / mcuRowsPerBand;
+
+        auto loadBlock = [=](size_t blockX, size_t blockY, size_t size, float* Y, float* U, float* V)
+        {
+            for (size_t y = 0; y < size; y++)
+            {
+                size_t sourceY = std::min(blockY + y, height - 1);
+                const uint8_t* row = data + (flipOnSave ? height - 1 - sourceY : sourceY) * width * channels;
+                for (size_t x = 0; x < size; x++)
+                {
+                    const uint8_t* pixel = row + std::min(blockX + x, width - 1) * channels;
+                    float r = pixel[0], g = channels >= 3 ? pixel[1] : r, b = channels >= 3 ? pixel[2] : r;
+                    size_t index = y * size + x;
+                    Y[index] = +0.29900f * r + 0.58700f * g + 0.11400f * b - 128.0f;
+                    U[index] = -0.16874f * r - 0.33126f * g + 0.50000f * b;
+                    V[index] = +0.50000f * r - 0.41869f * g - 0.08131f * b;
+                }
+            }
+        };
+
+        MxVector<MxVector<uint8_t>> bands(bandCount);
+        ThreadPool::ParallelFor(bandCount, 1, [&](size_t begin, size_t end)
+        {
+            float Y[256], U[256], V[256], block[64];
+            for (size_t band = begin; band < end; band++)
+            {
+                // DC prediction is reset after restart marker, so each band starts from zero
+                int dcY = 0, dcU = 0, dcV = 0;
+                auto& output = bands[band];
+                JpegBitWriter writer(output);
+                size_t lastRow = std::min((band + 1) * mcuRowsPerBand, mcuCountY);
+                for (size_t mcuY = band * mcuRowsPerBand; mcuY < lastRow; mcuY++)
+                {
+                    for (size_t mcuX = 0; mcuX < mcuCountX; mcuX++)
+                    {
+                        loadBlock(mcuX * mcuSize, mcuY * mcuSize, mcuSize, Y, U, V);
+                        if (subsample)
+                        {
+                            for (size_t i = 0; i < 4; i++)
+                            {
+                                size_t offsetX = (i % 2) * 8, offsetY = (i / 2) * 8;
+                                for (size_t y = 0; y < 8; y++)
+                                    std::memcpy(block + y * 8, Y + (offsetY + y) * 16 + offsetX, 8 * sizeof(float));
+                                dcY = EncodeJpegBlock(writer, block, quantization.LuminanceDivisors, dcY, tables.LuminanceDC, tables.LuminanceAC);
+                            }
+                            for (size_t y = 0; y < 8; y++)
+                            {
+                                for (size_t x = 0; x < 8; x++)
+                                {
+                                    size_t index = 2 * y * 16 + 2 * x;
+                                    block[y * 8 + x] = (U[index] + U[index + 1] + U[index + 16] + U[index + 17]) * 0.25f;
+                                }
+                            }
+                            dcU = EncodeJpegBlock(writer, block, quantization.ChrominanceDivisors, dcU, tables.ChrominanceDC, tables.ChrominanceAC);
+                            for (size_t y = 0; y < 8; y++)
+                            {
+                                for (size_t x = 0; x < 8; x++)
+                                {
+                                    size_t index = 2 * y * 16 + 2 * x;
+                                    block[y * 8 + x] = (V[index] + V[index + 1] + V[index + 16] + V[index + 17]) * 0.25f;
+                                }
+                            }
+                            dcV = EncodeJpegBlock(writer, block, quantization.ChrominanceDivisors, dcV, tables.ChrominanceDC, tables.ChrominanceAC);
+                        }
+                        else
+                        {
+                            dcY = EncodeJpegBlock(writer, Y, quantization.LuminanceDivisors, dcY, tables.LuminanceDC, tables.LuminanceAC);
+                            dcU = EncodeJpegBlock(writer, U, quantization.ChrominanceDivisors, dcU, tables.ChrominanceDC, tables.ChrominanceAC);
+                            dcV = EncodeJpegBlock(writer, V, quantization.ChrominanceDivisors, dcV, tables.ChrominanceDC, tables.ChrominanceAC);
+                        }
+                    }
+                }
+                writer.Flush();
+                if (band + 1 != bandCount)
+                {
+                    output.push_back(0xFF);
+                    output.push_back(uint8_t(0xD0 + band % 8));
+                }
+            }
+        });
+
+        RawImageData result;
+        const uint8_t startOfImage[2] = { 0xFF, 0xD8 };
+        result.insert(result.end(), startOfImage, startOfImage + 2);
+        AppendJpegMarker(result, 0xE0, { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 });
+
+        MxVector<uint8_t> quantizationTables;
+        quantizationTables.push_back(0);
+        for (size_t i = 0; i < 64; i++) quantizationTables.push_back(quantization.Luminance[JpegZigZag[i]]);
+        quantizationTables.push_back(1);
+        for (size_t i = 0; i < 64; i++) quantizationTables.push_back(quantization.Chrominance[JpegZigZag[i]]);
+        AppendJpegMarker(result, 0xDB, quantizationTables);
+
+        uint8_t lumaSampling = subsample ? 0x22 : 0x11;
+        AppendJpegMarker(result, 0xC0, { 8, uint8_t(height >> 8), uint8_t(height), uint8_t(width >> 8), uint8_t(width), 3, 
+            1, lumaSampling, 0, 2, 0x11, 1, 3, 0x11, 1 });
+
+        MxVector<uint8_t> huffmanTables;
+        auto appendHuffmanTable = [&huffmanTables](uint8_t id, const uint8_t* bits, const uint8_t* values)
+        {
+            huffmanTables.push_back(id);
+            huffmanTables.insert(huffmanTables.end(), bits, bits + 16);
+            size_t count = 0;
+            for (size_t i = 0; i < 16; i++) count += bits[i];
+            huffmanTables.insert(huffmanTables.end(), values, values + count);
+        };
+        appendHuffmanTable(0x00, JpegLuminanceDCBits, JpegDCValues);
+        appendHuffmanTable(0x10, JpegLuminanceACBits, JpegLuminanceACValues);
+        appendHuffmanTable(0x01, JpegChrominanceDCBits, JpegDCValues);
+        appendHuffmanTable(0x11, JpegChrominanceACBits, JpegChrominanceACValues);
+        AppendJpegMarker(result, 0xC4, huffmanTables);
+
+        if (bandCount > 1)
+        {
+            size_t restartInterval = mcuRowsPerBand * mcuCountX;
+            AppendJpegMarker(result, 0xDD, { uint8_t(restartInterval >> 8), uint8_t(restartInterval) });
+        }
+        AppendJpegMarker(result, 0xDA, { 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 });
+
+        size_t offset = result.size(), totalSize = 0;
+        for (const auto& band : bands)
+            totalSize += band.size();
+        result.resize(offset + totalSize + 2);
+        for (const auto& band : bands)
+        {
+            std::memcpy(result.data() + offset, band.data(), band.size());
+            offset += band.size();
+        }
+        result[offset + 0] = 0xFF;
+        result[offset + 1] = 0xD9;
+        return result;
+    }
+
+    ImageEncoderBenchmark ImageEncoder::RunBenchmark(size_t width, size_t height)
+    {
+        ImageEncoderBenchmark result;
+        result.Width = width;
+        result.Height = height;
+
+        // smooth shading with low-amplitude noise and hard edges, which is typical for rendered frames
+        size_t channels = 4;
+        MxVector<uint8_t> pixels(width * height * channels);
+        ThreadPool::ParallelFor(height, 64, [&](size_t begin, size_t end)
+        {
+            for (size_t y = begin; y < end; y++)
+            {
+                uint32_t seed = uint32_t(y * 2654435761u);
+                for (size_t x = 0; x < width; x++)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    uint8_t* pixel = pixels.data() + (y * width + x) * channels;
+                    bool isEdge = ((x / 256) + (y / 256)) % 2 == 0;
+                    float shade = 0.5f + 0.5f * std::sin(float(x) * 0.01f) * std::cos(float(y) * 0.013f);
+                    pixel[0] = uint8_t(shade * (isEdge ? 200.0f : 120.0f));
+                    pixel[1] = uint8_t(float(x) * 255.0f / float(width));
+                    pixel[2] = uint8_t(float(y) * 255.0f / float(height) * 0.5f + float(seed >> 29));
+                    pixel[3] = 255;
+                }
+            }
+        });
+
+        auto measure = [&](const char* name, bool isLossless, auto&& encode)
+        {
+            ImageEncoderTiming timing;
+            timing.Name = name;
+            TimeStep start = Time::Current();
+            RawImageData encoded = encode();
+            timing.Time = Time::Current() - start;
+            timing.ByteSize = encoded.size();
+
+            // decoder always returns RGBA pixels, so generated image can be compared directly
+            Image decoded = ImageLoader::LoadImageFromMemory(encoded.data(), encoded.size(), false);
+            if (decoded.GetRawData() != nullptr && decoded.GetWidth() == width && decoded.GetHeight() == height)
+            {
+                const uint8_t* decodedPixels = decoded.GetRawData();
+                for (size_t i = 0; i < pixels.size(); i++)
+                    timing.MaxError = std::max(timing.MaxError, (size_t)std::abs((int)pixels[i] - (int)decodedPixels[i]));
+                // JPEG error is bounded only by quantization, so decoded image is accepted if it is close to source
+                timing.IsValid = isLossless ? timing.MaxError == 0 : timing.MaxError < 64;
+            }
+            result.Encoders.push_back(timing);
+        };
+
+        int w = (int)width, h = (int)height, c = (int)channels;
+        measure("stb png", true, [&]() { return ImageConverter::ConvertImagePNG(pixels.data(), w, h, c, false); });
+        measure("png fast", true, [&]() { return ImageEncoder::EncodePNG(pixels.data(), width, height, channels, PngCompression::FAST, false); });
+        measure("png default", true, [&]() { return ImageEncoder::EncodePNG(pixels.data(), width, height, channels, PngCompression::DEFAULT, false); });
+        measure("png best", true, [&]() { return ImageEncoder::EncodePNG(pixels.data(), width, height, channels, PngCompression::BEST, false); });
+        measure("stb jpg", false, [&]() { return ImageConverter::ConvertImageJPG(pixels.data(), w, h, c, 90, false); });
+        measure("jpg", false, [&]() { return ImageEncoder::EncodeJPG(pixels.data(), width, height, channels, 90, false); });
+
+        const size_t sourceSize = pixels.size();
+        for (const auto& encoder : result.Encoders)
+        {
+            MXLOG_INFO("MxEngine::ImageEncoder", MxFormat("{0}: {1}ms, {2} bytes ({3}% of source), max error {4}{5}", encoder.Name, 
+                encoder.Time * 1000.0f, encoder.ByteSize, 100.0f * float(encoder.ByteSize) / float(sourceSize), encoder.MaxError,
+                encoder.IsValid ? "" : " (invalid)"));
+        }
+        MXLOG_INFO("MxEngine::ImageEncoder", MxFormat("benchmark on {0}x{1} image, {2} threads", width, height, ThreadPool::GetWorkerCount() + 1));
+        return result;
+    }
+}
@@ -0,0 +1,150 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+#include <functional>
+
+namespace MxEngine
+{
+    /*!
+    compression levels of parallel PNG encoder. FAST uses single filter and single hash probe per byte, 
+    DEFAULT selects filter for each row and searches short hash chains, BEST also uses long chains with lazy matching
+    */
+    enum class PngCompression : uint8_t
+    {
+        FAST,
+        DEFAULT,
+        BEST,
+    };
+
+    const char* EnumToString(PngCompression compression);
+
+    /*!
+    timing of one encoder, measured in seconds. Encoded image is decoded back and compared to source image.
+    Error is maximal difference of decoded pixel channels (always zero for lossless formats)
+    */
+    struct ImageEncoderTiming
+    {
+        const char* Name = "";
+        TimeStep Time = 0.0f;
+        size_t ByteSize = 0;
+        size_t MaxError = 0;
+        bool IsValid = false;
+    };
+
+    struct ImageEncoderBenchmark
+    {
+        size_t Width = 0;
+        size_t Height = 0;
+        MxVector<ImageEncoderTiming> Encoders;
+    };
+
+    /*!
+    ImageEncoder contains PNG and JPEG encoders which split image into bands of rows and encode them independently on all threads.
+    PNG bands are filtered and deflated separately and stored as consecutive IDAT chunks of one zlib stream, so result can be read by any decoder.
+    JPEG bands are groups of MCU rows separated by restart markers
+    */
+    class ImageEncoder
+    {
+    public:
+        using RawImageData = MxVector<uint8_t>;
+
+        /*!
+        approximate number of bytes of source image encoded by one thread. Smaller images are encoded as one band
+        */
+        constexpr static size_t BandByteSize = 1 << 20;
+
+        /*!
+        encodes 8-bit image as PNG
+        \param data pointer to tightly packed pixels
+        \param channels number of channels (1 - grey, 2 - grey alpha, 3 - RGB, 4 - RGBA)
+        \param compression compression level
+        \param flipOnSave if rows should be written from the last one to the first one
+        \returns PNG file contents
+        */
+        static RawImageData EncodePNG(const uint8_t* data, size_t width, size_t height, size_t channels, PngCompression compression, bool flipOnSave = true);
+        /*!
+        encodes 8-bit image as baseline JPEG. Alpha channel is ignored, single and two channel images are treated as grey
+        \param data pointer to tightly packed pixels
+        \param quality quality in range [1, 100]. Chroma is subsampled for quality 90 and below
+        \param flipOnSave if rows should be written from the last one to the first one
+        \returns JPEG file contents or empty array if image is larger than 65535 pixels in any dimension
+        */
+        static RawImageData EncodeJPG(const uint8_t* data, size_t width, size_t height, size_t channels, int quality = 90, bool flipOnSave = true);
+
+        /*!
+        encodes generated image with single-threaded stb encoders and parallel encoders, validating results by decoding them back
+        \param width width of generated image
+        \param height height of generated image
+        \returns benchmark timings, sizes and validation results
+        */
+        static ImageEncoderBenchmark RunBenchmark(size_t width = 7680, size_t height = 4320);
+    };
+
+    /*!
+    incremental PNG encoder. Image rows are passed in strips from the top one to the bottom one. Each strip is compressed in parallel bands
+    and passed to output callback immediately, so whole image is never kept in memory. Result is one zlib stream, as in ImageEncoder::EncodePNG()
+    */
+    class PngStreamEncoder
+    {
+    public:
+        using OutputCallback = std::function<void(const uint8_t* data, size_t size)>;
+    private:
+        OutputCallback output;
+        MxVector<uint8_t> previousRow;
+        size_t width = 0;
+        size_t height = 0;
+        size_t channels = 0;
+        size_t writtenRows = 0;
+        uint32_t checksum = 1;
+        PngCompression compression = PngCompression::DEFAULT;
+    public:
+        /*!
+        creates encoder and writes PNG header to output
+        \param channels number of channels (1 - grey, 2 - grey alpha, 3 - RGB, 4 - RGBA)
+        \param compression compression level
+        \param output function which receives encoded bytes. It is always invoked on the thread which writes rows
+        */
+        PngStreamEncoder(size_t width, size_t height, size_t channels, PngCompression compression, OutputCallback output);
+
+        /*!
+        encodes next strip of image. When last row is encoded, PNG end chunk is written
+        \param data pointer to tightly packed 8-bit rows
+        \param rowCount number of rows in strip. Rows which exceed image height are ignored
+        \param flipRows if rows of strip should be taken from the last one to the first one
+        */
+        void WriteRows(const uint8_t* data, size_t rowCount, bool flipRows = false);
+        size_t GetWrittenRows() const;
+        bool IsFinished() const;
+    };
+}
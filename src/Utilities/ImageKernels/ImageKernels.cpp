@@ -0,0 +1,1313 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ImageKernels.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+#include "Utilities/KernelBenchmark/KernelBenchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_IMAGE_KERNELS_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MXENGINE_IMAGE_KERNELS_AVX2
+#define MXENGINE_TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__GNUC__) || defined(__clang__)
+// AVX2 kernels are compiled for AVX2 target separately, so engine does not require AVX2 capable CPU
+#define MXENGINE_IMAGE_KERNELS_AVX2
+#define MXENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+
+namespace MxEngine
+{
+    const char* EnumToString(ImageInstructionSet set)
+    {
+        switch (set)
+        {
+        case ImageInstructionSet::SCALAR:
+            return "SCALAR";
+        case ImageInstructionSet::SSE2:
+            return "SSE2";
+        case ImageInstructionSet::AVX2:
+            return "AVX2";
+        default:
+            return "SCALAR";
+        }
+    }
+
+    /*!
+    pointers to kernels of one instruction set. Kernels which have no specialized version for instruction set point to version of lower one
+    */
+    struct ImageKernelTable
+    {
+        void (*FlipVertically)(uint8_t* data, size_t rowByteSize, size_t rowCount);
+        void (*Swizzle)(const uint8_t* source, uint8_t* destination, size_t pixelCount, const uint8_t order[4]);
+        void (*ExtractChannel)(const uint8_t* source, size_t channelCount, size_t channel, uint8_t* destination, size_t pixelCount);
+        void (*InsertChannel)(const uint8_t* source, uint8_t* destination, size_t channelCount, size_t channel, size_t pixelCount);
+        void (*ConvertToFloat)(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount, ColorSpace space);
+        void (*ConvertToByte)(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount, ColorSpace space);
+        void (*ConvertToHalf)(const float* source, uint16_t* destination, size_t count);
+        void (*ConvertFromHalf)(const uint16_t* source, float* destination, size_t count);
+        void (*DownsampleBoxRow)(const uint8_t* row0, const uint8_t* row1, uint8_t* destination, size_t sourceWidth, size_t channelCount);
+        void (*FilterRowHorizontal)(const uint8_t* row, float* destination, size_t sourceWidth, size_t channelCount, const float* weights);
+        void (*FilterRowsVertical)(const float* const* rows, uint8_t* destination, size_t count, const float* weights);
+    };
+
+    constexpr size_t KaiserTapCount = 8;
+    constexpr size_t KaiserTapOffset = 3; // first tap of destination pixel x is source pixel 2x - 3
+    constexpr uint32_t SrgbTableMinExponent = 127 - 13; // linear values below 2^-13 are encoded as zero
+    constexpr uint32_t SrgbTableMantissaBits = 8;
+    constexpr uint32_t SrgbTableShift = 23 - SrgbTableMantissaBits;
+    constexpr uint32_t SrgbTableBase = SrgbTableMinExponent << SrgbTableMantissaBits;
+    constexpr size_t SrgbTableSize = (size_t(127 - SrgbTableMinExponent) << SrgbTableMantissaBits) + 1;
+
+    /*!
+    lookup tables of color conversions. sRGB encoding table is indexed by exponent and highest mantissa bits of linear value
+    */
+    struct ColorTables
+    {
+        float ByteToFloat[512]; // first half decodes sRGB, second half is linear
+        uint8_t FloatToSrgb[SrgbTableSize + 3]; // padded, so table can be gathered by 32-bit lanes
+
+        ColorTables()
+        {
+            for (size_t i = 0; i < 256; i++)
+            {
+                float linear = float(i) * (1.0f / 255.0f);
+                float decoded = linear <= 0.04045f ? linear / 12.92f : std::pow((linear + 0.055f) / 1.055f, 2.4f);
+                this->ByteToFloat[i] = decoded;
+                this->ByteToFloat[i + 256] = linear;
+            }
+            for (size_t i = 0; i < SrgbTableSize; i++)
+            {
+                // each entry is computed for the center of range of values which map to it
+                uint32_t bits = uint32_t(SrgbTableBase + i) << SrgbTableShift | (1u << (SrgbTableShift - 1));
+                float value = 0.0f;
+                std::memcpy(&value, &bits, sizeof(value));
+                value = std::min(value, 1.0f);
+                float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                this->FloatToSrgb[i] = (uint8_t)std::min(255.0f, encoded * 255.0f + 0.5f);
+            }
+            std::memset(this->FloatToSrgb + SrgbTableSize, 0, 3);
+        }
+    };
+
+    static const ColorTables& GetColorTables()
+    {
+        static ColorTables tables;
+        return tables;
+    }
+
+    static bool IsAlphaChannel(size_t channel, size_t channelCount)
+    {
+        return (channelCount == 2 || channelCount == 4) && channel == channelCount - 1;
+    }
+
+    static uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static float BitsToFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // scalar kernels. Vectorized kernels use them for unaligned tails and must produce the same results
+
+    static void FlipVerticallyScalar(uint8_t* data, size_t rowByteSize, size_t rowCount)
+    {
+        if (data == nullptr || rowCount < 2) return;
+        MxVector<uint8_t> row(rowByteSize);
+        for (size_t top = 0, bottom = rowCount - 1; top < bottom; top++, bottom--)
+        {
+            std::memcpy(row.data(), data + top * rowByteSize, rowByteSize);
+            std::memcpy(data + top * rowByteSize, data + bottom * rowByteSize, rowByteSize);
+            std::memcpy(data + bottom * rowByteSize, row.data(), rowByteSize);
+        }
+    }
+
+    static void SwizzleScalar(const uint8_t* source, uint8_t* destination, size_t pixelCount, const uint8_t order[4])
+    {
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            uint8_t pixel[4] = { source[4 * i + 0], source[4 * i + 1], source[4 * i + 2], source[4 * i + 3] };
+            destination[4 * i + 0] = pixel[order[0]];
+            destination[4 * i + 1] = pixel[order[1]];
+            destination[4 * i + 2] = pixel[order[2]];
+            destination[4 * i + 3] = pixel[order[3]];
+        }
+    }
+
+    static void ExtractChannelScalar(const uint8_t* source, size_t channelCount, size_t channel, uint8_t* destination, size_t pixelCount)
+    {
+        for (size_t i = 0; i < pixelCount; i++)
+            destination[i] = source[i * channelCount + channel];
+    }
+
+    static void InsertChannelScalar(const uint8_t* source, uint8_t* destination, size_t channelCount, size_t channel, size_t pixelCount)
+    {
+        for (size_t i = 0; i < pixelCount; i++)
+            destination[i * channelCount + channel] = source[i];
+    }
+
+    static void ConvertToFloatScalar(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        const float* table = GetColorTables().ByteToFloat;
+        const float* channelTables[4];
+        for (size_t c = 0; c < channelCount; c++)
+            channelTables[c] = space == ColorSpace::SRGB && !IsAlphaChannel(c, channelCount) ? table : table + 256;
+
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            for (size_t c = 0; c < channelCount; c++)
+                destination[i * channelCount + c] = channelTables[c][source[i * channelCount + c]];
+        }
+    }
+
+    static uint8_t EncodeLinear(float value)
+    {
+        // comparison order matches SSE min / max, so NaN is converted to zero
+        float x = value > 0.0f ? value : 0.0f;
+        x = x < 1.0f ? x : 1.0f;
+        return (uint8_t)(int)(x * 255.0f + 0.5f);
+    }
+
+    static uint8_t EncodeSrgb(float value, const uint8_t* table)
+    {
+        const float minValue = BitsToFloat(SrgbTableMinExponent << 23);
+        float x = value > minValue ? value : minValue;
+        x = x < 1.0f ? x : 1.0f;
+        return table[(FloatBits(x) >> SrgbTableShift) - SrgbTableBase];
+    }
+
+    static void ConvertToByteScalar(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        const uint8_t* table = GetColorTables().FloatToSrgb;
+        bool isSrgb[4];
+        for (size_t c = 0; c < channelCount; c++)
+            isSrgb[c] = space == ColorSpace::SRGB && !IsAlphaChannel(c, channelCount);
+
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            for (size_t c = 0; c < channelCount; c++)
+            {
+                float value = source[i * channelCount + c];
+                destination[i * channelCount + c] = isSrgb[c] ? EncodeSrgb(value, table) : EncodeLinear(value);
+            }
+        }
+    }
+
+    static uint16_t FloatToHalf(float value)
+    {
+        constexpr uint32_t f16max = (127 + 16) << 23;
+        constexpr uint32_t f32infinity = 255 << 23;
+        constexpr uint32_t minNormal = (127 - 14) << 23;
+        constexpr uint32_t subnormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+        uint32_t bits = FloatBits(value);
+        uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint32_t result;
+        if (bits >= f16max)
+        {
+            result = bits > f32infinity ? 0x7E00 : 0x7C00; // NaN stays NaN, overflow becomes infinity
+        }
+        else if (bits < minNormal)
+        {
+            // float addition aligns mantissa to half subnormal precision with correct rounding
+            result = FloatBits(BitsToFloat(bits) + BitsToFloat(subnormalMagic)) - subnormalMagic;
+        }
+        else
+        {
+            uint32_t mantissaOdd = (bits >> 13) & 1;
+            bits += 0xFFF - ((127 - 15) << 23);
+            bits += mantissaOdd;
+            result = bits >> 13;
+        }
+        return uint16_t(result | (sign >> 16));
+    }
+
+    static float HalfToFloat(uint16_t value)
+    {
+        // half exponent is rebased by multiplication, which also normalizes subnormals
+        constexpr uint32_t magic = (254 - 15) << 23;
+        uint32_t exponentMantissa = value & 0x7FFFu;
+        uint32_t bits = FloatBits(BitsToFloat(exponentMantissa << 13) * BitsToFloat(magic));
+        if (exponentMantissa > 0x7BFF) bits |= 255u << 23;
+        bits |= uint32_t(value & 0x8000u) << 16;
+        return BitsToFloat(bits);
+    }
+
+    static void ConvertToHalfScalar(const float* source, uint16_t* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            destination[i] = FloatToHalf(source[i]);
+    }
+
+    static void ConvertFromHalfScalar(const uint16_t* source, float* destination, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            destination[i] = HalfToFloat(source[i]);
+    }
+
+    static void DownsampleBoxPixels(const uint8_t* row0, const uint8_t* row1, uint8_t* destination, size_t begin, size_t end, size_t sourceWidth, size_t channelCount)
+    {
+        for (size_t x = begin; x < end; x++)
+        {
+            size_t x0 = 2 * x, x1 = std::min(2 * x + 1, sourceWidth - 1);
+            for (size_t c = 0; c < channelCount; c++)
+            {
+                uint32_t sum = row0[x0 * channelCount + c] + row0[x1 * channelCount + c] + row1[x0 * channelCount + c] + row1[x1 * channelCount + c];
+                destination[x * channelCount + c] = uint8_t((sum + 2) >> 2);
+            }
+        }
+    }
+
+    static void DownsampleBoxRowScalar(const uint8_t* row0, const uint8_t* row1, uint8_t* destination, size_t sourceWidth, size_t channelCount)
+    {
+        DownsampleBoxPixels(row0, row1, destination, 0, std::max(sourceWidth / 2, (size_t)1), sourceWidth, channelCount);
+    }
+
+    static void FilterPixelsHorizontal(const uint8_t* row, float* destination, size_t begin, size_t end, size_t sourceWidth, size_t channelCount, const float* weights)
+    {
+        for (size_t x = begin; x < end; x++)
+        {
+            size_t taps[KaiserTapCount];
+            for (size_t k = 0; k < KaiserTapCount; k++)
+            {
+                // clamp to border, computed in signed arithmetic as first taps of left pixels are negative
+                ptrdiff_t index = ptrdiff_t(2 * x + k) - (ptrdiff_t)KaiserTapOffset;
+                taps[k] = (size_t)Clamp(index, (ptrdiff_t)0, (ptrdiff_t)sourceWidth - 1);
+            }
+            for (size_t c = 0; c < channelCount; c++)
+            {
+                float sum = weights[0] * (float)row[taps[0] * channelCount + c];
+                for (size_t k = 1; k < KaiserTapCount; k++)
+                    sum += weights[k] * (float)row[taps[k] * channelCount + c];
+                destination[x * channelCount + c] = sum;
+            }
+        }
+    }
+
+    static void FilterRowHorizontalScalar(const uint8_t* row, float* destination, size_t sourceWidth, size_t channelCount, const float* weights)
+    {
+        FilterPixelsHorizontal(row, destination, 0, std::max(sourceWidth / 2, (size_t)1), sourceWidth, channelCount, weights);
+    }
+
+    static uint8_t RoundFilteredValue(float value)
+    {
+        float x = value + 0.5f;
+        x = x > 0.0f ? x : 0.0f;
+        x = x < 255.0f ? x : 255.0f;
+        return (uint8_t)(int)x;
+    }
+
+    static void FilterValuesVertical(const float* const* rows, uint8_t* destination, size_t begin, size_t end, const float* weights)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            float sum = weights[0] * rows[0][i];
+            for (size_t k = 1; k < KaiserTapCount; k++)
+                sum += weights[k] * rows[k][i];
+            destination[i] = RoundFilteredValue(sum);
+        }
+    }
+
+    static void FilterRowsVerticalScalar(const float* const* rows, uint8_t* destination, size_t count, const float* weights)
+    {
+        FilterValuesVertical(rows, destination, 0, count, weights);
+    }
+
+    constexpr ImageKernelTable ScalarKernels =
+    {
+        FlipVerticallyScalar,
+        SwizzleScalar,
+        ExtractChannelScalar,
+        InsertChannelScalar,
+        ConvertToFloatScalar,
+        ConvertToByteScalar,
+        ConvertToHalfScalar,
+        ConvertFromHalfScalar,
+        DownsampleBoxRowScalar,
+        FilterRowHorizontalScalar,
+        FilterRowsVerticalScalar,
+    };
+
+#if defined(MXENGINE_IMAGE_KERNELS_SSE2)
+    static void FlipVerticallySSE2(uint8_t* data, size_t rowByteSize, size_t rowCount)
+    {
+        if (data == nullptr || rowCount < 2) return;
+        for (size_t top = 0, bottom = rowCount - 1; top < bottom; top++, bottom--)
+        {
+            // rows are swapped through registers, so no temporary row is needed
+            uint8_t* topRow = data + top * rowByteSize;
+            uint8_t* bottomRow = data + bottom * rowByteSize;
+            size_t i = 0;
+            for (; i + 16 <= rowByteSize; i += 16)
+            {
+                __m128i t = _mm_loadu_si128((const __m128i*)(topRow + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(bottomRow + i));
+                _mm_storeu_si128((__m128i*)(topRow + i), b);
+                _mm_storeu_si128((__m128i*)(bottomRow + i), t);
+            }
+            for (; i < rowByteSize; i++)
+                std::swap(topRow[i], bottomRow[i]);
+        }
+    }
+
+    static void SwizzleSSE2(const uint8_t* source, uint8_t* destination, size_t pixelCount, const uint8_t order[4])
+    {
+        // without byte shuffle each destination channel is shifted from its source channel position and masked
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        __m128i shifts[4];
+        for (size_t c = 0; c < 4; c++)
+            shifts[c] = _mm_cvtsi32_si128(int(8 * order[c]));
+
+        size_t i = 0;
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i pixels = _mm_loadu_si128((const __m128i*)(source + 4 * i));
+            __m128i r = _mm_and_si128(_mm_srl_epi32(pixels, shifts[0]), mask);
+            __m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(pixels, shifts[1]), mask), 8);
+            __m128i b = _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(pixels, shifts[2]), mask), 16);
+            __m128i a = _mm_slli_epi32(_mm_srl_epi32(pixels, shifts[3]), 24);
+            _mm_storeu_si128((__m128i*)(destination + 4 * i), _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a)));
+        }
+        SwizzleScalar(source + 4 * i, destination + 4 * i, pixelCount - i, order);
+    }
+
+    static void ExtractChannelSSE2(const uint8_t* source, size_t channelCount, size_t channel, uint8_t* destination, size_t pixelCount)
+    {
+        size_t i = 0;
+        if (channelCount == 4)
+        {
+            // 16 pixels per iteration: channel is shifted to low byte of each 32-bit lane, then lanes are packed back to bytes
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            const __m128i shift = _mm_cvtsi32_si128(int(8 * channel));
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                const __m128i* pixels = (const __m128i*)(source + 4 * i);
+                __m128i p0 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 0), shift), mask);
+                __m128i p1 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 1), shift), mask);
+                __m128i p2 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 2), shift), mask);
+                __m128i p3 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 3), shift), mask);
+                _mm_storeu_si128((__m128i*)(destination + i), _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+            }
+        }
+        ExtractChannelScalar(source + i * channelCount, channelCount, channel, destination + i, pixelCount - i);
+    }
+
+    static void InsertChannelSSE2(const uint8_t* source, uint8_t* destination, size_t channelCount, size_t channel, size_t pixelCount)
+    {
+        size_t i = 0;
+        if (channelCount == 4)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i shift = _mm_cvtsi32_si128(int(8 * channel));
+            const __m128i keep = _mm_set1_epi32(~int(0xFFu << (8 * channel)));
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                __m128i values = _mm_loadu_si128((const __m128i*)(source + i));
+                __m128i words[2] = { _mm_unpacklo_epi8(values, zero), _mm_unpackhi_epi8(values, zero) };
+                for (size_t j = 0; j < 4; j++)
+                {
+                    __m128i lanes = (j & 1) == 0 ? _mm_unpacklo_epi16(words[j / 2], zero) : _mm_unpackhi_epi16(words[j / 2], zero);
+                    __m128i* pixels = (__m128i*)(destination + 4 * (i + 4 * j));
+                    __m128i kept = _mm_and_si128(_mm_loadu_si128(pixels), keep);
+                    _mm_storeu_si128(pixels, _mm_or_si128(kept, _mm_sll_epi32(lanes, shift)));
+                }
+            }
+        }
+        InsertChannelScalar(source + i, destination + i * channelCount, channelCount, channel, pixelCount - i);
+    }
+
+    static void ConvertToFloatSSE2(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        // sRGB decoding is a table lookup, which cannot be vectorized without gather instructions
+        if (space == ColorSpace::SRGB)
+        {
+            ConvertToFloatScalar(source, destination, pixelCount, channelCount, space);
+            return;
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+        size_t count = pixelCount * channelCount;
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i values = _mm_loadu_si128((const __m128i*)(source + i));
+            __m128i words[2] = { _mm_unpacklo_epi8(values, zero), _mm_unpackhi_epi8(values, zero) };
+            for (size_t j = 0; j < 4; j++)
+            {
+                __m128i lanes = (j & 1) == 0 ? _mm_unpacklo_epi16(words[j / 2], zero) : _mm_unpackhi_epi16(words[j / 2], zero);
+                _mm_storeu_ps(destination + i + 4 * j, _mm_mul_ps(_mm_cvtepi32_ps(lanes), scale));
+            }
+        }
+        // linear conversion does not depend on channel, so tail is converted as single-channel pixels
+        ConvertToFloatScalar(source + i, destination + i, count - i, 1, ColorSpace::LINEAR);
+    }
+
+    static __m128i EncodeLinearSSE2(__m128 values)
+    {
+        __m128 x = _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+    }
+
+    static void ConvertToByteSSE2(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        if (space == ColorSpace::SRGB)
+        {
+            ConvertToByteScalar(source, destination, pixelCount, channelCount, space);
+            return;
+        }
+
+        size_t count = pixelCount * channelCount;
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v0 = EncodeLinearSSE2(_mm_loadu_ps(source + i + 0));
+            __m128i v1 = EncodeLinearSSE2(_mm_loadu_ps(source + i + 4));
+            __m128i v2 = EncodeLinearSSE2(_mm_loadu_ps(source + i + 8));
+            __m128i v3 = EncodeLinearSSE2(_mm_loadu_ps(source + i + 12));
+            _mm_storeu_si128((__m128i*)(destination + i), _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3)));
+        }
+        ConvertToByteScalar(source + i, destination + i, count - i, 1, ColorSpace::LINEAR);
+    }
+
+    static __m128i FloatToHalfSSE2(__m128 values)
+    {
+        // same algorithm as scalar FloatToHalf, with branches replaced by masks
+        const __m128i f16max = _mm_set1_epi32((127 + 16) << 23);
+        const __m128i f32infinity = _mm_set1_epi32(255 << 23);
+        const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+        const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+        __m128 sign = _mm_and_ps(values, _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000u))));
+        __m128 absolute = _mm_xor_ps(values, sign);
+        __m128i bits = _mm_castps_si128(absolute);
+
+        __m128i isNaN = _mm_cmpgt_epi32(bits, f32infinity);
+        __m128i isRegular = _mm_cmpgt_epi32(f16max, bits);
+        __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, bits);
+        __m128i infinityOrNaN = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+        __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+        __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+        __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(bits, normalBias), mantissaOdd), 13);
+
+        __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+        __m128i result = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infinityOrNaN));
+        // sign is shifted arithmetically, so results stay in signed 16-bit range and can be packed with saturation
+        return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+    }
+
+    static void ConvertToHalfSSE2(const float* source, uint16_t* destination, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v0 = FloatToHalfSSE2(_mm_loadu_ps(source + i + 0));
+            __m128i v1 = FloatToHalfSSE2(_mm_loadu_ps(source + i + 4));
+            _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(v0, v1));
+        }
+        ConvertToHalfScalar(source + i, destination + i, count - i);
+    }
+
+    static __m128 HalfToFloatSSE2(__m128i values)
+    {
+        __m128i exponentMantissa = _mm_and_si128(values, _mm_set1_epi32(0x7FFF));
+        __m128i sign = _mm_slli_epi32(_mm_xor_si128(values, exponentMantissa), 16);
+        __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentMantissa, 13)), _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+        __m128i isInfinityOrNaN = _mm_cmpgt_epi32(exponentMantissa, _mm_set1_epi32(0x7BFF));
+        __m128i infinityExponent = _mm_and_si128(isInfinityOrNaN, _mm_set1_epi32(255 << 23));
+        return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infinityExponent)));
+    }
+
+    static void ConvertFromHalfSSE2(const uint16_t* source, float* destination, size_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i values = _mm_loadu_si128((const __m128i*)(source + i));
+            _mm_storeu_ps(destination + i + 0, HalfToFloatSSE2(_mm_unpacklo_epi16(values, zero)));
+            _mm_storeu_ps(destination + i + 4, HalfToFloatSSE2(_mm_unpackhi_epi16(values, zero)));
+        }
+        ConvertFromHalfScalar(source + i, destination + i, count - i);
+    }
+
+    static void DownsampleBoxRowSSE2(const uint8_t* row0, const uint8_t* row1, uint8_t* destination, size_t sourceWidth, size_t channelCount)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        size_t width = sourceWidth / 2;
+        size_t x = 0;
+        if (channelCount == 1)
+        {
+            // even and odd pixels are split into 16-bit lanes, so each lane accumulates one destination pixel
+            const __m128i low = _mm_set1_epi16(0xFF);
+            for (; x + 16 <= width; x += 16)
+            {
+                __m128i sums[2];
+                for (size_t j = 0; j < 2; j++)
+                {
+                    __m128i a = _mm_loadu_si128((const __m128i*)(row0 + 2 * x + 16 * j));
+                    __m128i b = _mm_loadu_si128((const __m128i*)(row1 + 2 * x + 16 * j));
+                    __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, low), _mm_srli_epi16(a, 8)), _mm_add_epi16(_mm_and_si128(b, low), _mm_srli_epi16(b, 8)));
+                    sums[j] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+                }
+                _mm_storeu_si128((__m128i*)(destination + x), _mm_packus_epi16(sums[0], sums[1]));
+            }
+        }
+        else if (channelCount == 4)
+        {
+            // neighbour pixels occupy two halves of 16-bit register after vertical sum, so they are added by 64-bit shift
+            for (; x + 4 <= width; x += 4)
+            {
+                __m128i pairs[2];
+                for (size_t j = 0; j < 2; j++)
+                {
+                    __m128i a = _mm_loadu_si128((const __m128i*)(row0 + 8 * x + 16 * j));
+                    __m128i b = _mm_loadu_si128((const __m128i*)(row1 + 8 * x + 16 * j));
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                    __m128i pair = _mm_unpacklo_epi64(_mm_add_epi16(lo, _mm_srli_si128(lo, 8)), _mm_add_epi16(hi, _mm_srli_si128(hi, 8)));
+                    pairs[j] = _mm_srli_epi16(_mm_add_epi16(pair, two), 2);
+                }
+                _mm_storeu_si128((__m128i*)(destination + 4 * x), _mm_packus_epi16(pairs[0], pairs[1]));
+            }
+        }
+        DownsampleBoxPixels(row0, row1, destination, x, std::max(width, (size_t)1), sourceWidth, channelCount);
+    }
+
+    static __m128 LoadPixelSSE2(const uint8_t* pixel)
+    {
+        int32_t value;
+        std::memcpy(&value, pixel, sizeof(value));
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero));
+    }
+
+    static void FilterRowHorizontalSSE2(const uint8_t* row, float* destination, size_t sourceWidth, size_t channelCount, const float* weights)
+    {
+        size_t width = std::max(sourceWidth / 2, (size_t)1);
+        if (channelCount != 4 || sourceWidth < 2 * KaiserTapCount)
+        {
+            FilterRowHorizontalScalar(row, destination, sourceWidth, channelCount, weights);
+            return;
+        }
+
+        // RGBA pixel fits one register, so all channels are filtered at once. Border pixels need clamping and are filtered by scalar code
+        size_t begin = (KaiserTapOffset + 1) / 2;
+        size_t end = (sourceWidth + KaiserTapOffset - KaiserTapCount) / 2 + 1;
+        FilterPixelsHorizontal(row, destination, 0, begin, sourceWidth, channelCount, weights);
+
+        __m128 taps[KaiserTapCount];
+        for (size_t k = 0; k < KaiserTapCount; k++)
+            taps[k] = _mm_set1_ps(weights[k]);
+
+        for (size_t x = begin; x < end; x++)
+        {
+            const uint8_t* pixels = row + (2 * x - KaiserTapOffset) * 4;
+            __m128 sum = _mm_mul_ps(taps[0], LoadPixelSSE2(pixels));
+            for (size_t k = 1; k < KaiserTapCount; k++)
+                sum = _mm_add_ps(sum, _mm_mul_ps(taps[k], LoadPixelSSE2(pixels + 4 * k)));
+            _mm_storeu_ps(destination + 4 * x, sum);
+        }
+        FilterPixelsHorizontal(row, destination, end, width, sourceWidth, channelCount, weights);
+    }
+
+    static void FilterRowsVerticalSSE2(const float* const* rows, uint8_t* destination, size_t count, const float* weights)
+    {
+        __m128 taps[KaiserTapCount];
+        for (size_t k = 0; k < KaiserTapCount; k++)
+            taps[k] = _mm_set1_ps(weights[k]);
+
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 maxValue = _mm_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i values[2];
+            for (size_t j = 0; j < 2; j++)
+            {
+                __m128 sum = _mm_mul_ps(taps[0], _mm_loadu_ps(rows[0] + i + 4 * j));
+                for (size_t k = 1; k < KaiserTapCount; k++)
+                    sum = _mm_add_ps(sum, _mm_mul_ps(taps[k], _mm_loadu_ps(rows[k] + i + 4 * j)));
+                values[j] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(sum, half), zero), maxValue));
+            }
+            __m128i words = _mm_packs_epi32(values[0], values[1]);
+            _mm_storel_epi64((__m128i*)(destination + i), _mm_packus_epi16(words, words));
+        }
+        FilterValuesVertical(rows, destination, i, count, weights);
+    }
+
+    constexpr ImageKernelTable SSE2Kernels =
+    {
+        FlipVerticallySSE2,
+        SwizzleSSE2,
+        ExtractChannelSSE2,
+        InsertChannelSSE2,
+        ConvertToFloatSSE2,
+        ConvertToByteSSE2,
+        ConvertToHalfSSE2,
+        ConvertFromHalfSSE2,
+        DownsampleBoxRowSSE2,
+        FilterRowHorizontalSSE2,
+        FilterRowsVerticalSSE2,
+    };
+#endif
+
+#if defined(MXENGINE_IMAGE_KERNELS_AVX2)
+    MXENGINE_TARGET_AVX2 static void FlipVerticallyAVX2(uint8_t* data, size_t rowByteSize, size_t rowCount)
+    {
+        if (data == nullptr || rowCount < 2) return;
+        for (size_t top = 0, bottom = rowCount - 1; top < bottom; top++, bottom--)
+        {
+            uint8_t* topRow = data + top * rowByteSize;
+            uint8_t* bottomRow = data + bottom * rowByteSize;
+            size_t i = 0;
+            for (; i + 32 <= rowByteSize; i += 32)
+            {
+                __m256i t = _mm256_loadu_si256((const __m256i*)(topRow + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(bottomRow + i));
+                _mm256_storeu_si256((__m256i*)(topRow + i), b);
+                _mm256_storeu_si256((__m256i*)(bottomRow + i), t);
+            }
+            for (; i < rowByteSize; i++)
+                std::swap(topRow[i], bottomRow[i]);
+        }
+    }
+
+    MXENGINE_TARGET_AVX2 static void SwizzleAVX2(const uint8_t* source, uint8_t* destination, size_t pixelCount, const uint8_t order[4])
+    {
+        // byte shuffle works inside 128-bit lanes, so shuffle mask contains lane-relative indices
+        alignas(32) uint8_t shuffle[32];
+        for (size_t j = 0; j < 32; j++)
+            shuffle[j] = uint8_t((j & 12) + order[j & 3]);
+        const __m256i mask = _mm256_load_si256((const __m256i*)shuffle);
+
+        size_t i = 0;
+        for (; i + 8 <= pixelCount; i += 8)
+        {
+            __m256i pixels = _mm256_loadu_si256((const __m256i*)(source + 4 * i));
+            _mm256_storeu_si256((__m256i*)(destination + 4 * i), _mm256_shuffle_epi8(pixels, mask));
+        }
+        SwizzleScalar(source + 4 * i, destination + 4 * i, pixelCount - i, order);
+    }
+
+    MXENGINE_TARGET_AVX2 static void ExtractChannelAVX2(const uint8_t* source, size_t channelCount, size_t channel, uint8_t* destination, size_t pixelCount)
+    {
+        size_t i = 0;
+        if (channelCount == 4)
+        {
+            // packing works inside 128-bit lanes, so resulting 4-pixel groups are interleaved and must be permuted back
+            const __m256i mask = _mm256_set1_epi32(0xFF);
+            const __m128i shift = _mm_cvtsi32_si128(int(8 * channel));
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            for (; i + 32 <= pixelCount; i += 32)
+            {
+                const __m256i* pixels = (const __m256i*)(source + 4 * i);
+                __m256i p0 = _mm256_and_si256(_mm256_srl_epi32(_mm256_loadu_si256(pixels + 0), shift), mask);
+                __m256i p1 = _mm256_and_si256(_mm256_srl_epi32(_mm256_loadu_si256(pixels + 1), shift), mask);
+                __m256i p2 = _mm256_and_si256(_mm256_srl_epi32(_mm256_loadu_si256(pixels + 2), shift), mask);
+                __m256i p3 = _mm256_and_si256(_mm256_srl_epi32(_mm256_loadu_si256(pixels + 3), shift), mask);
+                __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(p0, p1), _mm256_packs_epi32(p2, p3));
+                _mm256_storeu_si256((__m256i*)(destination + i), _mm256_permutevar8x32_epi32(packed, order));
+            }
+        }
+        ExtractChannelScalar(source + i * channelCount, channelCount, channel, destination + i, pixelCount - i);
+    }
+
+    MXENGINE_TARGET_AVX2 static void InsertChannelAVX2(const uint8_t* source, uint8_t* destination, size_t channelCount, size_t channel, size_t pixelCount)
+    {
+        size_t i = 0;
+        if (channelCount == 4)
+        {
+            const __m128i shift = _mm_cvtsi32_si128(int(8 * channel));
+            const __m256i keep = _mm256_set1_epi32(~int(0xFFu << (8 * channel)));
+            for (; i + 8 <= pixelCount; i += 8)
+            {
+                __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(source + i)));
+                __m256i* pixels = (__m256i*)(destination + 4 * i);
+                __m256i kept = _mm256_and_si256(_mm256_loadu_si256(pixels), keep);
+                _mm256_storeu_si256(pixels, _mm256_or_si256(kept, _mm256_sll_epi32(lanes, shift)));
+            }
+        }
+        InsertChannelScalar(source + i, destination + i * channelCount, channelCount, channel, pixelCount - i);
+    }
+
+    /*!
+    gets offsets into ByteToFloat / FloatToSrgb selector for 8 consecutive channel values. Alpha lanes are selected to be linear
+    */
+    MXENGINE_TARGET_AVX2 static __m256i GetAlphaLanes(size_t channelCount)
+    {
+        if (channelCount == 4) return _mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1);
+        if (channelCount == 2) return _mm256_setr_epi32(0, -1, 0, -1, 0, -1, 0, -1);
+        return _mm256_setzero_si256();
+    }
+
+    MXENGINE_TARGET_AVX2 static void ConvertToFloatAVX2(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        const float* table = GetColorTables().ByteToFloat;
+        // linear values are taken from second half of table, so sRGB and alpha lanes are gathered by one instruction
+        __m256i tableOffset = space == ColorSpace::SRGB ? _mm256_and_si256(GetAlphaLanes(channelCount), _mm256_set1_epi32(256)) : _mm256_set1_epi32(256);
+        size_t count = pixelCount * channelCount;
+        size_t i = 0;
+        // 8 values start at pixel boundary only if pixel size divides 8
+        if (space == ColorSpace::LINEAR || channelCount != 3)
+        {
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i indices = _mm256_add_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(source + i))), tableOffset);
+                _mm256_storeu_ps(destination + i, _mm256_i32gather_ps(table, indices, sizeof(float)));
+            }
+        }
+        // linear conversion does not depend on channel. Otherwise vectorized part ends at pixel boundary
+        if (space == ColorSpace::LINEAR)
+            ConvertToFloatScalar(source + i, destination + i, count - i, 1, space);
+        else
+            ConvertToFloatScalar(source + i, destination + i, (count - i) / channelCount, channelCount, space);
+    }
+
+    MXENGINE_TARGET_AVX2 static __m256i EncodeLinearAVX2(__m256 values)
+    {
+        __m256 x = _mm256_min_ps(_mm256_max_ps(values, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+        return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)));
+    }
+
+    MXENGINE_TARGET_AVX2 static __m256i EncodeSrgbAVX2(__m256 values, const uint8_t* table)
+    {
+        __m256 x = _mm256_min_ps(_mm256_max_ps(values, _mm256_castsi256_ps(_mm256_set1_epi32(SrgbTableMinExponent << 23))), _mm256_set1_ps(1.0f));
+        __m256i indices = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(x), SrgbTableShift), _mm256_set1_epi32(SrgbTableBase));
+        // table is padded, so 32-bit gather never reads out of bounds. Only lowest byte of each lane is used
+        __m256i gathered = _mm256_i32gather_epi32((const int*)table, indices, 1);
+        return _mm256_and_si256(gathered, _mm256_set1_epi32(0xFF));
+    }
+
+    MXENGINE_TARGET_AVX2 static void ConvertToByteAVX2(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        const uint8_t* table = GetColorTables().FloatToSrgb;
+        const __m256i alphaLanes = GetAlphaLanes(channelCount);
+        size_t count = pixelCount * channelCount;
+        size_t i = 0;
+        if (space == ColorSpace::LINEAR || channelCount != 3)
+        {
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 values = _mm256_loadu_ps(source + i);
+                __m256i encoded = EncodeLinearAVX2(values);
+                if (space == ColorSpace::SRGB)
+                    encoded = _mm256_blendv_epi8(EncodeSrgbAVX2(values, table), encoded, alphaLanes);
+
+                __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(encoded), _mm256_extracti128_si256(encoded, 1));
+                _mm_storel_epi64((__m128i*)(destination + i), _mm_packus_epi16(words, words));
+            }
+        }
+        if (space == ColorSpace::LINEAR)
+            ConvertToByteScalar(source + i, destination + i, count - i, 1, space);
+        else
+            ConvertToByteScalar(source + i, destination + i, (count - i) / channelCount, channelCount, space);
+    }
+
+    MXENGINE_TARGET_AVX2 static __m256i FloatToHalfAVX2(__m256 values)
+    {
+        const __m256i f16max = _mm256_set1_epi32((127 + 16) << 23);
+        const __m256i f32infinity = _mm256_set1_epi32(255 << 23);
+        const __m256i minNormal = _mm256_set1_epi32((127 - 14) << 23);
+        const __m256i subnormalMagic = _mm256_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m256i normalBias = _mm256_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+        __m256 sign = _mm256_and_ps(values, _mm256_castsi256_ps(_mm256_set1_epi32(int(0x80000000u))));
+        __m256 absolute = _mm256_xor_ps(values, sign);
+        __m256i bits = _mm256_castps_si256(absolute);
+
+        __m256i isNaN = _mm256_cmpgt_epi32(bits, f32infinity);
+        __m256i isRegular = _mm256_cmpgt_epi32(f16max, bits);
+        __m256i isSubnormal = _mm256_cmpgt_epi32(minNormal, bits);
+        __m256i infinityOrNaN = _mm256_or_si256(_mm256_and_si256(isNaN, _mm256_set1_epi32(0x200)), _mm256_set1_epi32(0x7C00));
+
+        __m256i subnormal = _mm256_sub_epi32(_mm256_castps_si256(_mm256_add_ps(absolute, _mm256_castsi256_ps(subnormalMagic))), subnormalMagic);
+        __m256i mantissaOdd = _mm256_srai_epi32(_mm256_slli_epi32(bits, 31 - 13), 31);
+        __m256i normal = _mm256_srli_epi32(_mm256_sub_epi32(_mm256_add_epi32(bits, normalBias), mantissaOdd), 13);
+
+        __m256i finite = _mm256_blendv_epi8(normal, subnormal, isSubnormal);
+        __m256i result = _mm256_blendv_epi8(infinityOrNaN, finite, isRegular);
+        return _mm256_or_si256(result, _mm256_srai_epi32(_mm256_castps_si256(sign), 16));
+    }
+
+    MXENGINE_TARGET_AVX2 static void ConvertToHalfAVX2(const float* source, uint16_t* destination, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i halves = FloatToHalfAVX2(_mm256_loadu_ps(source + i));
+            __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(halves), _mm256_extracti128_si256(halves, 1));
+            _mm_storeu_si128((__m128i*)(destination + i), packed);
+        }
+        ConvertToHalfScalar(source + i, destination + i, count - i);
+    }
+
+    MXENGINE_TARGET_AVX2 static void ConvertFromHalfAVX2(const uint16_t* source, float* destination, size_t count)
+    {
+        const __m256 magic = _mm256_castsi256_ps(_mm256_set1_epi32((254 - 15) << 23));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i values = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(source + i)));
+            __m256i exponentMantissa = _mm256_and_si256(values, _mm256_set1_epi32(0x7FFF));
+            __m256i sign = _mm256_slli_epi32(_mm256_xor_si256(values, exponentMantissa), 16);
+            __m256 scaled = _mm256_mul_ps(_mm256_castsi256_ps(_mm256_slli_epi32(exponentMantissa, 13)), magic);
+            __m256i isInfinityOrNaN = _mm256_cmpgt_epi32(exponentMantissa, _mm256_set1_epi32(0x7BFF));
+            __m256i infinityExponent = _mm256_and_si256(isInfinityOrNaN, _mm256_set1_epi32(255 << 23));
+            _mm256_storeu_ps(destination + i, _mm256_or_ps(scaled, _mm256_castsi256_ps(_mm256_or_si256(sign, infinityExponent))));
+        }
+        ConvertFromHalfScalar(source + i, destination + i, count - i);
+    }
+
+    MXENGINE_TARGET_AVX2 static void FilterRowsVerticalAVX2(const float* const* rows, uint8_t* destination, size_t count, const float* weights)
+    {
+        __m256 taps[KaiserTapCount];
+        for (size_t k = 0; k < KaiserTapCount; k++)
+            taps[k] = _mm256_set1_ps(weights[k]);
+
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 maxValue = _mm256_set1_ps(255.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 sum = _mm256_mul_ps(taps[0], _mm256_loadu_ps(rows[0] + i));
+            for (size_t k = 1; k < KaiserTapCount; k++)
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(taps[k], _mm256_loadu_ps(rows[k] + i)));
+            __m256i values = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_add_ps(sum, half), zero), maxValue));
+            __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+            _mm_storel_epi64((__m128i*)(destination + i), _mm_packus_epi16(words, words));
+        }
+        FilterValuesVertical(rows, destination, i, count, weights);
+    }
+
+    // box and horizontal filters operate on 8 or 16 byte groups of RGBA pixels, for which SSE2 kernels are already optimal
+    constexpr ImageKernelTable AVX2Kernels =
+    {
+        FlipVerticallyAVX2,
+        SwizzleAVX2,
+        ExtractChannelAVX2,
+        InsertChannelAVX2,
+        ConvertToFloatAVX2,
+        ConvertToByteAVX2,
+        ConvertToHalfAVX2,
+        ConvertFromHalfAVX2,
+        DownsampleBoxRowSSE2,
+        FilterRowHorizontalSSE2,
+        FilterRowsVerticalAVX2,
+    };
+
+    static bool IsAVX2Available()
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+        bool hasAVX = (info[2] & (1 << 28)) != 0;
+        if (!hasOSXSave || !hasAVX) return false;
+        // operating system must save upper halves of ymm registers on context switch
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2");
+    #endif
+    }
+#endif
+
+    static ImageInstructionSet DetectInstructionSet()
+    {
+    #if defined(MXENGINE_IMAGE_KERNELS_AVX2)
+        if (IsAVX2Available()) return ImageInstructionSet::AVX2;
+    #endif
+    #if defined(MXENGINE_IMAGE_KERNELS_SSE2)
+        return ImageInstructionSet::SSE2;
+    #else
+        return ImageInstructionSet::SCALAR;
+    #endif
+    }
+
+    static const ImageKernelTable& GetKernelTable(ImageInstructionSet set)
+    {
+        switch (set)
+        {
+        #if defined(MXENGINE_IMAGE_KERNELS_AVX2)
+        case ImageInstructionSet::AVX2:
+            return AVX2Kernels;
+        #endif
+        #if defined(MXENGINE_IMAGE_KERNELS_SSE2)
+        case ImageInstructionSet::SSE2:
+            return SSE2Kernels;
+        #endif
+        default:
+            return ScalarKernels;
+        }
+    }
+
+    static const ImageKernelTable& GetKernelTable()
+    {
+        static const ImageKernelTable& table = GetKernelTable(ImageKernels::GetInstructionSet());
+        return table;
+    }
+
+    ImageInstructionSet ImageKernels::GetInstructionSet()
+    {
+        static ImageInstructionSet set = DetectInstructionSet();
+        return set;
+    }
+
+    bool ImageKernels::IsSupported(ImageInstructionSet set)
+    {
+        return (uint8_t)set <= (uint8_t)ImageKernels::GetInstructionSet();
+    }
+
+    void ImageKernels::FlipVertically(uint8_t* data, size_t rowByteSize, size_t rowCount)
+    {
+        GetKernelTable().FlipVertically(data, rowByteSize, rowCount);
+    }
+
+    void ImageKernels::FlipVertically(Image& image)
+    {
+        ImageKernels::FlipVertically(image.GetRawData(), image.GetWidth() * image.GetPixelSize(), image.GetHeight());
+    }
+
+    void ImageKernels::Swizzle(const uint8_t* source, uint8_t* destination, size_t pixelCount, const uint8_t order[4])
+    {
+        MX_ASSERT(order[0] < 4 && order[1] < 4 && order[2] < 4 && order[3] < 4);
+        GetKernelTable().Swizzle(source, destination, pixelCount, order);
+    }
+
+    void ImageKernels::ExtractChannel(const uint8_t* source, size_t channelCount, size_t channel, uint8_t* destination, size_t pixelCount)
+    {
+        MX_ASSERT(channel < channelCount && channelCount <= 4);
+        GetKernelTable().ExtractChannel(source, channelCount, channel, destination, pixelCount);
+    }
+
+    void ImageKernels::InsertChannel(const uint8_t* source, uint8_t* destination, size_t channelCount, size_t channel, size_t pixelCount)
+    {
+        MX_ASSERT(channel < channelCount && channelCount <= 4);
+        GetKernelTable().InsertChannel(source, destination, channelCount, channel, pixelCount);
+    }
+
+    void ImageKernels::ConvertToFloat(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        GetKernelTable().ConvertToFloat(source, destination, pixelCount, channelCount, space);
+    }
+
+    void ImageKernels::ConvertToByte(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount, ColorSpace space)
+    {
+        GetKernelTable().ConvertToByte(source, destination, pixelCount, channelCount, space);
+    }
+
+    void ImageKernels::ConvertToHalf(const float* source, uint16_t* destination, size_t count)
+    {
+        GetKernelTable().ConvertToHalf(source, destination, count);
+    }
+
+    void ImageKernels::ConvertFromHalf(const uint16_t* source, float* destination, size_t count)
+    {
+        GetKernelTable().ConvertFromHalf(source, destination, count);
+    }
+
+    void ImageKernels::Blit(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t rowByteSize, size_t rowCount)
+    {
+        // memcpy is already vectorized by runtime library for the widest available registers
+        for (size_t y = 0; y < rowCount; y++)
+            std::memcpy(destination + y * destinationStride, source + y * sourceStride, rowByteSize);
+    }
+
+    static Image DownsampleBox(const Image& image, const ImageKernelTable& kernels)
+    {
+        MX_ASSERT(!image.IsFloatingPoint());
+        size_t width = image.GetWidth(), height = image.GetHeight(), channels = image.GetChannelCount();
+        if (image.GetRawData() == nullptr || width == 0 || height == 0) return Image();
+
+        size_t resultWidth = std::max(width / 2, (size_t)1), resultHeight = std::max(height / 2, (size_t)1);
+        auto result = (uint8_t*)std::malloc(resultWidth * resultHeight * channels);
+        const uint8_t* source = image.GetRawData();
+
+        ThreadPool::ParallelFor(resultHeight, ImageKernels::ParallelRowGranularity, [&](size_t begin, size_t end)
+        {
+            for (size_t y = begin; y < end; y++)
+            {
+                const uint8_t* row0 = source + (2 * y) * width * channels;
+                const uint8_t* row1 = source + std::min(2 * y + 1, height - 1) * width * channels;
+                kernels.DownsampleBoxRow(row0, row1, result + y * resultWidth * channels, width, channels);
+            }
+        });
+        return Image(result, resultWidth, resultHeight, channels, false);
+    }
+
+    static float BesselI0(float x)
+    {
+        // power series converges quickly for window parameters used in practice
+        float sum = 1.0f, term = 1.0f;
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (x / (2.0f * k)) * (x / (2.0f * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static std::array<float, KaiserTapCount> ComputeKaiserWeights(float alpha)
+    {
+        // taps are placed at half-pixel offsets around destination pixel center, filter cutoff is half of source sampling rate
+        std::array<float, KaiserTapCount> weights;
+        constexpr float Radius = KaiserTapCount / 2.0f;
+        float total = 0.0f;
+        for (size_t k = 0; k < KaiserTapCount; k++)
+        {
+            float offset = float(k) - (KaiserTapCount - 1) / 2.0f;
+            float t = offset / Radius;
+            float x = Pi<float>() * offset * 0.5f;
+            float sinc = std::sin(x) / x;
+            float window = BesselI0(alpha * std::sqrt(1.0f - t * t)) / BesselI0(alpha);
+            weights[k] = sinc * window;
+            total += weights[k];
+        }
+        for (auto& weight : weights)
+            weight /= total;
+        return weights;
+    }
+
+    static Image DownsampleKaiser(const Image& image, float alpha, const ImageKernelTable& kernels)
+    {
+        MX_ASSERT(!image.IsFloatingPoint());
+        size_t width = image.GetWidth(), height = image.GetHeight(), channels = image.GetChannelCount();
+        if (image.GetRawData() == nullptr || width == 0 || height == 0) return Image();
+
+        size_t resultWidth = std::max(width / 2, (size_t)1), resultHeight = std::max(height / 2, (size_t)1);
+        size_t filteredRowSize = resultWidth * channels;
+        auto weights = ComputeKaiserWeights(alpha);
+        const uint8_t* source = image.GetRawData();
+
+        // filter is separable: all source rows are filtered horizontally first, then destination rows combine 8 filtered rows
+        MxVector<float> filtered(height * filteredRowSize);
+        ThreadPool::ParallelFor(height, ImageKernels::ParallelRowGranularity, [&](size_t begin, size_t end)
+        {
+            for (size_t y = begin; y < end; y++)
+                kernels.FilterRowHorizontal(source + y * width * channels, filtered.data() + y * filteredRowSize, width, channels, weights.data());
+        });
+
+        auto result = (uint8_t*)std::malloc(resultWidth * resultHeight * channels);
+        ThreadPool::ParallelFor(resultHeight, ImageKernels::ParallelRowGranularity, [&](size_t begin, size_t end)
+        {
+            for (size_t y = begin; y < end; y++)
+            {
+                const float* rows[KaiserTapCount];
+                for (size_t k = 0; k < KaiserTapCount; k++)
+                {
+                    ptrdiff_t index = ptrdiff_t(2 * y + k) - (ptrdiff_t)KaiserTapOffset;
+                    rows[k] = filtered.data() + (size_t)Clamp(index, (ptrdiff_t)0, (ptrdiff_t)height - 1) * filteredRowSize;
+                }
+                kernels.FilterRowsVertical(rows, result + y * filteredRowSize, filteredRowSize, weights.data());
+            }
+        });
+        return Image(result, resultWidth, resultHeight, channels, false);
+    }
+
+    Image ImageKernels::DownsampleBox(const Image& image)
+    {
+        MAKE_SCOPE_PROFILER("ImageKernels::DownsampleBox()");
+        return MxEngine::DownsampleBox(image, GetKernelTable());
+    }
+
+    Image ImageKernels::DownsampleKaiser(const Image& image, float alpha)
+    {
+        MAKE_SCOPE_PROFILER("ImageKernels::DownsampleKaiser()");
+        return MxEngine::DownsampleKaiser(image, alpha, GetKernelTable());
+    }
+
+    ImageKernelsBenchmark ImageKernels::RunBenchmark(size_t size)
+    {
+        ImageKernelsBenchmark result;
+        result.Width = size;
+        result.Height = size;
+        result.InstructionSet = ImageKernels::GetInstructionSet();
+
+        // smooth gradients with noise, so filters and conversions work on realistic data
+        size_t pixelCount = size * size;
+        MxVector<uint8_t> pixels(pixelCount * 4);
+        uint32_t seed = 0x12345678u;
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                uint8_t* pixel = pixels.data() + (y * size + x) * 4;
+                pixel[0] = uint8_t(x * 255 / size);
+                pixel[1] = uint8_t(y * 255 / size);
+                pixel[2] = uint8_t(seed >> 24);
+                pixel[3] = uint8_t((x + y) * 255 / (2 * size));
+            }
+        }
+        // float input covers negative, subnormal, overflowing and special values
+        MxVector<float> floats(pixelCount * 4);
+        for (size_t i = 0; i < floats.size(); i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            floats[i] = std::ldexp(float(int32_t(seed >> 16) - 32768), int((seed >> 8) % 48) - 40);
+        }
+        floats[0] = std::numeric_limits<float>::infinity();
+        floats[1] = -std::numeric_limits<float>::infinity();
+        floats[2] = std::numeric_limits<float>::quiet_NaN();
+        MxVector<uint16_t> halves(pixelCount * 4);
+        for (size_t i = 0; i < halves.size(); i++)
+            halves[i] = uint16_t(i);
+        const uint8_t bgra[4] = { 2, 1, 0, 3 };
+
+        // each vectorized output is compared to scalar reference, see KernelBenchmark::Measure()
+        KernelBenchmark<ImageKernelTable, ImageInstructionSet, ImageKernelTiming> benchmark(ScalarKernels, result.InstructionSet);
+        for (auto set : { ImageInstructionSet::SSE2, ImageInstructionSet::AVX2 })
+        {
+            if (ImageKernels::IsSupported(set)) benchmark.AddTable(set, GetKernelTable(set));
+        }
+
+        MxVector<uint8_t> bytes[2];
+        MxVector<float> floatOutput[2];
+        MxVector<uint16_t> halfOutput[2];
+        Image images[2];
+
+        benchmark.Measure("flip", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            bytes[isReference] = pixels;
+            kernels.FlipVertically(bytes[isReference].data(), size * 4, size);
+        }, [&]() { return ComputeKernelMaxError(bytes[1].data(), bytes[0].data(), bytes[0].size()); });
+
+        benchmark.Measure("swizzle", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            bytes[isReference].resize(pixels.size());
+            kernels.Swizzle(pixels.data(), bytes[isReference].data(), pixelCount, bgra);
+        }, [&]() { return ComputeKernelMaxError(bytes[1].data(), bytes[0].data(), bytes[0].size()); });
+
+        benchmark.Measure("extract channel", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            bytes[isReference].resize(pixelCount);
+            kernels.ExtractChannel(pixels.data(), 4, 2, bytes[isReference].data(), pixelCount);
+        }, [&]() { return ComputeKernelMaxError(bytes[1].data(), bytes[0].data(), bytes[0].size()); });
+
+        benchmark.Measure("insert channel", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            bytes[isReference] = pixels;
+            kernels.InsertChannel(pixels.data() + pixelCount, bytes[isReference].data(), 4, 1, pixelCount);
+        }, [&]() { return ComputeKernelMaxError(bytes[1].data(), bytes[0].data(), bytes[0].size()); });
+
+        benchmark.Measure("sRGB to float", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            floatOutput[isReference].resize(pixels.size());
+            kernels.ConvertToFloat(pixels.data(), floatOutput[isReference].data(), pixelCount, 4, ColorSpace::SRGB);
+        }, [&]() { return ComputeKernelMaxError(floatOutput[1].data(), floatOutput[0].data(), floatOutput[0].size()); });
+
+        benchmark.Measure("float to sRGB", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            bytes[isReference].resize(pixels.size());
+            kernels.ConvertToByte(floats.data(), bytes[isReference].data(), pixelCount, 4, ColorSpace::SRGB);
+        }, [&]() { return ComputeKernelMaxError(bytes[1].data(), bytes[0].data(), bytes[0].size()); });
+
+        benchmark.Measure("float to byte", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            bytes[isReference].resize(pixels.size());
+            kernels.ConvertToByte(floats.data(), bytes[isReference].data(), pixelCount, 4, ColorSpace::LINEAR);
+        }, [&]() { return ComputeKernelMaxError(bytes[1].data(), bytes[0].data(), bytes[0].size()); });
+
+        benchmark.Measure("float to half", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            halfOutput[isReference].resize(floats.size());
+            kernels.ConvertToHalf(floats.data(), halfOutput[isReference].data(), floats.size());
+        }, [&]() { return ComputeKernelMaxError(halfOutput[1].data(), halfOutput[0].data(), halfOutput[0].size()); });
+
+        benchmark.Measure("half to float", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            floatOutput[isReference].resize(halves.size());
+            kernels.ConvertFromHalf(halves.data(), floatOutput[isReference].data(), halves.size());
+        }, [&]() { return ComputeKernelMaxError(floatOutput[1].data(), floatOutput[0].data(), floatOutput[0].size()); });
+
+        auto copy = (uint8_t*)std::malloc(pixels.size());
+        std::memcpy(copy, pixels.data(), pixels.size());
+        Image source(copy, size, size, 4, false);
+        auto compareImages = [&]() { return ComputeKernelMaxError(images[1].GetRawData(), images[0].GetRawData(), images[0].GetTotalByteSize()); };
+
+        benchmark.Measure("box downsample", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            images[isReference] = MxEngine::DownsampleBox(source, kernels);
+        }, compareImages);
+
+        benchmark.Measure("kaiser downsample", [&](const ImageKernelTable& kernels, bool isReference)
+        {
+            images[isReference] = MxEngine::DownsampleKaiser(source, 4.0f, kernels);
+        }, compareImages);
+
+        result.FailedKernels = benchmark.Report("MxEngine::ImageKernels", [](const ImageKernelTiming& kernel) -> size_t
+        {
+            // filters accumulate in floats, so compiler may contract scalar reference differently
+            return std::strcmp(kernel.Name, "kaiser downsample") == 0 ? 1 : 0;
+        });
+        result.Kernels = std::move(benchmark.Timings);
+
+        MXLOG_INFO("MxEngine::ImageKernels", MxFormat("benchmark on {0}x{0} image using {1} kernels, {2} threads", 
+            size, EnumToString(result.InstructionSet), ThreadPool::GetWorkerCount() + 1));
+        if (result.FailedKernels > 0)
+            MXLOG_WARNING("MxEngine::ImageKernels", MxFormat("{0} kernels produced results different from scalar reference", result.FailedKernels));
+        return result;
+    }
+}
@@ -0,0 +1,166 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/Image/Image.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+namespace MxEngine
+{
+    enum class ImageInstructionSet : uint8_t
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+    };
+
+    const char* EnumToString(ImageInstructionSet set);
+
+    enum class ColorSpace : uint8_t
+    {
+        LINEAR,
+        SRGB,
+    };
+
+    /*!
+    timings of one image kernel, measured in seconds. Error is the maximal difference from scalar kernel output in units in the last place of output type
+    */
+    struct ImageKernelTiming
+    {
+        const char* Name = "";
+        TimeStep Reference = 0.0f;
+        TimeStep Optimized = 0.0f;
+        size_t MaxError = 0;
+    };
+
+    /*!
+    results of image kernels benchmark. Each kernel of each supported instruction set is validated against scalar kernel
+    */
+    struct ImageKernelsBenchmark
+    {
+        size_t Width = 0;
+        size_t Height = 0;
+        ImageInstructionSet InstructionSet = ImageInstructionSet::SCALAR;
+        MxVector<ImageKernelTiming> Kernels;
+        size_t FailedKernels = 0;
+    };
+
+    /*!
+    ImageKernels contains vectorized implementations of common pixel operations on tightly packed images.
+    Each kernel has scalar, SSE2 and AVX2 version. Best instruction set is selected once at runtime, scalar kernels are used as reference.
+    Integer kernels produce exactly the same output on all instruction sets, floating point filters may differ by one in last bit of 8-bit result
+    */
+    class ImageKernels
+    {
+    public:
+        /*!
+        minimal number of rows processed by one thread in image-level operations. Smaller images are processed by the calling thread only
+        */
+        constexpr static size_t ParallelRowGranularity = 64;
+
+        /*!
+        gets instruction set which is used by kernels. It is the best instruction set supported both by compiler and current CPU
+        */
+        static ImageInstructionSet GetInstructionSet();
+        /*!
+        checks if kernels of the instruction set can be executed on current CPU
+        */
+        static bool IsSupported(ImageInstructionSet set);
+
+        /*!
+        flips rows of an image in place
+        \param data pointer to first row
+        \param rowByteSize size of each row in bytes (rows are tightly packed)
+        \param rowCount number of rows
+        */
+        static void FlipVertically(uint8_t* data, size_t rowByteSize, size_t rowCount);
+        static void FlipVertically(Image& image);
+        /*!
+        reorders channels of RGBA8 pixels. Source and destination may be the same
+        \param order index of source channel for each destination channel, for example { 2, 1, 0, 3 } converts BGRA to RGBA
+        */
+        static void Swizzle(const uint8_t* source, uint8_t* destination, size_t pixelCount, const uint8_t order[4]);
+        /*!
+        copies one channel of 8-bit pixels into tightly packed single-channel buffer
+        \param channelCount number of channels in source pixels (1 - 4)
+        \param channel index of channel to extract
+        */
+        static void ExtractChannel(const uint8_t* source, size_t channelCount, size_t channel, uint8_t* destination, size_t pixelCount);
+        /*!
+        copies tightly packed single-channel buffer into one channel of 8-bit pixels. Other channels are not modified
+        \param channelCount number of channels in destination pixels (1 - 4)
+        \param channel index of channel to overwrite
+        */
+        static void InsertChannel(const uint8_t* source, uint8_t* destination, size_t channelCount, size_t channel, size_t pixelCount);
+        /*!
+        converts 8-bit pixels to floating point in [0, 1] range. Alpha channel (last channel of 2 and 4 channel pixels) is always linear
+        \param space color space of source pixels. sRGB colors are converted to linear space
+        */
+        static void ConvertToFloat(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount, ColorSpace space);
+        /*!
+        converts floating point pixels to 8-bit. Values are clamped to [0, 1] range, NaNs are converted to zero.
+        Alpha channel (last channel of 2 and 4 channel pixels) is always linear
+        \param space color space of destination pixels. Linear colors are encoded to sRGB (with error at most one)
+        */
+        static void ConvertToByte(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount, ColorSpace space);
+        /*!
+        converts floats to IEEE half precision values with round-to-nearest-even. Overflowing values become infinities
+        */
+        static void ConvertToHalf(const float* source, uint16_t* destination, size_t count);
+        /*!
+        converts IEEE half precision values to floats. Conversion is exact
+        */
+        static void ConvertFromHalf(const uint16_t* source, float* destination, size_t count);
+        /*!
+        copies rectangle of bytes between images with different strides
+        \param rowByteSize number of bytes copied from each row
+        \param rowCount number of rows to copy
+        */
+        static void Blit(const uint8_t* source, size_t sourceStride, uint8_t* destination, size_t destinationStride, size_t rowByteSize, size_t rowCount);
+        /*!
+        downsamples 8-bit image by half using 2x2 box filter. Last row and column of odd-sized image are skipped
+        \returns image with half width and height (at least 1x1)
+        */
+        static Image DownsampleBox(const Image& image);
+        /*!
+        downsamples 8-bit image by half using separable Kaiser-windowed sinc filter with 8 taps. Image borders are clamped
+        \param alpha Kaiser window shape parameter. Bigger values reduce ringing, but blur the result more
+        \returns image with half width and height (at least 1x1)
+        */
+        static Image DownsampleKaiser(const Image& image, float alpha = 4.0f);
+        /*!
+        runs each kernel on generated image through scalar and all supported vectorized versions, validating their results and logging timings
+        \param size width and height of generated image
+        \returns benchmark timings and validation results
+        */
+        static ImageKernelsBenchmark RunBenchmark(size_t size = 2048);
+    };
+}
@@ -0,0 +1,143 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace MxEngine
+{
+    /*!
+    computes maximal difference between two buffers in units of their element type. Floats are compared by their bit patterns
+    */
+    template<typename T>
+    size_t ComputeKernelMaxError(const T* expected, const T* actual, size_t count)
+    {
+        size_t maxError = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            int64_t a, b;
+            if constexpr (std::is_same_v<T, float>)
+            {
+                uint32_t bitsA = 0, bitsB = 0;
+                std::memcpy(&bitsA, &expected[i], sizeof(bitsA));
+                std::memcpy(&bitsB, &actual[i], sizeof(bitsB));
+                a = (int64_t)bitsA;
+                b = (int64_t)bitsB;
+            }
+            else
+            {
+                a = (int64_t)expected[i];
+                b = (int64_t)actual[i];
+            }
+            maxError = std::max(maxError, (size_t)std::abs(a - b));
+        }
+        return maxError;
+    }
+
+    /*!
+    kernel benchmark runs each kernel with scalar table and with all supported vectorized tables, validating them against scalar output.
+    Used by image and audio kernels, which share the same table-per-instruction-set layout. Timing type must have Name, Reference, Optimized
+    and MaxError fields (see ImageKernelTiming)
+    */
+    template<typename Table, typename InstructionSet, typename Timing>
+    class KernelBenchmark
+    {
+        const Table& reference;
+        InstructionSet activeSet;
+        MxVector<std::pair<InstructionSet, const Table*>> tables;
+    public:
+        MxVector<Timing> Timings;
+
+        /*!
+        creates benchmark without vectorized tables
+        \param reference scalar kernel table
+        \param activeSet instruction set used by engine. Its timing is reported as optimized one
+        */
+        KernelBenchmark(const Table& reference, InstructionSet activeSet)
+            : reference(reference), activeSet(activeSet) { }
+
+        void AddTable(InstructionSet set, const Table& table)
+        {
+            this->tables.emplace_back(set, &table);
+        }
+
+        /*!
+        runs kernel with scalar table and then with each vectorized table. Output of each vectorized run is compared to reference output
+        \param name name of kernel (must outlive benchmark results)
+        \param run callable with (const Table& kernels, bool isReference) signature. Reference output must be stored apart from others
+        \param compare callable without arguments, which returns maximal error of last vectorized output
+        */
+        template<typename Run, typename Compare>
+        void Measure(const char* name, Run&& run, Compare&& compare)
+        {
+            Timing timing;
+            timing.Name = name;
+            TimeStep start = Time::Current();
+            run(this->reference, true);
+            timing.Reference = Time::Current() - start;
+            for (const auto& [set, table] : this->tables)
+            {
+                start = Time::Current();
+                run(*table, false);
+                if (set == this->activeSet) timing.Optimized = Time::Current() - start;
+                timing.MaxError = std::max(timing.MaxError, compare());
+            }
+            this->Timings.push_back(timing);
+        }
+
+        /*!
+        logs timings of all measured kernels
+        \param caller logger category
+        \param getTolerance callable with (const Timing&) signature, which returns maximal allowed error of kernel
+        \returns number of kernels which error exceeds their tolerance
+        */
+        template<typename F>
+        size_t Report(const char* caller, F&& getTolerance) const
+        {
+            size_t failedKernels = 0;
+            for (const auto& kernel : this->Timings)
+            {
+                if (kernel.MaxError > getTolerance(kernel)) failedKernels++;
+
+                MXLOG_INFO(caller, MxFormat("{0}: {1}ms -> {2}ms, max error {3}", kernel.Name,
+                    kernel.Reference * 1000.0f, kernel.Optimized * 1000.0f, kernel.MaxError));
+            }
+            return failedKernels;
+        }
+    };
+}
@@ -30,6 +30,7 @@
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/Format/Format.h"
 #include "Utilities/Random/Random.h"
+#include "Utilities/MeshOptimizer/MeshOptimizer.h"
 
 #include <array>
 #include <map>
@@ -37,18 +38,18 @@
 namespace MxEngine
 {
     LODGenerator::LODGenerator(const MeshData& mesh)
-        : mesh(mesh) { }
+        : LODGenerator(mesh.GetVertecies(), mesh.GetIndicies(), mesh.GetBoundingBox()) { }
+
+    LODGenerator::LODGenerator(const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies, const AABB& boundingBox)
+        : vertecies(vertecies), indicies(indicies), boundingBox(boundingBox) { }
 
     void LODGenerator::PrepareIndexData(float threshold)
     {
-        auto& vertecies = mesh.GetVertecies();
-        auto& indicies = mesh.GetIndicies();
-
-        projection.resize(vertecies.size(), std::numeric_limits<uint32_t>::max());
+        projection.assign(vertecies.size(), std::numeric_limits<uint32_t>::max());
+        weights.clear();
         weights.resize(vertecies.size());
 
-        Vector3Cmp::Threshold = threshold;
-        MxMap<Vector3, size_t, Vector3Cmp> vertexMapping;
+        MxMap<Vector3, size_t, Vector3Cmp> vertexMapping(Vector3Cmp{ threshold });
         
         for (size_t i = 0; i < indicies.size(); i += 3)
         {
@@ -70,7 +71,7 @@ namespace MxEngine
 
     size_t LODGenerator::CollapseDublicate(MxMap<Vector3, size_t, Vector3Cmp>& vertexMapping, size_t f)
     {
-        const Vector3& Vf = mesh.GetVertecies()[f].Position;
+        const Vector3& Vf = this->vertecies[f].Position;
 
         auto it = vertexMapping.find(Vf);
         if (it == vertexMapping.end())
@@ -84,28 +85,30 @@ namespace MxEngine
         }
     }
 
-    MeshData LODGenerator::CreateObject(float threshold)
+    LODGenerator::LODData LODGenerator::CreateObjectData(float threshold)
     {
-        MeshData result;
+        LODData result;
 
         threshold = Clamp(threshold, 0.0f, 1.0f);
         if (threshold == 0.0f) //-V550
         {
-            result = this->mesh;
+            result.Vertecies = this->vertecies;
+            result.Indicies = this->indicies;
+            result.Optimization = MeshOptimizer::Optimize(result.Vertecies, result.Indicies);
             return result;
         }
 
-        Vector3 distance = mesh.GetBoundingBox().Length();
+        Vector3 distance = this->boundingBox.Length();
         float averageDistance = Dot(distance, MakeVector3(1.0f / 3.0f));
         if (averageDistance == 0.0f) averageDistance = 1.0f; //-V550
         this->PrepareIndexData(threshold * averageDistance);
 
         constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
 
-        auto& oldVertecies = mesh.GetVertecies();
-        auto& oldIndicies  = mesh.GetIndicies();
-        auto& vertecies    = result.GetVertecies();
-        auto& indicies     = result.GetIndicies();
+        auto& oldVertecies = this->vertecies;
+        auto& oldIndicies  = this->indicies;
+        auto& vertecies    = result.Vertecies;
+        auto& indicies     = result.Indicies;
 
         // collapse vertecies. If triangle has pair of equal verticies - ignore it
         indicies.reserve(oldIndicies.size());
@@ -157,8 +160,21 @@ namespace MxEngine
             f = (uint32_t)indexTable[f];
         }
 
+        // vertex collapse breaks original triangle order, so restore cache locality
+        result.Optimization = MeshOptimizer::Optimize(vertecies, indicies);
+
         indicies.shrink_to_fit();
         vertecies.shrink_to_fit();
+        return result;
+    }
+
+    MeshData LODGenerator::CreateObject(float threshold)
+    {
+        auto data = this->CreateObjectData(threshold);
+
+        MeshData result;
+        result.GetVertecies() = std::move(data.Vertecies);
+        result.GetIndicies() = std::move(data.Indicies);
         result.BufferIndicies();
         result.BufferVertecies();
         return result;
@@ -31,26 +31,26 @@
 #include "Utilities/ObjectLoader/ObjectLoader.h"
 #include "Utilities/STL/MxMap.h"
 #include "Utilities/STL/MxHashMap.h"
+#include "Utilities/MeshOptimizer/MeshOptimizer.h"
 
 namespace MxEngine
 {
     /*!
     This class is used to generate object LODs by comparing vertecies. It is passed as set comparator to filter unique vertecies with some threshold
-    \warning TODO: make this class thread-safe and non-static
     */
     struct Vector3Cmp
     {
         /*!
         threshold which sets epsilon to ignore. If vec_abs(v1 - v2) == vec(threshold), v1 considered equal to v2
         */
-        inline static float Threshold = 100.0f;
+        float Threshold = 100.0f;
 
-        static bool EqF(float x, float y)
+        bool EqF(float x, float y) const
         {
             return std::abs(x - y) <= Threshold;
         }
 
-        static bool LessF(float x, float y) 
+        bool LessF(float x, float y) const
         {
             return y - x >= Threshold;
         }
@@ -75,9 +75,11 @@ namespace MxEngine
     class LODGenerator
     {
         /*!
-        initial object reference. Used to generate LODs and does not changed by LODGenerator
+        initial object data references. Used to generate LODs and does not changed by LODGenerator
         */
-        const MeshData& mesh;
+        const MxVector<Vertex>& vertecies;
+        const MxVector<uint32_t>& indicies;
+        AABB boundingBox;
 
         using ProjectionTable = MxVector<uint32_t>;
         using WeightList = MxHashMap<size_t, size_t>;
@@ -104,15 +106,37 @@ namespace MxEngine
         void PrepareIndexData(float threshold);
     public:
         /*!
-        construct LODGenerator object. Calls PrepareIndexData() method. Note that MeshData must not be destroyed till LODGenerator is used
+        CPU-side LOD data which does not own any graphic resources and can be safely created on any thread
+        */
+        struct LODData
+        {
+            MxVector<Vertex> Vertecies;
+            MxVector<uint32_t> Indicies;
+            MeshOptimizationReport Optimization;
+        };
+
+        /*!
+        construct LODGenerator object. Note that MeshData must not be destroyed till LODGenerator is used
         \param mesh mesh of object from which LODs will be generated
         */
         LODGenerator(const MeshData& mesh);
         /*!
-        creates new LOD as MeshData object.
+        construct LODGenerator object from raw mesh data. Note that vertecies and indicies must not be destroyed till LODGenerator is used
+        \param vertecies vertex data of mesh from which LODs will be generated
+        \param indicies index data of mesh from which LODs will be generated
+        \param boundingBox bounding box of mesh vertecies
+        */
+        LODGenerator(const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies, const AABB& boundingBox);
+        /*!
+        creates new LOD as raw vertex and index data, optimized by MeshOptimizer. Does not touch graphic API, so can be called from worker threads
+        \param threshold minimal value in vertecies components from which vertecies are considered equal (see Vector3Cmp comparator)
+        \returns mesh LOD as LODData
+        */
+        LODData CreateObjectData(float threshold);
+        /*!
+        creates new LOD as MeshData object and buffers it to GPU. Must be called from main thread
         \param threshold minimal value in vertecies components from which vertecies are considered equal (see Vector3Cmp comparator)
         \returns mesh LOD as MeshData
-        \warning this function is not Thread-safe even across multiple LODGenerator instances, as Vector3Cmp uses static field (TODO fix this)
         */
         MeshData CreateObject(float threshold);
     };
@@ -142,6 +142,7 @@ namespace MxEngine
     {
         if ((uint8_t)type >= (uint8_t)Logger::GetVerbosityLevel())
         {
+            std::lock_guard<std::recursive_mutex> lock(logger->Mutex);
             SetConsoleColor(logger->Colors[(size_t)type]);
             Logger::LogLineToConsole(text);
             SetConsoleColor(ConsoleColor::GRAY);
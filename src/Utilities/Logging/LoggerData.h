@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <mutex>
 
 #include "LogSettings.h"
 #include "Platform.h"
@@ -10,6 +11,7 @@ namespace MxEngine
     struct LoggerData
     {
         std::ofstream LogFile;
+        std::recursive_mutex Mutex; // messages may be logged from worker threads
 
         VerbosityLevel Verbosity = VerbosityLevel::ALL;
         bool AbortOnFatal = true;
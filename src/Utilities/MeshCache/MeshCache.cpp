@@ -0,0 +1,487 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "MeshCache.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/FileSystem/CacheFile.h"
+#include "Utilities/GeometryKernels/GeometryKernels.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <cstring>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+namespace MxEngine
+{
+    constexpr uint8_t MeshCacheMagic[8] = { 'M', 'X', 'M', 'E', 'S', 'H', '\0', '\0' };
+
+    enum MeshCacheSubmeshFlags : uint32_t
+    {
+        MESH_CACHE_USE_TEXTURE = 1 << 0,
+        MESH_CACHE_USE_NORMAL  = 1 << 1,
+    };
+
+    constexpr uint32_t MeshCacheNoMaterial = 0xFFFFFFFF;
+
+    struct MeshCacheString
+    {
+        uint32_t Offset;
+        uint32_t Length;
+    };
+
+    struct MeshCacheHeader
+    {
+        uint8_t Magic[8];
+        uint32_t Version;
+        uint32_t VertexStride;
+        SourceStamp Source;
+        uint32_t ImportFlags;
+        uint32_t SubmeshCount;
+        uint32_t MaterialCount;
+        uint32_t TextureCount;
+        uint32_t DependencyCount;
+        uint32_t StringTableSize;
+        uint64_t SubmeshTableOffset;
+        uint64_t MaterialTableOffset;
+        uint64_t TextureTableOffset;
+        uint64_t DependencyTableOffset;
+        uint64_t StringTableOffset;
+        uint64_t FileSize;
+        float BoundsMin[3];
+        float BoundsMax[3];
+    };
+
+    struct MeshCacheSubmesh
+    {
+        MeshCacheString Name;
+        uint32_t MaterialIndex;
+        uint32_t Flags;
+        uint64_t VertexOffset;
+        uint64_t VertexCount;
+        uint64_t IndexOffset;
+        uint64_t IndexCount;
+        float BoundsMin[3];
+        float BoundsMax[3];
+    };
+
+    struct MeshCacheMaterial
+    {
+        MeshCacheString Name;
+        MeshCacheString AlbedoMap;
+        MeshCacheString EmmisiveMap;
+        MeshCacheString HeightMap;
+        MeshCacheString NormalMap;
+        MeshCacheString AmbientOcclusionMap;
+        MeshCacheString MetallicMap;
+        MeshCacheString RoughnessMap;
+        float Transparency;
+        float Displacement;
+        float Emmision;
+        float MetallicFactor;
+        float RoughnessFactor;
+        float BaseColor[3];
+        float UVMultipliers[2];
+    };
+
+    struct MeshCacheTexture
+    {
+        MeshCacheString Path;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t Channels;
+        uint32_t IsFloatingPoint;
+        uint64_t DataOffset;
+        uint64_t ByteSize;
+    };
+
+    struct MeshCacheDependency
+    {
+        MeshCacheString Path;
+        SourceStamp Source;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Vertex>, "vertex must be trivially copyable to be stored in mesh cache");
+    static_assert(sizeof(Vertex) == Vertex::Size * sizeof(float), "vertex must not contain padding to be stored in mesh cache");
+
+    MxString MeshCache::GetCachePath(const MxString& path)
+    {
+        return path + ".mxmesh";
+    }
+
+    bool MeshCache::Load(const MxString& path, ObjectInfo& object, uint32_t importFlags)
+    {
+        MAKE_SCOPE_PROFILER("MeshCache::Load()");
+        auto cachePath = ToFilePath(MeshCache::GetCachePath(path));
+        if (!File::IsFile(cachePath)) return false;
+
+        MappedFile cache(cachePath);
+        const uint8_t* bytes = cache.GetData();
+        const uint64_t fileSize = (uint64_t)cache.GetSize();
+        if (bytes == nullptr || fileSize < sizeof(MeshCacheHeader))
+        {
+            MXLOG_WARNING("MxEngine::MeshCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+
+        MeshCacheHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.Magic, MeshCacheMagic, sizeof(MeshCacheMagic)) != 0 || header.FileSize != fileSize)
+        {
+            MXLOG_WARNING("MxEngine::MeshCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+        if (header.Version != MeshCache::FormatVersion || header.VertexStride != sizeof(Vertex) || header.ImportFlags != importFlags)
+        {
+            MXLOG_DEBUG("MxEngine::MeshCache", "cache was built with other engine version or import settings: " + ToMxString(cachePath));
+            return false;
+        }
+
+        SourceStamp source;
+        auto sourceState = CacheFile::ValidateSource(ToFilePath(path), header.Source, source);
+        if (sourceState == SourceState::MODIFIED)
+        {
+            MXLOG_DEBUG("MxEngine::MeshCache", "cache is outdated: " + ToMxString(cachePath));
+            return false;
+        }
+
+        auto inRange = [fileSize](uint64_t offset, uint64_t count, uint64_t stride)
+        {
+            return offset <= fileSize && count <= (fileSize - offset) / stride;
+        };
+
+        if (!inRange(header.SubmeshTableOffset, header.SubmeshCount, sizeof(MeshCacheSubmesh)) ||
+            !inRange(header.MaterialTableOffset, header.MaterialCount, sizeof(MeshCacheMaterial)) ||
+            !inRange(header.TextureTableOffset, header.TextureCount, sizeof(MeshCacheTexture)) ||
+            !inRange(header.DependencyTableOffset, header.DependencyCount, sizeof(MeshCacheDependency)) ||
+            !inRange(header.StringTableOffset, header.StringTableSize, sizeof(char)))
+        {
+            MXLOG_WARNING("MxEngine::MeshCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+
+        const char* strings = (const char*)(bytes + header.StringTableOffset);
+        bool isCorrupted = false;
+        auto readString = [strings, &header, &isCorrupted](MeshCacheString str)
+        {
+            if ((uint64_t)str.Offset + str.Length > header.StringTableSize)
+            {
+                isCorrupted = true;
+                return MxString();
+            }
+            return MxString(strings + str.Offset, strings + str.Offset + str.Length);
+        };
+
+        // material libraries and binary buffers affect imported object same as object file itself
+        ObjectInfo result;
+        result.dependencies.resize(header.DependencyCount);
+        MxVector<std::pair<uint64_t, SourceStamp>> touchedDependencies;
+        for (size_t i = 0; i < result.dependencies.size(); i++)
+        {
+            uint64_t entryOffset = header.DependencyTableOffset + i * sizeof(MeshCacheDependency);
+            MeshCacheDependency entry;
+            std::memcpy(&entry, bytes + entryOffset, sizeof(entry));
+
+            auto& dependency = result.dependencies[i];
+            dependency = readString(entry.Path);
+            SourceStamp stamp;
+            auto state = CacheFile::ValidateSource(ToFilePath(dependency), entry.Source, stamp);
+            if (state == SourceState::MODIFIED)
+            {
+                MXLOG_DEBUG("MxEngine::MeshCache", "cache is outdated as " + dependency + " was modified: " + ToMxString(cachePath));
+                return false;
+            }
+            if (state == SourceState::TOUCHED)
+                touchedDependencies.emplace_back(entryOffset + offsetof(MeshCacheDependency, Source), stamp);
+        }
+
+        result.materials.resize(header.MaterialCount);
+        for (size_t i = 0; i < result.materials.size(); i++)
+        {
+            MeshCacheMaterial entry;
+            std::memcpy(&entry, bytes + header.MaterialTableOffset + i * sizeof(MeshCacheMaterial), sizeof(entry));
+
+            auto& material = result.materials[i];
+            material.Name                = readString(entry.Name);
+            material.AlbedoMap           = readString(entry.AlbedoMap);
+            material.EmmisiveMap         = readString(entry.EmmisiveMap);
+            material.HeightMap           = readString(entry.HeightMap);
+            material.NormalMap           = readString(entry.NormalMap);
+            material.AmbientOcclusionMap = readString(entry.AmbientOcclusionMap);
+            material.MetallicMap         = readString(entry.MetallicMap);
+            material.RoughnessMap        = readString(entry.RoughnessMap);
+            material.Transparency        = entry.Transparency;
+            material.Displacement        = entry.Displacement;
+            material.Emmision            = entry.Emmision;
+            material.MetallicFactor      = entry.MetallicFactor;
+            material.RoughnessFactor     = entry.RoughnessFactor;
+            material.BaseColor           = MakeVector3(entry.BaseColor[0], entry.BaseColor[1], entry.BaseColor[2]);
+            material.UVMultipliers       = MakeVector2(entry.UVMultipliers[0], entry.UVMultipliers[1]);
+        }
+
+        result.meshes.resize(header.SubmeshCount);
+        for (size_t i = 0; i < result.meshes.size(); i++)
+        {
+            MeshCacheSubmesh entry;
+            std::memcpy(&entry, bytes + header.SubmeshTableOffset + i * sizeof(MeshCacheSubmesh), sizeof(entry));
+
+            if (!inRange(entry.VertexOffset, entry.VertexCount, sizeof(Vertex)) ||
+                !inRange(entry.IndexOffset, entry.IndexCount, sizeof(uint32_t)) ||
+                (entry.MaterialIndex != MeshCacheNoMaterial && entry.MaterialIndex >= header.MaterialCount))
+            {
+                isCorrupted = true;
+                break;
+            }
+
+            auto& mesh = result.meshes[i];
+            mesh.name = readString(entry.Name);
+            mesh.useTexture = (entry.Flags & MESH_CACHE_USE_TEXTURE) != 0;
+            mesh.useNormal = (entry.Flags & MESH_CACHE_USE_NORMAL) != 0;
+            if (entry.MaterialIndex != MeshCacheNoMaterial)
+                mesh.material = result.materials.data() + entry.MaterialIndex;
+
+            // MeshData owns its CPU-side copy, so blobs are copied once directly from the mapped view
+            mesh.vertecies.resize((size_t)entry.VertexCount);
+            mesh.indicies.resize((size_t)entry.IndexCount);
+            std::memcpy(mesh.vertecies.data(), bytes + entry.VertexOffset, mesh.vertecies.size() * sizeof(Vertex));
+            std::memcpy(mesh.indicies.data(), bytes + entry.IndexOffset, mesh.indicies.size() * sizeof(uint32_t));
+        }
+
+        result.textures.resize(isCorrupted ? 0 : header.TextureCount);
+        for (size_t i = 0; i < result.textures.size(); i++)
+        {
+            MeshCacheTexture entry;
+            std::memcpy(&entry, bytes + header.TextureTableOffset + i * sizeof(MeshCacheTexture), sizeof(entry));
+
+            size_t pixelSize = (size_t)entry.Channels * (entry.IsFloatingPoint ? sizeof(float) : sizeof(uint8_t));
+            if (!inRange(entry.DataOffset, entry.ByteSize, sizeof(uint8_t)) || entry.ByteSize != (uint64_t)entry.Width * entry.Height * pixelSize)
+            {
+                isCorrupted = true;
+                break;
+            }
+
+            // embedded textures are stored decoded, so they are passed to texture creation without any conversion
+            auto data = (uint8_t*)std::malloc((size_t)entry.ByteSize);
+            std::memcpy(data, bytes + entry.DataOffset, (size_t)entry.ByteSize);
+
+            auto& texture = result.textures[i];
+            texture.Path = readString(entry.Path);
+            texture.Data = Image(data, entry.Width, entry.Height, entry.Channels, entry.IsFloatingPoint != 0);
+        }
+
+        if (isCorrupted)
+        {
+            MXLOG_WARNING("MxEngine::MeshCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+        cache.Close();
+
+        if (sourceState == SourceState::TOUCHED)
+            CacheFile::UpdateSourceStamp(cachePath, offsetof(MeshCacheHeader, Source), source);
+        for (const auto& [offset, stamp] : touchedDependencies)
+            CacheFile::UpdateSourceStamp(cachePath, offset, stamp);
+
+        object = std::move(result);
+        MXLOG_DEBUG("MxEngine::MeshCache", "loaded object from cache: " + ToMxString(cachePath));
+        return true;
+    }
+
+    bool MeshCache::Save(const ObjectInfo& object, const MxString& path, uint32_t importFlags)
+    {
+        MAKE_SCOPE_PROFILER("MeshCache::Save()");
+        auto sourcePath = ToFilePath(path);
+        auto cachePath = ToFilePath(MeshCache::GetCachePath(path));
+        SourceStamp source;
+        if (!CacheFile::GetSourceStamp(sourcePath, source))
+        {
+            MXLOG_WARNING("MxEngine::MeshCache", "cannot create cache for non-existing file: " + path);
+            return false;
+        }
+
+        MxString stringTable;
+        auto addString = [&stringTable](const MxString& str)
+        {
+            MeshCacheString result;
+            result.Offset = (uint32_t)stringTable.size();
+            result.Length = (uint32_t)str.size();
+            stringTable += str;
+            return result;
+        };
+
+        MeshCacheHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.Magic, MeshCacheMagic, sizeof(MeshCacheMagic));
+        header.Version = MeshCache::FormatVersion;
+        header.VertexStride = (uint32_t)sizeof(Vertex);
+        header.Source = source;
+        header.ImportFlags = importFlags;
+        header.SubmeshCount = (uint32_t)object.meshes.size();
+        header.MaterialCount = (uint32_t)object.materials.size();
+        header.TextureCount = (uint32_t)object.textures.size();
+        header.DependencyCount = (uint32_t)object.dependencies.size();
+
+        MxVector<MeshCacheMaterial> materials(object.materials.size());
+        for (size_t i = 0; i < materials.size(); i++)
+        {
+            const auto& material = object.materials[i];
+            auto& entry = materials[i];
+            entry.Name                = addString(material.Name);
+            entry.AlbedoMap           = addString(material.AlbedoMap);
+            entry.EmmisiveMap         = addString(material.EmmisiveMap);
+            entry.HeightMap           = addString(material.HeightMap);
+            entry.NormalMap           = addString(material.NormalMap);
+            entry.AmbientOcclusionMap = addString(material.AmbientOcclusionMap);
+            entry.MetallicMap         = addString(material.MetallicMap);
+            entry.RoughnessMap        = addString(material.RoughnessMap);
+            entry.Transparency        = material.Transparency;
+            entry.Displacement        = material.Displacement;
+            entry.Emmision            = material.Emmision;
+            entry.MetallicFactor      = material.MetallicFactor;
+            entry.RoughnessFactor     = material.RoughnessFactor;
+            entry.BaseColor[0]        = material.BaseColor.x;
+            entry.BaseColor[1]        = material.BaseColor.y;
+            entry.BaseColor[2]        = material.BaseColor.z;
+            entry.UVMultipliers[0]    = material.UVMultipliers.x;
+            entry.UVMultipliers[1]    = material.UVMultipliers.y;
+        }
+
+        MxVector<MeshCacheDependency> dependencies(object.dependencies.size());
+        for (size_t i = 0; i < dependencies.size(); i++)
+        {
+            auto& entry = dependencies[i];
+            entry.Path = addString(object.dependencies[i]);
+            if (!CacheFile::GetSourceStamp(ToFilePath(object.dependencies[i]), entry.Source))
+            {
+                MXLOG_WARNING("MxEngine::MeshCache", "cannot create cache as object dependency does not exist: " + object.dependencies[i]);
+                return false;
+            }
+        }
+
+        MxVector<MeshCacheTexture> textures(object.textures.size());
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            const auto& texture = object.textures[i];
+            auto& entry = textures[i];
+            entry.Path            = addString(texture.Path);
+            entry.Width           = (uint32_t)texture.Data.GetWidth();
+            entry.Height          = (uint32_t)texture.Data.GetHeight();
+            entry.Channels        = (uint32_t)texture.Data.GetChannelCount();
+            entry.IsFloatingPoint = texture.Data.IsFloatingPoint() ? 1 : 0;
+            entry.ByteSize        = texture.Data.GetTotalByteSize();
+        }
+
+        MxVector<MeshCacheSubmesh> submeshes(object.meshes.size());
+        AABB objectBounds{ MakeVector3(0.0f), MakeVector3(0.0f) };
+        for (size_t i = 0; i < submeshes.size(); i++)
+        {
+            const auto& mesh = object.meshes[i];
+            auto& entry = submeshes[i];
+            entry.Name = addString(mesh.name);
+            entry.Flags = (mesh.useTexture ? MESH_CACHE_USE_TEXTURE : 0) | (mesh.useNormal ? MESH_CACHE_USE_NORMAL : 0);
+            entry.MaterialIndex = mesh.material != nullptr ? (uint32_t)(mesh.material - object.materials.data()) : MeshCacheNoMaterial;
+            entry.VertexCount = mesh.vertecies.size();
+            entry.IndexCount = mesh.indicies.size();
+
+            AABB box;
+            BoundingSphere sphere;
+            GeometryKernels::ComputeBounds(mesh.vertecies, box, sphere);
+            if (i == 0) objectBounds = box;
+            objectBounds.Min = VectorMin(objectBounds.Min, box.Min);
+            objectBounds.Max = VectorMax(objectBounds.Max, box.Max);
+            for (size_t j = 0; j < 3; j++)
+            {
+                entry.BoundsMin[j] = box.Min[(int)j];
+                entry.BoundsMax[j] = box.Max[(int)j];
+            }
+        }
+        for (size_t j = 0; j < 3; j++)
+        {
+            header.BoundsMin[j] = objectBounds.Min[(int)j];
+            header.BoundsMax[j] = objectBounds.Max[(int)j];
+        }
+
+        // layout: header | submesh table | material table | texture table | dependency table | string table | aligned vertex, index and texture blobs
+        uint64_t offset = sizeof(MeshCacheHeader);
+        header.SubmeshTableOffset = offset = CacheFile::AlignOffset(offset, alignof(uint64_t));
+        offset += submeshes.size() * sizeof(MeshCacheSubmesh);
+        header.MaterialTableOffset = offset = CacheFile::AlignOffset(offset, alignof(uint64_t));
+        offset += materials.size() * sizeof(MeshCacheMaterial);
+        header.TextureTableOffset = offset = CacheFile::AlignOffset(offset, alignof(uint64_t));
+        offset += textures.size() * sizeof(MeshCacheTexture);
+        header.DependencyTableOffset = offset = CacheFile::AlignOffset(offset, alignof(uint64_t));
+        offset += dependencies.size() * sizeof(MeshCacheDependency);
+        header.StringTableOffset = offset;
+        header.StringTableSize = (uint32_t)stringTable.size();
+        offset += stringTable.size();
+        for (auto& entry : submeshes)
+        {
+            entry.VertexOffset = offset = CacheFile::AlignOffset(offset, MeshCache::BlobAlignment);
+            offset += entry.VertexCount * sizeof(Vertex);
+            entry.IndexOffset = offset = CacheFile::AlignOffset(offset, MeshCache::BlobAlignment);
+            offset += entry.IndexCount * sizeof(uint32_t);
+        }
+        for (auto& entry : textures)
+        {
+            entry.DataOffset = offset = CacheFile::AlignOffset(offset, MeshCache::BlobAlignment);
+            offset += entry.ByteSize;
+        }
+        header.FileSize = offset;
+
+        bool isWritten = CacheFile::Write(cachePath, [&](CacheWriter& writer)
+        {
+            writer.WriteAt(0, &header, sizeof(header));
+            writer.WriteAt(header.SubmeshTableOffset, submeshes.data(), submeshes.size() * sizeof(MeshCacheSubmesh));
+            writer.WriteAt(header.MaterialTableOffset, materials.data(), materials.size() * sizeof(MeshCacheMaterial));
+            writer.WriteAt(header.TextureTableOffset, textures.data(), textures.size() * sizeof(MeshCacheTexture));
+            writer.WriteAt(header.DependencyTableOffset, dependencies.data(), dependencies.size() * sizeof(MeshCacheDependency));
+            writer.WriteAt(header.StringTableOffset, stringTable.data(), stringTable.size());
+            for (size_t i = 0; i < submeshes.size(); i++)
+            {
+                const auto& mesh = object.meshes[i];
+                writer.WriteAt(submeshes[i].VertexOffset, mesh.vertecies.data(), mesh.vertecies.size() * sizeof(Vertex));
+                writer.WriteAt(submeshes[i].IndexOffset, mesh.indicies.data(), mesh.indicies.size() * sizeof(uint32_t));
+            }
+            for (size_t i = 0; i < textures.size(); i++)
+                writer.WriteAt(textures[i].DataOffset, object.textures[i].Data.GetRawData(), (size_t)textures[i].ByteSize);
+        });
+        if (!isWritten) return false;
+
+        MXLOG_DEBUG("MxEngine::MeshCache", MxFormat("created cache {0} ({1} submeshes, {2} bytes)", 
+            ToMxString(cachePath).c_str(), header.SubmeshCount, header.FileSize));
+        return true;
+    }
+
+    void MeshCache::Invalidate(const MxString& path)
+    {
+        std::error_code error;
+        std::filesystem::remove(ToFilePath(MeshCache::GetCachePath(path)), error);
+    }
+}
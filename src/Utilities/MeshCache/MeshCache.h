@@ -0,0 +1,82 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/ObjectLoader/ObjectLoader.h"
+
+namespace MxEngine
+{
+    /*!
+    MeshCache stores imported objects in engine-native .mxmesh format next to their source files.
+    Cache file consists of versioned header, submesh, material and texture tables, string table and raw vertex / index / embedded texture blobs.
+    Blobs are stored in the same layout as runtime buffers and aligned at 64 bytes, so loading is a bulk copy out of mapped file without per-element conversion.
+    Cache is rebuilt when object file or any of its companion files (material libraries, binary buffers) is edited, or when it was imported with other settings
+    */
+    class MeshCache
+    {
+    public:
+        /*!
+        version of .mxmesh format. Caches with other versions are ignored and rebuilt
+        */
+        constexpr static uint32_t FormatVersion = 3;
+        /*!
+        alignment in bytes of each vertex / index / texture blob inside cache file
+        */
+        constexpr static size_t BlobAlignment = 64;
+
+        /*!
+        gets path of cache file for object source file
+        \param path path to object source file
+        \returns path to .mxmesh file
+        */
+        static MxString GetCachePath(const MxString& path);
+        /*!
+        loads object from memory-mapped cache file if it exists and is up-to-date with its source
+        \param path path to object source file (not to the cache itself)
+        \param object object info to load data to. Not modified if cache cannot be used
+        \param importFlags user-defined import settings. Cache built with other settings is treated as outdated
+        \returns true if object was loaded from cache, false either
+        */
+        static bool Load(const MxString& path, ObjectInfo& object, uint32_t importFlags = 0);
+        /*!
+        writes object to cache file, replacing old one only after new cache is complete
+        \param object object info to save
+        \param path path to object source file (not to the cache itself)
+        \param importFlags user-defined import settings which were used to produce object
+        \returns true if cache was written successfully, false either
+        */
+        static bool Save(const ObjectInfo& object, const MxString& path, uint32_t importFlags = 0);
+        /*!
+        removes cache file of object source file if it exists
+        \param path path to object source file
+        */
+        static void Invalidate(const MxString& path);
+    };
+}
@@ -0,0 +1,393 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "MeshOptimizer.h"
+#include "Utilities/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace MxEngine
+{
+    constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    /*!
+    scoring function from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    vertecies of last triangle get fixed score, other cached vertecies are scored by their position in LRU cache
+    vertecies with few remaining triangles are boosted to get rid of lonely triangles as fast as possible
+    */
+    static float ComputeVertexScore(int cachePosition, uint32_t remainingTriangles)
+    {
+        constexpr float CacheDecayPower = 1.5f;
+        constexpr float LastTriangleScore = 0.75f;
+        constexpr float ValenceBoostScale = 2.0f;
+        constexpr float ValenceBoostPower = 0.5f;
+        constexpr int CacheSize = (int)MeshOptimizer::OptimizationCacheSize;
+
+        if (remainingTriangles == 0) return -1.0f; // vertex is not used anymore
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                score = LastTriangleScore;
+            }
+            else
+            {
+                float scaler = 1.0f / float(CacheSize - 3);
+                score = std::pow(1.0f - float(cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+        score += ValenceBoostScale * std::pow((float)remainingTriangles, -ValenceBoostPower);
+        return score;
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const MxVector<uint32_t>& indicies, size_t vertexCount, size_t cacheSize)
+    {
+        VertexCacheStatistics result;
+        result.TriangleCount = indicies.size() / 3;
+        if (result.TriangleCount == 0 || vertexCount == 0) return result;
+
+        // FIFO cache is simulated with timestamps: vertex is cached if it was inserted less than cacheSize insertions ago
+        MxVector<size_t> cacheTimestamps(vertexCount, 0);
+        MxVector<bool> isUsed(vertexCount, false);
+        size_t timestamp = cacheSize + 1;
+
+        for (size_t i = 0; i < result.TriangleCount * 3; i++)
+        {
+            uint32_t index = indicies[i];
+            if (timestamp - cacheTimestamps[index] > cacheSize)
+            {
+                cacheTimestamps[index] = timestamp++;
+                result.TransformedVertecies++;
+            }
+            if (!isUsed[index])
+            {
+                isUsed[index] = true;
+                result.VertexCount++;
+            }
+        }
+
+        result.ACMR = float(result.TransformedVertecies) / float(result.TriangleCount);
+        result.ATVR = float(result.TransformedVertecies) / float(result.VertexCount);
+        return result;
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(MxVector<uint32_t>& indicies, size_t vertexCount)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexCache()");
+        constexpr size_t CacheSize = OptimizationCacheSize;
+
+        size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0 || vertexCount == 0) return;
+
+        // build vertex -> triangles adjacency in compressed form. Emitted triangles are swap-removed from each vertex range
+        MxVector<uint32_t> remainingTriangles(vertexCount, 0);
+        for (size_t i = 0; i < triangleCount * 3; i++)
+            remainingTriangles[indicies[i]]++;
+
+        MxVector<uint32_t> adjacencyOffsets(vertexCount, 0);
+        uint32_t offset = 0;
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            adjacencyOffsets[v] = offset;
+            offset += remainingTriangles[v];
+        }
+
+        MxVector<uint32_t> adjacency(triangleCount * 3);
+        MxVector<uint32_t> adjacencyCounts(vertexCount, 0);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = indicies[t * 3 + k];
+                adjacency[adjacencyOffsets[v] + adjacencyCounts[v]++] = (uint32_t)t;
+            }
+        }
+
+        MxVector<float> vertexScores(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+            vertexScores[v] = ComputeVertexScore(-1, remainingTriangles[v]);
+
+        MxVector<bool> isEmitted(triangleCount, false);
+        MxVector<uint32_t> result;
+        result.reserve(triangleCount * 3);
+
+        std::array<uint32_t, CacheSize + 3> cache;
+        std::array<uint32_t, CacheSize + 3> newCache;
+        size_t cacheCount = 0;
+
+        auto triangleScore = [&](size_t t)
+        {
+            return vertexScores[indicies[t * 3 + 0]] + vertexScores[indicies[t * 3 + 1]] + vertexScores[indicies[t * 3 + 2]];
+        };
+
+        size_t nextUnemitted = 0;
+        size_t bestTriangle = 0;
+        for (size_t emitted = 0; emitted < triangleCount; emitted++)
+        {
+            if (bestTriangle == InvalidIndex)
+            {
+                // no candidates in cache, continue from the first triangle which is not emitted yet
+                while (isEmitted[nextUnemitted]) nextUnemitted++;
+                bestTriangle = nextUnemitted;
+            }
+
+            const uint32_t* triangle = &indicies[bestTriangle * 3];
+            result.push_back(triangle[0]);
+            result.push_back(triangle[1]);
+            result.push_back(triangle[2]);
+            isEmitted[bestTriangle] = true;
+
+            // remove emitted triangle from adjacency of its vertecies
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t v = triangle[k];
+                uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+                uint32_t count = remainingTriangles[v];
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    if (begin[i] == (uint32_t)bestTriangle)
+                    {
+                        std::swap(begin[i], begin[count - 1]);
+                        break;
+                    }
+                }
+                remainingTriangles[v]--;
+            }
+
+            // move triangle vertecies to the front of LRU cache
+            size_t newCacheCount = 0;
+            for (size_t k = 0; k < 3; k++)
+                newCache[newCacheCount++] = triangle[k];
+            for (size_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t v = cache[i];
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                    newCache[newCacheCount++] = v;
+            }
+
+            // vertecies pushed out of cache lose their cache score
+            for (size_t i = CacheSize; i < newCacheCount; i++)
+            {
+                uint32_t v = newCache[i];
+                vertexScores[v] = ComputeVertexScore(-1, remainingTriangles[v]);
+            }
+            cacheCount = Min(newCacheCount, CacheSize);
+            std::copy(newCache.begin(), newCache.begin() + cacheCount, cache.begin());
+
+            for (size_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t v = cache[i];
+                vertexScores[v] = ComputeVertexScore((int)i, remainingTriangles[v]);
+            }
+
+            // select next triangle among the ones adjacent to cached vertecies
+            bestTriangle = InvalidIndex;
+            float bestScore = -1.0f;
+            for (size_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t v = cache[i];
+                const uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+                for (uint32_t j = 0; j < remainingTriangles[v]; j++)
+                {
+                    float score = triangleScore(begin[j]);
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = begin[j];
+                    }
+                }
+            }
+        }
+
+        std::copy(result.begin(), result.end(), indicies.begin());
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(MxVector<uint32_t>& indicies, const MxVector<Vertex>& vertecies, float threshold)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeOverdraw()");
+        constexpr size_t CacheSize = AnalysisCacheSize;
+
+        size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0 || vertecies.empty()) return;
+
+        MxVector<size_t> cacheTimestamps(vertecies.size(), 0);
+        size_t timestamp = CacheSize + 1;
+
+        auto flushCache = [&timestamp]() { timestamp += CacheSize + 1; };
+        auto countMisses = [&](size_t t)
+        {
+            size_t misses = 0;
+            for (size_t k = 0; k < 3; k++)
+            {
+                uint32_t index = indicies[t * 3 + k];
+                if (timestamp - cacheTimestamps[index] > CacheSize)
+                {
+                    cacheTimestamps[index] = timestamp++;
+                    misses++;
+                }
+            }
+            return misses;
+        };
+
+        // hard boundaries: triangles which miss all their vertecies, so cache is effectively flushed there anyway
+        MxVector<size_t> hardClusters;
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            if (countMisses(t) == 3)
+                hardClusters.push_back(t);
+        }
+        hardClusters.push_back(triangleCount);
+
+        // soft boundaries: split hard clusters further while their local ACMR stays close to the one of whole cluster
+        MxVector<size_t> clusters;
+        for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+        {
+            size_t begin = hardClusters[c], end = hardClusters[c + 1];
+
+            flushCache();
+            size_t clusterMisses = 0;
+            for (size_t t = begin; t < end; t++)
+                clusterMisses += countMisses(t);
+            float clusterThreshold = threshold * float(clusterMisses) / float(end - begin);
+
+            flushCache();
+            size_t start = begin;
+            size_t misses = 0;
+            clusters.push_back(begin);
+            for (size_t t = begin; t < end; t++)
+            {
+                misses += countMisses(t);
+                if (t + 1 < end && float(misses) / float(t + 1 - start) <= clusterThreshold)
+                {
+                    clusters.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    flushCache();
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // sort clusters by how much they face outside of mesh center
+        size_t clusterCount = clusters.size() - 1;
+        Vector3 meshCenter = MakeVector3(0.0f);
+        for (const auto& vertex : vertecies)
+            meshCenter += vertex.Position;
+        meshCenter /= (float)vertecies.size();
+
+        MxVector<float> sortKeys(clusterCount);
+        for (size_t c = 0; c < clusterCount; c++)
+        {
+            Vector3 centroid = MakeVector3(0.0f);
+            Vector3 normal = MakeVector3(0.0f);
+            float totalArea = 0.0f;
+            for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+            {
+                const Vector3& p0 = vertecies[indicies[t * 3 + 0]].Position;
+                const Vector3& p1 = vertecies[indicies[t * 3 + 1]].Position;
+                const Vector3& p2 = vertecies[indicies[t * 3 + 2]].Position;
+                Vector3 areaNormal = Cross(p1 - p0, p2 - p0);
+                float area = Length(areaNormal);
+
+                centroid += area * (p0 + p1 + p2) / 3.0f;
+                normal += areaNormal;
+                totalArea += area;
+            }
+            float normalLength = Length(normal);
+            if (totalArea == 0.0f || normalLength == 0.0f) //-V550
+            {
+                sortKeys[c] = 0.0f;
+                continue;
+            }
+            centroid /= totalArea;
+            sortKeys[c] = Dot(centroid - meshCenter, normal / normalLength);
+        }
+
+        MxVector<uint32_t> clusterOrder(clusterCount);
+        for (size_t c = 0; c < clusterCount; c++)
+            clusterOrder[c] = (uint32_t)c;
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](uint32_t c1, uint32_t c2)
+        {
+            return sortKeys[c1] > sortKeys[c2];
+        });
+
+        MxVector<uint32_t> result;
+        result.reserve(triangleCount * 3);
+        for (uint32_t c : clusterOrder)
+        {
+            result.insert(result.end(), indicies.begin() + clusters[c] * 3, indicies.begin() + clusters[c + 1] * 3);
+        }
+        std::copy(result.begin(), result.end(), indicies.begin());
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(MxVector<Vertex>& vertecies, MxVector<uint32_t>& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexFetch()");
+        MxVector<uint32_t> remap(vertecies.size(), InvalidIndex);
+        MxVector<Vertex> result;
+        result.reserve(vertecies.size());
+
+        for (auto& index : indicies)
+        {
+            if (remap[index] == InvalidIndex)
+            {
+                remap[index] = (uint32_t)result.size();
+                result.push_back(vertecies[index]);
+            }
+            index = remap[index];
+        }
+        vertecies = std::move(result);
+    }
+
+    MeshOptimizationReport MeshOptimizer::Optimize(MxVector<Vertex>& vertecies, MxVector<uint32_t>& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::Optimize()");
+        MeshOptimizationReport report;
+        report.Before = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+        MeshOptimizer::OptimizeVertexCache(indicies, vertecies.size());
+        MeshOptimizer::OptimizeOverdraw(indicies, vertecies);
+        MeshOptimizer::OptimizeVertexFetch(vertecies, indicies);
+
+        report.After = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+        return report;
+    }
+
+    MeshOptimizationReport MeshOptimizer::Optimize(MeshData& mesh)
+    {
+        auto report = MeshOptimizer::Optimize(mesh.GetVertecies(), mesh.GetIndicies());
+        mesh.BufferVertecies();
+        mesh.BufferIndicies();
+        return report;
+    }
+}
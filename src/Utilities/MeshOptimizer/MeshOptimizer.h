@@ -0,0 +1,127 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Resources/MeshData.h"
+
+namespace MxEngine
+{
+    /*!
+    vertex cache efficiency of index buffer, measured by simulating FIFO post-transform cache
+    */
+    struct VertexCacheStatistics
+    {
+        /*!
+        average cache miss ratio - transformed vertecies per triangle. 0.5 is optimal for regular grids, 3.0 is worst case
+        */
+        float ACMR = 0.0f;
+        /*!
+        average transform to vertex ratio - transformed vertecies per unique vertex. 1.0 is optimal
+        */
+        float ATVR = 0.0f;
+        size_t TransformedVertecies = 0;
+        size_t TriangleCount = 0;
+        size_t VertexCount = 0;
+    };
+
+    /*!
+    result of mesh optimization pass, containing cache statistics before and after optimization
+    */
+    struct MeshOptimizationReport
+    {
+        VertexCacheStatistics Before;
+        VertexCacheStatistics After;
+    };
+
+    /*!
+    MeshOptimizer is a set of algorithms which reorder mesh data to make it more GPU-friendly without changing its appearance:
+    - post-transform vertex cache ordering (Tom Forsyth linear-speed vertex cache optimization)
+    - overdraw-aware cluster ordering (Sander et al. fast triangle reordering)
+    - vertex fetch remapping (vertecies are stored in order of first use)
+    all functions work with plain CPU-side data and can be safely called from worker threads
+    */
+    class MeshOptimizer
+    {
+    public:
+        /*!
+        size of LRU cache used by Forsyth algorithm to score vertecies
+        */
+        constexpr static size_t OptimizationCacheSize = 32;
+        /*!
+        size of FIFO cache used to measure ACMR / ATVR (close to real hardware)
+        */
+        constexpr static size_t AnalysisCacheSize = 16;
+        /*!
+        default ACMR threshold for overdraw clusters. Clusters can be split while their ACMR stays in range [ACMR, ACMR * threshold]
+        */
+        constexpr static float DefaultOverdrawThreshold = 1.05f;
+
+        /*!
+        simulates FIFO vertex cache to measure efficiency of index buffer
+        \param indicies triangle list indicies
+        \param vertexCount number of vertecies in mesh vertex buffer
+        \param cacheSize size of simulated cache
+        \returns vertex cache statistics
+        */
+        static VertexCacheStatistics AnalyzeVertexCache(const MxVector<uint32_t>& indicies, size_t vertexCount, size_t cacheSize = AnalysisCacheSize);
+        /*!
+        reorders triangles to maximize post-transform vertex cache hits
+        \param indicies triangle list indicies which will be reordered
+        \param vertexCount number of vertecies in mesh vertex buffer
+        */
+        static void OptimizeVertexCache(MxVector<uint32_t>& indicies, size_t vertexCount);
+        /*!
+        reorders clusters of triangles so outer-facing parts of mesh are drawn first, reducing overdraw. Should be called after OptimizeVertexCache
+        \param indicies triangle list indicies which will be reordered
+        \param vertecies mesh vertex buffer
+        \param threshold maximum allowed ACMR growth factor (see DefaultOverdrawThreshold)
+        */
+        static void OptimizeOverdraw(MxVector<uint32_t>& indicies, const MxVector<Vertex>& vertecies, float threshold = DefaultOverdrawThreshold);
+        /*!
+        reorders vertecies in order of their first use by index buffer and removes unused ones. Indicies are remapped accordingly
+        \param vertecies mesh vertex buffer which will be reordered
+        \param indicies triangle list indicies which will be remapped
+        */
+        static void OptimizeVertexFetch(MxVector<Vertex>& vertecies, MxVector<uint32_t>& indicies);
+        /*!
+        applies vertex cache, overdraw and vertex fetch optimizations to mesh data
+        \param vertecies mesh vertex buffer
+        \param indicies triangle list indicies
+        \returns cache statistics before and after optimization
+        */
+        static MeshOptimizationReport Optimize(MxVector<Vertex>& vertecies, MxVector<uint32_t>& indicies);
+        /*!
+        applies all optimizations to mesh data and buffers it to GPU. Must be called from main thread
+        \param mesh mesh which will be optimized
+        \returns cache statistics before and after optimization
+        */
+        static MeshOptimizationReport Optimize(MeshData& mesh);
+    };
+}
@@ -36,11 +36,15 @@
 #include "Utilities/Json/Json.h"
 #include "Utilities/Image/ImageLoader.h"
 #include "Utilities/Image/ImageManager.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+
+#include "Utilities/ImageKernels/ImageKernels.h"
 
 #include <algorithm>
 
 #if defined(MXENGINE_USE_ASSIMP)
 #include <assimp/Importer.hpp>
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/pbrmaterial.h>
@@ -54,92 +58,148 @@ namespace MxEngine
 	const char* const AOTexName = "ao";
 	const char* const RoughnessTexName = "roughness";
 	const char* const MetallicTexName = "metallic";
-	const char* const RoughnessMetallicTexName = "roughness-metallic";
 	constexpr ImageType PreferredFormat = ImageType::PNG;
 	const char* const PreferredExtension = ".png";
 
-	void SaveRoughnessMetallicTexture(const Image& image, const char* roughnessName, const char* metallicName, const FilePath& saveDirectory)
+	/*!
+	splits PBR roughness & metallic texture, which is encoded in G & B channels, into two single-channel images
+	\param image RGBA8 image to split
+	\returns pair of roughness and metallic images
+	*/
+	std::pair<Image, Image> SplitRoughnessMetallicTexture(const Image& image)
 	{
-		auto roughnessPath = ToMxString(saveDirectory / roughnessName) + PreferredExtension;
-		auto metallicPath  = ToMxString(saveDirectory /  metallicName) + PreferredExtension;
-		if (File::Exists(roughnessPath) || File::Exists(metallicPath))
-			return; // avoid rewriting existing textures
-
-		auto roughnessData = (uint8_t*)std::malloc(image.GetTotalByteSize());
-		auto metallicData = (uint8_t*)std::malloc(image.GetTotalByteSize());
-		Image roughness(roughnessData, image.GetWidth(), image.GetHeight(), 1, image.IsFloatingPoint());
-		Image metallic(metallicData, image.GetWidth(), image.GetHeight(), 1, image.IsFloatingPoint());
+		MAKE_SCOPE_PROFILER("ObjectLoader::SplitRoughnessMetallicTexture()");
+		MX_ASSERT(image.GetChannelCount() == 4 && !image.IsFloatingPoint());
+		size_t pixelCount = image.GetWidth() * image.GetHeight();
+		auto roughnessData = (uint8_t*)std::malloc(pixelCount);
+		auto metallicData = (uint8_t*)std::malloc(pixelCount);
+
+		const uint8_t* source = image.GetRawData();
+		ThreadPool::ParallelFor(pixelCount, 1 << 18, [source, roughnessData, metallicData](size_t begin, size_t end)
+		{
+			ImageKernels::ExtractChannel(source + begin * 4, 4, 1, roughnessData + begin, end - begin);
+			ImageKernels::ExtractChannel(source + begin * 4, 4, 2, metallicData + begin, end - begin);
+		});
+
+		return {
+			Image(roughnessData, image.GetWidth(), image.GetHeight(), 1, false),
+			Image(metallicData, image.GetWidth(), image.GetHeight(), 1, false)
+		};
+	}
 
-		for (size_t x = 0; x < image.GetWidth(); x++)
+	Image DecodeEmbeddedTexture(const aiTexture* texture)
+	{
+		if (texture->mHeight == 0) // compressed data (png, jpg)
+			return ImageLoader::LoadImageFromMemory((const uint8_t*)texture->pcData, texture->mWidth);
+
+		// uncompressed data is stored as BGRA texels, so it is only swizzled and vertically flipped
+		size_t width = (size_t)texture->mWidth, height = (size_t)texture->mHeight;
+		const uint8_t BGRAToRGBA[4] = { 2, 1, 0, 3 };
+		auto data = (uint8_t*)std::malloc(width * height * 4);
+		for (size_t y = 0; y < height; y++)
 		{
-			for (size_t y = 0; y < image.GetHeight(); y++)
-			{
-				if (image.IsFloatingPoint())
-				{
-					auto pixel = image.GetPixelFloat(x, y);
-					// G channel
-					roughness.SetPixelFloat(x, y, pixel[1], 0.0f, 0.0f, 0.0f);
-					// B channel
-					metallic.SetPixelFloat(x, y, pixel[2], 0.0f, 0.0f, 0.0f);
-				}
-				else
-				{
-					auto pixel = image.GetPixelByte(x, y);
-					// G channel
-					roughness.SetPixelByte(x, y, pixel[1], 0, 0, 0);
-					// B channel
-					metallic.SetPixelByte(x, y, pixel[2], 0, 0, 0);
-				}
-			}
+			auto source = (const uint8_t*)(texture->pcData + (height - y - 1) * width);
+			ImageKernels::Swizzle(source, data + y * width * 4, width, BGRAToRGBA);
 		}
-		ImageManager::SaveImage(roughnessPath, roughness, PreferredFormat);
-		ImageManager::SaveImage(metallicPath, metallic, PreferredFormat);
+		return Image(data, width, height, 4, false);
 	}
 
-	MxString GetActualTexturePath(const FilePath& lookupDirectory, const char* name, const aiScene* scene, const aiMaterial* material, aiTextureType type)
+	/*!
+	embedded textures are named after object file and their index inside it, so textures of different objects and materials never collide
+	*/
+	MxString GetEmbeddedTexturePath(const FilePath& objectPath, const char* name, const aiScene* scene, const aiTexture* texture)
 	{
-		auto path = ToMxString(lookupDirectory / name) + PreferredExtension;
-		if (File::Exists(path)) return path; // check if texture already on disk
+		size_t index = size_t(std::find(scene->mTextures, scene->mTextures + scene->mNumTextures, texture) - scene->mTextures);
+		auto filename = MxFormat("{0}.{1}-{2}{3}", ToMxString(objectPath.stem()), name, index, PreferredExtension);
+		return ToMxString(objectPath.parent_path() / filename.c_str());
+	}
 
-		if (material->GetTextureCount(type) > 0)
-		{
-			aiString assimpPath;
-			if (material->GetTexture(type, 0, &assimpPath) == aiReturn_SUCCESS)
-			{
-				const char* filepath = assimpPath.C_Str();
+	bool HasEmbeddedTexture(const ObjectInfo& object, const MxString& path)
+	{
+		return std::any_of(object.textures.begin(), object.textures.end(), [&path](const EmbeddedTexture& texture) { return texture.Path == path; });
+	}
 
-				// check if texture is embedded into object file
-				// if no - just return path to a texture
-				const aiTexture* data = scene->GetEmbeddedTexture(filepath);
-				if (data == nullptr) return ToMxString(lookupDirectory / filepath);
+	void AddEmbeddedTexture(ObjectInfo& object, const MxString& path, Image image, bool exportTexture)
+	{
+		// encoding to png is slow, so it is done only if user wants to edit textures of object
+		if (exportTexture) ImageManager::SaveImage(path, image, PreferredFormat);
+		object.textures.push_back(EmbeddedTexture{ path, std::move(image) });
+	}
 
-				// if texture data is embedded, we need to create a file from it
-				Image image;
-				if (data->mHeight == 0.0f) // compressed data (jpg)
-					image = ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, data->mWidth);
-				else
-					image = ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, data->mWidth * data->mHeight * sizeof(aiTexel));
+	const aiTexture* GetMaterialTexture(const aiScene* scene, const aiMaterial* material, aiTextureType type, aiString& assimpPath)
+	{
+		if (material->GetTextureCount(type) == 0 || material->GetTexture(type, 0, &assimpPath) != aiReturn_SUCCESS)
+			return nullptr;
+		return scene->GetEmbeddedTexture(assimpPath.C_Str());
+	}
 
-				// PBR roughness & metallic texture encoded in G & B channels
-				if (type == aiTextureType_UNKNOWN)
-				{
-					SaveRoughnessMetallicTexture(image, RoughnessTexName, MetallicTexName, lookupDirectory);
-				}
-				else
-				{				
-					// create image on disk to later load it
-					ImageManager::SaveImage(path, image, PreferredFormat);
-				}
-				return path;
+	MxString GetActualTexturePath(ObjectInfo& object, const FilePath& objectPath, const char* name, const aiScene* scene, const aiMaterial* material, aiTextureType type, bool exportTextures)
+	{
+		aiString assimpPath;
+		const aiTexture* data = GetMaterialTexture(scene, material, type, assimpPath);
+
+		// check if texture is embedded into object file
+		// if no - just return path to a texture
+		if (data == nullptr)
+			return assimpPath.length > 0 ? ToMxString(objectPath.parent_path() / assimpPath.C_Str()) : MxString();
+
+		// texture may be shared between materials or already exported by user, so it is decoded only once
+		auto path = GetEmbeddedTexturePath(objectPath, name, scene, data);
+		if (HasEmbeddedTexture(object, path) || File::Exists(path)) return path;
+
+		AddEmbeddedTexture(object, path, DecodeEmbeddedTexture(data), exportTextures);
+		return path;
+	}
+
+	std::pair<MxString, MxString> GetRoughnessMetallicTexturePaths(ObjectInfo& object, const FilePath& objectPath, const aiScene* scene, const aiMaterial* material, bool exportTextures)
+	{
+		// PBR roughness & metallic texture encoded in G & B channels. Only embedded textures are split
+		aiString assimpPath;
+		const aiTexture* data = GetMaterialTexture(scene, material, aiTextureType_UNKNOWN, assimpPath);
+		if (data == nullptr) return { };
+
+		auto roughnessPath = GetEmbeddedTexturePath(objectPath, RoughnessTexName, scene, data);
+		auto metallicPath = GetEmbeddedTexturePath(objectPath, MetallicTexName, scene, data);
+		bool isLoaded = HasEmbeddedTexture(object, roughnessPath) || (File::Exists(roughnessPath) && File::Exists(metallicPath));
+		if (isLoaded) return { roughnessPath, metallicPath };
+
+		auto image = DecodeEmbeddedTexture(data);
+		if (image.GetRawData() == nullptr) return { };
+
+		auto [roughness, metallic] = SplitRoughnessMetallicTexture(image);
+		AddEmbeddedTexture(object, roughnessPath, std::move(roughness), exportTextures);
+		AddEmbeddedTexture(object, metallicPath, std::move(metallic), exportTextures);
+		return { roughnessPath, metallicPath };
+	}
+
+	/*!
+	io system which remembers all files opened by importer, so caches can track material libraries and binary buffers of object
+	*/
+	class DependencyRecorderIOSystem : public Assimp::DefaultIOSystem
+	{
+		FilePath objectPath;
+		MxVector<MxString>& dependencies;
+	public:
+		DependencyRecorderIOSystem(const FilePath& objectPath, MxVector<MxString>& dependencies)
+			: objectPath(objectPath.lexically_normal()), dependencies(dependencies) { }
+
+		Assimp::IOStream* Open(const char* file, const char* mode) override
+		{
+			auto stream = Assimp::DefaultIOSystem::Open(file, mode);
+			auto path = FilePath(file).lexically_normal();
+			if (stream != nullptr && path != this->objectPath)
+			{
+				auto dependency = ToMxString(path);
+				if (std::find(this->dependencies.begin(), this->dependencies.end(), dependency) == this->dependencies.end())
+					this->dependencies.push_back(std::move(dependency));
 			}
+			return stream;
 		}
-		return MxString();
-	}
+	};
 
-	ObjectInfo ObjectLoader::Load(const MxString& filename)
+	ObjectInfo ObjectLoader::Load(const MxString& filename, bool exportEmbeddedTextures)
 	{
 		auto filepath = FilePath(filename.c_str());
-		auto directory = filepath.parent_path();
 		ObjectInfo object;
 
 		if (!File::Exists(filepath) || !File::IsFile(filepath))
@@ -152,7 +212,8 @@ namespace MxEngine
 		MAKE_SCOPE_TIMER("MxEngine::ObjectLoader", "ObjectLoader::LoadObject");
 		MXLOG_INFO("Assimp::Importer", "loading object from file: " + filename);
 
-		static Assimp::Importer importer; // TODO: not thread safe
+		Assimp::Importer importer; // importer is not re-entrant, so each load uses its own instance
+		importer.SetIOHandler(new DependencyRecorderIOSystem(filepath, object.dependencies)); // importer owns io system
 		const aiScene* scene = importer.ReadFile(filename.c_str(), 
 			aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices |
 			aiProcess_OptimizeGraph | aiProcess_OptimizeMeshes |
@@ -189,16 +250,20 @@ namespace MxEngine
 			// TODO: this is workaround, because some object formats export alpha channel as 0, but its actually means 1
 			if (materialInfo.Transparency == 0.0f) materialInfo.Transparency = 1.0f;
 
-			// process first to make sure metallic / roughness will present when checking for existing textures in GetActualTexturePath
-			auto _ = GetActualTexturePath(directory, RoughnessMetallicTexName, scene, material, aiTextureType_UNKNOWN);
+			// embedded textures are decoded into object info, so they can be passed to texture creation without disk roundtrip
+			auto roughnessMetallic = GetRoughnessMetallicTexturePaths(object, filepath, scene, material, exportEmbeddedTextures);
+
+			materialInfo.AlbedoMap           = GetActualTexturePath(object, filepath, AlbedoTexName,    scene, material, aiTextureType_DIFFUSE,           exportEmbeddedTextures);
+			materialInfo.EmmisiveMap         = GetActualTexturePath(object, filepath, EmmisiveTexName,  scene, material, aiTextureType_EMISSIVE,          exportEmbeddedTextures);
+			materialInfo.HeightMap           = GetActualTexturePath(object, filepath, HeightTexName,    scene, material, aiTextureType_HEIGHT,            exportEmbeddedTextures);
+			materialInfo.NormalMap           = GetActualTexturePath(object, filepath, NormalTexName,    scene, material, aiTextureType_NORMALS,           exportEmbeddedTextures);
+			materialInfo.AmbientOcclusionMap = GetActualTexturePath(object, filepath, AOTexName,        scene, material, aiTextureType_AMBIENT_OCCLUSION, exportEmbeddedTextures);
+			materialInfo.RoughnessMap        = GetActualTexturePath(object, filepath, RoughnessTexName, scene, material, aiTextureType_DIFFUSE_ROUGHNESS, exportEmbeddedTextures);
+			materialInfo.MetallicMap         = GetActualTexturePath(object, filepath, MetallicTexName,  scene, material, aiTextureType_METALNESS,         exportEmbeddedTextures);
 
-			materialInfo.AlbedoMap           = GetActualTexturePath(directory, AlbedoTexName,    scene, material, aiTextureType_DIFFUSE);
-			materialInfo.EmmisiveMap         = GetActualTexturePath(directory, EmmisiveTexName,  scene, material, aiTextureType_EMISSIVE);
-			materialInfo.HeightMap           = GetActualTexturePath(directory, HeightTexName,    scene, material, aiTextureType_HEIGHT);
-			materialInfo.NormalMap           = GetActualTexturePath(directory, NormalTexName,    scene, material, aiTextureType_NORMALS);
-			materialInfo.AmbientOcclusionMap = GetActualTexturePath(directory, AOTexName,        scene, material, aiTextureType_AMBIENT_OCCLUSION);
-			materialInfo.RoughnessMap        = GetActualTexturePath(directory, RoughnessTexName, scene, material, aiTextureType_DIFFUSE_ROUGHNESS);
-			materialInfo.MetallicMap         = GetActualTexturePath(directory, MetallicTexName,  scene, material, aiTextureType_METALNESS);
+			// split packed texture takes priority, as roughness and metallic maps may reference the packed texture itself
+			if (!roughnessMetallic.first.empty())  materialInfo.RoughnessMap = roughnessMetallic.first;
+			if (!roughnessMetallic.second.empty()) materialInfo.MetallicMap  = roughnessMetallic.second;
 
 			// if no pbr textures provided, set all pbr parameters to default value
 			if (materialInfo.MetallicMap.empty()) materialInfo.MetallicFactor = 0.0f;
@@ -268,7 +333,7 @@ namespace MxEngine
 				meshInfo.indicies[3 * i + 2] = mesh->mFaces[i].mIndices[2];
 			}
 			if (meshInfo.name.empty())
-				meshInfo.name = UUIDGenerator::Get();
+				meshInfo.name = MxFormat("mesh #{}", i);
 			meshInfo.useTexture = true;
 			meshInfo.vertecies = std::move(vertex);
 		}
@@ -357,12 +422,10 @@ namespace MxEngine
 
 namespace MxEngine
 {
-	ObjectInfo ObjectLoader::Load(MxString path)
+	ObjectInfo ObjectLoader::Load(const MxString& path, bool exportEmbeddedTextures)
 	{
 		MXLOG_ERROR("MxEngine::ObjectLoader", "object cannot be loaded as Assimp library was turned off in engine settings");
-		ObjectInfo object;
-		object.isSuccess = false;
-		return object;
+		return ObjectInfo();
 	}
 }
 #endif
\ No newline at end of file
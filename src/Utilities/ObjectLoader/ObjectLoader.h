@@ -36,6 +36,8 @@
 #include "Utilities/STL/MxString.h"
 #include "Utilities/STL/MxVector.h"
 #include "Core/Resources/MeshData.h"
+#include "Utilities/MeshOptimizer/MeshOptimizer.h"
+#include "Utilities/Image/Image.h"
 
 namespace MxEngine
 {
@@ -140,6 +142,14 @@ namespace MxEngine
 		has the mesh normal data (and tangent space) or not
 		*/
 		bool useNormal = false;
+		/*!
+		mesh clusters for per-cluster culling. Empty if clusters were not built during import
+		*/
+		MxVector<MeshCluster> clusters;
+		/*!
+		vertex cache statistics of optimization pass. Empty if mesh was not optimized during import
+		*/
+		MeshOptimizationReport optimization;
 
 		/*!
 		returns count of verteces in buffer
@@ -149,6 +159,22 @@ namespace MxEngine
 
 	using MaterialLibrary = MxVector<MaterialInfo>;
 
+	/*!
+	embedded texture is an image which was stored inside object file. It is decoded once during import and kept in memory,
+	so material texture paths may reference images which do not exist on disk
+	*/
+	struct EmbeddedTexture
+	{
+		/*!
+		virtual path of texture, by which materials reference it
+		*/
+		MxString Path;
+		/*!
+		decoded image data, already flipped as all images loaded from files
+		*/
+		Image Data;
+	};
+
 	/*!
 	object info a special class which contains all data from which in-game object can be constructed
 	it includes verteces, materials and precomputed bounding box. Also note that object is guaranteed to be aligned at (0, 0, 0), game world center
@@ -163,6 +189,14 @@ namespace MxEngine
 		list of all object meshes. For more info see MeshInfo documentation
 		*/
 		MxVector<MeshInfo> meshes;
+		/*!
+		list of decoded textures which were embedded into object file. For more info see EmbeddedTexture documentation
+		*/
+		MxVector<EmbeddedTexture> textures;
+		/*!
+		list of companion files (material libraries, binary buffers and etc.) which were read during import besides object file itself
+		*/
+		MxVector<MxString> dependencies;
 	};
 
 	/*!
@@ -175,10 +209,11 @@ namespace MxEngine
 		/*
 		loads object from disk by its file path
 		\param path absoulute or relative to executable folder path to a file to load
+		\param exportEmbeddedTextures should embedded textures also be encoded to png files next to object file
 		\returns ObjectInfo instance
-		\warning this function is not thread safe
+		\note each call uses its own importer, so objects can be loaded from multiple threads simultaneously
 		*/
-		static ObjectInfo Load(const MxString& path);
+		static ObjectInfo Load(const MxString& path, bool exportEmbeddedTextures = false);
 		static MaterialLibrary LoadMaterials(const MxString& path);
 		static void DumpMaterials(const MaterialLibrary& materials, const MxString& path);
 	};
@@ -29,6 +29,8 @@
 #include "Profiler.h"
 #include "Utilities/STL/MxString.h"
 
+#include <thread>
+
 namespace MxEngine
 {
 	void ProfileSession::WriteJsonHeader()
@@ -64,6 +66,7 @@ namespace MxEngine
 
 	void ProfileSession::WriteJsonEntry(const char* function, TimeStep begin, TimeStep delta)
 	{
+		std::lock_guard<std::mutex> lock(this->mutex);
 		if (!this->IsValid()) return;
 
 		if (this->GetEntryCount() > 0)
@@ -74,7 +77,7 @@ namespace MxEngine
 
 		output << "	{";
 		output << "\"pid\": 0, ";
-		output << "\"tid\": 0, ";
+		output << "\"tid\": " << std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) << ", ";
 		output << "\"ts\": " << std::to_string(uint64_t((double)begin * 1000000)) << ", ";
 		output << "\"dur\": " << std::to_string(uint64_t((double)delta * 1000000)) << ", ";
 		output << "\"ph\": \"X\", ";
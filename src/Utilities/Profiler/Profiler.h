@@ -33,6 +33,8 @@
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/FileSystem/File.h"
 
+#include <mutex>
+
 namespace MxEngine
 {
 	/*!
@@ -49,6 +51,10 @@ namespace MxEngine
 		count of json log entries (is used internally to create json file)
 		*/
 		size_t entriesCount = 0;
+		/*!
+		guards json output, as scope profilers may be destroyed on worker threads
+		*/
+		std::mutex mutex;
 
 		/*!
 		writes header of json file, i.e "{ traceEvents: [ ..."
@@ -0,0 +1,243 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TextureCache.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/FileSystem/CacheFile.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+
+#include <cstring>
+#include <cstddef>
+
+namespace MxEngine
+{
+    constexpr uint8_t TextureCacheMagic[8] = { 'M', 'X', 'T', 'E', 'X', '\0', '\0', '\0' };
+
+    struct TextureCacheHeader
+    {
+        uint8_t Magic[8];
+        uint32_t Version;
+        uint32_t Compression;
+        SourceStamp Source;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t LevelCount;
+        uint32_t Reserved;
+        uint64_t LevelTableOffset;
+        uint64_t FileSize;
+    };
+
+    struct TextureCacheLevel
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint64_t Offset;
+        uint64_t ByteSize;
+    };
+
+    MxString TextureCache::GetCachePath(const MxString& path, BlockCompression compression)
+    {
+        return path + "." + EnumToString(compression) + ".mxtex";
+    }
+
+    bool TextureCache::Load(const MxString& path, CompressedImage& image, BlockCompression compression)
+    {
+        MAKE_SCOPE_PROFILER("TextureCache::Load()");
+        auto cachePath = ToFilePath(TextureCache::GetCachePath(path, compression));
+        if (!File::IsFile(cachePath)) return false;
+
+        MappedFile cache(cachePath);
+        const uint8_t* bytes = cache.GetData();
+        const uint64_t fileSize = (uint64_t)cache.GetSize();
+        if (bytes == nullptr || fileSize < sizeof(TextureCacheHeader))
+        {
+            MXLOG_WARNING("MxEngine::TextureCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+
+        TextureCacheHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.Magic, TextureCacheMagic, sizeof(TextureCacheMagic)) != 0 || header.FileSize != fileSize)
+        {
+            MXLOG_WARNING("MxEngine::TextureCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+        if (header.Version != TextureCache::FormatVersion || header.Compression != (uint32_t)compression)
+        {
+            MXLOG_DEBUG("MxEngine::TextureCache", "cache was built with other engine version or compression: " + ToMxString(cachePath));
+            return false;
+        }
+
+        SourceStamp source;
+        auto sourceState = CacheFile::ValidateSource(ToFilePath(path), header.Source, source);
+        if (sourceState == SourceState::MODIFIED)
+        {
+            MXLOG_DEBUG("MxEngine::TextureCache", "cache is outdated: " + ToMxString(cachePath));
+            return false;
+        }
+
+        auto inRange = [fileSize](uint64_t offset, uint64_t count, uint64_t stride)
+        {
+            return offset <= fileSize && count <= (fileSize - offset) / stride;
+        };
+
+        if (header.LevelCount == 0 || !inRange(header.LevelTableOffset, header.LevelCount, sizeof(TextureCacheLevel)))
+        {
+            MXLOG_WARNING("MxEngine::TextureCache", "cache file is corrupted: " + ToMxString(cachePath));
+            return false;
+        }
+
+        CompressedImage result;
+        result.Compression = compression;
+        result.Levels.resize(header.LevelCount);
+        size_t blockSize = TextureCompressor::GetBlockByteSize(compression);
+        size_t dataSize = 0;
+        for (size_t i = 0; i < result.Levels.size(); i++)
+        {
+            TextureCacheLevel entry;
+            std::memcpy(&entry, bytes + header.LevelTableOffset + i * sizeof(TextureCacheLevel), sizeof(entry));
+
+            size_t expectedSize = ((entry.Width + 3) / 4) * ((entry.Height + 3) / 4) * blockSize;
+            if (!inRange(entry.Offset, entry.ByteSize, sizeof(uint8_t)) || entry.ByteSize != expectedSize)
+            {
+                MXLOG_WARNING("MxEngine::TextureCache", "cache file is corrupted: " + ToMxString(cachePath));
+                return false;
+            }
+
+            auto& level = result.Levels[i];
+            level.Width = entry.Width;
+            level.Height = entry.Height;
+            level.Offset = dataSize;
+            level.ByteSize = (size_t)entry.ByteSize;
+            dataSize += level.ByteSize;
+        }
+
+        // levels are packed together, so whole mip chain can be uploaded from one buffer
+        result.Data.resize(dataSize);
+        for (size_t i = 0; i < result.Levels.size(); i++)
+        {
+            TextureCacheLevel entry;
+            std::memcpy(&entry, bytes + header.LevelTableOffset + i * sizeof(TextureCacheLevel), sizeof(entry));
+            std::memcpy(result.Data.data() + result.Levels[i].Offset, bytes + entry.Offset, (size_t)entry.ByteSize);
+        }
+        cache.Close();
+
+        if (sourceState == SourceState::TOUCHED)
+            CacheFile::UpdateSourceStamp(cachePath, offsetof(TextureCacheHeader, Source), source);
+
+        image = std::move(result);
+        MXLOG_DEBUG("MxEngine::TextureCache", "loaded texture from cache: " + ToMxString(cachePath));
+        return true;
+    }
+
+    bool TextureCache::Save(const CompressedImage& image, const MxString& path)
+    {
+        MAKE_SCOPE_PROFILER("TextureCache::Save()");
+        auto sourcePath = ToFilePath(path);
+        auto cachePath = ToFilePath(TextureCache::GetCachePath(path, image.Compression));
+        SourceStamp source;
+        if (!CacheFile::GetSourceStamp(sourcePath, source))
+        {
+            MXLOG_WARNING("MxEngine::TextureCache", "cannot create cache for non-existing file: " + path);
+            return false;
+        }
+        if (image.Levels.empty())
+        {
+            MXLOG_WARNING("MxEngine::TextureCache", "cannot create cache for empty image: " + path);
+            return false;
+        }
+
+        TextureCacheHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.Magic, TextureCacheMagic, sizeof(TextureCacheMagic));
+        header.Version = TextureCache::FormatVersion;
+        header.Compression = (uint32_t)image.Compression;
+        header.Source = source;
+        header.Width = (uint32_t)image.Levels.front().Width;
+        header.Height = (uint32_t)image.Levels.front().Height;
+        header.LevelCount = (uint32_t)image.Levels.size();
+
+        // layout: header | level table | aligned level blobs
+        uint64_t offset = sizeof(TextureCacheHeader);
+        header.LevelTableOffset = offset = CacheFile::AlignOffset(offset, alignof(uint64_t));
+        offset += image.Levels.size() * sizeof(TextureCacheLevel);
+
+        MxVector<TextureCacheLevel> levels(image.Levels.size());
+        for (size_t i = 0; i < levels.size(); i++)
+        {
+            auto& entry = levels[i];
+            entry.Width = (uint32_t)image.Levels[i].Width;
+            entry.Height = (uint32_t)image.Levels[i].Height;
+            entry.ByteSize = image.Levels[i].ByteSize;
+            entry.Offset = offset = CacheFile::AlignOffset(offset, TextureCache::BlobAlignment);
+            offset += entry.ByteSize;
+        }
+        header.FileSize = offset;
+
+        bool isWritten = CacheFile::Write(cachePath, [&](CacheWriter& writer)
+        {
+            writer.WriteAt(0, &header, sizeof(header));
+            writer.WriteAt(header.LevelTableOffset, levels.data(), levels.size() * sizeof(TextureCacheLevel));
+            for (size_t i = 0; i < levels.size(); i++)
+                writer.WriteAt(levels[i].Offset, image.Data.data() + image.Levels[i].Offset, image.Levels[i].ByteSize);
+        });
+        if (!isWritten) return false;
+
+        MXLOG_DEBUG("MxEngine::TextureCache", MxFormat("created cache {0} ({1}, {2} levels, {3} bytes)",
+            ToMxString(cachePath).c_str(), EnumToString(image.Compression), header.LevelCount, header.FileSize));
+        return true;
+    }
+
+    bool TextureCache::Import(const MxString& path, CompressedImage& image, BlockCompression compression)
+    {
+        MAKE_SCOPE_PROFILER("TextureCache::Import()");
+        if (TextureCache::Load(path, image, compression)) return true;
+
+        auto source = ImageLoader::LoadImage(path);
+        if (source.GetRawData() == nullptr || source.IsFloatingPoint()) return false;
+
+        image = TextureCompressor::Compress(source, compression);
+        TextureCache::Save(image, path);
+        return true;
+    }
+
+    void TextureCache::Invalidate(const MxString& path)
+    {
+        constexpr BlockCompression compressions[] = {
+            BlockCompression::BC1, BlockCompression::BC3, BlockCompression::BC4, BlockCompression::BC5,
+        };
+        std::error_code error;
+        for (auto compression : compressions)
+            std::filesystem::remove(ToFilePath(TextureCache::GetCachePath(path, compression)), error);
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/TextureCompressor/TextureCompressor.h"
+#include "Utilities/STL/MxString.h"
+
+namespace MxEngine
+{
+    /*!
+    TextureCache stores block-compressed textures with their full mip chain in engine-native .mxtex format next to their source images.
+    Cache file consists of versioned header, mip level table and compressed level blobs, which are copied out of mapped file and uploaded to graphic API without re-encoding.
+    Each block compression of the same image has its own cache file, so texture used with different formats does not rebuild cache on each load.
+    Cache is rebuilt when source image is changed
+    */
+    class TextureCache
+    {
+    public:
+        /*!
+        version of .mxtex format. Caches with other versions are ignored and rebuilt
+        */
+        constexpr static uint32_t FormatVersion = 1;
+        /*!
+        alignment in bytes of each mip level blob inside cache file
+        */
+        constexpr static size_t BlobAlignment = 64;
+
+        /*!
+        gets path of cache file for image source file
+        \param path path to image source file
+        \param compression block compression of cached image
+        \returns path to .mxtex file
+        */
+        static MxString GetCachePath(const MxString& path, BlockCompression compression);
+        /*!
+        loads compressed image from cache file if it exists and is up-to-date with its source
+        \param path path to image source file (not to the cache itself)
+        \param image compressed image to load data to. Not modified if cache cannot be used
+        \param compression expected block compression. Cache with other compression is treated as outdated
+        \returns true if image was loaded from cache, false either
+        */
+        static bool Load(const MxString& path, CompressedImage& image, BlockCompression compression);
+        /*!
+        writes compressed image to cache file (see CacheFile::Write())
+        \param image compressed image to save
+        \param path path to image source file (not to the cache itself)
+        \returns true if cache was written successfully, false either
+        */
+        static bool Save(const CompressedImage& image, const MxString& path);
+        /*!
+        loads compressed image from cache or, if cache is missing or outdated, compresses source image and saves new cache.
+        Source image is vertically flipped, as all textures loaded from files
+        \param path path to image source file
+        \param image compressed image to load data to
+        \param compression block compression to use
+        \returns true if image was loaded or built, false if source image cannot be loaded
+        */
+        static bool Import(const MxString& path, CompressedImage& image, BlockCompression compression);
+        /*!
+        removes cache files of image source file for all block compressions if they exist
+        \param path path to image source file
+        */
+        static void Invalidate(const MxString& path);
+    };
+}
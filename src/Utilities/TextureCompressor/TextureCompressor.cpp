@@ -0,0 +1,721 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TextureCompressor.h"
+#include "Utilities/ThreadPool/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+#include "Core/Macro/Macro.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+namespace MxEngine
+{
+    const char* EnumToString(BlockCompression compression)
+    {
+        switch (compression)
+        {
+        case BlockCompression::NONE:
+            return "NONE";
+        case BlockCompression::BC1:
+            return "BC1";
+        case BlockCompression::BC3:
+            return "BC3";
+        case BlockCompression::BC4:
+            return "BC4";
+        case BlockCompression::BC5:
+            return "BC5";
+        default:
+            return "NONE";
+        }
+    }
+
+    using PixelBlock = uint8_t[16][4];
+    using ValueBlock = uint8_t[16];
+
+    static size_t GetRowGranularity(size_t rowCount)
+    {
+        // several chunks per thread, so uneven rows are balanced between workers
+        return Max((size_t)1, rowCount / ((ThreadPool::GetWorkerCount() + 1) * 4));
+    }
+
+    /*!
+    reads 4x4 block of pixels as RGBA. Pixels outside of image replicate its edge, so partial blocks are encoded without artifacts
+    */
+    static void LoadPixelBlock(const Image& image, size_t blockX, size_t blockY, PixelBlock& block)
+    {
+        const uint8_t* data = image.GetRawData();
+        size_t width = image.GetWidth(), height = image.GetHeight(), channels = image.GetChannelCount();
+        for (size_t y = 0; y < 4; y++)
+        {
+            size_t sourceY = Min(blockY * 4 + y, height - 1);
+            for (size_t x = 0; x < 4; x++)
+            {
+                size_t sourceX = Min(blockX * 4 + x, width - 1);
+                const uint8_t* pixel = data + (sourceY * width + sourceX) * channels;
+                uint8_t* result = block[y * 4 + x];
+                result[0] = pixel[0];
+                result[1] = channels > 1 ? pixel[1] : 0;
+                result[2] = channels > 2 ? pixel[2] : 0;
+                result[3] = channels > 3 ? pixel[3] : 255;
+            }
+        }
+    }
+
+    static void ExtractChannel(const PixelBlock& block, size_t channel, ValueBlock& values)
+    {
+        for (size_t i = 0; i < 16; i++)
+            values[i] = block[i][channel];
+    }
+
+    static uint16_t PackColor565(const float* color)
+    {
+        int r = Clamp(int(color[0] * (31.0f / 255.0f) + 0.5f), 0, 31);
+        int g = Clamp(int(color[1] * (63.0f / 255.0f) + 0.5f), 0, 63);
+        int b = Clamp(int(color[2] * (31.0f / 255.0f) + 0.5f), 0, 31);
+        return uint16_t((r << 11) | (g << 5) | b);
+    }
+
+    static void UnpackColor565(uint16_t color, int* result)
+    {
+        int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+        result[0] = (r << 3) | (r >> 2);
+        result[1] = (g << 2) | (g >> 4);
+        result[2] = (b << 3) | (b >> 2);
+    }
+
+    /*!
+    selects nearest palette entry for each pixel of the block. Endpoints are reordered so block is always decoded in four-color mode
+    \returns squared error of encoded block
+    */
+    static int ComputeColorIndices(const PixelBlock& block, uint16_t& color0, uint16_t& color1, uint32_t& indices)
+    {
+        if (color0 < color1) std::swap(color0, color1);
+
+        int palette[4][3];
+        UnpackColor565(color0, palette[0]);
+        UnpackColor565(color1, palette[1]);
+        for (size_t c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        // equal endpoints switch decoder to three-color mode, where only first entry is safe to use
+        size_t paletteSize = color0 == color1 ? 1 : 4;
+
+        int totalError = 0;
+        indices = 0;
+        for (size_t i = 0; i < 16; i++)
+        {
+            int bestError = std::numeric_limits<int>::max();
+            uint32_t bestIndex = 0;
+            for (size_t p = 0; p < paletteSize; p++)
+            {
+                int dr = block[i][0] - palette[p][0];
+                int dg = block[i][1] - palette[p][1];
+                int db = block[i][2] - palette[p][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = (uint32_t)p;
+                }
+            }
+            indices |= bestIndex << (2 * i);
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+    /*!
+    table of endpoint pairs which reproduce each 8-bit value best as first interpolated color (2/3 * e0 + 1/3 * e1)
+    */
+    struct SolidColorTable
+    {
+        uint8_t Endpoints5[256][2];
+        uint8_t Endpoints6[256][2];
+
+        SolidColorTable()
+        {
+            auto fillTable = [](uint8_t (&table)[256][2], int bits)
+            {
+                int maxValue = (1 << bits) - 1;
+                for (int value = 0; value < 256; value++)
+                {
+                    int bestError = std::numeric_limits<int>::max();
+                    for (int e0 = 0; e0 <= maxValue; e0++)
+                    {
+                        for (int e1 = 0; e1 <= maxValue; e1++)
+                        {
+                            int expanded0 = bits == 5 ? (e0 << 3) | (e0 >> 2) : (e0 << 2) | (e0 >> 4);
+                            int expanded1 = bits == 5 ? (e1 << 3) | (e1 >> 2) : (e1 << 2) | (e1 >> 4);
+                            int error = std::abs((2 * expanded0 + expanded1) / 3 - value);
+                            if (error < bestError)
+                            {
+                                bestError = error;
+                                table[value][0] = (uint8_t)e0;
+                                table[value][1] = (uint8_t)e1;
+                            }
+                        }
+                    }
+                }
+            };
+            fillTable(this->Endpoints5, 5);
+            fillTable(this->Endpoints6, 6);
+        }
+    };
+
+    /*!
+    encodes single-colored block exactly (up to 8-bit rounding), which is not possible with 565 endpoints alone
+    */
+    static void EncodeSolidColorBlock(const uint8_t* color, uint8_t* destination)
+    {
+        static const SolidColorTable table;
+        uint16_t color0 = uint16_t((table.Endpoints5[color[0]][0] << 11) | (table.Endpoints6[color[1]][0] << 5) | table.Endpoints5[color[2]][0]);
+        uint16_t color1 = uint16_t((table.Endpoints5[color[0]][1] << 11) | (table.Endpoints6[color[1]][1] << 5) | table.Endpoints5[color[2]][1]);
+
+        // all pixels use first interpolated color, its index depends on endpoint order
+        uint32_t indices = 0xAAAAAAAA;
+        if (color0 < color1)
+        {
+            std::swap(color0, color1);
+            indices = 0xFFFFFFFF;
+        }
+        else if (color0 == color1)
+        {
+            indices = 0;
+        }
+
+        destination[0] = uint8_t(color0 & 0xFF);
+        destination[1] = uint8_t(color0 >> 8);
+        destination[2] = uint8_t(color1 & 0xFF);
+        destination[3] = uint8_t(color1 >> 8);
+        std::memcpy(destination + 4, &indices, sizeof(indices));
+    }
+
+    static void EncodeColorBlock(const PixelBlock& block, uint8_t* destination)
+    {
+        bool isSolid = true;
+        for (size_t i = 1; i < 16 && isSolid; i++)
+            isSolid = block[i][0] == block[0][0] && block[i][1] == block[0][1] && block[i][2] == block[0][2];
+        if (isSolid)
+        {
+            EncodeSolidColorBlock(block[0], destination);
+            return;
+        }
+
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (size_t i = 0; i < 16; i++)
+        {
+            for (size_t c = 0; c < 3; c++)
+                mean[c] += block[i][c];
+        }
+        for (size_t c = 0; c < 3; c++) mean[c] /= 16.0f;
+
+        // covariance matrix: xx, xy, xz, yy, yz, zz
+        float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        for (size_t i = 0; i < 16; i++)
+        {
+            float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+            covariance[0] += r * r; covariance[1] += r * g; covariance[2] += r * b;
+            covariance[3] += g * g; covariance[4] += g * b; covariance[5] += b * b;
+        }
+
+        // principal axis is found by power iteration, it is the direction of best fitting line through block colors
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (size_t iteration = 0; iteration < 4; iteration++)
+        {
+            float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+            float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+            float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+            float length = Max(std::abs(x), std::abs(y), std::abs(z));
+            if (length < 1e-6f) break;
+            axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+        }
+
+        size_t minIndex = 0, maxIndex = 0;
+        float minProjection = std::numeric_limits<float>::max(), maxProjection = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < 16; i++)
+        {
+            float projection = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+            if (projection < minProjection) { minProjection = projection; minIndex = i; }
+            if (projection > maxProjection) { maxProjection = projection; maxIndex = i; }
+        }
+
+        // endpoints are slightly inset to the center of the block, which reduces average error of interpolated colors
+        float endpoint0[3], endpoint1[3];
+        for (size_t c = 0; c < 3; c++)
+        {
+            float inset = float(block[maxIndex][c] - block[minIndex][c]) / 16.0f;
+            endpoint0[c] = block[maxIndex][c] - inset;
+            endpoint1[c] = block[minIndex][c] + inset;
+        }
+
+        uint16_t color0 = PackColor565(endpoint0), color1 = PackColor565(endpoint1);
+        uint32_t indices = 0;
+        int error = ComputeColorIndices(block, color0, color1, indices);
+
+        // single least squares refinement of endpoints for selected indices
+        if (error > 0 && color0 != color1)
+        {
+            constexpr float Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+            float ax[3] = { 0.0f, 0.0f, 0.0f }, bx[3] = { 0.0f, 0.0f, 0.0f };
+            for (size_t i = 0; i < 16; i++)
+            {
+                float a = Weights[(indices >> (2 * i)) & 3], b = 1.0f - a;
+                aa += a * a; ab += a * b; bb += b * b;
+                for (size_t c = 0; c < 3; c++)
+                {
+                    ax[c] += a * block[i][c];
+                    bx[c] += b * block[i][c];
+                }
+            }
+
+            float determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) > 1e-6f)
+            {
+                for (size_t c = 0; c < 3; c++)
+                {
+                    endpoint0[c] = Clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+                    endpoint1[c] = Clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+                }
+                uint16_t refined0 = PackColor565(endpoint0), refined1 = PackColor565(endpoint1);
+                uint32_t refinedIndices = 0;
+                int refinedError = ComputeColorIndices(block, refined0, refined1, refinedIndices);
+                if (refinedError < error)
+                {
+                    color0 = refined0;
+                    color1 = refined1;
+                    indices = refinedIndices;
+                }
+            }
+        }
+
+        destination[0] = uint8_t(color0 & 0xFF);
+        destination[1] = uint8_t(color0 >> 8);
+        destination[2] = uint8_t(color1 & 0xFF);
+        destination[3] = uint8_t(color1 >> 8);
+        std::memcpy(destination + 4, &indices, sizeof(indices)); // block layout is little-endian
+    }
+
+    /*!
+    encodes BC4 block (also used for BC3 alpha and BC5 channels). Eight-value mode is always used
+    */
+    static void EncodeValueBlock(const ValueBlock& values, uint8_t* destination)
+    {
+        uint8_t minValue = 255, maxValue = 0;
+        for (size_t i = 0; i < 16; i++)
+        {
+            minValue = Min(minValue, values[i]);
+            maxValue = Max(maxValue, values[i]);
+        }
+
+        uint64_t indices = 0;
+        if (maxValue != minValue)
+        {
+            float scale = 7.0f / float(maxValue - minValue);
+            for (size_t i = 0; i < 16; i++)
+            {
+                // position along [max, min] segment: 0 is first endpoint, 7 is second endpoint, others are interpolated values
+                int position = int(float(maxValue - values[i]) * scale + 0.5f);
+                uint64_t index = position == 0 ? 0 : (position == 7 ? 1 : uint64_t(position + 1));
+                indices |= index << (3 * i);
+            }
+        }
+
+        destination[0] = maxValue;
+        destination[1] = minValue;
+        for (size_t i = 0; i < 6; i++)
+            destination[2 + i] = uint8_t(indices >> (8 * i));
+    }
+
+    static void DecodeColorBlock(const uint8_t* source, PixelBlock& block, bool forceFourColors)
+    {
+        uint16_t color0 = uint16_t(source[0] | (source[1] << 8));
+        uint16_t color1 = uint16_t(source[2] | (source[3] << 8));
+        uint32_t indices = 0;
+        std::memcpy(&indices, source + 4, sizeof(indices));
+
+        int palette[4][4];
+        UnpackColor565(color0, palette[0]);
+        UnpackColor565(color1, palette[1]);
+        palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+        for (size_t c = 0; c < 3; c++)
+        {
+            if (color0 > color1 || forceFourColors)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        if (color0 <= color1 && !forceFourColors) palette[3][3] = 0;
+
+        for (size_t i = 0; i < 16; i++)
+        {
+            const int* color = palette[(indices >> (2 * i)) & 3];
+            for (size_t c = 0; c < 4; c++)
+                block[i][c] = (uint8_t)color[c];
+        }
+    }
+
+    static void DecodeValueBlock(const uint8_t* source, ValueBlock& values)
+    {
+        int palette[8];
+        palette[0] = source[0];
+        palette[1] = source[1];
+        if (palette[0] > palette[1])
+        {
+            for (int i = 1; i < 7; i++)
+                palette[i + 1] = ((7 - i) * palette[0] + i * palette[1]) / 7;
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+                palette[i + 1] = ((5 - i) * palette[0] + i * palette[1]) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (size_t i = 0; i < 6; i++)
+            indices |= uint64_t(source[2 + i]) << (8 * i);
+        for (size_t i = 0; i < 16; i++)
+            values[i] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+    }
+
+    static void EncodeBlock(const Image& image, size_t blockX, size_t blockY, BlockCompression compression, uint8_t* destination)
+    {
+        PixelBlock block;
+        ValueBlock values;
+        LoadPixelBlock(image, blockX, blockY, block);
+        switch (compression)
+        {
+        case BlockCompression::BC1:
+            EncodeColorBlock(block, destination);
+            break;
+        case BlockCompression::BC3:
+            ExtractChannel(block, 3, values);
+            EncodeValueBlock(values, destination);
+            EncodeColorBlock(block, destination + 8);
+            break;
+        case BlockCompression::BC4:
+            ExtractChannel(block, 0, values);
+            EncodeValueBlock(values, destination);
+            break;
+        case BlockCompression::BC5:
+            ExtractChannel(block, 0, values);
+            EncodeValueBlock(values, destination);
+            ExtractChannel(block, 1, values);
+            EncodeValueBlock(values, destination + 8);
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void EncodeBlockRows(const Image& image, BlockCompression compression, uint8_t* destination, size_t rowBegin, size_t rowEnd)
+    {
+        size_t blocksX = (image.GetWidth() + 3) / 4;
+        size_t blockSize = TextureCompressor::GetBlockByteSize(compression);
+        for (size_t blockY = rowBegin; blockY < rowEnd; blockY++)
+        {
+            uint8_t* row = destination + blockY * blocksX * blockSize;
+            for (size_t blockX = 0; blockX < blocksX; blockX++)
+                EncodeBlock(image, blockX, blockY, compression, row + blockX * blockSize);
+        }
+    }
+
+    static void EncodeLevel(const Image& image, BlockCompression compression, uint8_t* destination)
+    {
+        size_t blocksY = (image.GetHeight() + 3) / 4;
+        ThreadPool::ParallelFor(blocksY, GetRowGranularity(blocksY), [&image, compression, destination](size_t begin, size_t end)
+        {
+            EncodeBlockRows(image, compression, destination, begin, end);
+        });
+    }
+
+    static void DownsampleRows(const Image& image, uint8_t* destination, size_t destinationWidth, size_t rowBegin, size_t rowEnd)
+    {
+        constexpr int Offsets[4] = { -1, 0, 1, 2 };
+        constexpr uint32_t Weights[4] = { 1, 3, 3, 1 };
+
+        const uint8_t* source = image.GetRawData();
+        int width = (int)image.GetWidth(), height = (int)image.GetHeight();
+        size_t channels = image.GetChannelCount();
+
+        for (size_t y = rowBegin; y < rowEnd; y++)
+        {
+            size_t rows[4];
+            for (size_t k = 0; k < 4; k++)
+                rows[k] = (size_t)Clamp(2 * (int)y + Offsets[k], 0, height - 1) * width;
+
+            for (size_t x = 0; x < destinationWidth; x++)
+            {
+                size_t columns[4];
+                for (size_t k = 0; k < 4; k++)
+                    columns[k] = (size_t)Clamp(2 * (int)x + Offsets[k], 0, width - 1);
+
+                uint8_t* pixel = destination + (y * destinationWidth + x) * channels;
+                for (size_t c = 0; c < channels; c++)
+                {
+                    uint32_t sum = 0;
+                    for (size_t ky = 0; ky < 4; ky++)
+                    {
+                        uint32_t rowSum = 0;
+                        for (size_t kx = 0; kx < 4; kx++)
+                            rowSum += Weights[kx] * source[(rows[ky] + columns[kx]) * channels + c];
+                        sum += Weights[ky] * rowSum;
+                    }
+                    pixel[c] = uint8_t((sum + 32) / 64);
+                }
+            }
+        }
+    }
+
+    size_t TextureCompressor::GetBlockByteSize(BlockCompression compression)
+    {
+        switch (compression)
+        {
+        case BlockCompression::BC1:
+        case BlockCompression::BC4:
+            return 8;
+        case BlockCompression::BC3:
+        case BlockCompression::BC5:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    size_t TextureCompressor::GetChannelCount(BlockCompression compression)
+    {
+        switch (compression)
+        {
+        case BlockCompression::BC4:
+            return 1;
+        case BlockCompression::BC5:
+            return 2;
+        default:
+            return 4;
+        }
+    }
+
+    Image TextureCompressor::Downsample(const Image& image)
+    {
+        MX_ASSERT(!image.IsFloatingPoint());
+        size_t width = Max((size_t)1, image.GetWidth() / 2);
+        size_t height = Max((size_t)1, image.GetHeight() / 2);
+        size_t channels = image.GetChannelCount();
+        auto data = (uint8_t*)std::malloc(width * height * channels);
+
+        ThreadPool::ParallelFor(height, GetRowGranularity(height), [&image, data, width](size_t begin, size_t end)
+        {
+            DownsampleRows(image, data, width, begin, end);
+        });
+        return Image(data, width, height, channels, false);
+    }
+
+    MxVector<Image> TextureCompressor::GenerateMipChain(const Image& image)
+    {
+        MAKE_SCOPE_PROFILER("TextureCompressor::GenerateMipChain()");
+        MxVector<Image> levels;
+        const Image* previous = &image;
+        while (previous->GetWidth() > 1 || previous->GetHeight() > 1)
+        {
+            levels.push_back(TextureCompressor::Downsample(*previous));
+            previous = &levels.back();
+        }
+        return levels;
+    }
+
+    CompressedImage TextureCompressor::Compress(const Image& image, BlockCompression compression, bool generateMipmaps)
+    {
+        MAKE_SCOPE_PROFILER("TextureCompressor::Compress()");
+        MX_ASSERT(compression != BlockCompression::NONE && !image.IsFloatingPoint());
+
+        MxVector<Image> mipChain;
+        if (generateMipmaps) mipChain = TextureCompressor::GenerateMipChain(image);
+
+        CompressedImage result;
+        result.Compression = compression;
+        result.Levels.resize(mipChain.size() + 1);
+
+        size_t blockSize = TextureCompressor::GetBlockByteSize(compression);
+        size_t offset = 0;
+        for (size_t i = 0; i < result.Levels.size(); i++)
+        {
+            const Image& level = i == 0 ? image : mipChain[i - 1];
+            auto& entry = result.Levels[i];
+            entry.Width = level.GetWidth();
+            entry.Height = level.GetHeight();
+            entry.Offset = offset;
+            entry.ByteSize = ((entry.Width + 3) / 4) * ((entry.Height + 3) / 4) * blockSize;
+            offset += entry.ByteSize;
+        }
+        result.Data.resize(offset);
+
+        for (size_t i = 0; i < result.Levels.size(); i++)
+        {
+            const Image& level = i == 0 ? image : mipChain[i - 1];
+            EncodeLevel(level, compression, result.Data.data() + result.Levels[i].Offset);
+        }
+        return result;
+    }
+
+    Image TextureCompressor::Decompress(const CompressedImage& image, size_t level)
+    {
+        MX_ASSERT(level < image.Levels.size());
+        const auto& entry = image.Levels[level];
+        size_t channels = TextureCompressor::GetChannelCount(image.Compression);
+        size_t blockSize = TextureCompressor::GetBlockByteSize(image.Compression);
+        size_t blocksX = (entry.Width + 3) / 4, blocksY = (entry.Height + 3) / 4;
+        auto data = (uint8_t*)std::malloc(entry.Width * entry.Height * channels);
+
+        for (size_t blockY = 0; blockY < blocksY; blockY++)
+        {
+            for (size_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                const uint8_t* source = image.Data.data() + entry.Offset + (blockY * blocksX + blockX) * blockSize;
+                PixelBlock block;
+                ValueBlock values;
+                switch (image.Compression)
+                {
+                case BlockCompression::BC1:
+                    DecodeColorBlock(source, block, false);
+                    break;
+                case BlockCompression::BC3:
+                    DecodeColorBlock(source + 8, block, true);
+                    DecodeValueBlock(source, values);
+                    for (size_t i = 0; i < 16; i++) block[i][3] = values[i];
+                    break;
+                case BlockCompression::BC4:
+                    DecodeValueBlock(source, values);
+                    for (size_t i = 0; i < 16; i++) block[i][0] = values[i];
+                    break;
+                case BlockCompression::BC5:
+                    DecodeValueBlock(source, values);
+                    for (size_t i = 0; i < 16; i++) block[i][0] = values[i];
+                    DecodeValueBlock(source + 8, values);
+                    for (size_t i = 0; i < 16; i++) block[i][1] = values[i];
+                    break;
+                default:
+                    std::memset(block, 0, sizeof(block));
+                    break;
+                }
+
+                for (size_t y = 0; y < 4 && blockY * 4 + y < entry.Height; y++)
+                {
+                    for (size_t x = 0; x < 4 && blockX * 4 + x < entry.Width; x++)
+                    {
+                        uint8_t* pixel = data + ((blockY * 4 + y) * entry.Width + blockX * 4 + x) * channels;
+                        std::memcpy(pixel, block[y * 4 + x], channels);
+                    }
+                }
+            }
+        }
+        return Image(data, entry.Width, entry.Height, channels, false);
+    }
+
+    TextureCompressorBenchmark TextureCompressor::RunBenchmark(size_t size)
+    {
+        TextureCompressorBenchmark result;
+        result.Width = size;
+        result.Height = size;
+        result.ThreadCount = ThreadPool::GetWorkerCount() + 1;
+
+        // smooth gradients with high-frequency detail, similar to photographed material textures
+        auto data = (uint8_t*)std::malloc(size * size * 4);
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                uint8_t* pixel = data + (y * size + x) * 4;
+                float detail = std::sin(0.37f * float(x)) * std::cos(0.23f * float(y));
+                pixel[0] = uint8_t(255.0f * float(x) / float(size));
+                pixel[1] = uint8_t(127.5f + 120.0f * detail);
+                pixel[2] = uint8_t(255.0f * float(y) / float(size));
+                pixel[3] = uint8_t((x ^ y) & 0xFF);
+            }
+        }
+        Image image(data, size, size, 4, false);
+        float megapixels = float(size * size) / 1'000'000.0f;
+        auto throughput = [megapixels](TimeStep start) { return megapixels / Max(Time::Current() - start, 1e-6f); };
+
+        size_t blocksY = (size + 3) / 4;
+        MxVector<uint8_t> blocks(((size + 3) / 4) * blocksY * 16);
+
+        TimeStep start = Time::Current();
+        {
+            auto reference = (uint8_t*)std::malloc((size / 2) * (size / 2) * 4);
+            DownsampleRows(image, reference, Max((size_t)1, size / 2), 0, Max((size_t)1, size / 2));
+            std::free(reference);
+        }
+        result.ReferenceMipGeneration = throughput(start);
+
+        start = Time::Current();
+        TextureCompressor::Downsample(image);
+        result.MipGeneration = throughput(start);
+
+        start = Time::Current();
+        EncodeBlockRows(image, BlockCompression::BC1, blocks.data(), 0, blocksY);
+        result.ReferenceBC1 = throughput(start);
+
+        start = Time::Current();
+        EncodeLevel(image, BlockCompression::BC1, blocks.data());
+        result.BC1 = throughput(start);
+
+        start = Time::Current();
+        EncodeLevel(image, BlockCompression::BC3, blocks.data());
+        result.BC3 = throughput(start);
+
+        start = Time::Current();
+        EncodeLevel(image, BlockCompression::BC4, blocks.data());
+        result.BC4 = throughput(start);
+
+        start = Time::Current();
+        EncodeLevel(image, BlockCompression::BC5, blocks.data());
+        result.BC5 = throughput(start);
+
+        MXLOG_INFO("MxEngine::TextureCompressor", MxFormat("benchmark on {0}x{1} image, {2} threads (MPix/s): downsample {3} -> {4}, BC1 {5} -> {6}, BC3 {7}, BC4 {8}, BC5 {9}",
+            result.Width, result.Height, result.ThreadCount, result.ReferenceMipGeneration, result.MipGeneration,
+            result.ReferenceBC1, result.BC1, result.BC3, result.BC4, result.BC5));
+        return result;
+    }
+}
@@ -0,0 +1,140 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/Image/Image.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+namespace MxEngine
+{
+    /*!
+    block compression formats supported by texture compressor. BC1 stores RGB, BC3 - RGBA, BC4 - single channel, BC5 - two channels
+    */
+    enum class BlockCompression : uint8_t
+    {
+        NONE,
+        BC1,
+        BC3,
+        BC4,
+        BC5,
+    };
+
+    const char* EnumToString(BlockCompression compression);
+
+    struct CompressedMipLevel
+    {
+        size_t Width = 0;
+        size_t Height = 0;
+        size_t Offset = 0;
+        size_t ByteSize = 0;
+    };
+
+    /*!
+    block-compressed image with its mip chain. All levels are stored in one contiguous buffer, level 0 is the largest
+    */
+    struct CompressedImage
+    {
+        BlockCompression Compression = BlockCompression::NONE;
+        MxVector<CompressedMipLevel> Levels;
+        MxVector<uint8_t> Data;
+    };
+
+    /*!
+    throughput of texture compressor benchmark, measured in megapixels per second
+    */
+    struct TextureCompressorBenchmark
+    {
+        size_t Width = 0;
+        size_t Height = 0;
+        size_t ThreadCount = 0;
+        float ReferenceMipGeneration = 0.0f;
+        float MipGeneration = 0.0f;
+        float ReferenceBC1 = 0.0f;
+        float BC1 = 0.0f;
+        float BC3 = 0.0f;
+        float BC4 = 0.0f;
+        float BC5 = 0.0f;
+    };
+
+    /*!
+    texture compressor encodes 8-bit images into GPU block-compressed formats and generates their mip chains on CPU.
+    Both encoding and mip generation are split by rows and processed on ThreadPool workers
+    */
+    class TextureCompressor
+    {
+    public:
+        /*!
+        gets size of one 4x4 block in bytes
+        \param compression block compression format
+        \returns 8 for BC1 and BC4, 16 for BC3 and BC5, 0 for NONE
+        */
+        static size_t GetBlockByteSize(BlockCompression compression);
+        /*!
+        gets number of channels of decompressed image
+        \param compression block compression format
+        \returns 4 for BC1 and BC3, 1 for BC4, 2 for BC5
+        */
+        static size_t GetChannelCount(BlockCompression compression);
+        /*!
+        downsamples image by two in each dimension using separable [1 3 3 1] tent filter, which is smoother than box filter used by drivers
+        \param image 8-bit image to downsample
+        \returns image of size max(1, width / 2) x max(1, height / 2) with same channel count
+        */
+        static Image Downsample(const Image& image);
+        /*!
+        generates full mip chain of image
+        \param image 8-bit image which is used as mip level 0
+        \returns mip levels starting from level 1 and ending with 1x1 image
+        */
+        static MxVector<Image> GenerateMipChain(const Image& image);
+        /*!
+        encodes image and (optionally) its mip chain into block-compressed format
+        \param image 8-bit image with 1-4 channels. Missing channels are treated as zero (alpha as 255)
+        \param compression block compression format. Must not be NONE
+        \param generateMipmaps should mip chain be generated and compressed
+        \returns compressed image with all its levels
+        */
+        static CompressedImage Compress(const Image& image, BlockCompression compression, bool generateMipmaps = true);
+        /*!
+        decodes one level of compressed image. Used when graphic driver does not support compressed format
+        \param image compressed image
+        \param level mip level to decode
+        \returns 8-bit image with GetChannelCount(compression) channels
+        */
+        static Image Decompress(const CompressedImage& image, size_t level);
+        /*!
+        encodes generated image with reference (single-threaded) and parallel encoder, logging throughput
+        \param size width and height of generated image
+        \returns benchmark results
+        */
+        static TextureCompressorBenchmark RunBenchmark(size_t size = 2048);
+    };
+}
@@ -0,0 +1,195 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "ThreadPool.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    void ThreadPool::StartWorkers(size_t count)
+    {
+        if (count == 0)
+        {
+            size_t hardwareThreads = (size_t)std::thread::hardware_concurrency();
+            count = hardwareThreads > 1 ? hardwareThreads - 1 : 1; // main thread is also busy
+        }
+
+        std::lock_guard lock(data->WorkerMutex);
+        data->IsStopped = false;
+        data->Workers.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            data->Workers.emplace_back(ThreadPool::WorkerLoop, data);
+        }
+        data->WorkerCount.store(count);
+        MXLOG_INFO("MxEngine::ThreadPool", MxFormat("started {0} worker threads", count));
+    }
+
+    void ThreadPool::StopWorkers()
+    {
+        {
+            std::lock_guard lock(data->WorkerMutex);
+            data->IsStopped = true;
+            data->WorkerCount.store(0);
+        }
+        data->WorkerCondition.notify_all();
+
+        for (auto& worker : data->Workers)
+        {
+            if (worker.joinable()) worker.join();
+        }
+        data->Workers.clear();
+    }
+
+    void ThreadPool::WorkerLoop(ThreadPoolData* data)
+    {
+        while (true)
+        {
+            ThreadPoolData::Task task;
+            {
+                std::unique_lock lock(data->WorkerMutex);
+                data->WorkerCondition.wait(lock, [data]() { return data->IsStopped || !data->WorkerTasks.empty(); });
+                if (data->IsStopped) return;
+
+                task = std::move(data->WorkerTasks.front().Function);
+                data->WorkerTasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    void ThreadPool::PushTask(ThreadPoolData::Task task, TaskGroup group)
+    {
+        {
+            std::lock_guard lock(data->WorkerMutex);
+            data->WorkerTasks.push_back({ std::move(task), group });
+        }
+        data->WorkerCondition.notify_one();
+    }
+
+    void ThreadPool::Init()
+    {
+        data = Alloc<ThreadPoolData>();
+        data->MainThreadId = std::this_thread::get_id();
+        ThreadPool::StartWorkers(0);
+    }
+
+    void ThreadPool::Destroy()
+    {
+        ThreadPool::StopWorkers();
+        Free(data);
+        data = nullptr;
+    }
+
+    ThreadPoolData* ThreadPool::GetImpl()
+    {
+        return data;
+    }
+
+    void ThreadPool::Clone(ThreadPoolData* impl)
+    {
+        data = impl;
+    }
+
+    void ThreadPool::SetWorkerCount(size_t count)
+    {
+        MX_ASSERT(ThreadPool::IsMainThread());
+        ThreadPool::StopWorkers();
+        ThreadPool::StartWorkers(count);
+    }
+
+    size_t ThreadPool::GetWorkerCount()
+    {
+        // worker list itself is rebuilt on restart, so it is never read outside of main thread
+        return data->WorkerCount.load();
+    }
+
+    bool ThreadPool::IsMainThread()
+    {
+        return std::this_thread::get_id() == data->MainThreadId;
+    }
+
+    TaskGroup ThreadPool::CreateTaskGroup()
+    {
+        return data->NextTaskGroup.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool ThreadPool::ExecutePendingTask(TaskGroup group)
+    {
+        ThreadPoolData::Task task;
+        {
+            std::lock_guard lock(data->WorkerMutex);
+            auto& tasks = data->WorkerTasks;
+            auto it = std::find_if(tasks.begin(), tasks.end(), [group](const auto& task) { return task.Group == group; });
+            if (it == tasks.end()) return false;
+
+            task = std::move(it->Function);
+            tasks.erase(it);
+        }
+        task();
+        return true;
+    }
+
+    size_t ThreadPool::ExecuteMainThreadTasks(TimeStep timeBudget)
+    {
+        MX_ASSERT(ThreadPool::IsMainThread());
+        TimeStep start = Time::Current();
+        size_t executed = 0;
+        do
+        {
+            ThreadPoolData::Task task;
+            {
+                std::lock_guard lock(data->MainThreadMutex);
+                if (data->MainThreadTasks.empty()) break;
+
+                task = std::move(data->MainThreadTasks.front());
+                data->MainThreadTasks.pop_front();
+            }
+            task();
+            executed++;
+        } while (Time::Current() - start < timeBudget);
+
+        return executed;
+    }
+
+    size_t ThreadPool::GetMainThreadTaskCount()
+    {
+        std::lock_guard lock(data->MainThreadMutex);
+        return data->MainThreadTasks.size();
+    }
+
+    void ThreadPool::SubmitToMainThread(ThreadPoolData::Task task)
+    {
+        std::lock_guard lock(data->MainThreadMutex);
+        data->MainThreadTasks.push_back(std::move(task));
+    }
+}
@@ -0,0 +1,214 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/Time/Time.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <deque>
+#include <atomic>
+
+namespace MxEngine
+{
+    /*!
+    identifier of related worker tasks. Threads which wait for a task help only with tasks of the same group
+    */
+    using TaskGroup = size_t;
+
+    struct ThreadPoolData
+    {
+        using Task = std::function<void()>;
+
+        struct WorkerTask
+        {
+            Task Function;
+            TaskGroup Group;
+        };
+
+        MxVector<std::thread> Workers;
+        std::deque<WorkerTask> WorkerTasks;
+        std::deque<Task> MainThreadTasks;
+        std::mutex WorkerMutex;
+        std::mutex MainThreadMutex;
+        std::condition_variable WorkerCondition;
+        std::thread::id MainThreadId;
+        std::atomic<TaskGroup> NextTaskGroup{ 1 };
+        std::atomic<size_t> WorkerCount{ 0 }; // changed under worker mutex, but read by any thread without locking
+        bool IsStopped = false;
+    };
+
+    /*!
+    thread pool is a global engine module which owns worker threads for CPU-only jobs (mesh processing, file decoding, etc.)
+    engine resources (handles, graphic and audio objects) are not thread-safe, so jobs must never create, copy or destroy them.
+    Instead, jobs post continuations to the main thread queue, which is executed by Application each frame under a time budget
+    */
+    class ThreadPool
+    {
+        inline static ThreadPoolData* data = nullptr;
+
+        static void StartWorkers(size_t count);
+        static void StopWorkers();
+        static void WorkerLoop(ThreadPoolData* data);
+        static void PushTask(ThreadPoolData::Task task, TaskGroup group);
+    public:
+        /*!
+        group of tasks submitted without explicit group. Such tasks are never executed by waiting threads
+        */
+        constexpr static TaskGroup DefaultGroup = 0;
+
+        static void Init();
+        static void Destroy();
+        static ThreadPoolData* GetImpl();
+        static void Clone(ThreadPoolData* impl);
+
+        /*!
+        restarts worker threads with new count. Already queued tasks are preserved. Must be called from main thread.
+        Other threads may observe zero workers while pool is restarted, in which case they process their parallel work by themselves
+        \param count worker thread count. If zero is passed, count is deduced from hardware concurrency
+        */
+        static void SetWorkerCount(size_t count);
+        static size_t GetWorkerCount();
+        static bool IsMainThread();
+        /*!
+        creates new task group, which is not used by any previously submitted task
+        */
+        static TaskGroup CreateTaskGroup();
+        /*!
+        executes oldest pending worker task of the group on the calling thread (used to help workers while waiting for results)
+        \param group group of task to execute
+        \returns true if task was executed, false if worker queue has no tasks of the group
+        */
+        static bool ExecutePendingTask(TaskGroup group);
+        /*!
+        executes tasks posted to main thread until queue is empty or time budget is exceeded. At least one task is always executed
+        \param timeBudget maximum time in seconds to spend on task execution
+        \returns number of executed tasks
+        */
+        static size_t ExecuteMainThreadTasks(TimeStep timeBudget);
+        static size_t GetMainThreadTaskCount();
+        static void SubmitToMainThread(ThreadPoolData::Task task);
+
+        /*!
+        schedules function for execution on worker thread
+        \param func callable object without arguments
+        \returns future which holds function result
+        */
+        template<typename F>
+        static auto Submit(F&& func)
+        {
+            return ThreadPool::Submit(DefaultGroup, std::forward<F>(func));
+        }
+
+        /*!
+        schedules function for execution on worker thread as a part of task group
+        \param group group of task. Threads waiting for the group may execute task themselves
+        \param func callable object without arguments
+        \returns future which holds function result
+        */
+        template<typename F>
+        static auto Submit(TaskGroup group, F&& func)
+        {
+            using ResultType = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(func));
+            auto future = task->get_future();
+            ThreadPool::PushTask([task]() { (*task)(); }, group);
+            return future;
+        }
+
+        /*!
+        blocks until future is ready. Unrelated worker tasks are never executed by the calling thread
+        \param future future returned by Submit() method
+        */
+        template<typename Future>
+        static void Wait(Future& future)
+        {
+            future.wait();
+        }
+
+        /*!
+        blocks until future is ready, executing pending worker tasks of the group on the calling thread meanwhile.
+        When no task of the group is queued, the rest of them is already running, so calling thread sleeps until future is ready
+        \param future future returned by Submit() method
+        \param group group which future task was submitted to
+        */
+        template<typename Future>
+        static void Wait(Future& future, TaskGroup group)
+        {
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                if (!ThreadPool::ExecutePendingTask(group))
+                {
+                    future.wait();
+                    return;
+                }
+            }
+        }
+
+        /*!
+        splits range [0, count) into chunks and processes them in parallel. Calling thread also participates in processing
+        \param count total number of elements
+        \param granularity minimal number of elements in one chunk
+        \param func callable object with (size_t begin, size_t end) signature
+        */
+        template<typename F>
+        static void ParallelFor(size_t count, size_t granularity, F&& func)
+        {
+            granularity = granularity == 0 ? 1 : granularity;
+            size_t chunkCount = (count + granularity - 1) / granularity;
+            if (chunkCount <= 1 || ThreadPool::GetWorkerCount() == 0)
+            {
+                if (count > 0) func(size_t(0), count);
+                return;
+            }
+
+            // chunks form their own group, so calling thread helps only with them and not with unrelated long tasks
+            TaskGroup group = ThreadPool::CreateTaskGroup();
+            MxVector<std::future<void>> futures;
+            futures.reserve(chunkCount - 1);
+            for (size_t chunk = 1; chunk < chunkCount; chunk++)
+            {
+                size_t begin = chunk * granularity;
+                size_t end = begin + granularity < count ? begin + granularity : count;
+                futures.push_back(ThreadPool::Submit(group, [&func, begin, end]() { func(begin, end); }));
+            }
+            func(size_t(0), granularity);
+
+            for (auto& future : futures)
+            {
+                ThreadPool::Wait(future, group);
+                future.get();
+            }
+        }
+    };
+}